@@ -0,0 +1,446 @@
+// 资源管理性能基准
+// 按参数生成资源树，对注册、路径查找、属性读写、动态更新、索引构建和各类查询分别计时。
+// 每个场景先做若干轮预热，再采集多轮样本，每轮样本执行一批操作并记录单次操作的平均耗时，
+// 输出各场景的百分位数；--json 指定文件时另外写出机器可读的结果，便于跨版本比较回归
+//
+// 用法: bench_resource [--depth N] [--fanout N] [--attrs N] [--indexes N] [--threads N]
+//                      [--dynamic N] [--samples N] [--warmup N] [--batch N]
+//                      [--filter 子串] [--json 文件|-]
+
+#include "resource_api.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <thread>
+
+#ifdef _WIN32
+#include <windows.h>
+#endif
+
+#ifndef RESOURCE_BENCH_BUILD_TYPE
+#define RESOURCE_BENCH_BUILD_TYPE "unknown"
+#endif
+
+using namespace resource;
+
+namespace {
+
+struct BenchConfig {
+    int depth = 3;        // 根节点以下的层数
+    int fanout = 20;      // 每个节点的子节点数
+    int attrs = 8;        // 每个节点的属性数，依次为int/double/string
+    int indexes = 2;      // 建立属性索引的属性数（取前indexes个属性）
+    int threads = 4;      // 并发场景的线程数
+    int dynamic = 1000;   // 动态结构体数量
+    int samples = 30;     // 每个场景采集的样本数
+    int warmup = 3;       // 预热轮数（不计入结果）
+    int batch = 256;      // 每轮样本执行的操作数
+    std::string filter;   // 只运行名称包含该子串的场景
+    std::string jsonPath; // JSON输出路径，"-"表示标准输出
+};
+
+struct BenchResult {
+    std::string name;
+    size_t opsPerSample;
+    std::vector<double> nanos;  // 每轮样本中单次操作的平均耗时（纳秒），已排序
+
+    double percentile(double p) const {
+        if (nanos.empty()) return 0.0;
+        size_t rank = static_cast<size_t>(p / 100.0 * nanos.size() + 0.5);
+        rank = std::min(std::max<size_t>(rank, 1), nanos.size());
+        return nanos[rank - 1];
+    }
+
+    double mean() const {
+        double total = 0.0;
+        for (double value : nanos) total += value;
+        return nanos.empty() ? 0.0 : total / nanos.size();
+    }
+};
+
+// 动态更新场景使用的结构体
+struct Track {
+    std::string id;
+    double longitude;
+    double latitude;
+    double altitude;
+    int state;
+};
+
+class TrackConverter : public StructConverter {
+public:
+    std::shared_ptr<ResourceNode> convert(const void* structPtr, const std::string& nodeName) const override {
+        const Track& track = *static_cast<const Track*>(structPtr);
+        auto node = std::make_shared<ResourceNode>(nodeName, track.id);
+        node->setAttribute("longitude", track.longitude);
+        node->setAttribute("latitude", track.latitude);
+        node->setAttribute("altitude", track.altitude);
+        node->setAttribute("state", track.state);
+        return node;
+    }
+
+    StructConverter* clone() const override { return new TrackConverter(*this); }
+};
+
+// 简单的线性同余随机数，保证每次运行访问序列一致
+class Lcg {
+public:
+    explicit Lcg(unsigned seed) : state_(seed) {}
+    size_t next(size_t bound) {
+        state_ = state_ * 1103515245u + 12345u;
+        return (state_ >> 8) % bound;
+    }
+
+private:
+    unsigned state_;
+};
+
+std::string attrName(int index) { return "attr" + std::to_string(index); }
+
+void setBenchAttribute(ResourceNode& node, int attr, size_t seq) {
+    switch (attr % 3) {
+    case 0: node.setAttribute(attrName(attr), static_cast<int>((seq * 31 + attr) % 1000)); break;
+    case 1: node.setAttribute(attrName(attr), static_cast<double>((seq * 17 + attr) % 5000) / 10.0); break;
+    default: node.setAttribute(attrName(attr), "v" + std::to_string((seq + attr) % 64)); break;
+    }
+}
+
+// 生成 depth 层、每层 fanout 个子节点的树，记录所有非根节点的路径和ID
+std::shared_ptr<ResourceNode> buildTree(const BenchConfig& config, std::vector<std::string>* paths,
+                                        std::vector<std::string>* ids) {
+    auto root = std::make_shared<ResourceNode>("基准", "bench");
+    size_t seq = 0;
+    std::vector<std::pair<std::shared_ptr<ResourceNode>, std::string>> level(1, std::make_pair(root, std::string("bench")));
+    for (int d = 0; d < config.depth; ++d) {
+        std::vector<std::pair<std::shared_ptr<ResourceNode>, std::string>> next;
+        next.reserve(level.size() * config.fanout);
+        for (const auto& parent : level) {
+            for (int f = 0; f < config.fanout; ++f, ++seq) {
+                std::string id = "n" + std::to_string(seq);
+                auto node = std::make_shared<ResourceNode>("层" + std::to_string(d + 1), id);
+                for (int a = 0; a < config.attrs; ++a) {
+                    setBenchAttribute(*node, a, seq);
+                }
+                parent.first->addChild(node);
+                std::string path = parent.second + "/" + id;
+                if (paths) paths->push_back(path);
+                if (ids) ids->push_back(id);
+                next.push_back(std::make_pair(node, path));
+            }
+        }
+        level.swap(next);
+    }
+    return root;
+}
+
+void createIndexes(ResourceIndexer& indexer, const BenchConfig& config) {
+    for (int a = 0; a < config.indexes && a < config.attrs; ++a) {
+        switch (a % 3) {
+        case 0: indexer.createAttributeIndex<int>(attrName(a)); break;
+        case 1: indexer.createAttributeIndex<double>(attrName(a)); break;
+        default: indexer.createAttributeIndex<std::string>(attrName(a)); break;
+        }
+    }
+}
+
+class BenchRunner {
+public:
+    // --json - 时JSON占用标准输出，表格改写到标准错误
+    explicit BenchRunner(const BenchConfig& config)
+        : config_(config), out_(config.jsonPath == "-" ? stderr : stdout) {}
+
+    bool selected(const std::string& name) const {
+        return config_.filter.empty() || name.find(config_.filter) != std::string::npos;
+    }
+
+    // 每轮调用一次body，body执行ops次操作；记录每次操作的平均纳秒数
+    void run(const std::string& name, size_t ops, const std::function<void()>& body) {
+        if (!selected(name) || ops == 0) return;
+        for (int i = 0; i < config_.warmup; ++i) body();
+
+        BenchResult result;
+        result.name = name;
+        result.opsPerSample = ops;
+        for (int i = 0; i < config_.samples; ++i) {
+            auto start = std::chrono::steady_clock::now();
+            body();
+            auto end = std::chrono::steady_clock::now();
+            double nanos = static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count());
+            result.nanos.push_back(nanos / ops);
+        }
+        std::sort(result.nanos.begin(), result.nanos.end());
+        printRow(result);
+        results_.push_back(result);
+    }
+
+    const std::vector<BenchResult>& results() const { return results_; }
+
+    void printHeader() const {
+        std::fprintf(out_, "%-28s %10s %12s %12s %12s %12s %12s\n", "场景", "每轮操作", "平均(ns)", "p50(ns)", "p90(ns)",
+                    "p99(ns)", "最大(ns)");
+    }
+
+private:
+    void printRow(const BenchResult& result) const {
+        std::fprintf(out_, "%-28s %10zu %12.1f %12.1f %12.1f %12.1f %12.1f\n", result.name.c_str(), result.opsPerSample,
+                    result.mean(), result.percentile(50), result.percentile(90), result.percentile(99),
+                    result.nanos.empty() ? 0.0 : result.nanos.back());
+        std::fflush(out_);
+    }
+
+    const BenchConfig& config_;
+    FILE* out_;
+    std::vector<BenchResult> results_;
+};
+
+void writeJson(std::ostream& out, const BenchConfig& config, size_t nodeCount, const std::vector<BenchResult>& results) {
+    out << "{\n";
+    out << "  \"build_type\": \"" << RESOURCE_BENCH_BUILD_TYPE << "\",\n";
+    out << "  \"config\": {\"depth\": " << config.depth << ", \"fanout\": " << config.fanout
+        << ", \"attrs\": " << config.attrs << ", \"indexes\": " << config.indexes
+        << ", \"threads\": " << config.threads << ", \"dynamic\": " << config.dynamic
+        << ", \"samples\": " << config.samples << ", \"warmup\": " << config.warmup
+        << ", \"batch\": " << config.batch << ", \"nodes\": " << nodeCount << "},\n";
+    out << "  \"results\": [\n";
+    for (size_t i = 0; i < results.size(); ++i) {
+        const BenchResult& r = results[i];
+        out << "    {\"name\": \"" << r.name << "\", \"ops_per_sample\": " << r.opsPerSample
+            << ", \"samples\": " << r.nanos.size() << ", \"mean_ns\": " << r.mean()
+            << ", \"p50_ns\": " << r.percentile(50) << ", \"p90_ns\": " << r.percentile(90)
+            << ", \"p99_ns\": " << r.percentile(99) << ", \"max_ns\": " << (r.nanos.empty() ? 0.0 : r.nanos.back())
+            << ", \"min_ns\": " << (r.nanos.empty() ? 0.0 : r.nanos.front()) << "}"
+            << (i + 1 < results.size() ? ",\n" : "\n");
+    }
+    out << "  ]\n}\n";
+}
+
+bool parseArgs(int argc, char* argv[], BenchConfig& config) {
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--help" || arg == "-h" || i + 1 >= argc) {
+            return false;
+        }
+        std::string value = argv[++i];
+        if (arg == "--filter") {
+            config.filter = value;
+            continue;
+        }
+        if (arg == "--json") {
+            config.jsonPath = value;
+            continue;
+        }
+        int number = std::atoi(value.c_str());
+        if (arg == "--depth") config.depth = number;
+        else if (arg == "--fanout") config.fanout = number;
+        else if (arg == "--attrs") config.attrs = number;
+        else if (arg == "--indexes") config.indexes = number;
+        else if (arg == "--threads") config.threads = number;
+        else if (arg == "--dynamic") config.dynamic = number;
+        else if (arg == "--samples") config.samples = number;
+        else if (arg == "--warmup") config.warmup = number;
+        else if (arg == "--batch") config.batch = number;
+        else return false;
+    }
+    return config.depth > 0 && config.fanout > 0 && config.attrs >= 0 && config.indexes >= 0 && config.threads > 0 &&
+           config.dynamic >= 0 && config.samples > 0 && config.warmup >= 0 && config.batch > 0;
+}
+
+} // namespace
+
+int main(int argc, char* argv[])
+{
+#ifdef _WIN32
+    SetConsoleOutputCP(CP_UTF8);
+#endif
+    BenchConfig config;
+    if (!parseArgs(argc, argv, config)) {
+        std::fprintf(stderr,
+            "用法: %s [--depth N] [--fanout N] [--attrs N] [--indexes N] [--threads N] [--dynamic N]\n"
+            "          [--samples N] [--warmup N] [--batch N] [--filter 子串] [--json 文件|-]\n", argv[0]);
+        return 2;
+    }
+    if (std::strcmp(RESOURCE_BENCH_BUILD_TYPE, "Release") != 0 && std::strcmp(RESOURCE_BENCH_BUILD_TYPE, "RelWithDebInfo") != 0) {
+        std::fprintf(stderr, "警告: 当前构建类型为 %s，基准结果请使用 -DCMAKE_BUILD_TYPE=Release 构建\n",
+                     RESOURCE_BENCH_BUILD_TYPE);
+    }
+
+    std::vector<std::string> paths;
+    std::vector<std::string> ids;
+    ResourceRegistry registry;
+    registry.registerRootNode(buildTree(config, &paths, &ids));
+    const size_t nodeCount = paths.size();
+    const size_t batch = static_cast<size_t>(config.batch);
+    BenchRunner runner(config);
+    std::fprintf(config.jsonPath == "-" ? stderr : stdout,
+                 "节点数: %zu, 深度: %d, 扇出: %d, 属性数: %d, 索引数: %d, 线程数: %d\n\n", nodeCount, config.depth,
+                 config.fanout, config.attrs, config.indexes, config.threads);
+    runner.printHeader();
+    Lcg rng(2024);
+
+    // --- 注册 ---
+    runner.run("register_tree", nodeCount, [&]() {
+        ResourceRegistry scratch;
+        scratch.registerRootNode(buildTree(config, nullptr, nullptr));
+    });
+
+    // --- 路径查找与属性读写 ---
+    std::vector<std::shared_ptr<ResourceNode>> nodes;
+    for (const auto& path : paths) nodes.push_back(registry.getNodeByPath(path));
+
+    volatile size_t sink = 0;
+    runner.run("path_lookup", batch, [&]() {
+        for (size_t i = 0; i < batch; ++i) sink = sink + (registry.getNodeByPath(paths[rng.next(nodeCount)]) ? 1 : 0);
+    });
+
+    if (config.attrs > 0) {
+        runner.run("attr_get", batch, [&]() {
+            for (size_t i = 0; i < batch; ++i) sink = sink + nodes[rng.next(nodeCount)]->getAttribute<int>("attr0");
+        });
+        runner.run("attr_set", batch, [&]() {
+            for (size_t i = 0; i < batch; ++i) nodes[rng.next(nodeCount)]->setAttribute("attr0", static_cast<int>(i));
+        });
+    }
+
+    // --- 索引构建 ---
+    runner.run("index_build", nodeCount, [&]() {
+        ResourceIndexer scratch(registry);
+        createIndexes(scratch, config);
+    });
+
+    ResourceIndexer indexer(registry);
+    createIndexes(indexer, config);
+    indexer.setQueryCacheCapacity(0);
+    for (const auto& path : paths) registry.setAttribute(path, "attr0", static_cast<int>(rng.next(1000)));
+    registry.commitChanges();
+
+    // 经注册表修改并提交，包含变更记录和增量索引维护
+    if (config.attrs > 0) {
+        runner.run("attr_set_committed", batch, [&]() {
+            for (size_t i = 0; i < batch; ++i) {
+                registry.setAttribute(paths[rng.next(nodeCount)], "attr0", static_cast<int>(rng.next(1000)));
+            }
+            registry.commitChanges();
+        });
+    }
+
+    // --- 动态结构体更新 ---
+    std::vector<Track> tracks(static_cast<size_t>(config.dynamic));
+    TrackConverter converter;
+    registry.registerRootNode(std::make_shared<ResourceNode>("航迹", "tracks"));
+    for (size_t i = 0; i < tracks.size(); ++i) {
+        tracks[i].id = "track" + std::to_string(i);
+        tracks[i].longitude = 116.0;
+        tracks[i].latitude = 39.0;
+        tracks[i].altitude = 1000.0;
+        tracks[i].state = 0;
+        registry.registerDynamicStruct(tracks[i], "tracks/" + tracks[i].id, converter, "航迹");
+    }
+    registry.commitChanges();
+    runner.run("dynamic_update", tracks.size(), [&]() {
+        for (auto& track : tracks) {
+            track.longitude += 0.001;
+            track.latitude += 0.001;
+            ++track.state;
+        }
+        registry.updateAllDynamicObjects();
+    });
+
+    // --- 查询 ---
+    runner.run("find_by_id", batch, [&]() {
+        for (size_t i = 0; i < batch; ++i) sink = sink + (indexer.getById(ids[rng.next(nodeCount)]) ? 1 : 0);
+    });
+    runner.run("find_by_name", 1, [&]() { sink = sink + indexer.findByName("层1").size(); });
+
+    if (config.indexes > 0 && config.attrs > 0) {
+        const size_t queries = std::max<size_t>(batch / 16, 1);
+        runner.run("query_eq", queries, [&]() {
+            for (size_t i = 0; i < queries; ++i) {
+                sink = sink + indexer.findByAttributeIndexed<int>("attr0", static_cast<int>(rng.next(1000))).size();
+            }
+        });
+        runner.run("query_greater_than", queries, [&]() {
+            for (size_t i = 0; i < queries; ++i) {
+                sink = sink + indexer.findGreaterThan<int>("attr0", 990 + static_cast<int>(rng.next(10))).size();
+            }
+        });
+        runner.run("query_range", queries, [&]() {
+            for (size_t i = 0; i < queries; ++i) {
+                int low = static_cast<int>(rng.next(990));
+                sink = sink + indexer.findInRange<int>("attr0", low, low + 10).size();
+            }
+        });
+        runner.run("query_top_k", queries, [&]() {
+            for (size_t i = 0; i < queries; ++i) sink = sink + indexer.findTopK<int>("attr0", 20).size();
+        });
+        runner.run("query_range_paged", queries, [&]() {
+            for (size_t i = 0; i < queries; ++i) {
+                PageToken<int> token;
+                sink = sink + indexer.findInRange<int>("attr0", 0, 999, 50, token).size();
+            }
+        });
+        runner.run("aggregate", queries, [&]() {
+            for (size_t i = 0; i < queries; ++i) sink = sink + indexer.aggregate("attr0").count;
+        });
+
+        indexer.setQueryCacheCapacity(256);
+        runner.run("query_range_cached", batch, [&]() {
+            for (size_t i = 0; i < batch; ++i) {
+                int low = static_cast<int>(rng.next(16)) * 10;
+                sink = sink + indexer.findInRange<int>("attr0", low, low + 10).size();
+            }
+        });
+        indexer.setQueryCacheCapacity(0);
+    }
+
+    std::vector<std::function<bool(const std::shared_ptr<ResourceNode>&)>> conditions = {
+        [](const std::shared_ptr<ResourceNode>& node) {
+            return node->hasAttribute("attr0") && node->getAttribute<int>("attr0") < 100;
+        },
+        [](const std::shared_ptr<ResourceNode>& node) { return node->getName() == "层1"; }
+    };
+    runner.run("query_multi_conditions", 1, [&]() { sink = sink + indexer.findByMultiConditions(conditions, true).size(); });
+    runner.run("query_predicate_scan", 1, [&]() {
+        sink = sink + indexer.findByAttribute<int>("attr0", 7).size();
+    });
+
+    // --- 并发查找 ---
+    // 每个线程各执行batch次查找，记录的是总耗时除以全部操作数，即吞吐量的倒数
+    const size_t concurrentOps = batch * static_cast<size_t>(config.threads);
+    auto concurrent = [&](const std::function<void(Lcg&)>& lookup) {
+        std::vector<std::thread> workers;
+        for (int t = 0; t < config.threads; ++t) {
+            workers.push_back(std::thread([&lookup, &batch, t]() {
+                Lcg local(static_cast<unsigned>(t) * 7919u + 1u);
+                for (size_t i = 0; i < batch; ++i) lookup(local);
+            }));
+        }
+        for (auto& worker : workers) worker.join();
+    };
+    std::atomic<size_t> hits(0);
+    runner.run("concurrent_find_by_id", concurrentOps, [&]() {
+        concurrent([&](Lcg& local) { if (indexer.getById(ids[local.next(nodeCount)])) ++hits; });
+    });
+    runner.run("concurrent_path_lookup", concurrentOps, [&]() {
+        concurrent([&](Lcg& local) { if (registry.getNodeByPath(paths[local.next(nodeCount)])) ++hits; });
+    });
+
+    if (!config.jsonPath.empty()) {
+        if (config.jsonPath == "-") {
+            writeJson(std::cout, config, nodeCount, runner.results());
+        } else {
+            std::ofstream out(config.jsonPath.c_str());
+            if (!out) {
+                std::fprintf(stderr, "无法写入 %s\n", config.jsonPath.c_str());
+                return 1;
+            }
+            writeJson(out, config, nodeCount, runner.results());
+            std::printf("\n结果已写入 %s\n", config.jsonPath.c_str());
+        }
+    }
+    return 0;
+}
@@ -4,6 +4,14 @@
 #include "resource_node.h"
 #include "resource_registry.h"
 #include "resource_indexer.h"
+#include "resource_changelog.h"
+#include "resource_history.h"
+#include "resource_json.h"
+#include "resource_lazy.h"
+#include "resource_metrics.h"
+#include "resource_spill.h"
+#include "resource_table.h"
+#include "resource_typed_converter.h"
 
 template<typename Func>
 long long measureTime(Func func) {
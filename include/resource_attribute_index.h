@@ -0,0 +1,690 @@
+#pragma once
+
+#include "resource_registry.h"
+#include "resource_bitmap.h"
+#include "resource_memory.h"
+#include <algorithm>
+#include <functional>
+#include <map>
+#include <memory>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <typeinfo>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+namespace resource {
+
+// 索引键在查询缓存键中的文本形式，需要无歧义（同一索引内不同的键得到不同的文本）
+// 没有特化的类型返回false，其查询不进入缓存；自定义键类型可以特化此模板以启用缓存
+template<typename T, typename Enable = void>
+struct IndexKeyFormat {
+    static bool append(std::string&, const T&) { return false; }
+};
+
+template<>
+struct IndexKeyFormat<std::string> {
+    static bool append(std::string& out, const std::string& value) {
+        out += "s" + std::to_string(value.size()) + ":" + value;
+        return true;
+    }
+};
+
+template<typename T>
+struct IndexKeyFormat<T, typename std::enable_if<std::is_integral<T>::value>::type> {
+    static bool append(std::string& out, const T& value) {
+        out += "i" + std::to_string(value);
+        return true;
+    }
+};
+
+template<typename T>
+struct IndexKeyFormat<T, typename std::enable_if<std::is_floating_point<T>::value>::type> {
+    static bool append(std::string& out, const T& value) {
+        std::ostringstream stream;
+        stream << std::hexfloat << value;
+        out += "d" + stream.str();
+        return true;
+    }
+};
+
+template<typename T>
+struct IndexKeyFormat<T, typename std::enable_if<std::is_enum<T>::value>::type> {
+    static bool append(std::string& out, const T& value) {
+        typedef typename std::underlying_type<T>::type Underlying;
+        return IndexKeyFormat<Underlying>::append(out, static_cast<Underlying>(value));
+    }
+};
+
+// 哈希索引使用的键哈希，枚举按底层整数取哈希；自定义键类型需要特化std::hash并提供operator==
+template<typename T, typename Enable = void>
+struct IndexKeyHash {
+    size_t operator()(const T& value) const { return std::hash<T>()(value); }
+};
+
+template<typename T>
+struct IndexKeyHash<T, typename std::enable_if<std::is_enum<T>::value>::type> {
+    size_t operator()(const T& value) const {
+        typedef typename std::underlying_type<T>::type Underlying;
+        return std::hash<Underlying>()(static_cast<Underlying>(value));
+    }
+};
+
+// 键类型能否建立哈希索引（枚举，或有可用的std::hash特化）
+template<typename T, typename Enable = void>
+struct IsHashableIndexKey : std::is_enum<T> {};
+
+template<typename T>
+struct IsHashableIndexKey<T, decltype(void(std::hash<T>()(std::declval<const T&>())))> : std::true_type {};
+
+// 属性索引的种类，创建索引时按属性的查询方式选择
+enum class IndexKind {
+    Ordered,  // 有序映射，支持等值、范围、前k个和分页查询，数值索引可直接给出聚合
+    Hash,     // 开放寻址的扁平哈希表，只支持等值查询，适合ID、序列号等高基数属性
+    Bitmap    // 每个值一个压缩位图，适合燃料、已部署等只有少数几个取值的属性，可在多个属性间做集合运算
+};
+
+// 提交中可能需要更新索引的节点，live为false表示节点已从注册表移除
+struct IndexCandidate {
+    const std::shared_ptr<ResourceNode>* node;
+    bool live;
+};
+
+// 属性索引的类型无关部分：索引器通过它重建、增量维护和统计索引，不需要知道键的类型
+class AttributeIndexBase {
+public:
+    explicit AttributeIndexBase(const std::string& attrName) : attrName_(attrName) {}
+    virtual ~AttributeIndexBase() {}
+
+    const std::string& attrName() const { return attrName_; }
+    virtual const std::type_info& keyType() const = 0;
+    virtual IndexKind kind() const = 0;
+
+    // 按注册表的当前内容重建
+    virtual void rebuild(const ResourceRegistry& registry) = 0;
+    // 对比候选节点的当前值和索引中的旧键，更新所在的桶
+    virtual void update(const std::vector<IndexCandidate>& candidates) = 0;
+
+    // 数值索引给出计数、总和与最值，其他类型或索引为空时返回false
+    virtual bool aggregate(AggregateResult& result) const = 0;
+    // 是否为能给出聚合结果的数值索引（与当前是否为空无关）
+    virtual bool numeric() const { return false; }
+    // 按键的顺序访问索引中的全部节点
+    virtual void forEachNode(const std::function<void(const ResourceNode&)>& visitor) const = 0;
+    // 索引对象、有序桶和节点到键的映射占用的内存
+    virtual size_t memoryBytes() const = 0;
+
+private:
+    std::string attrName_;
+};
+
+// 属性值类型为T的索引，键直接按T比较，不经过类型转换
+// 只收录属性值类型恰好为T的节点，int索引不包含double属性，反之亦然
+template<typename T>
+class TypedAttributeIndex : public AttributeIndexBase {
+public:
+    explicit TypedAttributeIndex(const std::string& attrName) : AttributeIndexBase(attrName) {}
+
+    // 属性值类型为T时返回其值，否则返回nullptr
+    static const T* keyOf(const AttributeValue* value) {
+        return value ? value->as<T>() : nullptr;
+    }
+
+    const std::type_info& keyType() const override { return typeid(T); }
+
+    // 把属性值等于key的节点追加到results
+    virtual void findEqual(const T& key, std::vector<std::shared_ptr<ResourceNode>>& results) const = 0;
+};
+
+// 有序索引，要求T可复制并支持operator<
+template<typename T>
+class OrderedAttributeIndex : public TypedAttributeIndex<T> {
+public:
+    typedef std::map<T, std::vector<std::shared_ptr<ResourceNode>>> BucketMap;
+
+    explicit OrderedAttributeIndex(const std::string& attrName) : TypedAttributeIndex<T>(attrName), sum_(0.0) {}
+
+    const BucketMap& buckets() const { return buckets_; }
+    // 索引中的节点数
+    size_t nodeCount() const { return nodeKeys_.size(); }
+
+    IndexKind kind() const override { return IndexKind::Ordered; }
+
+    void findEqual(const T& key, std::vector<std::shared_ptr<ResourceNode>>& results) const override {
+        auto it = buckets_.find(key);
+        if (it != buckets_.end()) {
+            results.insert(results.end(), it->second.begin(), it->second.end());
+        }
+    }
+
+    void rebuild(const ResourceRegistry& registry) override {
+        buckets_.clear();
+        nodeKeys_.clear();
+        sum_ = 0.0;
+        registry.traverseNodes([this](std::shared_ptr<ResourceNode> node) {
+            const T* key = this->keyOf(node->findAttribute(this->attrName()));
+            if (key) {
+                buckets_[*key].push_back(node);
+                nodeKeys_.insert(std::make_pair(node.get(), *key));
+                addNumber(*key, 1.0, IsNumeric());
+            }
+        });
+    }
+
+    void update(const std::vector<IndexCandidate>& candidates) override {
+        struct BucketOp {
+            T key;
+            const std::shared_ptr<ResourceNode>* node;
+            bool insert;
+        };
+
+        std::vector<BucketOp> ops;
+        for (const auto& candidate : candidates) {
+            const ResourceNode* ptr = candidate.node->get();
+            const T* newKey = candidate.live ? this->keyOf(ptr->findAttribute(this->attrName())) : nullptr;
+
+            auto old = nodeKeys_.find(ptr);
+            if (old != nodeKeys_.end()) {
+                if (newKey && equivalent(old->second, *newKey)) continue;
+                ops.push_back(BucketOp{old->second, candidate.node, false});
+                addNumber(old->second, -1.0, IsNumeric());
+                if (newKey) {
+                    old->second = *newKey;
+                } else {
+                    nodeKeys_.erase(old);
+                }
+            } else if (newKey) {
+                nodeKeys_.insert(std::make_pair(ptr, *newKey));
+            }
+            if (newKey) {
+                ops.push_back(BucketOp{*newKey, candidate.node, true});
+                addNumber(*newKey, 1.0, IsNumeric());
+            }
+        }
+
+        // 只排序下标，避免搬动键和节点指针
+        std::vector<size_t> order(ops.size());
+        for (size_t i = 0; i < order.size(); ++i) {
+            order[i] = i;
+        }
+        std::sort(order.begin(), order.end(), [&ops](size_t a, size_t b) { return ops[a].key < ops[b].key; });
+
+        // 同一个键的操作相邻，每个桶只查找一次
+        for (size_t i = 0; i < order.size();) {
+            const T& key = ops[order[i]].key;
+            size_t j = i;
+            while (j < order.size() && equivalent(ops[order[j]].key, key)) ++j;
+
+            auto bucketIt = buckets_.lower_bound(key);
+            if (bucketIt == buckets_.end() || key < bucketIt->first) {
+                bucketIt = buckets_.insert(bucketIt, std::make_pair(key, std::vector<std::shared_ptr<ResourceNode>>()));
+            }
+            auto& bucket = bucketIt->second;
+
+            std::unordered_set<const ResourceNode*> removed;
+            for (size_t k = i; k < j; ++k) {
+                const BucketOp& op = ops[order[k]];
+                if (op.insert) {
+                    bucket.push_back(*op.node);
+                } else {
+                    removed.insert(op.node->get());
+                }
+            }
+            if (!removed.empty()) {
+                bucket.erase(std::remove_if(bucket.begin(), bucket.end(),
+                    [&removed](const std::shared_ptr<ResourceNode>& node) { return removed.count(node.get()) > 0; }),
+                    bucket.end());
+            }
+            if (bucket.empty()) {
+                buckets_.erase(bucketIt);
+            }
+            i = j;
+        }
+    }
+
+    bool numeric() const override { return IsNumeric::value; }
+
+    bool aggregate(AggregateResult& result) const override {
+        if (!IsNumeric::value || buckets_.empty()) {
+            return false;
+        }
+        result.count = nodeKeys_.size();
+        result.sum = sum_;
+        result.min = toNumber(buckets_.begin()->first, IsNumeric());
+        result.max = toNumber(buckets_.rbegin()->first, IsNumeric());
+        return true;
+    }
+
+    void forEachNode(const std::function<void(const ResourceNode&)>& visitor) const override {
+        for (const auto& bucket : buckets_) {
+            for (const auto& node : bucket.second) {
+                visitor(*node);
+            }
+        }
+    }
+
+    size_t memoryBytes() const override {
+        MemoryUsage keys;
+        size_t bytes = sizeof(*this) + detail::stringHeapBytes(this->attrName()) + detail::treeBytes(buckets_) +
+                       detail::hashTableBytes(nodeKeys_);
+        for (const auto& bucket : buckets_) {
+            detail::accountValueHeap(bucket.first, keys);
+            bytes += detail::vectorBytes(bucket.second);
+        }
+        for (const auto& entry : nodeKeys_) {
+            detail::accountValueHeap(entry.second, keys);
+        }
+        return bytes + keys.total();
+    }
+
+private:
+    // 布尔之外的算术类型维护总和，供aggregate直接使用
+    typedef std::integral_constant<bool, std::is_arithmetic<T>::value && !std::is_same<T, bool>::value> IsNumeric;
+
+    static bool equivalent(const T& a, const T& b) { return !(a < b) && !(b < a); }
+
+    static double toNumber(const T& value, std::true_type) { return static_cast<double>(value); }
+    static double toNumber(const T&, std::false_type) { return 0.0; }
+
+    void addNumber(const T& value, double sign, std::true_type) { sum_ += sign * static_cast<double>(value); }
+    void addNumber(const T&, double, std::false_type) {}
+
+    BucketMap buckets_;
+    // 节点当前所在的桶，增量维护时据此找到旧位置
+    std::unordered_map<const ResourceNode*, T> nodeKeys_;
+    double sum_;
+};
+
+// 等值哈希索引：键和节点列表直接存放在开放寻址（线性探测）的槽数组中，
+// 建立和查找不需要逐个分配树节点；不维护键的顺序，因此不支持范围查询和直接聚合
+// 要求T可复制、支持operator==，并且有可用的IndexKeyHash<T>
+template<typename T>
+class HashAttributeIndex : public TypedAttributeIndex<T> {
+public:
+    explicit HashAttributeIndex(const std::string& attrName) : TypedAttributeIndex<T>(attrName), size_(0) {}
+
+    IndexKind kind() const override { return IndexKind::Hash; }
+
+    // 不同键的个数
+    size_t keyCount() const { return size_; }
+
+    void findEqual(const T& key, std::vector<std::shared_ptr<ResourceNode>>& results) const override {
+        if (slots_.empty()) {
+            return;
+        }
+        const Slot& slot = slots_[findSlot(key, IndexKeyHash<T>()(key))];
+        if (slot.used) {
+            results.insert(results.end(), slot.nodes.begin(), slot.nodes.end());
+        }
+    }
+
+    void rebuild(const ResourceRegistry& registry) override {
+        slots_.clear();
+        size_ = 0;
+        nodeKeys_.clear();
+        registry.traverseNodes([this](std::shared_ptr<ResourceNode> node) {
+            const T* key = this->keyOf(node->findAttribute(this->attrName()));
+            if (key) {
+                insert(*key, node);
+                nodeKeys_.insert(std::make_pair(node.get(), *key));
+            }
+        });
+    }
+
+    void update(const std::vector<IndexCandidate>& candidates) override {
+        for (const auto& candidate : candidates) {
+            const ResourceNode* ptr = candidate.node->get();
+            const T* newKey = candidate.live ? this->keyOf(ptr->findAttribute(this->attrName())) : nullptr;
+
+            auto old = nodeKeys_.find(ptr);
+            if (old != nodeKeys_.end()) {
+                if (newKey && old->second == *newKey) continue;
+                remove(old->second, ptr);
+                if (newKey) {
+                    old->second = *newKey;
+                } else {
+                    nodeKeys_.erase(old);
+                }
+            } else if (newKey) {
+                nodeKeys_.insert(std::make_pair(ptr, *newKey));
+            }
+            if (newKey) {
+                insert(*newKey, *candidate.node);
+            }
+        }
+    }
+
+    bool aggregate(AggregateResult&) const override { return false; }
+
+    void forEachNode(const std::function<void(const ResourceNode&)>& visitor) const override {
+        for (const auto& slot : slots_) {
+            for (const auto& node : slot.nodes) {
+                visitor(*node);
+            }
+        }
+    }
+
+    size_t memoryBytes() const override {
+        MemoryUsage keys;
+        size_t bytes = sizeof(*this) + detail::stringHeapBytes(this->attrName()) + detail::vectorBytes(slots_) +
+                       detail::hashTableBytes(nodeKeys_);
+        for (const auto& slot : slots_) {
+            if (slot.used) {
+                detail::accountValueHeap(slot.key, keys);
+                bytes += detail::vectorBytes(slot.nodes);
+            }
+        }
+        for (const auto& entry : nodeKeys_) {
+            detail::accountValueHeap(entry.second, keys);
+        }
+        return bytes + keys.total();
+    }
+
+private:
+    struct Slot {
+        bool used;
+        size_t hash;
+        T key;
+        std::vector<std::shared_ptr<ResourceNode>> nodes;
+
+        Slot() : used(false), hash(0), key() {}
+    };
+
+    // key所在的槽，不存在时返回探测序列上的第一个空槽（槽数组非空且总有空槽）
+    size_t findSlot(const T& key, size_t hash) const {
+        const size_t mask = slots_.size() - 1;
+        for (size_t pos = hash & mask;; pos = (pos + 1) & mask) {
+            const Slot& slot = slots_[pos];
+            if (!slot.used || (slot.hash == hash && slot.key == key)) {
+                return pos;
+            }
+        }
+    }
+
+    void insert(const T& key, const std::shared_ptr<ResourceNode>& node) {
+        // 装载因子不超过1/2，探测序列保持很短
+        if ((size_ + 1) * 2 > slots_.size()) {
+            grow();
+        }
+        const size_t hash = IndexKeyHash<T>()(key);
+        Slot& slot = slots_[findSlot(key, hash)];
+        if (!slot.used) {
+            slot.used = true;
+            slot.hash = hash;
+            slot.key = key;
+            ++size_;
+        }
+        slot.nodes.push_back(node);
+    }
+
+    void remove(const T& key, const ResourceNode* node) {
+        if (slots_.empty()) {
+            return;
+        }
+        size_t hole = findSlot(key, IndexKeyHash<T>()(key));
+        Slot& slot = slots_[hole];
+        if (!slot.used) {
+            return;
+        }
+        for (auto it = slot.nodes.begin(); it != slot.nodes.end(); ++it) {
+            if (it->get() == node) {
+                slot.nodes.erase(it);
+                break;
+            }
+        }
+        if (!slot.nodes.empty()) {
+            return;
+        }
+
+        // 槽空出后把同一探测链上后面的条目前移，不使用墓碑，查找始终在第一个空槽停下
+        slot = Slot();
+        --size_;
+        const size_t mask = slots_.size() - 1;
+        for (size_t next = (hole + 1) & mask; slots_[next].used; next = (next + 1) & mask) {
+            // 条目的初始位置到next的探测路径经过hole时才能前移
+            const size_t home = slots_[next].hash & mask;
+            if (((next - home) & mask) >= ((next - hole) & mask)) {
+                slots_[hole] = std::move(slots_[next]);
+                slots_[next] = Slot();
+                hole = next;
+            }
+        }
+    }
+
+    void grow() {
+        std::vector<Slot> old;
+        old.swap(slots_);
+        slots_.resize(old.empty() ? 16 : old.size() * 2);
+        const size_t mask = slots_.size() - 1;
+        for (auto& slot : old) {
+            if (!slot.used) continue;
+            size_t pos = slot.hash & mask;
+            while (slots_[pos].used) {
+                pos = (pos + 1) & mask;
+            }
+            slots_[pos] = std::move(slot);
+        }
+    }
+
+    // 槽数为2的幂
+    std::vector<Slot> slots_;
+    size_t size_;
+    std::unordered_map<const ResourceNode*, T> nodeKeys_;
+};
+
+// 位图索引共用的节点行号：同一节点在所有位图索引中的行号相同，不同属性的位图才能直接做交并
+// 行号按引用计数分配，节点从所有位图索引中移除后行号回收复用，使位图保持稠密
+class NodeRowTable {
+public:
+    static const uint32_t npos = 0xFFFFFFFFu;
+
+    NodeRowTable() : live_(0) {}
+
+    // 取得节点的行号并增加一次引用
+    uint32_t acquire(const std::shared_ptr<ResourceNode>& node) {
+        auto it = byNode_.find(node.get());
+        if (it != byNode_.end()) {
+            ++rows_[it->second].refs;
+            return it->second;
+        }
+        uint32_t row;
+        if (!free_.empty()) {
+            row = free_.back();
+            free_.pop_back();
+        } else {
+            row = static_cast<uint32_t>(rows_.size());
+            rows_.push_back(Row());
+        }
+        rows_[row].node = node;
+        rows_[row].refs = 1;
+        byNode_.insert(std::make_pair(node.get(), row));
+        ++live_;
+        return row;
+    }
+
+    // 减少一次引用，归零时回收行号
+    void release(const ResourceNode* node) {
+        auto it = byNode_.find(node);
+        if (it == byNode_.end()) {
+            return;
+        }
+        Row& row = rows_[it->second];
+        if (--row.refs == 0) {
+            row.node.reset();
+            free_.push_back(it->second);
+            byNode_.erase(it);
+            --live_;
+        }
+    }
+
+    uint32_t rowOf(const ResourceNode* node) const {
+        auto it = byNode_.find(node);
+        return it != byNode_.end() ? it->second : npos;
+    }
+
+    const std::shared_ptr<ResourceNode>& nodeAt(uint32_t row) const { return rows_[row].node; }
+
+    // 当前分配出去的行数
+    size_t size() const { return live_; }
+
+    size_t memoryBytes() const {
+        return detail::vectorBytes(rows_) + detail::vectorBytes(free_) + detail::hashTableBytes(byNode_);
+    }
+
+private:
+    struct Row {
+        std::shared_ptr<ResourceNode> node;
+        size_t refs;
+
+        Row() : refs(0) {}
+    };
+
+    std::vector<Row> rows_;
+    std::vector<uint32_t> free_;
+    std::unordered_map<const ResourceNode*, uint32_t> byNode_;
+    size_t live_;
+};
+
+// 位图索引：每个取值一个RoaringBitmap，记录具有该值的节点行号
+// 取值很少时比有序索引的桶省内存，多个条件的组合用位图的按字交、并、差完成，最后才换回节点。
+// 不保存节点到键的映射，节点的旧值通过逐个检查各取值的位图找到，因此只适合取值个数很少的属性
+// 要求T可复制并支持operator<
+template<typename T>
+class BitmapAttributeIndex : public TypedAttributeIndex<T> {
+public:
+    typedef std::map<T, RoaringBitmap> BitmapMap;
+
+    BitmapAttributeIndex(const std::string& attrName, const std::shared_ptr<NodeRowTable>& rows)
+        : TypedAttributeIndex<T>(attrName), rows_(rows) {}
+
+    ~BitmapAttributeIndex() override { releaseAll(); }
+
+    IndexKind kind() const override { return IndexKind::Bitmap; }
+
+    const BitmapMap& bitmaps() const { return bitmaps_; }
+
+    // 取值为key的节点行号，没有时返回空位图
+    const RoaringBitmap& bitmapOf(const T& key) const {
+        static const RoaringBitmap empty;
+        auto it = bitmaps_.find(key);
+        return it != bitmaps_.end() ? it->second : empty;
+    }
+
+    void findEqual(const T& key, std::vector<std::shared_ptr<ResourceNode>>& results) const override {
+        const RoaringBitmap& rows = bitmapOf(key);
+        results.reserve(results.size() + rows.cardinality());
+        rows.forEach([&](uint32_t row) { results.push_back(rows_->nodeAt(row)); });
+    }
+
+    void rebuild(const ResourceRegistry& registry) override {
+        releaseAll();
+        registry.traverseNodes([this](std::shared_ptr<ResourceNode> node) {
+            const T* key = this->keyOf(node->findAttribute(this->attrName()));
+            if (key) {
+                bitmaps_[*key].add(rows_->acquire(node));
+            }
+        });
+    }
+
+    void update(const std::vector<IndexCandidate>& candidates) override {
+        for (const auto& candidate : candidates) {
+            const ResourceNode* ptr = candidate.node->get();
+            const T* newKey = candidate.live ? this->keyOf(ptr->findAttribute(this->attrName())) : nullptr;
+
+            const uint32_t row = rows_->rowOf(ptr);
+            auto old = row != NodeRowTable::npos ? bitmapContaining(row) : bitmaps_.end();
+            if (old != bitmaps_.end()) {
+                if (newKey && !(old->first < *newKey) && !(*newKey < old->first)) continue;
+                old->second.remove(row);
+                if (old->second.empty()) {
+                    bitmaps_.erase(old);
+                }
+                if (newKey) {
+                    // 节点仍在索引中，沿用原来的行号
+                    bitmaps_[*newKey].add(row);
+                } else {
+                    rows_->release(ptr);
+                }
+            } else if (newKey) {
+                bitmaps_[*newKey].add(rows_->acquire(*candidate.node));
+            }
+        }
+    }
+
+    bool aggregate(AggregateResult&) const override { return false; }
+
+    void forEachNode(const std::function<void(const ResourceNode&)>& visitor) const override {
+        for (const auto& bitmap : bitmaps_) {
+            bitmap.second.forEach([&](uint32_t row) { visitor(*rows_->nodeAt(row)); });
+        }
+    }
+
+    // 共用的行号表由索引器单独统计
+    size_t memoryBytes() const override {
+        MemoryUsage keys;
+        size_t bytes = sizeof(*this) + detail::stringHeapBytes(this->attrName()) + detail::treeBytes(bitmaps_);
+        for (const auto& bitmap : bitmaps_) {
+            detail::accountValueHeap(bitmap.first, keys);
+            bytes += bitmap.second.memoryBytes();
+        }
+        return bytes + keys.total();
+    }
+
+private:
+    typename BitmapMap::iterator bitmapContaining(uint32_t row) {
+        for (auto it = bitmaps_.begin(); it != bitmaps_.end(); ++it) {
+            if (it->second.contains(row)) {
+                return it;
+            }
+        }
+        return bitmaps_.end();
+    }
+
+    void releaseAll() {
+        std::vector<uint32_t> rows;
+        for (const auto& bitmap : bitmaps_) {
+            bitmap.second.forEach([&](uint32_t row) { rows.push_back(row); });
+        }
+        for (uint32_t row : rows) {
+            rows_->release(rows_->nodeAt(row).get());
+        }
+        bitmaps_.clear();
+    }
+
+    std::shared_ptr<NodeRowTable> rows_;
+    BitmapMap bitmaps_;
+};
+
+namespace detail {
+
+template<typename T>
+TypedAttributeIndex<T>* newHashIndex(const std::string& attrName, std::true_type) {
+    return new HashAttributeIndex<T>(attrName);
+}
+
+template<typename T>
+TypedAttributeIndex<T>* newHashIndex(const std::string& attrName, std::false_type) {
+    throw std::invalid_argument("Key type of attribute " + attrName + " is not hashable");
+}
+
+} // namespace detail
+
+// 按种类创建T类型的属性索引（尚未构建），键类型不支持所选种类时抛出std::invalid_argument
+// 位图索引使用rows分配节点行号
+template<typename T>
+std::unique_ptr<TypedAttributeIndex<T>> makeAttributeIndex(const std::string& attrName, IndexKind kind,
+                                                           const std::shared_ptr<NodeRowTable>& rows) {
+    if (kind == IndexKind::Bitmap) {
+        return std::unique_ptr<TypedAttributeIndex<T>>(new BitmapAttributeIndex<T>(attrName, rows));
+    }
+    if (kind == IndexKind::Hash) {
+        return std::unique_ptr<TypedAttributeIndex<T>>(
+            detail::newHashIndex<T>(attrName, std::integral_constant<bool, IsHashableIndexKey<T>::value>()));
+    }
+    return std::unique_ptr<TypedAttributeIndex<T>>(new OrderedAttributeIndex<T>(attrName));
+}
+
+} // namespace resource
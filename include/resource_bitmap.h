@@ -0,0 +1,93 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace resource {
+
+// 压缩位图（Roaring方式）：32位整数按高16位分块，每块根据元素个数选择存储方式——
+// 不超过4096个时为有序的16位数组，超过时为65536位的位集。稀疏块省内存，稠密块的交、并、差按64位字批量计算
+class RoaringBitmap {
+public:
+    RoaringBitmap() {}
+
+    void add(uint32_t value);
+    // 返回value原来是否存在
+    bool remove(uint32_t value);
+    bool contains(uint32_t value) const;
+    void clear() { containers_.clear(); }
+
+    size_t cardinality() const;
+    bool empty() const { return containers_.empty(); }
+
+    // 按升序访问所有元素
+    template<typename Func>
+    void forEach(Func func) const {
+        for (const auto& container : containers_) {
+            const uint32_t high = static_cast<uint32_t>(container.key) << 16;
+            if (container.bits.empty()) {
+                for (uint16_t low : container.values) {
+                    func(high | low);
+                }
+                continue;
+            }
+            for (size_t word = 0; word < container.bits.size(); ++word) {
+                uint64_t bits = container.bits[word];
+                while (bits != 0) {
+                    unsigned bit = lowestBit(bits);
+                    func(high | static_cast<uint32_t>(word * 64 + bit));
+                    bits &= bits - 1;
+                }
+            }
+        }
+    }
+
+    RoaringBitmap& operator&=(const RoaringBitmap& other);
+    RoaringBitmap& operator|=(const RoaringBitmap& other);
+    // 差集（AND NOT）
+    RoaringBitmap& operator-=(const RoaringBitmap& other);
+
+    friend RoaringBitmap operator&(RoaringBitmap a, const RoaringBitmap& b) { return a &= b; }
+    friend RoaringBitmap operator|(RoaringBitmap a, const RoaringBitmap& b) { return a |= b; }
+    friend RoaringBitmap operator-(RoaringBitmap a, const RoaringBitmap& b) { return a -= b; }
+
+    bool operator==(const RoaringBitmap& other) const;
+    bool operator!=(const RoaringBitmap& other) const { return !(*this == other); }
+
+    // 块数组、各块的数组和位集占用的内存
+    size_t memoryBytes() const;
+
+private:
+    struct Container {
+        uint16_t key;                  // 元素的高16位
+        std::vector<uint16_t> values;  // 数组块：有序的低16位
+        std::vector<uint64_t> bits;    // 位集块：1024个字，非空时values不使用
+        size_t count;                  // 元素个数，两种块都维护
+
+        Container() : key(0), count(0) {}
+    };
+
+    // 数组块的最大元素个数，超过时改为位集（此时两者同为8KB）
+    static const size_t ARRAY_LIMIT = 4096;
+    static const size_t BITSET_WORDS = 1024;
+
+    static unsigned lowestBit(uint64_t bits);
+    static size_t popcount(uint64_t bits);
+
+    static void toBitset(Container& container);
+    static void toArray(Container& container);
+    // 按元素个数选择合适的存储方式
+    static void normalize(Container& container);
+
+    static Container intersect(const Container& a, const Container& b);
+    static Container unite(const Container& a, const Container& b);
+    static Container subtract(const Container& a, const Container& b);
+
+    // key所在块的下标，不存在时返回插入位置
+    size_t lowerBound(uint16_t key) const;
+
+    std::vector<Container> containers_;  // 按key升序
+};
+
+} // namespace resource
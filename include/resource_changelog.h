@@ -0,0 +1,115 @@
+#pragma once
+
+#include "resource_node.h"
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <memory>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <chrono>
+
+namespace resource {
+
+class ResourceRegistry;
+
+// 日志落盘策略
+enum class FsyncPolicy {
+    NEVER,     // 仅写入操作系统缓存，由系统决定何时落盘
+    PERIODIC,  // 最多每隔fsyncInterval执行一次fsync
+    ALWAYS     // 每次批量写入后立即fsync
+};
+
+struct ChangeLogOptions {
+    FsyncPolicy fsyncPolicy;
+    size_t batchBytes;                        // 缓冲区达到该大小时立即唤醒刷盘线程
+    std::chrono::milliseconds flushInterval;  // 刷盘线程的最长等待时间（组提交窗口）
+    std::chrono::milliseconds fsyncInterval;  // PERIODIC策略下两次fsync的最小间隔
+
+    ChangeLogOptions()
+        : fsyncPolicy(FsyncPolicy::PERIODIC),
+          batchBytes(64 * 1024),
+          flushInterval(5),
+          fsyncInterval(100) {}
+};
+
+// 日志记录类型
+enum class ChangeRecordType : uint8_t {
+    SET_ATTRIBUTE = 1,
+    REMOVE_ATTRIBUTE = 2,
+    REGISTER_NODE = 3,
+    REMOVE_NODE = 4,
+    COMMIT = 5
+};
+
+// 追加式变更日志（预写日志）
+// 记录格式: [u32 负载长度][u32 CRC32][负载]，负载以记录类型开头
+// 写入方只负责编码并追加到内存缓冲区，由后台线程批量写盘（组提交），
+// 恢复时先加载最近的快照，再调用replay重放之后的日志
+class ChangeLog {
+public:
+    explicit ChangeLog(const std::string& filePath, const ChangeLogOptions& options = ChangeLogOptions());
+    ~ChangeLog();
+
+    ChangeLog(const ChangeLog&) = delete;
+    ChangeLog& operator=(const ChangeLog&) = delete;
+
+    bool isOpen() const { return file_ != nullptr; }
+    const std::string& getFilePath() const { return filePath_; }
+
+    // 追加记录，返回记录序号（从1开始）；属性值类型不支持编码或日志已写盘失败时返回0
+    uint64_t logSetAttribute(const std::string& nodePath, const std::string& key, const AttributeValue& value);
+    uint64_t logRemoveAttribute(const std::string& nodePath, const std::string& key);
+    uint64_t logRegisterNode(const std::string& parentPath, const ResourceNode& node);
+    uint64_t logRemoveNode(const std::string& path);
+    uint64_t logCommit();
+
+    // 阻塞直到此前追加的所有记录都已写入并fsync；写盘失败时抛出std::runtime_error
+    // 失败后日志不再写入（之后追加的记录都被丢弃），须保存快照后换用新的日志文件
+    void sync();
+
+    // 刷盘线程记录的写盘错误，没有错误时为空
+    std::string writeError() const;
+
+    uint64_t lastSequence() const;
+    uint64_t durableSequence() const;
+
+    // 写入快照并截断日志，调用期间不应有其他线程追加记录
+    bool checkpoint(const ResourceRegistry& registry, const std::string& snapshotPath);
+
+    // 将日志重放到注册表上，返回成功应用的记录数；遇到残缺或校验失败的记录时停止
+    static size_t replay(const std::string& logPath, ResourceRegistry& registry);
+
+    // 快照读写，loadSnapshot会先清空注册表
+    static bool saveSnapshot(const ResourceRegistry& registry, const std::string& snapshotPath);
+    static bool loadSnapshot(const std::string& snapshotPath, ResourceRegistry& registry);
+
+private:
+    uint64_t append(const std::string& payload);
+    void flusherLoop();
+    bool syncFile();
+
+    std::string filePath_;
+    ChangeLogOptions options_;
+    FILE* file_;
+
+    mutable std::mutex mutex_;
+    std::condition_variable flushCond_;
+    std::condition_variable durableCond_;
+    std::string pending_;
+    std::string spare_;
+    uint64_t appendedSeq_;
+    uint64_t writtenSeq_;
+    uint64_t syncedSeq_;
+    bool syncRequested_;
+    bool stop_;
+    std::string writeError_;
+
+    std::mutex fileMutex_;
+    std::chrono::steady_clock::time_point lastFsync_;
+
+    std::thread flusher_;
+};
+
+} // namespace resource
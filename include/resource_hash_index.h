@@ -0,0 +1,362 @@
+#pragma once
+
+#include "resource_memory.h"
+#include "resource_string_pool.h"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+// 测试用的停顿点开关：打开后读者在登记纪元前、取得条目后各调用一次测试钩子，
+// 用来确定地构造读者被抢占的时间窗口；关闭时停顿点展开为空语句
+#ifndef RESOURCE_HASH_INDEX_TESTING
+#define RESOURCE_HASH_INDEX_TESTING 0
+#endif
+
+namespace resource {
+
+#if RESOURCE_HASH_INDEX_TESTING
+enum class HashIndexPoint {
+    BeforeEnter,  // 已读取纪元、尚未增加读者计数
+    AfterLookup   // 已取得条目、尚未复制值
+};
+
+inline std::function<void(HashIndexPoint)>& hashIndexTestHook() {
+    static std::function<void(HashIndexPoint)> hook;
+    return hook;
+}
+
+#define RESOURCE_HASH_INDEX_POINT(point)                                                   \
+    do {                                                                                   \
+        if (::resource::hashIndexTestHook()) {                                             \
+            ::resource::hashIndexTestHook()(::resource::HashIndexPoint::point);            \
+        }                                                                                  \
+    } while (0)
+#else
+#define RESOURCE_HASH_INDEX_POINT(point) ((void)0)
+#endif
+
+// 以字符串为键的开放寻址哈希表，供索引器的ID/名称索引使用
+// 键使用驻留字符串，与节点共享同一份名称/ID，不再复制；插入时直接取驻留字符串缓存的哈希值
+// 控制字节数组与条目指针数组分开存放：探测时先比较控制字节中保存的7位哈希指纹，
+// 一条缓存行可覆盖64个槽位，只有指纹相同时才读取条目比较完整的键
+//
+// 并发约定：任意多个线程可以无锁地并发调用find/contains/size，写操作（insertOrAssign/erase/clear）
+// 只允许单个线程执行。条目一经发布便不再修改，更新时整体替换；被替换或删除的条目和扩容前的
+// 旧表先放入回收列表，等所有可能看到它们的读者离开后再由写线程释放（因此有并发读者时，
+// 被删除条目中的值可能要到之后的写操作才析构）
+template<typename Value>
+class ConcurrentHashIndex {
+public:
+    ConcurrentHashIndex() : table_(new Table(MIN_CAPACITY)), size_(0), tombstones_(0), epoch_(0), waitingParity_(0) {}
+
+    ~ConcurrentHashIndex() {
+        Table* table = table_.load();
+        for (size_t i = 0; i < table->capacity; ++i) {
+            delete table->entries[i].load();
+        }
+        delete table;
+        reclaim(pending_);
+        reclaim(waiting_);
+    }
+
+    ConcurrentHashIndex(const ConcurrentHashIndex&) = delete;
+    ConcurrentHashIndex& operator=(const ConcurrentHashIndex&) = delete;
+
+    // 查找键并复制其值，可与写线程并发执行
+    bool find(const std::string& key, Value& out) const {
+        ReadGuard guard(*this);
+        const Entry* entry = lookup(key, hashOf(key));
+        if (!entry) {
+            return false;
+        }
+        RESOURCE_HASH_INDEX_POINT(AfterLookup);
+        out = entry->value;
+        return true;
+    }
+
+    bool contains(const std::string& key) const {
+        ReadGuard guard(*this);
+        return lookup(key, hashOf(key)) != nullptr;
+    }
+
+    size_t size() const { return size_.load(); }
+    bool empty() const { return size() == 0; }
+
+    // 以下为写操作，只能由单个线程调用
+
+    void insertOrAssign(const InternedString& key, Value value) {
+        const size_t hash = key.hash();
+        Table* table = table_.load();
+        size_t pos = hash >> 7 & table->mask();
+        size_t target = table->capacity;
+
+        for (size_t probe = 0; probe < table->capacity; ++probe, pos = (pos + 1) & table->mask()) {
+            const uint8_t control = table->controls[pos].load();
+            if (control == EMPTY) {
+                if (target == table->capacity) target = pos;
+                break;
+            }
+            if (control == DELETED) {
+                if (target == table->capacity) target = pos;
+                continue;
+            }
+            Entry* entry = table->entries[pos].load();
+            if (control == fingerprint(hash) && entry->hash == hash && entry->key == key) {
+                // 整体替换条目（复用已有条目的键），正在读取旧条目的读者不受影响
+                table->entries[pos].store(new Entry(hash, entry->key, std::move(value)));
+                retire(entry);
+                collect();
+                return;
+            }
+        }
+
+        if (table->controls[target].load() == DELETED) {
+            --tombstones_;
+        }
+        // 先发布条目再写控制字节，读者看到指纹时条目已经可见
+        table->entries[target].store(new Entry(hash, key, std::move(value)));
+        table->controls[target].store(fingerprint(hash));
+        ++size_;
+        if ((size_.load() + tombstones_) * 8 >= table->capacity * 7) {
+            rehash();
+        }
+        collect();
+    }
+
+    bool erase(const std::string& key) {
+        const size_t hash = hashOf(key);
+        Table* table = table_.load();
+        size_t pos = hash >> 7 & table->mask();
+        for (size_t probe = 0; probe < table->capacity; ++probe, pos = (pos + 1) & table->mask()) {
+            const uint8_t control = table->controls[pos].load();
+            if (control == EMPTY) {
+                return false;
+            }
+            Entry* entry = table->entries[pos].load();
+            if (control == fingerprint(hash) && entry->hash == hash && entry->key.str() == key) {
+                table->controls[pos].store(DELETED);
+                table->entries[pos].store(nullptr);
+                retire(entry);
+                --size_;
+                ++tombstones_;
+                collect();
+                return true;
+            }
+        }
+        return false;
+    }
+
+    void clear() {
+        Table* old = table_.load();
+        table_.store(new Table(MIN_CAPACITY));
+        for (size_t i = 0; i < old->capacity; ++i) {
+            if (Entry* entry = old->entries[i].load()) {
+                retire(entry);
+            }
+        }
+        retire(old);
+        size_ = 0;
+        tombstones_ = 0;
+        collect();
+    }
+
+    // 访问全部键值（写线程使用，与写操作不能并发）
+    void forEach(const std::function<void(const std::string& key, const Value& value)>& visitor) const {
+        const Table* table = table_.load();
+        for (size_t i = 0; i < table->capacity; ++i) {
+            if (const Entry* entry = table->entries[i].load()) {
+                visitor(entry->key.str(), entry->value);
+            }
+        }
+    }
+
+    // 估算占用的内存，valueBytes给出单个值持有的堆内存（写线程使用，与写操作不能并发）
+    template<typename ValueBytes>
+    size_t memoryUsage(ValueBytes valueBytes) const {
+        const Table* table = table_.load();
+        size_t bytes = sizeof(Table) + table->capacity * (sizeof(std::atomic<uint8_t>) + sizeof(std::atomic<Entry*>));
+        for (size_t i = 0; i < table->capacity; ++i) {
+            if (const Entry* entry = table->entries[i].load()) {
+                bytes += sizeof(Entry) + valueBytes(entry->value);
+            }
+        }
+        return bytes;
+    }
+
+private:
+    static const size_t MIN_CAPACITY = 16;
+    static const size_t READER_SLOTS = 64;
+    static const uint8_t EMPTY = 0x80;
+    static const uint8_t DELETED = 0xFE;
+
+    struct Entry {
+        size_t hash;
+        InternedString key;
+        Value value;
+
+        Entry(size_t h, const InternedString& k, Value v) : hash(h), key(k), value(std::move(v)) {}
+    };
+
+    struct Table {
+        size_t capacity;  // 2的幂
+        std::atomic<uint8_t>* controls;
+        std::atomic<Entry*>* entries;
+
+        explicit Table(size_t cap)
+            : capacity(cap), controls(new std::atomic<uint8_t>[cap]), entries(new std::atomic<Entry*>[cap]) {
+            for (size_t i = 0; i < cap; ++i) {
+                controls[i].store(EMPTY, std::memory_order_relaxed);
+                entries[i].store(nullptr, std::memory_order_relaxed);
+            }
+        }
+
+        ~Table() {
+            delete[] controls;
+            delete[] entries;
+        }
+
+        size_t mask() const { return capacity - 1; }
+    };
+
+    // 待回收的对象：条目或整张旧表
+    struct Retired {
+        Entry* entry;
+        Table* table;
+    };
+
+    // 读者计数按纪元奇偶分两组，每组计数独占一条缓存行，线程按固定槽位计数避免争用
+    struct ReaderSlot {
+        std::atomic<uint32_t> readers[2];
+        char padding[64 - 2 * sizeof(std::atomic<uint32_t>)];
+
+        ReaderSlot() {
+            readers[0].store(0, std::memory_order_relaxed);
+            readers[1].store(0, std::memory_order_relaxed);
+        }
+    };
+
+    // 读取纪元和增加计数之间写线程可能已经翻转纪元，此时计数落在旧的一组，之后的回收不会等待这个读者；
+    // 因此计数后重新读取纪元，奇偶变了就撤销计数重试
+    class ReadGuard {
+    public:
+        explicit ReadGuard(const ConcurrentHashIndex& index) : slot_(index.slots_[threadSlot()]), parity_(0) {
+            for (;;) {
+                parity_ = index.epoch_.load() & 1;
+                RESOURCE_HASH_INDEX_POINT(BeforeEnter);
+                slot_.readers[parity_].fetch_add(1);
+                if ((index.epoch_.load() & 1) == parity_) {
+                    break;
+                }
+                slot_.readers[parity_].fetch_sub(1);
+            }
+        }
+
+        ~ReadGuard() { slot_.readers[parity_].fetch_sub(1); }
+
+        ReadGuard(const ReadGuard&) = delete;
+        ReadGuard& operator=(const ReadGuard&) = delete;
+
+    private:
+        ReaderSlot& slot_;
+        unsigned parity_;
+    };
+
+    static size_t hashOf(const std::string& key) { return std::hash<std::string>()(key); }
+    static uint8_t fingerprint(size_t hash) { return static_cast<uint8_t>(hash & 0x7F); }
+
+    static size_t threadSlot() {
+        static std::atomic<size_t> nextSlot(0);
+        thread_local size_t slot = nextSlot.fetch_add(1) % READER_SLOTS;
+        return slot;
+    }
+
+    const Entry* lookup(const std::string& key, size_t hash) const {
+        const Table* table = table_.load();
+        const uint8_t expected = fingerprint(hash);
+        size_t pos = hash >> 7 & table->mask();
+        for (size_t probe = 0; probe < table->capacity; ++probe, pos = (pos + 1) & table->mask()) {
+            const uint8_t control = table->controls[pos].load();
+            if (control == EMPTY) {
+                return nullptr;
+            }
+            if (control == expected) {
+                // 槽位可能刚被删除或复用，比较完整的键
+                const Entry* entry = table->entries[pos].load();
+                if (entry && entry->hash == hash && entry->key.str() == key) {
+                    return entry;
+                }
+            }
+        }
+        return nullptr;
+    }
+
+    // 负载超过7/8时扩容（墓碑较多时按原容量重建），条目指针直接移入新表
+    void rehash() {
+        Table* old = table_.load();
+        size_t capacity = old->capacity;
+        while (size_.load() * 2 >= capacity) {
+            capacity *= 2;
+        }
+        Table* table = new Table(capacity);
+        for (size_t i = 0; i < old->capacity; ++i) {
+            Entry* entry = old->entries[i].load();
+            if (!entry) continue;
+            size_t pos = entry->hash >> 7 & table->mask();
+            while (table->controls[pos].load(std::memory_order_relaxed) != EMPTY) {
+                pos = (pos + 1) & table->mask();
+            }
+            table->entries[pos].store(entry, std::memory_order_relaxed);
+            table->controls[pos].store(fingerprint(entry->hash), std::memory_order_relaxed);
+        }
+        table_.store(table);
+        tombstones_ = 0;
+        retire(old);
+    }
+
+    void retire(Entry* entry) { pending_.push_back(Retired{entry, nullptr}); }
+    void retire(Table* table) { pending_.push_back(Retired{nullptr, table}); }
+
+    // 回收分两步：先翻转纪元，把此前的回收列表交给等待区；
+    // 等旧纪元的读者计数全部归零后，进入旧纪元的读者都已离开，等待区中的对象可以释放。
+    // 没有并发读者时翻转后立即释放；有读者时推迟到之后的写操作
+    void collect() {
+        for (;;) {
+            if (!waiting_.empty()) {
+                for (size_t i = 0; i < READER_SLOTS; ++i) {
+                    if (slots_[i].readers[waitingParity_].load() != 0) {
+                        return;
+                    }
+                }
+                reclaim(waiting_);
+            }
+            if (pending_.empty()) {
+                return;
+            }
+            waiting_.swap(pending_);
+            waitingParity_ = epoch_.fetch_add(1) & 1;
+        }
+    }
+
+    static void reclaim(std::vector<Retired>& retired) {
+        for (const auto& item : retired) {
+            delete item.entry;
+            delete item.table;
+        }
+        retired.clear();
+    }
+
+    std::atomic<Table*> table_;
+    std::atomic<size_t> size_;
+    size_t tombstones_;
+
+    mutable ReaderSlot slots_[READER_SLOTS];
+    std::atomic<unsigned> epoch_;
+    unsigned waitingParity_;
+    std::vector<Retired> pending_;
+    std::vector<Retired> waiting_;
+};
+
+} // namespace resource
@@ -0,0 +1,158 @@
+#pragma once
+
+#include "resource_registry.h"
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace resource {
+
+// 历史样本：tick为AttributeHistory收到的提交批次序号，timestamp为提交时的时间（默认为系统时间，微秒）
+struct HistorySample {
+    uint64_t tick;
+    int64_t timestamp;
+    double value;
+
+    HistorySample() : tick(0), timestamp(0), value(0.0) {}
+    HistorySample(uint64_t t, int64_t ts, double v) : tick(t), timestamp(ts), value(v) {}
+};
+
+// Gorilla方式压缩的样本块：块内第一个样本原样保存，之后tick和时间戳保存二阶差分，
+// 数值保存与前一个值的异或中有效的位。匀速推进的tick/时间戳每个样本只占1位，
+// 缓慢变化的坐标通常只占十几到二十几位
+class HistoryBlock {
+public:
+    HistoryBlock() { clear(); }
+
+    // 清空内容，保留已分配的空间供环形复用
+    void clear();
+    void append(const HistorySample& sample);
+
+    size_t size() const { return count_; }
+    bool empty() const { return count_ == 0; }
+    const HistorySample& first() const { return first_; }
+    const HistorySample& last() const { return last_; }
+
+    // 按顺序解码全部样本，追加满足filter的样本
+    void decode(std::vector<HistorySample>& out, const std::function<bool(const HistorySample&)>& filter) const;
+
+    size_t memoryBytes() const { return words_.capacity() * sizeof(uint64_t); }
+
+private:
+    void writeBits(uint64_t value, unsigned bits);
+    void writeDelta(int64_t deltaOfDelta);
+    void writeValue(uint64_t bits);
+
+    std::vector<uint64_t> words_;
+    size_t bitCount_;
+    size_t count_;
+    HistorySample first_;
+    HistorySample last_;
+    // 编码下一个样本所需的状态
+    int64_t tickDelta_;
+    int64_t timeDelta_;
+    unsigned leading_;
+    unsigned trailing_;
+};
+
+// 单个节点单个属性的历史：固定个数的压缩块组成的环，写满后整块淘汰最旧的样本
+// 至少保留最近capacity个样本，capacity为块大小的整数倍时最多多出一个块；内存上限由块数和每块的最坏大小决定
+class HistorySeries {
+public:
+    // 每块的最大样本数，capacity更小时以capacity为准
+    static const size_t BLOCK_SAMPLES = 64;
+
+    explicit HistorySeries(size_t capacity);
+
+    void append(const HistorySample& sample);
+
+    // 按tick或时间戳的闭区间读取，结果按时间顺序
+    void readTicks(uint64_t fromTick, uint64_t toTick, std::vector<HistorySample>& out) const;
+    void readTimes(int64_t fromTime, int64_t toTime, std::vector<HistorySample>& out) const;
+
+    size_t size() const;
+    const HistorySample* latest() const;
+    size_t memoryBytes() const;
+
+private:
+    void read(std::vector<HistorySample>& out,
+              const std::function<bool(const HistoryBlock&)>& overlaps,
+              const std::function<bool(const HistorySample&)>& filter) const;
+
+    size_t blockSamples_;
+    std::vector<HistoryBlock> blocks_;
+    size_t oldest_;  // 最旧的块
+    size_t used_;    // 已使用的块数，最新的块为(oldest_ + used_ - 1) % blocks_.size()
+};
+
+// 动态属性的历史记录：注册为注册表的变更监听器，被跟踪的数值属性每次提交变化时追加一个样本
+// 经纬度、高度等每个tick被updateAllDynamicObjects覆盖的属性，可以在这里查询最近一段时间的取值，
+// 不需要在库外再复制一遍
+// 样本只在值变化的提交中记录（值未变的tick没有样本，按区间读取时以前一个样本为准），每次提交每个属性最多一个样本；
+// 整数、浮点等数值类型按double保存，非数值的值忽略。节点移除时其历史一并删除
+// 历史按节点地址保存，延迟加载节点（见ResourceNode::setLoader）加载出的子树不记录：卸载这些子树不产生事件，
+// 记下的条目会残留，之后在同一地址分配的节点会继承它们。延迟加载节点自身的属性照常记录
+// 与索引器一样在写锁内更新，读取方持有注册表的ReadLock即可与提交并发查询
+class AttributeHistory : public ChangeListener {
+public:
+    explicit AttributeHistory(ResourceRegistry& registry);
+    ~AttributeHistory();
+
+    AttributeHistory(const AttributeHistory&) = delete;
+    AttributeHistory& operator=(const AttributeHistory&) = delete;
+
+    // 开始跟踪属性，每个节点至少保留最近capacity个样本；已跟踪时只修改容量（已有的历史被清空）
+    // 开始跟踪时记录各节点的当前值作为第一个样本；与索引器的createAttributeIndex一样须在写线程调用
+    void track(const std::string& attrName, size_t capacity);
+    void untrack(const std::string& attrName);
+    bool isTracked(const std::string& attrName) const { return tracked_.count(attrName) > 0; }
+
+    // 时间戳来源，默认为系统时间（微秒）
+    void setClock(const std::function<int64_t()>& clock) { clock_ = clock; }
+
+    // 最近一次提交的序号（开始跟踪也算作一次提交）
+    uint64_t currentTick() const { return tick_; }
+
+    // 按tick或时间戳的闭区间读取节点属性的历史
+    std::vector<HistorySample> history(const ResourceNode& node, const std::string& attrName,
+                                       uint64_t fromTick, uint64_t toTick) const;
+    std::vector<HistorySample> historyByTime(const ResourceNode& node, const std::string& attrName,
+                                             int64_t fromTime, int64_t toTime) const;
+    // 保留的全部样本
+    std::vector<HistorySample> history(const ResourceNode& node, const std::string& attrName) const;
+
+    // 压缩块、各节点的序列表等占用的内存
+    size_t memoryBytes() const;
+
+    void onChangesCommitted(const ChangeBatch& batch) override;
+
+private:
+    struct TrackedAttribute {
+        size_t slot;      // 在NodeHistory::series中的位置
+        size_t capacity;
+    };
+
+    // 单个节点所有被跟踪属性的历史，按跟踪属性的槽位存放
+    struct NodeHistory {
+        std::vector<std::unique_ptr<HistorySeries>> series;
+    };
+
+    const HistorySeries* findSeries(const ResourceNode& node, const std::string& attrName) const;
+    void record(const ResourceNode& node, const TrackedAttribute& attr, const AttributeValue& value,
+                int64_t timestamp);
+    // 节点子树中被跟踪属性的当前值
+    void recordSubtree(const ResourceNode& root, int64_t timestamp);
+    void forgetSubtree(const ResourceNode& root);
+
+    ResourceRegistry& registry_;
+    std::function<int64_t()> clock_;
+    uint64_t tick_;
+    std::unordered_map<std::string, TrackedAttribute> tracked_;
+    std::vector<size_t> freeSlots_;
+    std::unordered_map<const ResourceNode*, NodeHistory> nodes_;
+};
+
+} // namespace resource
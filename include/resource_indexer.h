@@ -1,6 +1,8 @@
 #pragma once
 
 #include "resource_registry.h"
+#include "resource_attribute_index.h"
+#include "resource_hash_index.h"
 #include <vector>
 #include <functional>
 #include <unordered_map>
@@ -12,283 +14,512 @@
 #include <type_traits>
 #include <sstream>
 #include <algorithm>
+#include <list>
+#include <mutex>
+#include <atomic>
+#include <cstdint>
+#include <stdexcept>
 
 namespace resource {
 
-class ResourceIndexer {
+// 分页查询的续查标记：初始为空表示从头查起，查询后指向下一页的起点，没有更多结果时重新变为空
+// 记录的是键和该键桶内已返回的节点数，两页之间修改了该键的节点时分页可能重复或遗漏
+template<typename T>
+struct PageToken {
+    bool empty;
+    T key;        // 下一页从这个键的桶开始
+    size_t skip;  // 跳过该桶中已返回的节点
+
+    PageToken() : empty(true), key(), skip(0) {}
+};
+
+// 查询缓存统计
+struct QueryCacheStats {
+    size_t hits;
+    size_t misses;
+    size_t invalidations;  // 因依赖的属性或树结构变化而失效的条目
+    size_t evictions;      // 超出容量被淘汰的条目
+    size_t entries;
+
+    QueryCacheStats() : hits(0), misses(0), invalidations(0), evictions(0), entries(0) {}
+};
+
+// 索引器注册为注册表的变更监听器：通过注册表的修改（setAttribute、commit、
+// updateAllDynamicObjects等）在提交时增量更新索引，直接修改节点仍需调用refreshIndex
+class ResourceIndexer : public ChangeListener {
 public:
     explicit ResourceIndexer(ResourceRegistry& registry);
     ~ResourceIndexer();
+
+    ResourceIndexer(const ResourceIndexer&) = delete;
+    ResourceIndexer& operator=(const ResourceIndexer&) = delete;
     
     // 原有的方法保持不变
-    std::vector<std::shared_ptr<ResourceNode>> findByName(const std::string& name);
-    std::vector<std::shared_ptr<ResourceNode>> findById(const std::string& id);
+    // 名称/ID查询走无锁哈希索引，可以在多个线程中与提交并发调用
+    std::vector<std::shared_ptr<ResourceNode>> findByName(const std::string& name) const;
+    std::vector<std::shared_ptr<ResourceNode>> findById(const std::string& id) const;
+    // 按ID取单个节点，不存在时返回nullptr
+    std::shared_ptr<ResourceNode> getById(const std::string& id) const;
     std::vector<std::shared_ptr<ResourceNode>> findByPredicate(
         const std::function<bool(const std::shared_ptr<ResourceNode>&)>& predicate);
     
     template<typename T>
     std::vector<std::shared_ptr<ResourceNode>> findByAttribute(const std::string& attrName, const T& value) {
+        // 缺少属性或类型不符的节点只是一次指针比较，不抛出异常
         return findByPredicate([&](const std::shared_ptr<ResourceNode>& node) -> bool {
-            if (!node->hasAttribute(attrName)) return false;
-            
-            try {
-                return node->getAttribute<T>(attrName) == value;
-            } catch (...) {
-                return false;
-            }
+            const T* attr = node->tryGetAttribute<T>(attrName);
+            return attr && *attr == value;
         });
     }
     
     std::vector<std::shared_ptr<ResourceNode>> findByMultiConditions(
         const std::vector<std::function<bool(const std::shared_ptr<ResourceNode>&)>>& conditions,
         bool matchAll = true);
+
+    // 可缓存的多条件查询：条件函数无法比较，由调用方给出标识查询的cacheKey和条件读取的属性，
+    // 这些属性和树结构都没有变化时直接返回上次的结果
+    std::vector<std::shared_ptr<ResourceNode>> findByMultiConditions(
+        const std::vector<std::function<bool(const std::shared_ptr<ResourceNode>&)>>& conditions,
+        bool matchAll, const std::string& cacheKey, const std::vector<std::string>& attributes);
+
+    // === 查询缓存 ===
+    // 索引查询（findByAttributeIndexed/findGreaterThan/findLessThan/findInRange）的结果按规范化的查询
+    // 缓存在LRU中，每个条目记录所依赖属性当时的版本号；提交时被修改的属性版本号加一，
+    // 条目在下次命中时发现版本不一致即失效。节点增删会清空整个缓存，避免缓存持有已删除的节点
+    // 与索引一样，绕过注册表直接修改节点后需要调用refreshIndex（同时清空缓存）
+    // 缓存有自己的互斥量，持有ReadLock的多个查询线程可以同时查找和写入缓存；统计为原子计数，随时可读
+
+    // 设置缓存容量（条目数），为0时关闭缓存
+    void setQueryCacheCapacity(size_t capacity);
+    size_t getQueryCacheCapacity() const { return queryCacheCapacity_.load(std::memory_order_relaxed); }
+    void clearQueryCache();
+    QueryCacheStats getQueryCacheStats() const;
     
-    // 原有的索引维护
+    // 估算ID/名称索引、属性索引、分组聚合和查询缓存占用的内存（计入indexes）
+    // byIndex非空时分开给出，键为"id"、"name"、属性名、"group:分组属性/数值属性"、"query_cache"和"bitmap_rows"
+    MemoryUsage memoryUsage(std::map<std::string, size_t>* byIndex = nullptr) const;
+
+    // 原有的索引维护：先提交注册表中尚未提交的变更（投递给其他监听器和订阅者，避免事件无限堆积），
+    // 再按树的当前内容重建全部索引；内部获取写锁，调用方不能持有注册表的锁
     void refreshIndex();
+
+    // 提交时的增量维护：收集受影响的节点，按索引键排序后每个桶只查找一次
+    void onChangesCommitted(const ChangeBatch& batch) override;
     
-    // === 属性索引功能，现在使用有序索引 ===
+    // === 属性索引功能 ===
+    // 每个索引是一个TypedAttributeIndex<T>，键按T原生比较（64位整数、枚举、自定义类型不经过double转换），
+    // 只收录属性值类型恰好为T的节点。refreshIndex通过索引自身的rebuild重建，与类型无关
+    // 同一属性和类型只有一个索引，种类在创建时选择
+    // 查询可能在持有读锁的多个线程中并发执行，不会创建索引：属性没有T类型的索引时，该次查询按树的当前内容
+    // 临时构建有序索引（结果与有序索引相同，但每次都要扫描整棵树），需要反复查询的属性应预先创建索引
     
-    // 为特定属性创建索引
+    // 为特定属性创建索引，已存在时按新的种类重新构建
+    // 创建和删除索引是写操作，与提交一样不能和查询并发
+    // 只做等值查询的高基数属性（ID、序列号等）适合IndexKind::Hash，建立和查找都比有序索引快；
+    // 取值很少的分类属性适合IndexKind::Bitmap，见下面的位图集合运算
     template<typename T>
-    void createAttributeIndex(const std::string& attrName) {
-        // 生成属性索引键
-        std::string indexKey = getAttributeIndexKey(attrName, typeid(T));
-        
-        // 创建或清空索引
-        attributeIndices_[indexKey].clear();
-        
-        // 遍历所有节点，构建索引
-        registry_.traverseNodes([&](std::shared_ptr<ResourceNode> node) {
-            if (node->hasAttribute(attrName)) {
-                try {
-                    T value = node->getAttribute<T>(attrName);
-                    
-                    // 使用模板特化将T类型转换为索引键类型
-                    IndexKey indexValue = convertToIndexKey<T>(value);
-                    attributeIndices_[indexKey][indexValue].push_back(node);
-                } catch (...) {
-                    // 忽略类型不匹配的属性
-                }
-            }
-        });
-        
-        // 记录已创建的索引
-        indexedAttributes_.insert(indexKey);
+    void createAttributeIndex(const std::string& attrName, IndexKind kind = IndexKind::Ordered) {
+        std::unique_ptr<TypedAttributeIndex<T>> index = makeAttributeIndex<T>(attrName, kind, bitmapRows_);
+        index->rebuild(registry_);
+        attributeIndices_[getAttributeIndexKey(attrName, typeid(T))].reset(index.release());
+        updateCoverage(attrName);
+    }
+
+    // 属性索引的种类，没有索引时返回false
+    template<typename T>
+    bool getAttributeIndexKind(const std::string& attrName, IndexKind& kind) const {
+        auto it = attributeIndices_.find(getAttributeIndexKey(attrName, typeid(T)));
+        if (it == attributeIndices_.end()) {
+            return false;
+        }
+        kind = it->second->kind();
+        return true;
     }
     
     // 使用索引查询属性
     template<typename T>
     std::vector<std::shared_ptr<ResourceNode>> findByAttributeIndexed(const std::string& attrName, const T& value) {
-        // 生成属性索引键
-        std::string indexKey = getAttributeIndexKey(attrName, typeid(T));
-        
-        // 检查是否有此属性的索引
-        if (indexedAttributes_.count(indexKey) == 0) {
-            // 没有索引，创建索引
-            createAttributeIndex<T>(attrName);
+        RESOURCE_METRIC_SCOPE(registry_.getMetrics(), FindByAttributeIndexed);
+        std::unique_ptr<TypedAttributeIndex<T>> scan;
+        const TypedAttributeIndex<T>& index = queryIndex<T>(attrName, scan);
+
+        // 相同的查询在属性未变化时直接返回缓存的结果
+        std::vector<std::shared_ptr<ResourceNode>> results;
+        std::string cacheKey = makeQueryKey("eq", attrName, value);
+        if (findCachedResult(cacheKey, results)) {
+            return results;
         }
         
-        // 转换值为索引键
-        IndexKey indexValue = convertToIndexKey<T>(value);
-        
         // 查找索引
-        auto& indexMap = attributeIndices_[indexKey];
-        auto it = indexMap.find(indexValue);
-        if (it != indexMap.end()) {
-            return it->second;
-        }
+        index.findEqual(value, results);
         
-        return std::vector<std::shared_ptr<ResourceNode>>();
+        storeCachedResult(cacheKey, std::vector<std::string>(1, attrName), results);
+        return results;
     }
     
     // 大于查询
     template<typename T>
-    typename std::enable_if<std::is_arithmetic<T>::value, std::vector<std::shared_ptr<ResourceNode>>>::type
-    findGreaterThan(const std::string& attrName, const T& value) {
-        // 生成属性索引键
-        std::string indexKey = getAttributeIndexKey(attrName, typeid(T));
-        
-        // 检查是否有此属性的索引
-        if (indexedAttributes_.count(indexKey) == 0) {
-            // 没有索引，创建索引
-            createAttributeIndex<T>(attrName);
-        }
-        
-        // 转换值为索引键
-        IndexKey indexValue = convertToIndexKey<T>(value);
+    std::vector<std::shared_ptr<ResourceNode>> findGreaterThan(const std::string& attrName, const T& value) {
+        RESOURCE_METRIC_SCOPE(registry_.getMetrics(), FindGreaterThan);
+        std::unique_ptr<TypedAttributeIndex<T>> scan;
+        const auto& indexMap = queryOrderedIndex<T>(attrName, scan).buckets();
         
         std::vector<std::shared_ptr<ResourceNode>> results;
-        auto& indexMap = attributeIndices_[indexKey];
-        
-        // 找到第一个大于value的位置
-        auto it = indexMap.upper_bound(indexValue);
+        std::string cacheKey = makeQueryKey("gt", attrName, value);
+        if (findCachedResult(cacheKey, results)) {
+            return results;
+        }
         
         // 收集所有大于value的节点
-        while (it != indexMap.end()) {
+        for (auto it = indexMap.upper_bound(value); it != indexMap.end(); ++it) {
             results.insert(results.end(), it->second.begin(), it->second.end());
-            ++it;
         }
         
+        storeCachedResult(cacheKey, std::vector<std::string>(1, attrName), results);
         return results;
     }
     
     // 小于查询
     template<typename T>
-    typename std::enable_if<std::is_arithmetic<T>::value, std::vector<std::shared_ptr<ResourceNode>>>::type
-    findLessThan(const std::string& attrName, const T& value) {
-        // 生成属性索引键
-        std::string indexKey = getAttributeIndexKey(attrName, typeid(T));
-        
-        // 检查是否有此属性的索引
-        if (indexedAttributes_.count(indexKey) == 0) {
-            // 没有索引，创建索引
-            createAttributeIndex<T>(attrName);
-        }
-        
-        // 转换值为索引键
-        IndexKey indexValue = convertToIndexKey<T>(value);
+    std::vector<std::shared_ptr<ResourceNode>> findLessThan(const std::string& attrName, const T& value) {
+        RESOURCE_METRIC_SCOPE(registry_.getMetrics(), FindLessThan);
+        std::unique_ptr<TypedAttributeIndex<T>> scan;
+        const auto& indexMap = queryOrderedIndex<T>(attrName, scan).buckets();
         
         std::vector<std::shared_ptr<ResourceNode>> results;
-        auto& indexMap = attributeIndices_[indexKey];
+        std::string cacheKey = makeQueryKey("lt", attrName, value);
+        if (findCachedResult(cacheKey, results)) {
+            return results;
+        }
         
         // 收集所有小于value的节点
-        for (auto it = indexMap.begin(); it != indexMap.end() && it->first < indexValue; ++it) {
+        for (auto it = indexMap.begin(); it != indexMap.end() && it->first < value; ++it) {
             results.insert(results.end(), it->second.begin(), it->second.end());
         }
         
+        storeCachedResult(cacheKey, std::vector<std::string>(1, attrName), results);
         return results;
     }
     
     // 范围查询
     template<typename T>
-    typename std::enable_if<std::is_arithmetic<T>::value, std::vector<std::shared_ptr<ResourceNode>>>::type
-    findInRange(const std::string& attrName, const T& minValue, const T& maxValue) {
-        // 生成属性索引键
-        std::string indexKey = getAttributeIndexKey(attrName, typeid(T));
-        
-        // 检查是否有此属性的索引
-        if (indexedAttributes_.count(indexKey) == 0) {
-            // 没有索引，创建索引
-            createAttributeIndex<T>(attrName);
-        }
-        
-        // 转换值为索引键
-        IndexKey minIndexValue = convertToIndexKey<T>(minValue);
-        IndexKey maxIndexValue = convertToIndexKey<T>(maxValue);
+    std::vector<std::shared_ptr<ResourceNode>> findInRange(const std::string& attrName, const T& minValue,
+                                                           const T& maxValue) {
+        RESOURCE_METRIC_SCOPE(registry_.getMetrics(), FindInRange);
+        std::unique_ptr<TypedAttributeIndex<T>> scan;
+        const auto& indexMap = queryOrderedIndex<T>(attrName, scan).buckets();
         
         std::vector<std::shared_ptr<ResourceNode>> results;
-        auto& indexMap = attributeIndices_[indexKey];
-        
-        // 找到第一个大于等于minValue的位置
-        auto it = indexMap.lower_bound(minIndexValue);
+        std::string cacheKey = makeQueryKey("range", attrName, minValue, &maxValue);
+        if (findCachedResult(cacheKey, results)) {
+            return results;
+        }
         
         // 收集所有在[minValue, maxValue]范围内的节点
-        while (it != indexMap.end() && it->first <= maxIndexValue) {
+        for (auto it = indexMap.lower_bound(minValue); it != indexMap.end() && !(maxValue < it->first); ++it) {
             results.insert(results.end(), it->second.begin(), it->second.end());
-            ++it;
         }
         
+        storeCachedResult(cacheKey, std::vector<std::string>(1, attrName), results);
         return results;
     }
     
+    // === 位图集合运算 ===
+    // 位图索引的各个取值对应节点行号的位图，所有位图索引共用同一套行号，
+    // 多个分类属性的组合条件可以先用&、|、-（AND NOT）在位图上算出结果，再用nodesOf换回节点：
+    //   indexer.nodesOf(indexer.bitmapOf<std::string>("燃料", "柴油") & indexer.bitmapOf<bool>("已部署", true))
+    // 行号和返回的位图引用只在下一次提交或refreshIndex之前有效
+
+    // 属性取值为value的节点行号，属性须先用createAttributeIndex建立位图索引，没有或为其他种类时抛出std::logic_error
+    template<typename T>
+    const RoaringBitmap& bitmapOf(const std::string& attrName, const T& value) {
+        return bitmapIndex<T>(attrName).bitmapOf(value);
+    }
+
+    // 属性取values中任一值的节点行号
+    template<typename T>
+    RoaringBitmap bitmapOfAny(const std::string& attrName, const std::vector<T>& values) {
+        const BitmapAttributeIndex<T>& index = bitmapIndex<T>(attrName);
+        RoaringBitmap rows;
+        for (const auto& value : values) {
+            rows |= index.bitmapOf(value);
+        }
+        return rows;
+    }
+
+    // 属性有值（属于位图索引中任一取值）的节点行号，用作取反时的全集
+    template<typename T>
+    RoaringBitmap bitmapOfAll(const std::string& attrName) {
+        RoaringBitmap rows;
+        for (const auto& bitmap : bitmapIndex<T>(attrName).bitmaps()) {
+            rows |= bitmap.second;
+        }
+        return rows;
+    }
+
+    // 把行号位图换回节点，按行号升序
+    std::vector<std::shared_ptr<ResourceNode>> nodesOf(const RoaringBitmap& rows) const;
+
+    // === 聚合查询 ===
+
+    // 数值属性的计数/总和/最值/均值，subtreePath为空时统计整个注册表
+    // 整个注册表且属性的数值索引收录了全部数值（属性的每种数值类型都有索引）时，合并各索引维护的总和与
+    // 有序桶的两端，为O(1)；否则扫描（子树内的）全部节点。两种方式的结果相同
+    AggregateResult aggregate(const std::string& attrName, const std::string& subtreePath = std::string());
+
+    // 按字符串或布尔属性分组聚合数值属性（布尔分组键为"true"/"false"）
+    // 已创建对应的分组聚合时直接返回维护的结果；分组属性的字符串和布尔值都有索引收录时只访问这些索引中的节点
+    std::map<std::string, AggregateResult> aggregateBy(const std::string& groupAttr, const std::string& valueAttr,
+                                                       const std::string& subtreePath = std::string());
+
+    // 增量维护的分组聚合：每次提交只更新受影响节点所在的分组
+    void createGroupAggregate(const std::string& groupAttr, const std::string& valueAttr);
+    void removeGroupAggregate(const std::string& groupAttr, const std::string& valueAttr);
+    bool hasGroupAggregate(const std::string& groupAttr, const std::string& valueAttr) const {
+        return groupAggregates_.count(std::make_pair(groupAttr, valueAttr)) > 0;
+    }
+
+    // 按属性值排序的前k个节点（默认取最大的k个），从有序索引的一端读取，不物化全部结果
+    template<typename T>
+    std::vector<std::shared_ptr<ResourceNode>> findTopK(const std::string& attrName, size_t k, bool ascending = false) {
+        RESOURCE_METRIC_SCOPE(registry_.getMetrics(), FindTopK);
+        std::unique_ptr<TypedAttributeIndex<T>> scan;
+        const auto& index = queryOrderedIndex<T>(attrName, scan);
+        const auto& indexMap = index.buckets();
+
+        std::vector<std::shared_ptr<ResourceNode>> results;
+        results.reserve(std::min(k, index.nodeCount()));
+        if (ascending) {
+            for (auto it = indexMap.begin(); it != indexMap.end() && results.size() < k; ++it) {
+                appendUpTo(results, it->second, 0, k);
+            }
+        } else {
+            for (auto it = indexMap.rbegin(); it != indexMap.rend() && results.size() < k; ++it) {
+                appendUpTo(results, it->second, 0, k);
+            }
+        }
+        return results;
+    }
+
+    // 分页的范围查询：按键升序返回[minValue, maxValue]内最多limit个节点，token用于续查下一页
+    // limit须大于0，否则抛出std::invalid_argument（空页无法推进token）
+    template<typename T>
+    std::vector<std::shared_ptr<ResourceNode>> findInRange(const std::string& attrName, const T& minValue,
+                                                           const T& maxValue, size_t limit, PageToken<T>& token) {
+        RESOURCE_METRIC_SCOPE(registry_.getMetrics(), FindInRange);
+        if (limit == 0) {
+            throw std::invalid_argument("Page limit must be greater than zero");
+        }
+        std::unique_ptr<TypedAttributeIndex<T>> scan;
+        const auto& index = queryOrderedIndex<T>(attrName, scan);
+        const auto& indexMap = index.buckets();
+
+        auto it = indexMap.lower_bound(token.empty ? minValue : token.key);
+        size_t skip = 0;
+        if (!token.empty && it != indexMap.end() && !(token.key < it->first)) {
+            skip = token.skip;
+        }
+
+        std::vector<std::shared_ptr<ResourceNode>> results;
+        results.reserve(std::min(limit, index.nodeCount()));
+        token = PageToken<T>();
+        for (; it != indexMap.end() && !(maxValue < it->first); ++it, skip = 0) {
+            if (results.size() == limit) {
+                token.empty = false;
+                token.key = it->first;
+                token.skip = skip;
+                break;
+            }
+            size_t taken = appendUpTo(results, it->second, skip, limit);
+            if (skip + taken < it->second.size()) {
+                // 页在桶中间结束
+                token.empty = false;
+                token.key = it->first;
+                token.skip = skip + taken;
+                break;
+            }
+        }
+        return results;
+    }
+
     // 检查属性索引是否存在
     template<typename T>
     bool hasAttributeIndex(const std::string& attrName) {
-        std::string indexKey = getAttributeIndexKey(attrName, typeid(T));
-        return indexedAttributes_.count(indexKey) > 0;
+        return attributeIndices_.count(getAttributeIndexKey(attrName, typeid(T))) > 0;
     }
     
     // 删除属性索引
     template<typename T>
     void removeAttributeIndex(const std::string& attrName) {
-        std::string indexKey = getAttributeIndexKey(attrName, typeid(T));
-        attributeIndices_.erase(indexKey);
-        indexedAttributes_.erase(indexKey);
+        attributeIndices_.erase(getAttributeIndexKey(attrName, typeid(T)));
+        updateCoverage(attrName);
     }
     
 private:
     ResourceRegistry& registry_;
     
-    // 基本索引
-    std::unordered_map<std::string, std::vector<std::shared_ptr<ResourceNode>>> nameIndex_;
-    std::unordered_map<std::string, std::shared_ptr<ResourceNode>> idIndex_;
+    // 基本索引，只在提交线程中写入
+    ConcurrentHashIndex<std::vector<std::shared_ptr<ResourceNode>>> nameIndex_;
+    ConcurrentHashIndex<std::shared_ptr<ResourceNode>> idIndex_;
     
-    // 自定义索引键类型，支持排序
-    class IndexKey {
-    public:
-        enum class Type { STRING, DOUBLE, BOOL };
-        
-        // 构造函数
-        explicit IndexKey(const std::string& s) : type_(Type::STRING), stringValue_(s), doubleValue_(0.0), boolValue_(false) {}
-        explicit IndexKey(double d) : type_(Type::DOUBLE), stringValue_(""), doubleValue_(d), boolValue_(false) {}
-        explicit IndexKey(bool b) : type_(Type::BOOL), stringValue_(""), doubleValue_(0.0), boolValue_(b) {}
-        
-        // 比较运算符
-        bool operator<(const IndexKey& other) const {
-            if (type_ != other.type_) {
-                return static_cast<int>(type_) < static_cast<int>(other.type_);
-            }
-            
-            switch (type_) {
-                case Type::STRING: return stringValue_ < other.stringValue_;
-                case Type::DOUBLE: return doubleValue_ < other.doubleValue_;
-                case Type::BOOL: return !boolValue_ && other.boolValue_; // false < true
-                default: return false;
-            }
+    // 增量维护的分组聚合，最值由每组的有序值计数得出
+    struct GroupAggregate {
+        struct Group {
+            size_t count;
+            double sum;
+            std::map<double, size_t> values;
+
+            Group() : count(0), sum(0.0) {}
+        };
+
+        std::map<std::string, Group> groups;
+        // 节点当前计入的分组和值
+        std::unordered_map<const ResourceNode*, std::pair<std::string, double>> entries;
+
+        void add(const ResourceNode* node, const std::string& group, double value);
+        void remove(const ResourceNode* node);
+    };
+
+    // 位图索引共用的节点行号
+    std::shared_ptr<NodeRowTable> bitmapRows_;
+    // 属性索引: attribute_type:attribute_name -> index
+    std::unordered_map<std::string, std::unique_ptr<AttributeIndexBase>> attributeIndices_;
+
+    // 查询缓存：最近使用的条目在前
+    struct CachedQuery {
+        std::string key;
+        std::vector<std::shared_ptr<ResourceNode>> results;
+        // 依赖的属性版本号及缓存时的值
+        std::vector<std::pair<const uint64_t*, uint64_t>> versions;
+    };
+
+    struct QueryCacheCounters {
+        std::atomic<size_t> hits;
+        std::atomic<size_t> misses;
+        std::atomic<size_t> invalidations;
+        std::atomic<size_t> evictions;
+        std::atomic<size_t> entries;
+
+        QueryCacheCounters() : hits(0), misses(0), invalidations(0), evictions(0), entries(0) {}
+    };
+
+    // 保护下面的LRU链表、查找表和版本号表；版本号只在持有写锁的提交中递增
+    mutable std::mutex queryCacheMutex_;
+    std::atomic<size_t> queryCacheCapacity_;
+    std::list<CachedQuery> queryCache_;
+    std::unordered_map<std::string, std::list<CachedQuery>::iterator> queryCacheIndex_;
+    // 属性名 -> 版本号，只增不删，缓存条目保存指向其中元素的指针
+    std::unordered_map<std::string, uint64_t> attributeVersions_;
+    QueryCacheCounters queryCacheStats_;
+
+    // 键类型没有IndexKeyFormat时返回空串，该查询不缓存
+    template<typename T>
+    std::string makeQueryKey(const char* kind, const std::string& attrName, const T& first,
+                             const T* second = nullptr) {
+        std::string key(kind);
+        key += '\x1f';
+        key += getAttributeIndexKey(attrName, typeid(T));
+        key += '\x1f';
+        if (!IndexKeyFormat<T>::append(key, first)) {
+            return std::string();
         }
-        
-        bool operator==(const IndexKey& other) const {
-            if (type_ != other.type_) return false;
-            
-            switch (type_) {
-                case Type::STRING: return stringValue_ == other.stringValue_;
-                case Type::DOUBLE: return doubleValue_ == other.doubleValue_;
-                case Type::BOOL: return boolValue_ == other.boolValue_;
-                default: return false;
-            }
+        if (second) {
+            key += '\x1f';
+            IndexKeyFormat<T>::append(key, *second);
         }
+        return key;
+    }
 
-        bool operator<=(const IndexKey& other) const {
-            return *this < other || *this == other;
-        }
-        
-    private:
-        Type type_;
-        std::string stringValue_;
-        double doubleValue_;
-        bool boolValue_;
-    };
-    
-    // 属性索引: attribute_type:attribute_name -> value -> nodes
-    // 使用有序映射来支持范围查询
-    std::unordered_map<std::string, std::map<IndexKey, std::vector<std::shared_ptr<ResourceNode>>>> attributeIndices_;
-    std::unordered_set<std::string> indexedAttributes_;
+    // 查找的实际实现，不记录指标，供已记录指标的公开查找调用，避免同一次调用被记两次
+    std::vector<std::shared_ptr<ResourceNode>> collectMatching(
+        const std::function<bool(const std::shared_ptr<ResourceNode>&)>& predicate);
+    std::vector<std::shared_ptr<ResourceNode>> matchConditions(
+        const std::vector<std::function<bool(const std::shared_ptr<ResourceNode>&)>>& conditions, bool matchAll);
+
+    // 查找和写入缓存时自行加缓存锁；clearQueryCacheLocked要求调用方已持有缓存锁
+    bool findCachedResult(const std::string& key, std::vector<std::shared_ptr<ResourceNode>>& results);
+    void storeCachedResult(const std::string& key, const std::vector<std::string>& attributes,
+                           const std::vector<std::shared_ptr<ResourceNode>>& results);
+    void clearQueryCacheLocked();
+
+    // 分组聚合: (分组属性, 数值属性) -> 聚合
+    std::map<std::pair<std::string, std::string>, GroupAggregate> groupAggregates_;
+
+    // 索引收录了扫描时会读到的全部节点的属性，aggregate/aggregateBy只有对这些属性才改用索引：
+    // numericCovered_中的属性，每个数值都有同类型的数值索引；groupCovered_中的属性，每个字符串/布尔值都有同类型的索引
+    // 创建、删除索引和refreshIndex时扫描重新计算；提交中出现未收录的值时移除，直到下次重新计算
+    std::unordered_set<std::string> numericCovered_;
+    std::unordered_set<std::string> groupCovered_;
+
+    void updateCoverage(const std::string& attrName);
+    // value是否被attrName上的索引按扫描的口径收录
+    bool numericIndexed(const std::string& attrName, const AttributeValue& value) const;
+    bool groupIndexed(const std::string& attrName, const AttributeValue& value) const;
     
     void buildIndices();
-    void rebuildAttributeIndex(const std::string& typeName, const std::string& attrName);
-    
-    // 获取属性索引键
-    std::string getAttributeIndexKey(const std::string& attrName, const std::type_info& type) {
-        return std::string(type.name()) + ":" + attrName;
+    // 重建全部索引，不提交变更
+    void rebuildAll();
+
+    // 查询使用的属性索引，只读取索引表；没有T类型的索引时临时构建有序索引交给scan持有，查询结束即丢弃
+    template<typename T>
+    const TypedAttributeIndex<T>& queryIndex(const std::string& attrName,
+                                             std::unique_ptr<TypedAttributeIndex<T>>& scan) const {
+        auto it = attributeIndices_.find(getAttributeIndexKey(attrName, typeid(T)));
+        if (it != attributeIndices_.end()) {
+            RESOURCE_METRIC_INDEX_HIT(registry_.getMetrics());
+            // 索引键包含类型名，取到的一定是T类型的索引
+            return static_cast<const TypedAttributeIndex<T>&>(*it->second);
+        }
+        RESOURCE_METRIC_INDEX_SCAN(registry_.getMetrics());
+        scan = makeAttributeIndex<T>(attrName, IndexKind::Ordered, bitmapRows_);
+        scan->rebuild(registry_);
+        return *scan;
     }
-    
-    // 将各种类型转换为IndexKey
+
+    // 范围、前k个和分页查询需要有序索引，属性已建立其他种类的索引时抛出std::logic_error
     template<typename T>
-    typename std::enable_if<std::is_same<T, std::string>::value, IndexKey>::type
-    convertToIndexKey(const T& value) {
-        return IndexKey(value);
+    const OrderedAttributeIndex<T>& queryOrderedIndex(const std::string& attrName,
+                                                      std::unique_ptr<TypedAttributeIndex<T>>& scan) const {
+        const TypedAttributeIndex<T>& index = queryIndex<T>(attrName, scan);
+        if (index.kind() != IndexKind::Ordered) {
+            throw std::logic_error("Attribute index on " + attrName + " does not support ordered queries");
+        }
+        return static_cast<const OrderedAttributeIndex<T>&>(index);
     }
-    
+
+    // 位图查询返回索引内位图的引用，不能临时构建，没有位图索引时抛出std::logic_error
     template<typename T>
-    typename std::enable_if<std::is_arithmetic<T>::value && !std::is_same<T, bool>::value, IndexKey>::type
-    convertToIndexKey(const T& value) {
-        return IndexKey(static_cast<double>(value));
+    const BitmapAttributeIndex<T>& bitmapIndex(const std::string& attrName) const {
+        auto it = attributeIndices_.find(getAttributeIndexKey(attrName, typeid(T)));
+        if (it == attributeIndices_.end()) {
+            throw std::logic_error("No bitmap index on " + attrName);
+        }
+        RESOURCE_METRIC_INDEX_HIT(registry_.getMetrics());
+        if (it->second->kind() != IndexKind::Bitmap) {
+            throw std::logic_error("Attribute index on " + attrName + " is not a bitmap index");
+        }
+        return static_cast<const BitmapAttributeIndex<T>&>(*it->second);
     }
+
+    // 从bucket的第skip个节点起追加，直到results达到limit个，返回追加的数量
+    static size_t appendUpTo(std::vector<std::shared_ptr<ResourceNode>>& results,
+                             const std::vector<std::shared_ptr<ResourceNode>>& bucket, size_t skip, size_t limit) {
+        if (skip >= bucket.size() || results.size() >= limit) {
+            return 0;
+        }
+        size_t count = std::min(bucket.size() - skip, limit - results.size());
+        results.insert(results.end(), bucket.begin() + skip, bucket.begin() + skip + count);
+        return count;
+    }
+
+    void rebuildGroupAggregate(const std::string& groupAttr, const std::string& valueAttr, GroupAggregate& aggregate);
+
+    // 依次访问subtreePath下的全部节点（为空时访问整个注册表），路径不存在时不访问任何节点
+    void forEachNodeIn(const std::string& subtreePath, const std::function<void(const ResourceNode&)>& visitor);
     
-    template<typename T>
-    typename std::enable_if<std::is_same<T, bool>::value, IndexKey>::type
-    convertToIndexKey(const T& value) {
-        return IndexKey(value);
+    // 获取属性索引键
+    static std::string getAttributeIndexKey(const std::string& attrName, const std::type_info& type) {
+        return std::string(type.name()) + ":" + attrName;
     }
 };
 
@@ -0,0 +1,130 @@
+#pragma once
+
+#include "resource_node.h"
+#include <istream>
+#include <ostream>
+#include <string>
+#include <vector>
+#include <memory>
+#include <unordered_map>
+
+namespace resource {
+
+class ResourceRegistry;
+
+// SAX风格的JSON事件接口，回调返回false时终止解析
+class JsonSaxHandler {
+public:
+    virtual ~JsonSaxHandler() {}
+    virtual bool onNull() = 0;
+    virtual bool onBool(bool value) = 0;
+    virtual bool onInteger(long long value) = 0;
+    virtual bool onDouble(double value) = 0;
+    virtual bool onString(const std::string& value) = 0;
+    virtual bool onKey(const std::string& key) = 0;
+    virtual bool onStartObject() = 0;
+    virtual bool onEndObject() = 0;
+    virtual bool onStartArray() = 0;
+    virtual bool onEndArray() = 0;
+};
+
+// 流式JSON解析器：按块读取输入，使用显式状态栈，不构建DOM
+class JsonSaxParser {
+public:
+    explicit JsonSaxParser(size_t bufferSize = 64 * 1024);
+
+    bool parse(std::istream& in, JsonSaxHandler& handler);
+    bool parse(const char* data, size_t size, JsonSaxHandler& handler);
+
+    const std::string& getError() const { return error_; }
+
+private:
+    bool run(JsonSaxHandler& handler);
+    bool refill();
+    int peekChar();
+    int nextChar();
+    void skipWhitespace();
+    bool parseString(std::string& out);
+    bool parseUnicodeEscape(std::string& out);
+    bool parseNumber(JsonSaxHandler& handler);
+    bool parseLiteral(const char* literal);
+    bool fail(const std::string& message);
+
+    std::vector<char> buffer_;
+    std::istream* in_;
+    const char* base_;     // 当前缓冲区起始位置
+    const char* cur_;
+    const char* end_;
+    size_t consumed_;      // 已丢弃缓冲区的累计字节数
+    std::string token_;
+    std::string error_;
+};
+
+// 导入时属性的目标类型
+enum class JsonAttributeType {
+    AUTO,    // 整数 -> int（超出范围时为long long），小数 -> double
+    INT,
+    INT64,
+    DOUBLE,
+    FLOAT,
+    BOOL,
+    STRING
+};
+
+struct JsonImportOptions {
+    // 按属性名指定目标类型，未指定的属性按AUTO处理
+    std::unordered_map<std::string, JsonAttributeType> attributeTypes;
+};
+
+// JSON -> ResourceNode树
+// 节点格式: {"name": "...", "id": "...", "attributes": {...}, "children": [...]}
+// 顶层可以是单个节点对象，也可以是节点对象数组
+class JsonTreeReader {
+public:
+    explicit JsonTreeReader(const JsonImportOptions& options = JsonImportOptions());
+
+    bool read(std::istream& in, std::vector<std::shared_ptr<ResourceNode>>& roots);
+    bool read(const std::string& json, std::vector<std::shared_ptr<ResourceNode>>& roots);
+
+    // 读取后挂载到注册表的parentPath下，parentPath为空时注册为根节点
+    bool readIntoRegistry(std::istream& in, ResourceRegistry& registry, const std::string& parentPath = "");
+
+    const std::string& getError() const { return error_; }
+
+private:
+    JsonImportOptions options_;
+    std::string error_;
+};
+
+// ResourceNode树 -> JSON，输出先写入内部缓冲区，缓冲区满时才写入流
+class JsonTreeWriter {
+public:
+    explicit JsonTreeWriter(std::ostream& out, bool pretty = false, size_t bufferSize = 64 * 1024);
+    ~JsonTreeWriter();
+
+    JsonTreeWriter(const JsonTreeWriter&) = delete;
+    JsonTreeWriter& operator=(const JsonTreeWriter&) = delete;
+
+    // 写入单个节点（包含整个子树）
+    void writeNode(const ResourceNode& node);
+
+    // 以数组形式写入注册表中的所有根节点
+    void writeRegistry(const ResourceRegistry& registry);
+
+    void flush();
+
+private:
+    void writeNodeAt(const ResourceNode& node, int depth);
+    bool writeAttributeValue(const AttributeValue& value);
+    void writeString(const std::string& value);
+    void writeDouble(double value);
+    void newline(int depth);
+    void reserveOrFlush();
+
+    std::ostream& out_;
+    bool pretty_;
+    size_t bufferSize_;
+    std::string buffer_;
+};
+
+} // namespace resource
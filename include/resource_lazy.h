@@ -0,0 +1,82 @@
+#pragma once
+
+#include "resource_registry.h"
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+namespace resource {
+
+// 延迟加载子树的内存预算：记录各节点加载出的子树大小，超出上限时卸载最久未访问的节点
+// 加载发生在读取方线程上（持有读锁），不能在那里卸载其他读取方可能正在访问的子树，
+// 所以超出预算时只记账，由写线程在持有写锁时调用enforce()卸载
+class LazyLoadBudget {
+public:
+    explicit LazyLoadBudget(size_t limitBytes)
+        : limit_(limitBytes), loadedBytes_(0), loads_(0), evictions_(0), clock_(0) {}
+
+    LazyLoadBudget(const LazyLoadBudget&) = delete;
+    LazyLoadBudget& operator=(const LazyLoadBudget&) = delete;
+
+    size_t limit() const;
+    void setLimit(size_t limitBytes);
+
+    // 当前已加载的子树字节数（加载时按ResourceNode::memoryUsage估算）和节点数
+    size_t loadedBytes() const;
+    size_t loadedCount() const;
+
+    // 累计加载和卸载次数
+    size_t loadCount() const;
+    size_t evictionCount() const;
+
+    // 按最久未访问的顺序卸载，直到不超过预算，返回卸载的节点数；须在没有读取方时调用
+    // 与加载一样不产生变更事件，按节点地址记录状态的监听器不能跟踪加载出的子树（AttributeHistory跳过它们）
+    size_t enforce();
+
+private:
+    friend class ResourceNode;
+
+    uint64_t nextUse() { return clock_.fetch_add(1, std::memory_order_relaxed) + 1; }
+    void noteLoaded(ResourceNode* node, size_t bytes);
+    // 节点卸载或析构时调用
+    void forget(const ResourceNode* node);
+
+    mutable std::mutex mutex_;
+    size_t limit_;
+    size_t loadedBytes_;
+    size_t loads_;
+    size_t evictions_;
+    std::unordered_map<ResourceNode*, size_t> loaded_;
+    std::atomic<uint64_t> clock_;
+};
+
+// 每次加载时转换obj，取转换结果的子节点作为延迟加载的子树（转换结果自身的属性不使用）
+// obj须在节点的生命周期内保持有效，加载时读取的是obj的当前内容
+template<typename T>
+NodeLoader converterLoader(const T& obj, const StructConverter& converter, const std::string& nodeName = "") {
+    std::shared_ptr<const StructConverter> owned(converter.clone());
+    const T* source = &obj;
+    const std::string name = nodeName.empty() ? typeid(T).name() : nodeName;
+    return [source, owned, name](ResourceNode& target) {
+        auto converted = owned->convert(source, name);
+        if (!converted) {
+            return;
+        }
+        std::vector<std::shared_ptr<ResourceNode>> children = converted->getChildren();
+        for (const auto& child : children) {
+            target.addChild(child);
+        }
+    };
+}
+
+// 把source当前的子树编码为二进制快照，加载时从快照解码；只保留二进制编码支持的属性类型
+// 快照在多个节点间共享（如同一型号的各个实例），加载出的子树彼此独立
+NodeLoader snapshotLoader(const ResourceNode& source);
+
+// 把node的子树换成快照并释放，此后按需从快照加载；须在节点挂载到注册表之前调用（不产生变更事件）
+void deferChildren(ResourceNode& node, std::shared_ptr<LazyLoadBudget> budget = nullptr);
+
+} // namespace resource
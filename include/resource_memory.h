@@ -0,0 +1,101 @@
+#pragma once
+
+#include <cstddef>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace resource {
+
+// 内存占用估算（字节），按类别分开统计
+// 数值由容器的容量和元素大小推算，不包括分配器自身的元数据，用于比较和容量规划而非精确计量
+struct MemoryUsage {
+    size_t nodeCount;
+    size_t nodeHeaders;       // ResourceNode对象及shared_ptr控制块
+    size_t childContainers;   // 子节点数组和按ID查找的子节点表
+    size_t attributeMaps;     // 动态属性表的桶和元素节点
+    size_t attributeValues;   // 属性值对象、模式槽位和表的列数组
+    size_t strings;           // 属性键和字符串值超出短字符串优化的堆内存（名称和ID在字符串池中）
+    size_t indexes;           // 索引器的各类索引和查询缓存
+
+    MemoryUsage()
+        : nodeCount(0), nodeHeaders(0), childContainers(0), attributeMaps(0), attributeValues(0), strings(0),
+          indexes(0) {}
+
+    size_t total() const {
+        return nodeHeaders + childContainers + attributeMaps + attributeValues + strings + indexes;
+    }
+
+    MemoryUsage& operator+=(const MemoryUsage& other) {
+        nodeCount += other.nodeCount;
+        nodeHeaders += other.nodeHeaders;
+        childContainers += other.childContainers;
+        attributeMaps += other.attributeMaps;
+        attributeValues += other.attributeValues;
+        strings += other.strings;
+        indexes += other.indexes;
+        return *this;
+    }
+};
+
+// ResourceRegistry::memoryUsage的结果
+struct MemoryReport {
+    MemoryUsage total;                          // 全部根节点、列存储表和注册表自身的容器
+    std::map<std::string, MemoryUsage> byRoot;  // 根节点ID -> 该子树
+    MemoryUsage tables;                         // 列存储表
+    std::map<std::string, size_t> byAttribute;  // 属性键 -> 属性表条目、值和字符串的字节数（按需统计）
+    size_t internedStrings;                     // 名称/ID字符串池，进程内所有注册表共用，不计入total
+
+    MemoryReport() : internedStrings(0) {}
+};
+
+namespace detail {
+
+// 字符串内容超出短字符串优化的容量时单独占用的堆内存
+inline size_t stringHeapBytes(const std::string& value) {
+    static const size_t inlineCapacity = std::string().capacity();
+    return value.capacity() > inlineCapacity ? value.capacity() + 1 : 0;
+}
+
+template<typename T>
+size_t vectorBytes(const std::vector<T>& values) {
+    return values.capacity() * sizeof(T);
+}
+
+// 哈希表的单个元素节点：next指针、缓存的哈希值和键值对
+template<typename Map>
+size_t hashNodeBytes() {
+    return sizeof(typename Map::value_type) + 2 * sizeof(void*);
+}
+
+// 哈希表：桶数组加上每个元素一个节点
+template<typename Map>
+size_t hashTableBytes(const Map& map) {
+    return map.bucket_count() * sizeof(void*) + map.size() * hashNodeBytes<Map>();
+}
+
+// 红黑树：每个元素一个节点（颜色和三个指针加键值对）
+template<typename Map>
+size_t treeBytes(const Map& map) {
+    return map.size() * (sizeof(typename Map::value_type) + 4 * sizeof(void*));
+}
+
+// 值对象之外由值持有的堆内存，字符串计入strings，其余计入attributeValues
+template<typename T>
+void accountValueHeap(const T&, MemoryUsage&) {}
+
+inline void accountValueHeap(const std::string& value, MemoryUsage& usage) {
+    usage.strings += stringHeapBytes(value);
+}
+
+template<typename T>
+void accountValueHeap(const std::vector<T>& values, MemoryUsage& usage) {
+    usage.attributeValues += vectorBytes(values);
+    for (const auto& value : values) {
+        accountValueHeap(value, usage);
+    }
+}
+
+} // namespace detail
+
+} // namespace resource
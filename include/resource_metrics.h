@@ -0,0 +1,140 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <vector>
+
+// 热点路径埋点的编译期开关，由CMake选项RESOURCE_ENABLE_METRICS控制
+// 关闭时埋点宏展开为空语句，热点路径上没有任何额外指令；注册表的stats()仍可用，但只有节点/属性计数
+#ifndef RESOURCE_ENABLE_METRICS
+#define RESOURCE_ENABLE_METRICS 0
+#endif
+
+namespace resource {
+
+// 被计时的操作
+enum class MetricOp : size_t {
+    GetNodeByPath,
+    UpdateDynamicObjects,
+    RefreshIndex,
+    FindByName,
+    FindById,
+    FindByPredicate,
+    FindByMultiConditions,
+    FindByAttributeIndexed,
+    FindGreaterThan,
+    FindLessThan,
+    FindInRange,
+    FindTopK,
+    Aggregate,
+    AggregateBy,
+    Count
+};
+
+const char* metricOpName(MetricOp op);
+
+// 单个操作的统计快照
+struct OperationStats {
+    std::string name;
+    uint64_t count;
+    uint64_t totalNanos;
+    uint64_t allocations;            // 调用期间当前线程的堆分配次数之和
+    std::vector<uint64_t> buckets;   // 各耗时区间的调用次数（非累计），最后一个区间为+Inf
+
+    double meanNanos() const { return count ? static_cast<double>(totalNanos) / count : 0.0; }
+    double allocationsPerCall() const { return count ? static_cast<double>(allocations) / count : 0.0; }
+};
+
+// ResourceRegistry::stats()返回的快照
+struct RegistryStats {
+    bool metricsEnabled;
+    size_t rootCount;
+    size_t nodeCount;
+    size_t attributeCount;
+    uint64_t indexHits;          // 属性查询命中已有索引
+    uint64_t indexScans;         // 属性查询时索引不存在而扫描整棵树
+    std::vector<OperationStats> operations;
+
+    RegistryStats() : metricsEnabled(RESOURCE_ENABLE_METRICS != 0), rootCount(0), nodeCount(0), attributeCount(0),
+                      indexHits(0), indexScans(0) {}
+};
+
+// 计数器与耗时直方图，全部为relaxed原子操作，可在并发查找中记录
+class ResourceMetrics {
+public:
+    // 耗时区间上界（纳秒），按4倍递增，最后一个区间为+Inf
+    static const size_t BUCKET_COUNT = 13;
+    static const uint64_t* bucketBounds();
+
+    ResourceMetrics();
+
+    ResourceMetrics(const ResourceMetrics&) = delete;
+    ResourceMetrics& operator=(const ResourceMetrics&) = delete;
+
+    void record(MetricOp op, uint64_t nanos, uint64_t allocations);
+    void countIndexHit() { indexHits_.fetch_add(1, std::memory_order_relaxed); }
+    void countIndexScan() { indexScans_.fetch_add(1, std::memory_order_relaxed); }
+
+    void snapshot(RegistryStats& stats) const;
+    void reset();
+
+private:
+    struct Histogram {
+        std::atomic<uint64_t> count;
+        std::atomic<uint64_t> totalNanos;
+        std::atomic<uint64_t> allocations;
+        std::atomic<uint64_t> buckets[BUCKET_COUNT];
+    };
+
+    Histogram operations_[static_cast<size_t>(MetricOp::Count)];
+    std::atomic<uint64_t> indexHits_;
+    std::atomic<uint64_t> indexScans_;
+};
+
+// 当前线程累计的堆分配次数；启用指标时由resource_metrics.cpp中替换的全局operator new统计，否则恒为0
+uint64_t threadAllocationCount();
+
+// 作用域计时：构造时记下时间和分配次数，析构时记入对应操作
+class ScopedOperationTimer {
+public:
+    ScopedOperationTimer(ResourceMetrics& metrics, MetricOp op)
+        : metrics_(metrics), op_(op), allocations_(threadAllocationCount()),
+          start_(std::chrono::steady_clock::now()) {}
+
+    ~ScopedOperationTimer() {
+        auto elapsed = std::chrono::steady_clock::now() - start_;
+        metrics_.record(op_, static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count()),
+                        threadAllocationCount() - allocations_);
+    }
+
+    ScopedOperationTimer(const ScopedOperationTimer&) = delete;
+    ScopedOperationTimer& operator=(const ScopedOperationTimer&) = delete;
+
+private:
+    ResourceMetrics& metrics_;
+    MetricOp op_;
+    uint64_t allocations_;
+    std::chrono::steady_clock::time_point start_;
+};
+
+// 以Prometheus文本格式输出统计快照
+void writePrometheus(std::ostream& out, const RegistryStats& stats);
+
+} // namespace resource
+
+#if RESOURCE_ENABLE_METRICS
+#define RESOURCE_METRICS_CONCAT_IMPL(a, b) a##b
+#define RESOURCE_METRICS_CONCAT(a, b) RESOURCE_METRICS_CONCAT_IMPL(a, b)
+#define RESOURCE_METRIC_SCOPE(metrics, op) \
+    ::resource::ScopedOperationTimer RESOURCE_METRICS_CONCAT(metricScope_, __LINE__)((metrics), ::resource::MetricOp::op)
+#define RESOURCE_METRIC_INDEX_HIT(metrics) (metrics).countIndexHit()
+#define RESOURCE_METRIC_INDEX_SCAN(metrics) (metrics).countIndexScan()
+#else
+#define RESOURCE_METRIC_SCOPE(metrics, op) ((void)0)
+#define RESOURCE_METRIC_INDEX_HIT(metrics) ((void)0)
+#define RESOURCE_METRIC_INDEX_SCAN(metrics) ((void)0)
+#endif
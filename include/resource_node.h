@@ -1,21 +1,94 @@
 #pragma once
 
+#include <atomic>
+#include <cstdint>
 #include <string>
 #include <vector>
 #include <memory>
+#include <mutex>
 #include <unordered_map>
 #include <functional>
 #include <typeinfo>
+#include <type_traits>
+#include <utility>
 #include <iostream>
+#include <new>
+#include <stdexcept>
+#include "resource_memory.h"
+#include "resource_string_pool.h"
 
 namespace resource {
 
+namespace detail {
+
+// 检测类型是否支持operator==，用于属性值比较
+template<typename T>
+class HasEqualOperator {
+    template<typename U>
+    static auto test(int) -> decltype(std::declval<const U&>() == std::declval<const U&>(), std::true_type());
+    template<typename>
+    static std::false_type test(...);
+public:
+    static const bool value = decltype(test<T>(0))::value;
+};
+
+template<typename T>
+typename std::enable_if<HasEqualOperator<T>::value, bool>::type
+valueEquals(const T& a, const T& b) {
+    return static_cast<bool>(a == b);
+}
+
+// 不可比较的类型一律视为不相等
+template<typename T>
+typename std::enable_if<!HasEqualOperator<T>::value, bool>::type
+valueEquals(const T&, const T&) {
+    return false;
+}
+
+// TypedAttributeValue按构造参数原地构造值的标记
+struct InPlace {};
+
+// 类型标记：每个类型一个静态对象的地址，判断类型只需比较指针
+// （type_info的比较在部分平台上要比较类型名字符串），扫描和建索引时代替typeid与dynamic_cast
+typedef const void* TypeTag;
+
+template<typename T>
+struct TypeTagHolder {
+    static const char tag;
+};
+
+template<typename T>
+const char TypeTagHolder<T>::tag = 0;
+
+template<typename T>
+TypeTag typeTag() {
+    return &TypeTagHolder<T>::tag;
+}
+
+} // namespace detail
+
 // 抽象的属性值基类，用于类型擦除
 class AttributeValue {
 public:
     virtual ~AttributeValue() {}
     virtual const std::type_info& getType() const = 0;
+    // 与getType()对应的类型标记
+    virtual detail::TypeTag typeTag() const = 0;
     virtual std::unique_ptr<AttributeValue> clone() const = 0;
+    // 比较两个属性值是否相等（类型不同或类型不可比较时返回false）
+    virtual bool equals(const AttributeValue& other) const = 0;
+    // 类型相同时原地复制other的值，类型不同时返回false
+    virtual bool assign(const AttributeValue& other) = 0;
+    // 指向存储的值，实际类型由getType()给出
+    virtual const void* data() const = 0;
+    // 累计值对象及其持有的堆内存；表中的行视图不持有值（由列统计），默认不计
+    virtual void accountMemory(MemoryUsage&) const {}
+
+    // 值的类型为T时返回指向值的指针，否则返回nullptr，不抛出异常
+    template<typename T>
+    const T* as() const {
+        return typeTag() == detail::typeTag<T>() ? static_cast<const T*>(data()) : nullptr;
+    }
 };
 
 // 具体的属性值类，可存储任意类型
@@ -23,100 +96,549 @@ template<typename T>
 class TypedAttributeValue : public AttributeValue {
 public:
     explicit TypedAttributeValue(const T& value) : value_(value) {}
+    explicit TypedAttributeValue(T&& value) : value_(std::move(value)) {}
+
+    template<typename... Args>
+    TypedAttributeValue(detail::InPlace, Args&&... args) : value_(std::forward<Args>(args)...) {}
     
     const std::type_info& getType() const override {
         return typeid(T);
     }
+
+    detail::TypeTag typeTag() const override {
+        return detail::typeTag<T>();
+    }
     
     const T& getValue() const {
         return value_;
     }
+
+    void setValue(const T& value) {
+        value_ = value;
+    }
+
+    void setValue(T&& value) {
+        value_ = std::move(value);
+    }
     
     std::unique_ptr<AttributeValue> clone() const override {
         return std::unique_ptr<AttributeValue>(new TypedAttributeValue<T>(value_));
     }
+
+    bool equals(const AttributeValue& other) const override {
+        const T* value = other.as<T>();
+        return value && detail::valueEquals(value_, *value);
+    }
+
+    bool assign(const AttributeValue& other) override {
+        const T* value = other.as<T>();
+        if (!value) return false;
+        value_ = *value;
+        return true;
+    }
+
+    const void* data() const override {
+        return &value_;
+    }
+
+    void accountMemory(MemoryUsage& usage) const override {
+        usage.attributeValues += sizeof(*this);
+        detail::accountValueHeap(value_, usage);
+    }
     
 private:
     T value_;
 };
 
+namespace detail {
+
+// std::vector<bool>按位存储，不能取元素地址，bool列改用单字节包装
+struct BoolStorage {
+    bool value;
+};
+
+template<typename T>
+struct ColumnStorage {
+    typedef typename std::conditional<std::is_same<T, bool>::value, BoolStorage, T>::type type;
+};
+
+template<typename T>
+const T& toColumnStorage(const T& value) {
+    return value;
+}
+
+inline BoolStorage toColumnStorage(bool value) {
+    BoolStorage storage;
+    storage.value = value;
+    return storage;
+}
+
+} // namespace detail
+
+// 类型擦除的属性列：一个模式字段在表中所有行上的值，连续存放
+class AttributeColumn {
+public:
+    virtual ~AttributeColumn() {}
+    virtual const std::type_info& getType() const = 0;
+    virtual size_t size() const = 0;
+    virtual void reserve(size_t rows) = 0;
+    // 追加一行，value的类型必须与列类型相同
+    virtual void append(const AttributeValue& value) = 0;
+    // 用最后一行覆盖row，然后删除最后一行
+    virtual void swapRemove(size_t row) = 0;
+    // 第row行的属性值视图，读写直接作用于列中的元素
+    virtual AttributeValue& cell(size_t row) = 0;
+    virtual void* valueAt(size_t row) = 0;
+    // 累计列数组及值持有的堆内存
+    virtual void accountMemory(MemoryUsage& usage) const = 0;
+};
+
+template<typename T>
+class TypedAttributeColumn : public AttributeColumn {
+public:
+    static std::unique_ptr<AttributeColumn> create() {
+        return std::unique_ptr<AttributeColumn>(new TypedAttributeColumn<T>());
+    }
+
+    const std::type_info& getType() const override { return typeid(T); }
+    size_t size() const override { return values_.size(); }
+
+    void reserve(size_t rows) override {
+        values_.reserve(rows);
+        cells_.reserve(rows);
+    }
+
+    void append(const AttributeValue& value) override {
+        values_.push_back(detail::toColumnStorage(*static_cast<const T*>(value.data())));
+        try {
+            cells_.push_back(Cell(this));
+        } catch (...) {
+            values_.pop_back();
+            throw;
+        }
+    }
+
+    void swapRemove(size_t row) override {
+        if (row + 1 != values_.size()) {
+            values_[row] = std::move(values_.back());
+        }
+        values_.pop_back();
+        cells_.pop_back();
+    }
+
+    AttributeValue& cell(size_t row) override { return cells_[row]; }
+    void* valueAt(size_t row) override { return data() + row; }
+
+    void accountMemory(MemoryUsage& usage) const override {
+        usage.attributeValues += detail::vectorBytes(values_) + detail::vectorBytes(cells_);
+        for (const auto& value : values_) {
+            detail::accountValueHeap(value, usage);
+        }
+    }
+
+    T* data() { return reinterpret_cast<T*>(values_.data()); }
+    const T* data() const { return reinterpret_cast<const T*>(values_.data()); }
+
+private:
+    typedef typename detail::ColumnStorage<T>::type Stored;
+
+    // 行视图只保存所属的列，行号由自身在cells_中的位置得出
+    class Cell : public AttributeValue {
+    public:
+        explicit Cell(TypedAttributeColumn* column) : column_(column) {}
+
+        const std::type_info& getType() const override { return typeid(T); }
+        detail::TypeTag typeTag() const override { return detail::typeTag<T>(); }
+
+        std::unique_ptr<AttributeValue> clone() const override {
+            return std::unique_ptr<AttributeValue>(new TypedAttributeValue<T>(value()));
+        }
+
+        bool equals(const AttributeValue& other) const override {
+            const T* value = other.as<T>();
+            return value && detail::valueEquals(this->value(), *value);
+        }
+
+        bool assign(const AttributeValue& other) override {
+            const T* value = other.as<T>();
+            if (!value) return false;
+            column_->data()[row()] = *value;
+            return true;
+        }
+
+        const void* data() const override { return &value(); }
+
+    private:
+        size_t row() const { return static_cast<size_t>(this - column_->cells_.data()); }
+        const T& value() const { return column_->data()[row()]; }
+
+        TypedAttributeColumn* column_;
+    };
+
+    TypedAttributeColumn() {}
+
+    std::vector<Stored> values_;
+    std::vector<Cell> cells_;
+};
+
+// 节点模式：一组有序的类型化字段
+// 绑定模式的节点把这些字段的TypedAttributeValue直接构造在一块连续的槽位内存中，按偏移量访问，
+// 属性名、类型和布局由所有节点共享，不再为每个属性单独分配内存
+class NodeSchema {
+public:
+    static const size_t npos = static_cast<size_t>(-1);
+
+    struct Field {
+        std::string name;
+        const std::type_info* type;
+        detail::TypeTag tag;
+        size_t offset;                                 // 在槽位内存中的偏移量
+        size_t valueOffset;                            // 值在TypedAttributeValue对象内的偏移量
+        std::unique_ptr<AttributeValue> defaultValue;  // 新节点的初始值
+        void (*construct)(void* slot, const AttributeValue& source);  // 在槽位上复制构造
+        std::unique_ptr<AttributeColumn> (*makeColumn)();             // 创建列存储表中的空列
+    };
+
+    explicit NodeSchema(const std::string& name) : name_(name), slotSize_(0), sealed_(false) {}
+
+    NodeSchema(const NodeSchema&) = delete;
+    NodeSchema& operator=(const NodeSchema&) = delete;
+
+    // 添加字段，字段名重复或已有节点绑定本模式时抛出异常
+    template<typename T>
+    NodeSchema& addField(const std::string& fieldName, const T& defaultValue = T()) {
+        if (sealed_) {
+            throw std::logic_error("Schema " + name_ + " is already in use");
+        }
+        if (indexByName_.count(fieldName) > 0) {
+            throw std::invalid_argument("Duplicate schema field: " + fieldName);
+        }
+
+        const size_t align = std::alignment_of<TypedAttributeValue<T>>::value;
+        Field field;
+        field.name = fieldName;
+        field.type = &typeid(T);
+        field.tag = detail::typeTag<T>();
+        field.offset = (slotSize_ + align - 1) / align * align;
+        field.defaultValue.reset(new TypedAttributeValue<T>(defaultValue));
+        field.valueOffset = static_cast<const unsigned char*>(field.defaultValue->data()) -
+                            reinterpret_cast<const unsigned char*>(field.defaultValue.get());
+        field.construct = &constructSlot<T>;
+        field.makeColumn = &TypedAttributeColumn<T>::create;
+
+        slotSize_ = field.offset + sizeof(TypedAttributeValue<T>);
+        indexByName_[fieldName] = fields_.size();
+        fields_.push_back(std::move(field));
+        return *this;
+    }
+
+    NodeSchema& addField(const std::string& fieldName, const char* defaultValue) {
+        return addField<std::string>(fieldName, std::string(defaultValue));
+    }
+
+    const std::string& getName() const { return name_; }
+    size_t fieldCount() const { return fields_.size(); }
+    const Field& field(size_t index) const { return fields_[index]; }
+    size_t slotSize() const { return slotSize_; }
+
+    // 字段下标，不存在时返回npos；热路径上可预先取得下标后用ResourceNode::getField访问
+    size_t fieldIndex(const std::string& fieldName) const {
+        auto it = indexByName_.find(fieldName);
+        return it != indexByName_.end() ? it->second : npos;
+    }
+
+    // 第一个节点绑定后布局固定，不能再添加字段
+    void seal() const { sealed_ = true; }
+
+private:
+    template<typename T>
+    static void constructSlot(void* slot, const AttributeValue& source) {
+        new (slot) TypedAttributeValue<T>(*static_cast<const T*>(source.data()));
+    }
+
+    std::string name_;
+    std::vector<Field> fields_;
+    std::unordered_map<std::string, size_t> indexByName_;
+    size_t slotSize_;
+    mutable bool sealed_;
+};
+
+// 按行存储模式字段的外部容器（列存储表），节点作为其中一行的句柄
+// 实现见resource_table.h中的ResourceTable
+class RowStorage {
+public:
+    virtual ~RowStorage() {}
+    virtual const std::shared_ptr<const NodeSchema>& getSchema() const = 0;
+    // 第row行第field个字段的属性值视图
+    virtual AttributeValue& cellAt(size_t field, size_t row) = 0;
+    // 第row行第field个字段的值，类型为字段类型
+    virtual void* valueAt(size_t field, size_t row) = 0;
+    // 行句柄析构时调用，删除该行
+    virtual void releaseRow(size_t row) = 0;
+};
+
+class ResourceNode;
+class LazyLoadBudget;
+
+// 延迟加载的加载器：在target（与节点同名同ID的临时节点）上添加子节点，加载完成后整体移交给节点
+// 由转换器或快照生成的加载器见resource_lazy.h
+typedef std::function<void(ResourceNode& target)> NodeLoader;
+
+// 延迟加载节点的状态，只有设置了加载器的节点才分配
+struct LazyState {
+    NodeLoader loader;
+    std::shared_ptr<LazyLoadBudget> budget;
+    std::mutex mutex;                // 多个读取方同时首次访问时只加载一次
+    std::atomic<bool> loaded;
+    std::atomic<uint64_t> lastUse;   // 最近一次访问在预算中的序号，卸载时先卸载最久未访问的
+
+    LazyState() : loaded(false), lastUse(0) {}
+};
+
 // 通用资源节点类 - 继承自enable_shared_from_this以支持shared_from_this()
 class ResourceNode : public std::enable_shared_from_this<ResourceNode> {
 public:
-    ResourceNode(const std::string& name, const std::string& id) : name_(name), id_(id) {}
-    ~ResourceNode() = default;
+    ResourceNode(const std::string& name, const std::string& id)
+        : name_(name), id_(id), parent_(nullptr), slots_(nullptr), row_(0), referenced_(false) {}
 
-    // 节点基本属性
-    const std::string& getName() const { return name_; }
-    const std::string& getId() const { return id_; }
-    void setName(const std::string& name) { name_ = name; }
+    // 创建绑定模式的节点，模式字段初始化为各自的默认值
+    ResourceNode(const std::string& name, const std::string& id, std::shared_ptr<const NodeSchema> schema);
+
+    // 创建行句柄：模式字段存放在rows的第row行，由ResourceTable::addRow调用
+    ResourceNode(const std::string& name, const std::string& id, std::shared_ptr<RowStorage> rows, size_t row);
+    ~ResourceNode();
+
+    // 槽位内存或表中的行由节点独占，不支持拷贝（使用clone）
+    ResourceNode(const ResourceNode&) = delete;
+    ResourceNode& operator=(const ResourceNode&) = delete;
+
+    const std::shared_ptr<const NodeSchema>& getSchema() const { return schema_; }
+
+    // 所在的列存储表及行号，不是行句柄时返回nullptr；行号在表中删除其他行后可能变化
+    RowStorage* getRowStorage() const { return rows_.get(); }
+    size_t getRow() const { return row_; }
+
+    // 节点基本属性，名称和ID驻留在字符串池中，相同的名称只保存一份
+    const std::string& getName() const { return name_.str(); }
+    const std::string& getId() const { return id_.str(); }
+    void setName(const std::string& name) { name_ = InternedString(name); }
+
+    // 驻留的名称和ID句柄，相互比较只需比较指针
+    const InternedString& getInternedName() const { return name_; }
+    const InternedString& getInternedId() const { return id_; }
+
+    // 父节点（根节点或未挂载的节点返回nullptr）
+    ResourceNode* getParent() const { return parent_; }
+
+    // 从所在树的根节点开始、由各级ID组成的路径，例如 "group001/cluster002/m2-6"
+    std::string getPath() const;
     
     // 子节点管理
     void addChild(std::shared_ptr<ResourceNode> child);
 
+    // 为即将添加的count个子节点预留空间，批量添加时避免子节点表反复扩容
+    void reserveChildren(size_t count) {
+        if (lazy_) ensureLoaded();
+        children_.reserve(children_.size() + count);
+        childMap_.reserve(childMap_.size() + count);
+    }
+
     void removeChild(const std::string& id);
 
     std::shared_ptr<ResourceNode> getChild(const std::string& id) const {
-        auto it = childMap_.find(id);
+        if (lazy_) ensureLoaded();
+        auto it = childMap_.find(&id);
         if (it != childMap_.end()) {
+            it->second->touch();
             return it->second;
         }
         return nullptr;
     }
 
     const std::vector<std::shared_ptr<ResourceNode>>& getChildren() const {
+        if (lazy_) ensureLoaded();
+        touch();
         return children_;
     }
+
+    // 已加载的子节点，不触发延迟加载；整树遍历（traverseNodes、traverse、索引、内存统计）使用
+    // 其他读取方可能正在加载这个节点：loaded以acquire读到true之后子节点才可见，此前按未加载返回空表，
+    // 不读取加载过程中被替换的children_
+    const std::vector<std::shared_ptr<ResourceNode>>& getLoadedChildren() const {
+        if (lazy_ && !lazy_->loaded.load(std::memory_order_acquire)) {
+            static const std::vector<std::shared_ptr<ResourceNode>> none;
+            return none;
+        }
+        return children_;
+    }
+
+    // === 延迟加载 ===
+    // 很少访问的子树（如详细的探测、毁伤能力）不在转换时建好，而是在第一次getChild/getChildren
+    // （以及addChild等修改子节点的操作）时由加载器生成；节点自身的属性仍然常驻，建索引和按属性扫描不会触发加载
+    // 加载出的子树不产生变更事件，不进入索引，通过路径或getChild访问
+    // budget非空时已加载的子树计入预算，超出时由写线程调用budget->enforce()卸载最久未访问的节点
+    // 只能在没有子节点时设置，否则抛出std::logic_error
+    void setLoader(NodeLoader loader, std::shared_ptr<LazyLoadBudget> budget = nullptr);
+    bool isLazy() const { return lazy_ != nullptr; }
+    bool isLoaded() const { return !lazy_ || lazy_->loaded.load(std::memory_order_acquire); }
+
+    // 访问位（CLOCK算法）：getChild取到该节点或对其调用getChildren时置位，由SpillManager扫描时清除
+    // 只在未置位时写入，多个读取方反复访问同一节点不会争用缓存行
+    void touch() const {
+        if (!referenced_.load(std::memory_order_relaxed)) {
+            referenced_.store(true, std::memory_order_relaxed);
+        }
+    }
+    bool isReferenced() const { return referenced_.load(std::memory_order_relaxed); }
+    // 清除访问位，返回清除前的值
+    bool clearReferenced() const { return referenced_.exchange(false, std::memory_order_relaxed); }
+
+    // 卸载子树回到未加载状态，下次访问时重新加载，对子树的修改随之丢弃
+    // 须在没有读取方时调用（写线程持有写锁）；返回是否确实卸载了内容
+    bool unload();
     
     // 属性管理 - 允许节点存储任意类型的属性
+    // 模式字段的类型固定，写入其他类型的值时抛出std::bad_cast
     template<typename T>
     void setAttribute(const std::string& key, const T& value) {
+        size_t field = schemaFieldIndex(key);
+        if (field != NodeSchema::npos) {
+            fieldRef<T>(field) = value;
+            return;
+        }
         attributes_[key] = std::unique_ptr<AttributeValue>(new TypedAttributeValue<T>(value));
     }
 
+    // 右值版本：值移入属性，大的字符串/数组不复制
+    template<typename T>
+    typename std::enable_if<!std::is_reference<T>::value && !std::is_const<T>::value>::type
+    setAttribute(const std::string& key, T&& value) {
+        size_t field = schemaFieldIndex(key);
+        if (field != NodeSchema::npos) {
+            fieldRef<T>(field) = std::move(value);
+            return;
+        }
+        attributes_[key] = std::unique_ptr<AttributeValue>(new TypedAttributeValue<T>(std::move(value)));
+    }
+
     void setAttribute(const std::string& key, const char* value) {
         // 将 const char* 转换为 std::string 后存储
         setAttribute<std::string>(key, std::string(value));
     }
 
+    // 用args在属性中原地构造T类型的值；模式字段先构造临时值再移入
+    template<typename T, typename... Args>
+    void emplaceAttribute(const std::string& key, Args&&... args) {
+        size_t field = schemaFieldIndex(key);
+        if (field != NodeSchema::npos) {
+            fieldRef<T>(field) = T(std::forward<Args>(args)...);
+            return;
+        }
+        attributes_[key] = std::unique_ptr<AttributeValue>(
+            new TypedAttributeValue<T>(detail::InPlace(), std::forward<Args>(args)...));
+    }
+
     template<typename T>
     void modifyAttribute(const std::string& key, const T& value) {
-        // 检查属性是否存在
-        auto it = attributes_.find(key);
-        if (it == attributes_.end()) {
-            throw std::runtime_error("Attribute not found: " + key);
+        size_t field = schemaFieldIndex(key);
+        if (field != NodeSchema::npos) {
+            fieldRef<T>(field) = value;
+            return;
         }
-        
-        // 检查类型是否匹配
-        auto* typedValue = dynamic_cast<TypedAttributeValue<T>*>(it->second.get());
-        if (!typedValue) {
-            throw std::bad_cast();
+        typedAttribute<T>(key).setValue(value);
+    }
+
+    template<typename T>
+    typename std::enable_if<!std::is_reference<T>::value && !std::is_const<T>::value>::type
+    modifyAttribute(const std::string& key, T&& value) {
+        size_t field = schemaFieldIndex(key);
+        if (field != NodeSchema::npos) {
+            fieldRef<T>(field) = std::move(value);
+            return;
         }
-        
-        // 类型匹配，创建新的属性值替换旧值
-        attributes_[key] = std::unique_ptr<AttributeValue>(new TypedAttributeValue<T>(value));
+        typedAttribute<T>(key).setValue(std::move(value));
     }
     
     template<typename T>
     T getAttribute(const std::string& key) const {
-        auto it = attributes_.find(key);
-        if (it != attributes_.end()) {
-            auto* typedValue = dynamic_cast<TypedAttributeValue<T>*>(it->second.get());
-            if (typedValue) {
-                return typedValue->getValue();
-            }
-            throw std::bad_cast();
+        return getAttributeRef<T>(key);
+    }
+
+    // 返回属性值的引用，不复制；引用在属性被修改或删除前有效
+    // 属性不存在时抛出std::runtime_error，类型不匹配时抛出std::bad_cast
+    template<typename T>
+    const T& getAttributeRef(const std::string& key) const {
+        if (const T* value = tryGetAttribute<T>(key)) {
+            return *value;
         }
-        throw std::runtime_error("Attribute not found: " + key);
+        if (!hasAttribute(key)) {
+            throw std::runtime_error("Attribute not found: " + key);
+        }
+        throw std::bad_cast();
+    }
+
+    // 属性不存在或类型不匹配时返回nullptr，不抛出异常；指针的有效期同getAttributeRef
+    // 类型按类型标记比较，按属性扫描和建索引都走这条路径
+    template<typename T>
+    const T* tryGetAttribute(const std::string& key) const {
+        size_t field = schemaFieldIndex(key);
+        if (field != NodeSchema::npos) {
+            return schema_->field(field).tag == detail::typeTag<T>() ? fieldPtr<T>(field) : nullptr;
+        }
+        auto it = attributes_.find(key);
+        return it != attributes_.end() ? it->second->as<T>() : nullptr;
     }
     
-    bool hasAttribute(const std::string& key) const { return attributes_.find(key) != attributes_.end(); }
+    // 按模式字段下标直接读写槽位（行句柄为所在列中的元素），省去属性名查找
+    template<typename T>
+    const T& getField(size_t index) const {
+        return fieldRef<T>(index);
+    }
+
+    template<typename T>
+    void setField(size_t index, const T& value) {
+        fieldRef<T>(index) = value;
+    }
+
+    template<typename T>
+    typename std::enable_if<!std::is_reference<T>::value && !std::is_const<T>::value>::type
+    setField(size_t index, T&& value) {
+        fieldRef<T>(index) = std::move(value);
+    }
+
+    bool hasAttribute(const std::string& key) const {
+        return findSchemaSlot(key) != nullptr || attributes_.find(key) != attributes_.end();
+    }
     
+    // 模式字段始终存在，不能删除
     void removeAttribute(const std::string& key) { attributes_.erase(key); }
+
+    // 查找属性值（包括模式字段），不存在时返回nullptr
+    const AttributeValue* findAttribute(const std::string& key) const {
+        if (const AttributeValue* slot = findSchemaSlot(key)) {
+            return slot;
+        }
+        auto it = attributes_.find(key);
+        return it != attributes_.end() ? it->second.get() : nullptr;
+    }
+
+    // 依次访问所有属性：先按模式中的顺序访问模式字段，再访问动态属性
+    void forEachAttribute(const std::function<void(const std::string& key, const AttributeValue& value)>& visitor) const;
     
+    // 估算节点占用的内存，recursive时包括整个子树；byAttribute非空时按属性键累计属性表条目、值和字符串
+    MemoryUsage memoryUsage(bool recursive = true, std::map<std::string, size_t>* byAttribute = nullptr) const;
+
+    // 属性总数（包括模式字段）
+    size_t attributeCount() const {
+        return attributes_.size() + (schema_ ? schema_->fieldCount() : 0);
+    }
+
     std::vector<std::string> getAttributeKeys() const {
         std::vector<std::string> keys;
-        keys.reserve(attributes_.size());
+        keys.reserve(attributes_.size() + (schema_ ? schema_->fieldCount() : 0));
+        for (size_t i = 0; schema_ && i < schema_->fieldCount(); ++i) {
+            keys.push_back(schema_->field(i).name);
+        }
         for (const auto& pair : attributes_) {
             keys.push_back(pair.first);
         }
@@ -124,6 +646,9 @@ public:
     }
     
     const std::type_info& getAttributeType(const std::string& key) const {
+        if (const AttributeValue* slot = findSchemaSlot(key)) {
+            return slot->getType();
+        }
         auto it = attributes_.find(key);
         if (it != attributes_.end()) {
             return it->second->getType();
@@ -142,22 +667,118 @@ public:
     
     // 添加原始属性更新方法
     void updateAttributeRaw(const std::string& key, std::unique_ptr<AttributeValue> value) {
+        if (AttributeValue* slot = findSchemaSlot(key)) {
+            if (!slot->assign(*value)) throw std::bad_cast();
+            return;
+        }
         attributes_[key] = std::move(value);
     }
+
+    // 替换属性值并返回旧值（属性原本不存在时返回nullptr）
+    std::unique_ptr<AttributeValue> exchangeAttributeRaw(const std::string& key, std::unique_ptr<AttributeValue> value) {
+        if (AttributeValue* slot = findSchemaSlot(key)) {
+            if (slot->getType() != value->getType()) throw std::bad_cast();
+            auto oldValue = slot->clone();
+            slot->assign(*value);
+            return oldValue;
+        }
+        std::unique_ptr<AttributeValue>& slot = attributes_[key];
+        slot.swap(value);
+        return value;
+    }
+
+    // 移除属性并返回其值（属性不存在或为模式字段时返回nullptr）
+    std::unique_ptr<AttributeValue> releaseAttribute(const std::string& key) {
+        auto it = attributes_.find(key);
+        if (it == attributes_.end()) {
+            return nullptr;
+        }
+        std::unique_ptr<AttributeValue> value = std::move(it->second);
+        attributes_.erase(it);
+        return value;
+    }
     
-    // 获取属性映射（用于更新）
+    // 获取动态属性映射（用于更新），不包含模式字段；需要全部属性时使用forEachAttribute
     const std::unordered_map<std::string, std::unique_ptr<AttributeValue>>& getAttributes() const {
         return attributes_;
     }
 
 private:
-    std::string name_;
-    std::string id_;
+    friend class ResourceTable;
+    friend class LazyLoadBudget;
+
+    // 首次访问时调用加载器，只在设置了加载器时调用
+    void ensureLoaded() const;
+
+    // 槽位中的属性值对象从偏移0处构造，TypedAttributeValue单继承，基类子对象位于同一地址
+    AttributeValue& slotAt(size_t index) const {
+        if (rows_) return rows_->cellAt(index, row_);
+        return *reinterpret_cast<AttributeValue*>(slots_ + schema_->field(index).offset);
+    }
+
+    size_t schemaFieldIndex(const std::string& key) const {
+        return schema_ ? schema_->fieldIndex(key) : NodeSchema::npos;
+    }
+
+    AttributeValue* findSchemaSlot(const std::string& key) const {
+        size_t index = schemaFieldIndex(key);
+        return index != NodeSchema::npos ? &slotAt(index) : nullptr;
+    }
+
+    // 已有的动态属性，不存在时抛出std::runtime_error，类型不匹配时抛出std::bad_cast
+    // 动态属性表中只存放TypedAttributeValue（表中行视图的clone也是），类型标记相同即可直接转换
+    template<typename T>
+    TypedAttributeValue<T>& typedAttribute(const std::string& key) {
+        auto it = attributes_.find(key);
+        if (it == attributes_.end()) {
+            throw std::runtime_error("Attribute not found: " + key);
+        }
+        if (it->second->typeTag() != detail::typeTag<T>()) {
+            throw std::bad_cast();
+        }
+        return static_cast<TypedAttributeValue<T>&>(*it->second);
+    }
+
+    // 模式字段的值，类型由模式决定，T不匹配时抛出std::bad_cast
+    template<typename T>
+    T& fieldRef(size_t index) const {
+        if (schema_->field(index).tag != detail::typeTag<T>()) throw std::bad_cast();
+        return *fieldPtr<T>(index);
+    }
+
+    // 不检查类型，调用方已确认字段类型为T
+    template<typename T>
+    T* fieldPtr(size_t index) const {
+        const NodeSchema::Field& field = schema_->field(index);
+        void* value = rows_ ? rows_->valueAt(index, row_) : slots_ + field.offset + field.valueOffset;
+        return static_cast<T*>(value);
+    }
+
+    // 按模式布局构造槽位，source非空时复制其模式字段的值
+    void constructSlots(const ResourceNode* source);
+
+    InternedString name_;
+    InternedString id_;
+    ResourceNode* parent_;  // 不持有所有权，由父节点在addChild/removeChild时维护
     std::vector<std::shared_ptr<ResourceNode>> children_;
-    std::unordered_map<std::string, std::shared_ptr<ResourceNode>> childMap_;
+    // 键指向子节点自身的ID（ID不可修改），不另存副本
+    StringRefMap<std::shared_ptr<ResourceNode>> childMap_;
     
+    // 模式字段槽位，未绑定模式或为行句柄时为空
+    std::shared_ptr<const NodeSchema> schema_;
+    unsigned char* slots_;
+
+    // 行句柄所在的表和行号，表由所有行句柄共同持有
+    std::shared_ptr<RowStorage> rows_;
+    size_t row_;
+
     // 通用属性存储 - 使用类型擦除代替std::any
     std::unordered_map<std::string, std::unique_ptr<AttributeValue>> attributes_;
+
+    // 延迟加载状态，普通节点为空
+    std::unique_ptr<LazyState> lazy_;
+
+    mutable std::atomic<bool> referenced_;
 };
 
 void simple_visitor(const std::shared_ptr<ResourceNode>& node, int depth);
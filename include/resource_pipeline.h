@@ -0,0 +1,79 @@
+#pragma once
+
+#include "resource_registry.h"
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace resource {
+
+// 流水线方式的动态对象更新
+// 顺序流程中每个tick依次执行：修改结构体 -> updateAllDynamicObjects -> 索引更新 -> 查询。
+// 流水线把转换和合并拆开：submitTick在转换线程上并行转换本tick的全部动态对象，返回后结构体即可继续修改；
+// 合并（连同提交时的增量索引更新）交给后台线程，与下一个tick的结构体修改和转换重叠执行。
+// 合并在注册表的写锁内完成，持有读锁的查询（见query）看到的始终是最近一个合并完成的tick
+//
+// 使用约定：submitTick和flush只由一个线程调用；注册或移除动态对象前先调用flush
+class TickPipeline {
+public:
+    // workers为额外的转换线程数，为0时只在调用submitTick的线程上转换
+    explicit TickPipeline(ResourceRegistry& registry, size_t workers = defaultWorkerCount());
+    ~TickPipeline();
+
+    TickPipeline(const TickPipeline&) = delete;
+    TickPipeline& operator=(const TickPipeline&) = delete;
+
+    // 转换所有动态对象并排入合并，返回本tick的序号（从1开始）
+    // 上一个tick还在排队等待合并时先等它开始合并；之前的转换或合并抛出的异常在此重新抛出
+    uint64_t submitTick();
+
+    // 等待已提交的tick全部合并完成
+    void flush();
+
+    uint64_t submittedTick() const { return submitted_.load(); }
+    uint64_t completedTick() const { return completed_.load(); }
+
+    // 持有注册表的读锁执行查询，期间不会有合并发生
+    void query(const std::function<void()>& reader) const;
+
+    static size_t defaultWorkerCount();
+
+private:
+    void workerLoop();
+    void mergeLoop();
+    void convertChunks();
+    void rethrowPendingError();
+
+    ResourceRegistry& registry_;
+
+    std::mutex mutex_;
+    std::condition_variable workCond_;
+    std::condition_variable doneCond_;
+    std::condition_variable mergeCond_;
+    bool stopping_;
+
+    // 当前tick的转换任务，转换线程按块领取
+    uint64_t convertGeneration_;
+    size_t activeWorkers_;
+    std::vector<std::shared_ptr<ResourceNode>>* converting_;
+    size_t convertCount_;
+    std::atomic<size_t> nextChunk_;
+
+    // 等待合并的tick（最多一个）
+    std::vector<std::shared_ptr<ResourceNode>> pending_;
+    bool mergePending_;
+
+    std::atomic<uint64_t> submitted_;
+    std::atomic<uint64_t> completed_;
+    std::exception_ptr error_;
+
+    std::vector<std::thread> workers_;
+    std::thread merger_;
+};
+
+} // namespace resource
@@ -1,20 +1,39 @@
 #pragma once
 
+#include "resource_metrics.h"
 #include "resource_node.h"
+#include "resource_subscription.h"
+#include "resource_sync.h"
+#include "resource_table.h"
+#include "resource_transaction.h"
 #include <memory>
 #include <unordered_map>
+#include <unordered_set>
 #include <functional>
 #include <typeindex>
 #include <tuple>
 
 namespace resource {
 
+class ChangeLog;
+
+// 结构体直接写入节点时值有变化的属性：属性名（由转换器持有）和旧值（属性原本不存在时为nullptr）
+typedef std::vector<std::pair<const std::string*, std::unique_ptr<AttributeValue>>> AttributeChanges;
+
 // 通用的结构体转换器接口
 class StructConverter {
 public:
     virtual ~StructConverter() = default;
     virtual std::shared_ptr<ResourceNode> convert(const void* structPtr, const std::string& nodeName) const = 0;
     virtual StructConverter* clone() const = 0;  // 添加克隆方法
+
+    // 动态对象更新时把结构体的当前值直接写入已有节点，changes收集有变化的属性
+    // 默认不支持（返回false），由注册表转换出临时节点后逐个属性和子节点合并
+    virtual bool updateInPlace(const void*, ResourceNode&, AttributeChanges&) const { return false; }
+
+    // 支持updateInPlace的转换器返回true：这类转换器只负责节点的属性，流水线合并（mergeDynamicObjects）时
+    // 也只合并转换结果的属性，不改动节点上另行添加的子节点，与updateAllDynamicObjects一致
+    virtual bool updatesInPlace() const { return false; }
 };
 
 class ResourceRegistry {
@@ -24,10 +43,10 @@ public:
     // 根节点管理
     bool registerRootNode(std::shared_ptr<ResourceNode> root);
 
-    void unregisterRootNode(const std::string& rootId) { rootNodes_.erase(rootId);}
+    void unregisterRootNode(const std::string& rootId);
 
     std::shared_ptr<ResourceNode> getRootNode(const std::string& rootId) const {
-        auto it = rootNodes_.find(rootId);
+        auto it = rootNodes_.find(&rootId);
         if (it != rootNodes_.end()) {
             return it->second;
         }
@@ -44,6 +63,21 @@ public:
         return result;
     }
     
+    // 节点模式：按名称注册，同名模式已存在时返回false
+    bool registerSchema(std::shared_ptr<const NodeSchema> schema);
+    std::shared_ptr<const NodeSchema> getSchema(const std::string& schemaName) const;
+
+    // 创建绑定已注册模式的节点（尚未挂载），模式不存在时返回nullptr
+    std::shared_ptr<ResourceNode> createNode(const std::string& schemaName,
+                                             const std::string& name, const std::string& id) const;
+
+    // 模式对应的列存储表（首次访问时创建），模式不存在时返回nullptr
+    std::shared_ptr<ResourceTable> getTable(const std::string& schemaName);
+
+    // 在模式对应的表中追加一行，返回尚未挂载的行句柄，模式不存在时返回nullptr
+    std::shared_ptr<ResourceNode> createRow(const std::string& schemaName,
+                                            const std::string& name, const std::string& id);
+
     // 节点路径操作
     bool registerNodeAtPath(const std::string& path, std::shared_ptr<ResourceNode> node);
     std::shared_ptr<ResourceNode> getNodeByPath(const std::string& path) const;
@@ -51,6 +85,61 @@ public:
     
     // 支持创建整个路径
     std::shared_ptr<ResourceNode> createPath(const std::string& path);
+
+    // 通过路径设置/删除节点属性（会写入变更日志并通知订阅者）
+    template<typename T>
+    bool setAttribute(const std::string& nodePath, const std::string& key, const T& value) {
+        return setAttributeValue(nodePath, key, std::unique_ptr<AttributeValue>(new TypedAttributeValue<T>(value)));
+    }
+
+    // 右值版本：值移入属性，不复制
+    template<typename T>
+    typename std::enable_if<!std::is_reference<T>::value && !std::is_const<T>::value, bool>::type
+    setAttribute(const std::string& nodePath, const std::string& key, T&& value) {
+        return setAttributeValue(nodePath, key,
+                                 std::unique_ptr<AttributeValue>(new TypedAttributeValue<T>(std::move(value))));
+    }
+
+    bool setAttribute(const std::string& nodePath, const std::string& key, const char* value) {
+        return setAttribute<std::string>(nodePath, key, std::string(value));
+    }
+
+    bool removeAttribute(const std::string& nodePath, const std::string& key);
+
+    // 变更日志：挂载后注册表上的所有变更都会追加到日志
+    // 注意：直接调用ResourceNode::setAttribute等节点方法的修改不会被记录
+    void attachChangeLog(std::shared_ptr<ChangeLog> changeLog) { changeLog_ = changeLog; }
+    std::shared_ptr<ChangeLog> detachChangeLog() {
+        auto changeLog = changeLog_;
+        changeLog_.reset();
+        return changeLog;
+    }
+    std::shared_ptr<ChangeLog> getChangeLog() const { return changeLog_; }
+
+    // 变更订阅：订阅路径（为空时订阅整个注册表）及其子树上的变更，可按属性名过滤
+    // （属性名过滤只作用于属性事件，节点增删事件始终投递）
+    // 事件在updateAllDynamicObjects结束或调用commitChanges时合并后批量投递
+    // subscribe/unsubscribe须在写线程调用，poll可在任意一个消费者线程调用
+    std::shared_ptr<ChangeSubscription> subscribe(const std::string& path,
+                                                  bool includeSubtree = true,
+                                                  const std::vector<std::string>& attributeKeys = std::vector<std::string>(),
+                                                  size_t capacity = 64);
+    bool unsubscribe(const std::shared_ptr<ChangeSubscription>& subscription);
+
+    // 同步变更监听器（如ResourceIndexer），提交时先于订阅者收到完整事件批次
+    void addChangeListener(ChangeListener* listener);
+    void removeChangeListener(ChangeListener* listener);
+
+    // 提交本批次变更：写入日志提交记录，通知监听器并向订阅者投递合并后的事件
+    void commitChanges();
+
+    // 原子地应用一个写入批次：全部校验通过后才修改节点树，成功后清空批次
+    // 失败时不做任何修改，批次保持不变，error（非空时）返回失败原因
+    bool commit(WriteBatch& batch, std::string* error = nullptr);
+
+    // 读写锁：commit和updateAllDynamicObjects在写锁内完成修改、索引更新和通知，
+    // 其他线程的读取方持有ReadLock即可看到一致的节点树和索引
+    SharedMutex& getMutex() const { return mutex_; }
     
     // 遍历根节点
     void traverseRootNode(const std::function<void(const std::shared_ptr<ResourceNode>&, int depth)>& visitor) const;
@@ -90,6 +179,47 @@ public:
         return success;
     }
 
+    // 大批量注册：全部对象挂到同一个父节点parentPath下（为空时作为根节点注册）
+    // 父节点只解析一次并预留子节点空间；workers>0时另开workers个线程并行转换，转换器须可并发调用
+    // 挂载在写锁内完成并立即提交，索引等监听器在同一个批次中一次完成增量更新
+    // 返回成功挂载的个数，转换失败或ID重复的对象被跳过
+    template<typename T>
+    size_t registerStructsBulk(const std::vector<T>& objects, const std::string& parentPath,
+                               const StructConverter& converter, const std::string& nodeName = "",
+                               size_t workers = 0) {
+        std::vector<const void*> pointers;
+        pointers.reserve(objects.size());
+        for (const auto& obj : objects) {
+            pointers.push_back(&obj);
+        }
+        auto nodes = convertStructs(pointers, converter, nodeName.empty() ? typeid(T).name() : nodeName, workers);
+
+        WriteLock lock(mutex_);
+        size_t attached = registerChildren(parentPath, nodes);
+        publishChanges();
+        return attached;
+    }
+
+    // 把一组尚未挂载的节点挂到parentPath下（为空时作为根节点注册），父节点只查找一次
+    // 与registerNodeAtPath一样只记录变更，由调用方提交；返回成功挂载的个数，ID重复的节点被跳过
+    size_t registerChildren(const std::string& parentPath, const std::vector<std::shared_ptr<ResourceNode>>& nodes);
+
+    // 把nodes[i]的子树摘下，改为由loaders[i]按需重新加载（见ResourceNode::setLoader），在写锁内完成并提交一次
+    // 节点自身保留在树上，索引中指向它的条目不受影响；被摘下的子节点以NODE_REMOVED事件通知监听器和订阅者，
+    // 数据并没有删除，所以不写入变更日志。供SpillManager换出冷子树使用，返回处理的节点数
+    // 子树中含有动态对象节点（见containsDynamicObject）的节点被跳过：摘下后它们仍会被每个tick更新，修改随之丢失
+    size_t evictChildren(const std::vector<std::shared_ptr<ResourceNode>>& nodes, const std::vector<NodeLoader>& loaders);
+
+    // evictChildren的反向通知。被摘下的子树在读取方线程上重新加载，读取方不能提交事件，
+    // 加载器调用reloadNotifier返回的函数登记加载完成的节点（任意线程均可调用）；写线程的下一次提交
+    // （任何经注册表的修改、commit、commitChanges、updateAllDynamicObjects等）先把登记节点的子节点
+    // 以NODE_ADDED事件通知监听器和订阅者（同样不写入变更日志），加载回来的后代随同这次提交重新进入索引
+    // 返回的函数只弱引用注册表，可以保存在加载器中，注册表销毁后调用不做任何事
+    std::function<void(const std::shared_ptr<ResourceNode>&)> reloadNotifier();
+
+    // 立即发布已登记的加载，不必等到下一次提交；在写锁内完成并提交一次，返回处理的节点数（已再次卸载的节点不计）
+    size_t publishReloads();
+
     template<typename T>
     std::shared_ptr<ResourceNode> registerDynamicStruct(
         T& obj, 
@@ -106,6 +236,7 @@ public:
             std::type_index(typeid(T)), 
             std::shared_ptr<const StructConverter>(converter.clone()),
             node));
+        dynamicNodes_.insert(node.get());
         
         if (path.empty()) {
             registerRootNode(node);
@@ -118,51 +249,83 @@ public:
     
     // 更新所有动态对象
     void updateAllDynamicObjects() {
+        WriteLock lock(mutex_);
+        RESOURCE_METRIC_SCOPE(metrics_, UpdateDynamicObjects);
         for (const auto& obj : dynamicObjects_) {
             // obj: [objPtr, typeIdx, converter, node]
             // updateNode(node, objPtr, converter);
             updateNode(std::get<3>(obj), std::get<0>(obj), std::get<2>(obj));
         }
+        publishChanges();
     }
     
+    // 流水线更新（见TickPipeline）：把updateAllDynamicObjects拆成转换和合并两步
+    // 转换只读取结构体和转换器，不修改节点树，也不需要持有锁，可以与上一次的合并并发执行；
+    // 转换和合并之间不能注册或移除动态对象
+    size_t getDynamicObjectCount() const { return dynamicObjects_.size(); }
+
+    // 按结构体的当前内容转换第[begin, end)个动态对象，结果写入converted的对应位置（须已有足够大小）
+    void convertDynamicObjects(size_t begin, size_t end, std::vector<std::shared_ptr<ResourceNode>>& converted) const;
+
+    // 持有写锁把转换结果合并到各动态对象的节点并提交变更，为nullptr的位置跳过
+    // 转换器的updatesInPlace()为true时只合并属性，否则属性和子节点都与转换结果同步
+    void mergeDynamicObjects(const std::vector<std::shared_ptr<ResourceNode>>& converted);
+
     // 更新特定节点
     bool updateNode(std::shared_ptr<ResourceNode> node, 
                     const void* objPtr,
                     std::shared_ptr<const StructConverter> converter);
 
     // 清除所有动态对象跟踪
-    void clearDynamicObjects() { dynamicObjects_.clear(); }
+    void clearDynamicObjects() {
+        dynamicObjects_.clear();
+        dynamicNodes_.clear();
+    }
 
     // 移除特定节点的动态跟踪
     bool removeDynamicObject(std::shared_ptr<ResourceNode> node);
+
+    // root或其已加载的后代是否为动态对象的节点（每次updateAllDynamicObjects都会写入，不能换出）
+    bool containsDynamicObject(const ResourceNode& root) const;
     
+    // path的最后一段为属性名，前面各段为node下的子节点；value按完美转发存入属性，右值不复制
     template<typename T>
     bool updateAttribute(
-        std::shared_ptr<ResourceNode> node, 
+        const std::shared_ptr<ResourceNode>& node, 
         const std::string& path, 
-        const T& value)
+        T&& value)
     {
+        typedef typename std::decay<T>::type Value;
+        static_assert(!std::is_same<Value, char*>::value && !std::is_same<Value, const char*>::value,
+                      "Character pointers must be stored as std::string");
         if (!node) return false;
         
         auto parts = splitPath(path);
-        auto currentNode = node;
+        ResourceNode* currentNode = node.get();
         
         // 导航到目标节点
-        for (size_t i = 0; i < parts.size() - 1; ++i) {
-            currentNode = currentNode->getChild(parts[i]);
+        for (size_t i = 0; i + 1 < parts.size(); ++i) {
+            currentNode = currentNode->getChild(parts[i]).get();
             if (!currentNode) return false;
         }
         
         // 设置最终属性
         if (!parts.empty()) {
-            currentNode->setAttribute(parts.back(), value);
+            auto oldValue = currentNode->exchangeAttributeRaw(parts.back(),
+                std::unique_ptr<AttributeValue>(new TypedAttributeValue<Value>(std::forward<T>(value))));
+            recordAttributeChanged(*currentNode, parts.back(), std::move(oldValue));
             return true;
         }
         return false;
     }
 
+    // 字符串字面量按std::string存储，与setAttribute一致
+    bool updateAttribute(const std::shared_ptr<ResourceNode>& node, const std::string& path, const char* value) {
+        return updateAttribute(node, path, std::string(value));
+    }
+
     // 递归终止函数 - 处理空参数情况
-    bool batchUpdateAttributes(std::shared_ptr<ResourceNode> node) 
+    bool batchUpdateAttributes(const std::shared_ptr<ResourceNode>& node) 
     {
         return node != nullptr;
     }
@@ -170,31 +333,108 @@ public:
     // 变长模板参数实现的批量更新
     template<typename T, typename... Args>
     bool batchUpdateAttributes(
-        std::shared_ptr<ResourceNode> node,
+        const std::shared_ptr<ResourceNode>& node,
         const std::string& path, 
-        const T& value, 
+        T&& value, 
         Args&&... args)
     {
-        bool result = updateAttribute(node, path, value);
+        bool result = updateAttribute(node, path, std::forward<T>(value));
         return result && batchUpdateAttributes(node, std::forward<Args>(args)...);
     }
 
     // 清空注册表
     void clear();
 
+    // === 运行统计 ===
+    // 根节点/节点/属性数在调用时遍历得到，与其他读取方一样需要持有ReadLock；
+    // 以RESOURCE_ENABLE_METRICS构建时还包含各热点操作的调用次数、耗时分布、分配次数和索引命中情况
+    RegistryStats stats() const;
+    ResourceMetrics& getMetrics() const { return metrics_; }
+
+    // 估算所有根节点子树和列存储表占用的内存，按根节点分开给出；byAttribute为true时另按属性键汇总
+    // 与stats()一样需要持有ReadLock
+    MemoryReport memoryUsage(bool byAttribute = false) const;
+
 private:
-    std::unordered_map<std::string, std::shared_ptr<ResourceNode>> rootNodes_;
+    // 键指向根节点自身的ID
+    StringRefMap<std::shared_ptr<ResourceNode>> rootNodes_;
+    std::unordered_map<std::string, std::shared_ptr<const NodeSchema>> schemas_;
+    std::unordered_map<std::string, std::shared_ptr<ResourceTable>> tables_;
     
     std::vector<std::string> splitPath(const std::string& path) const;
 
+    // 按顺序转换objects，workers>0时分块交给额外的线程并行转换；任一转换抛出的异常在汇合后重新抛出
+    static std::vector<std::shared_ptr<ResourceNode>> convertStructs(const std::vector<const void*>& objects,
+                                                                     const StructConverter& converter,
+                                                                     const std::string& nodeName,
+                                                                     size_t workers);
+
     // 存储动态对象引用、类型信息、转换器和对应节点
     std::vector<std::tuple<const void*, std::type_index, 
                             std::shared_ptr<const StructConverter>, 
                             std::shared_ptr<ResourceNode>>> dynamicObjects_;
+    // 动态对象的节点，同一节点注册多次时出现多次
+    std::unordered_multiset<const ResourceNode*> dynamicNodes_;
                             
+    // 只合并source的属性，值未变化的属性跳过
+    void mergeAttributes(ResourceNode& target, const ResourceNode& source);
+
     // 递归更新节点属性
     void updateNodeAttributes(std::shared_ptr<ResourceNode> target, 
                              std::shared_ptr<ResourceNode> source);
+
+    // 变更日志
+    std::shared_ptr<ChangeLog> changeLog_;
+
+    // 变更订阅及待投递的事件（同一属性的多次修改合并为一条）
+    std::vector<std::shared_ptr<ChangeSubscription>> subscriptions_;
+    ChangeBatch pendingChanges_;
+    std::unordered_map<std::string, size_t> pendingAttributeIndex_;
+
+    std::vector<ChangeListener*> listeners_;
+
+    mutable SharedMutex mutex_;
+
+    // 读取方线程登记的已加载节点，由写线程在提交时取走
+    struct ReloadQueue {
+        std::mutex mutex;
+        std::vector<std::weak_ptr<ResourceNode>> nodes;
+        std::atomic<bool> pending;
+
+        ReloadQueue() : pending(false) {}
+    };
+    std::shared_ptr<ReloadQueue> reloads_;
+
+    // 热点路径的计数器，只在启用RESOURCE_ENABLE_METRICS时写入
+    mutable ResourceMetrics metrics_;
+
+    bool isTrackingChanges() const { return !subscriptions_.empty() || !listeners_.empty(); }
+
+    // commitChanges的实现，调用方负责持有写锁
+    void publishChanges();
+    // 取走登记的加载，为仍处于加载状态的节点记录子节点的NODE_ADDED事件，返回处理的节点数；调用方持有写锁
+    size_t recordReloads();
+
+    // 所有变更的统一入口：写入日志并记录待投递事件
+    // knownPath为调用方已经得到的节点路径，避免再沿父节点拼接
+    void recordAttributeChanged(const ResourceNode& node, const std::string& key,
+                                std::unique_ptr<AttributeValue> oldValue,
+                                const std::string* knownPath = nullptr);
+    void recordAttributeRemoved(const ResourceNode& node, const std::string& key,
+                                std::unique_ptr<AttributeValue> oldValue,
+                                const std::string* knownPath = nullptr);
+    // knownParentPath为调用方已经得到的父节点路径
+    // logged为false时只投递事件，不写入变更日志
+    void recordNodeAdded(const ResourceNode* parent, const ResourceNode& node,
+                         const std::string* knownParentPath = nullptr, bool logged = true);
+    // 替换nodePath处节点的属性并记录变更，节点不存在时返回false
+    bool setAttributeValue(const std::string& nodePath, const std::string& key, std::unique_ptr<AttributeValue> value);
+    // logged为false时只投递事件，不写入变更日志
+    void recordNodeRemoved(const std::string& path, const std::shared_ptr<ResourceNode>& node, bool logged = true);
+    void pushAttributeEvent(ChangeEvent::Type type, const ResourceNode& node,
+                            const std::string& path, const std::string& key,
+                            std::unique_ptr<AttributeValue> oldValue,
+                            std::shared_ptr<const AttributeValue> newValue);
 };
 
 } // namespace resource
\ No newline at end of file
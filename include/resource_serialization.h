@@ -0,0 +1,79 @@
+#pragma once
+
+#include "resource_node.h"
+#include <cstdint>
+#include <string>
+#include <memory>
+
+namespace resource {
+
+// 二进制编码中的属性值类型码
+enum class ValueTypeCode : uint8_t {
+    UNSUPPORTED = 0,
+    INT32 = 1,
+    INT64 = 2,
+    DOUBLE = 3,
+    FLOAT = 4,
+    BOOL = 5,
+    STRING = 6
+};
+
+// 追加式二进制写入器（小端序）
+class BinaryWriter {
+public:
+    explicit BinaryWriter(std::string& buffer) : buffer_(buffer) {}
+
+    void writeU8(uint8_t value) { buffer_.push_back(static_cast<char>(value)); }
+    void writeU32(uint32_t value);
+    void writeU64(uint64_t value);
+    void writeDouble(double value);
+    void writeString(const std::string& value);
+    void writeBytes(const char* data, size_t size);
+
+    size_t size() const { return buffer_.size(); }
+
+private:
+    std::string& buffer_;
+};
+
+// 二进制读取器，越界读取时置失败标志而不抛出异常
+class BinaryReader {
+public:
+    BinaryReader(const char* data, size_t size) : data_(data), size_(size), pos_(0), ok_(true) {}
+
+    uint8_t readU8();
+    uint32_t readU32();
+    uint64_t readU64();
+    double readDouble();
+    std::string readString();
+
+    bool ok() const { return ok_; }
+    bool atEnd() const { return pos_ >= size_; }
+    size_t position() const { return pos_; }
+
+private:
+    bool require(size_t bytes);
+
+    const char* data_;
+    size_t size_;
+    size_t pos_;
+    bool ok_;
+};
+
+// 属性值编解码，不支持的类型返回false / nullptr
+bool encodeAttributeValue(BinaryWriter& writer, const AttributeValue& value);
+std::unique_ptr<AttributeValue> decodeAttributeValue(BinaryReader& reader);
+
+// 节点编解码（包含名称、ID、属性以及全部子节点）
+void encodeNode(BinaryWriter& writer, const ResourceNode& node);
+std::shared_ptr<ResourceNode> decodeNode(BinaryReader& reader);
+
+// 子节点列表编解码（数量 + 各子节点），用于延迟加载的快照和换出文件
+// decodeChildren把解码出的子节点添加到target，数据残缺时返回false
+void encodeChildren(BinaryWriter& writer, const ResourceNode& node);
+bool decodeChildren(BinaryReader& reader, ResourceNode& target);
+
+// CRC32校验，用于检测日志尾部的残缺记录
+uint32_t crc32(const char* data, size_t size);
+
+} // namespace resource
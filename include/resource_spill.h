@@ -0,0 +1,77 @@
+#pragma once
+
+#include "resource_registry.h"
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace resource {
+
+namespace detail {
+class SpillFile;
+}
+
+// 冷子树换出到磁盘：场景规模超过内存时，把长时间未访问的子树编码后追加到本地换出文件，
+// 子树的根节点留在树上作为桩（延迟加载节点，见ResourceNode::setLoader），经getNodeByPath/getChild访问时
+// 再从文件透明地加载回来
+//
+// 参与换出的候选子树为manage指定的各父节点下的每个子节点。访问记录使用节点上的访问位（CLOCK算法）：
+// 读取方访问时置位，sweep逐个经过候选子树，置位的清除后跳过（第二次机会），未置位的在驻留字节数超过预算时换出
+//
+// 索引与换出：
+// - 桩节点是原来的节点对象，自身属性常驻，索引中指向它的条目在换出和加载前后保持有效
+// - 被换出的后代不在内存中，以NODE_REMOVED事件离开索引（不写入变更日志），换出期间按名称、ID和属性查询不到它们
+// - 加载发生在读取方线程上，读取方不能提交事件：加载器向注册表登记（见ResourceRegistry::reloadNotifier），
+//   写线程的下一次提交（任何写操作或commitChanges、sweep、publishReloads）把加载回来的后代以NODE_ADDED事件
+//   重新加入索引，此前只能经路径或getChild访问
+// - 加载回来的后代是从文件解码出的新节点对象；换出前取得的后代引用仍然有效，但已脱离节点树，不会再被索引
+// 换出时子树中的修改一并写入文件；含有模式字段、二进制编码不支持的属性类型、延迟加载后代或
+// 动态对象节点（registerDynamicStruct跟踪的节点，每个tick都会被写入）的子树不换出
+//
+// sweep须在写线程调用（它在注册表的写锁内摘下子树并提交一次）；加载可以在持有读锁的读取方线程上并发发生
+class SpillManager {
+public:
+    // spillPath为换出文件，已存在时被截断；管理器和所有桩节点都释放后文件被删除
+    SpillManager(ResourceRegistry& registry, const std::string& spillPath, size_t budgetBytes);
+    ~SpillManager();
+
+    SpillManager(const SpillManager&) = delete;
+    SpillManager& operator=(const SpillManager&) = delete;
+
+    // parentPath下的每个子节点各作为一个候选子树
+    void manage(const std::string& parentPath);
+
+    void setBudget(size_t budgetBytes) { budget_ = budgetBytes; }
+    size_t getBudget() const { return budget_; }
+
+    // 扫描候选子树，驻留字节数超过预算时换出未被访问的子树，返回换出的个数
+    size_t sweep();
+
+    // 立即把尚未发布的加载回来的子树发布给索引等监听器（注册表的任何提交都会顺带发布），返回处理的子树数；
+    // sweep开始时自动调用，须在写线程调用
+    size_t publishReloads();
+
+    // 最近一次sweep结束时候选子树的驻留字节数（不含桩节点自身）
+    size_t residentBytes() const { return residentBytes_; }
+    // 当前处于换出状态的候选子树数
+    size_t spilledCount() const;
+
+    // 累计换出和从文件加载的次数，换出文件的大小（重复换出的子树追加新记录，旧记录不回收）
+    size_t spillCount() const { return spills_; }
+    size_t reloadCount() const;
+    uint64_t fileBytes() const;
+
+private:
+    std::vector<std::shared_ptr<ResourceNode>> candidates() const;
+
+    ResourceRegistry& registry_;
+    std::shared_ptr<detail::SpillFile> file_;
+    size_t budget_;
+    std::vector<std::string> managed_;
+    size_t hand_;  // CLOCK指针：下一次扫描开始的候选位置
+    size_t residentBytes_;
+    size_t spills_;
+};
+
+} // namespace resource
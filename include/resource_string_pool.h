@@ -0,0 +1,96 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <functional>
+#include <string>
+#include <unordered_map>
+#include <utility>
+
+namespace resource {
+
+// 以其他对象持有的字符串为键的哈希表：键是指向字符串的指针，哈希和比较按内容进行
+// 键字符串由值（或其他长期存在的对象）持有，表中不再保存副本；查找时传入临时字符串的地址即可
+struct StringRefHash {
+    size_t operator()(const std::string* value) const { return std::hash<std::string>()(*value); }
+};
+
+struct StringRefEqual {
+    bool operator()(const std::string* a, const std::string* b) const { return a == b || *a == *b; }
+};
+
+template<typename Value>
+using StringRefMap = std::unordered_map<const std::string*, Value, StringRefHash, StringRefEqual>;
+
+// 进程内共享的字符串池，节点的名称和ID在此驻留，相同内容只保存一份
+// 条目按引用计数管理，最后一个InternedString释放时从池中删除；池按哈希分片加锁，可多线程使用
+class StringPool {
+public:
+    struct Entry {
+        std::string value;
+        size_t hash;
+        std::atomic<size_t> refs;
+
+        Entry(const std::string& v, size_t h) : value(v), hash(h), refs(1) {}
+    };
+
+    // 返回value对应的条目并增加一次引用
+    static Entry* acquire(const std::string& value);
+    // 减少一次引用，归零时删除条目
+    static void release(Entry* entry);
+
+    // 池中不同字符串的个数
+    static size_t size();
+    // 估算池占用的内存（条目、字符串内容和各分片的哈希表）
+    static size_t memoryUsage();
+};
+
+// 驻留字符串的句柄：复制只增加引用计数，相等比较只比较指针
+// 空字符串不进入字符串池，以空句柄表示
+class InternedString {
+public:
+    InternedString() : entry_(nullptr) {}
+    InternedString(const std::string& value) : entry_(value.empty() ? nullptr : StringPool::acquire(value)) {}
+    InternedString(const char* value) : InternedString(std::string(value)) {}
+
+    InternedString(const InternedString& other) : entry_(other.entry_) {
+        if (entry_) {
+            entry_->refs.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+
+    InternedString(InternedString&& other) noexcept : entry_(other.entry_) { other.entry_ = nullptr; }
+
+    InternedString& operator=(InternedString other) noexcept {
+        std::swap(entry_, other.entry_);
+        return *this;
+    }
+
+    ~InternedString() {
+        if (entry_) {
+            StringPool::release(entry_);
+        }
+    }
+
+    const std::string& str() const { return entry_ ? entry_->value : emptyString(); }
+    size_t hash() const { return entry_ ? entry_->hash : emptyHash(); }
+    bool empty() const { return entry_ == nullptr; }
+
+    bool operator==(const InternedString& other) const { return entry_ == other.entry_; }
+    bool operator!=(const InternedString& other) const { return entry_ != other.entry_; }
+
+private:
+    static const std::string& emptyString() {
+        static const std::string empty;
+        return empty;
+    }
+
+    static size_t emptyHash() {
+        static const size_t hash = std::hash<std::string>()(std::string());
+        return hash;
+    }
+
+    StringPool::Entry* entry_;
+};
+
+} // namespace resource
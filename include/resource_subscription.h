@@ -0,0 +1,128 @@
+#pragma once
+
+#include "resource_node.h"
+#include <atomic>
+#include <string>
+#include <vector>
+#include <memory>
+#include <unordered_set>
+
+namespace resource {
+
+// 变更事件
+struct ChangeEvent {
+    enum class Type {
+        NODE_ADDED,
+        NODE_REMOVED,
+        ATTRIBUTE_CHANGED,
+        ATTRIBUTE_REMOVED
+    };
+
+    Type type;
+    std::string path;  // 节点路径
+    std::string key;   // 属性名（节点事件为空）
+    std::shared_ptr<const AttributeValue> oldValue;  // 新增属性时为空
+    std::shared_ptr<const AttributeValue> newValue;  // 删除属性时为空
+    // 事件对应的节点，删除事件为被删除子树的根；跨线程读取节点内容需调用方自行同步
+    std::shared_ptr<ResourceNode> node;
+
+    ChangeEvent() : type(Type::NODE_ADDED) {}
+    ChangeEvent(Type t, const std::string& p, const std::string& k = std::string())
+        : type(t), path(p), key(k) {}
+};
+
+typedef std::vector<ChangeEvent> ChangeBatch;
+
+// 同步变更监听器：提交时在写线程上收到完整的事件批次（不做路径过滤）
+// 供索引等需要与节点树保持一致的内部结构使用，回调内不能再修改注册表
+class ChangeListener {
+public:
+    virtual ~ChangeListener() {}
+    virtual void onChangesCommitted(const ChangeBatch& batch) = 0;
+};
+
+// 单生产者单消费者无锁环形缓冲区
+// 生产者（注册表写线程）满时不等待，由调用方决定丢弃策略
+template<typename T>
+class SpscRingBuffer {
+public:
+    explicit SpscRingBuffer(size_t capacity)
+        : slots_(capacity + 1), head_(0), tail_(0) {}
+
+    bool tryPush(T&& item) {
+        size_t tail = tail_.load(std::memory_order_relaxed);
+        size_t next = increment(tail);
+        if (next == head_.load(std::memory_order_acquire)) {
+            return false;  // 已满
+        }
+        slots_[tail] = std::move(item);
+        tail_.store(next, std::memory_order_release);
+        return true;
+    }
+
+    bool tryPop(T& item) {
+        size_t head = head_.load(std::memory_order_relaxed);
+        if (head == tail_.load(std::memory_order_acquire)) {
+            return false;  // 为空
+        }
+        item = std::move(slots_[head]);
+        slots_[head] = T();
+        head_.store(increment(head), std::memory_order_release);
+        return true;
+    }
+
+    bool empty() const {
+        return head_.load(std::memory_order_acquire) == tail_.load(std::memory_order_acquire);
+    }
+
+    size_t capacity() const { return slots_.size() - 1; }
+
+private:
+    size_t increment(size_t index) const {
+        return index + 1 == slots_.size() ? 0 : index + 1;
+    }
+
+    std::vector<T> slots_;
+    // 生产者和消费者的位置用填充隔开到不同缓存行，避免伪共享
+    std::atomic<size_t> head_;
+    char padding_[64];
+    std::atomic<size_t> tail_;
+};
+
+// 变更订阅：由ResourceRegistry::subscribe创建
+// 注册表在提交时把过滤后的事件批量推入订阅的环形缓冲区，消费者线程调用poll读取
+// 节点增删事件的路径为订阅路径的祖先时也会投递（订阅的节点随祖先的子树一起挂载或删除）
+class ChangeSubscription {
+public:
+    ChangeSubscription(const std::string& path, bool includeSubtree,
+                       const std::vector<std::string>& attributeKeys, size_t capacity);
+
+    const std::string& getPath() const { return path_; }
+    bool includesSubtree() const { return includeSubtree_; }
+
+    // 消费者接口：取出一批事件，没有待处理批次时返回false
+    bool poll(ChangeBatch& batch) { return ring_.tryPop(batch); }
+    bool hasPending() const { return !ring_.empty(); }
+
+    // 缓冲区满时被丢弃的批次数；非零说明消费者需要重新同步完整状态
+    uint64_t droppedBatches() const { return dropped_.load(std::memory_order_relaxed); }
+
+    // 判断事件是否属于本订阅
+    bool matches(const ChangeEvent& event) const;
+
+    // 生产者接口：推送一批事件，缓冲区满时丢弃并计数
+    bool publish(ChangeBatch&& batch);
+
+private:
+    bool isWithin(const std::string& path) const;
+    // path是否为订阅路径的祖先
+    bool isAncestor(const std::string& path) const;
+
+    std::string path_;
+    bool includeSubtree_;
+    std::unordered_set<std::string> attributeKeys_;
+    SpscRingBuffer<ChangeBatch> ring_;
+    std::atomic<uint64_t> dropped_;
+};
+
+} // namespace resource
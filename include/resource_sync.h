@@ -0,0 +1,81 @@
+#pragma once
+
+#include <mutex>
+#include <condition_variable>
+
+namespace resource {
+
+// 读写锁（C++11没有std::shared_mutex），写者优先，避免持续的读请求饿死写线程
+class SharedMutex {
+public:
+    SharedMutex() : readers_(0), writing_(false), waitingWriters_(0) {}
+
+    SharedMutex(const SharedMutex&) = delete;
+    SharedMutex& operator=(const SharedMutex&) = delete;
+
+    void lock() {
+        std::unique_lock<std::mutex> guard(mutex_);
+        ++waitingWriters_;
+        writerCond_.wait(guard, [this]() { return !writing_ && readers_ == 0; });
+        --waitingWriters_;
+        writing_ = true;
+    }
+
+    void unlock() {
+        std::lock_guard<std::mutex> guard(mutex_);
+        writing_ = false;
+        if (waitingWriters_ > 0) {
+            writerCond_.notify_one();
+        }
+        readerCond_.notify_all();
+    }
+
+    void lock_shared() {
+        std::unique_lock<std::mutex> guard(mutex_);
+        readerCond_.wait(guard, [this]() { return !writing_ && waitingWriters_ == 0; });
+        ++readers_;
+    }
+
+    void unlock_shared() {
+        std::lock_guard<std::mutex> guard(mutex_);
+        if (--readers_ == 0 && waitingWriters_ > 0) {
+            writerCond_.notify_one();
+        }
+    }
+
+private:
+    std::mutex mutex_;
+    std::condition_variable readerCond_;
+    std::condition_variable writerCond_;
+    int readers_;
+    bool writing_;
+    int waitingWriters_;
+};
+
+// RAII读锁
+class ReadLock {
+public:
+    explicit ReadLock(SharedMutex& mutex) : mutex_(mutex) { mutex_.lock_shared(); }
+    ~ReadLock() { mutex_.unlock_shared(); }
+
+    ReadLock(const ReadLock&) = delete;
+    ReadLock& operator=(const ReadLock&) = delete;
+
+private:
+    SharedMutex& mutex_;
+};
+
+// RAII写锁
+class WriteLock {
+public:
+    explicit WriteLock(SharedMutex& mutex) : mutex_(mutex) { mutex_.lock(); }
+    ~WriteLock() { mutex_.unlock(); }
+
+    WriteLock(const WriteLock&) = delete;
+    WriteLock& operator=(const WriteLock&) = delete;
+
+private:
+    SharedMutex& mutex_;
+};
+
+} // namespace resource
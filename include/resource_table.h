@@ -0,0 +1,153 @@
+#pragma once
+
+#include "resource_node.h"
+#include <algorithm>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace resource {
+
+// 数值聚合结果，列扫描和ResourceIndexer的聚合查询共用
+struct AggregateResult {
+    size_t count;
+    double sum;
+    double min;
+    double max;
+
+    AggregateResult() : count(0), sum(0.0), min(0.0), max(0.0) {}
+
+    double average() const { return count > 0 ? sum / static_cast<double>(count) : 0.0; }
+
+    void add(double value) {
+        min = count == 0 || value < min ? value : min;
+        max = count == 0 || value > max ? value : max;
+        sum += value;
+        ++count;
+    }
+
+    void merge(const AggregateResult& other) {
+        if (other.count == 0) return;
+        min = count == 0 || other.min < min ? other.min : min;
+        max = count == 0 || other.max > max ? other.max : max;
+        sum += other.sum;
+        count += other.count;
+    }
+};
+
+// 列存储表：同一模式的大量同构节点按列存放，每个模式字段的值在一个连续数组中
+// 节点作为行句柄仍提供完整的ResourceNode接口，名称、子节点和额外的动态属性照常存放在节点上；
+// 按列扫描和整列更新是对连续内存的顺序读写，编译器可以向量化
+// 通过column/fill直接写列不经过注册表，不会记录变更，写入后需要刷新相关索引
+class ResourceTable : public RowStorage, public std::enable_shared_from_this<ResourceTable> {
+public:
+    // 行句柄共同持有表，表只能通过create创建
+    static std::shared_ptr<ResourceTable> create(std::shared_ptr<const NodeSchema> schema);
+
+    ResourceTable(const ResourceTable&) = delete;
+    ResourceTable& operator=(const ResourceTable&) = delete;
+
+    const std::shared_ptr<const NodeSchema>& getSchema() const override { return schema_; }
+
+    size_t rowCount() const { return rows_.size(); }
+    void reserve(size_t rows);
+
+    // 估算列数组和行表占用的内存（不含行句柄节点本身），byAttribute非空时按字段名累计
+    MemoryUsage memoryUsage(std::map<std::string, size_t>* byAttribute = nullptr) const;
+
+    // 追加一行（模式字段为默认值）并返回其行句柄，句柄析构时删除该行，最后一行移入空位
+    std::shared_ptr<ResourceNode> addRow(const std::string& name, const std::string& id);
+
+    // 第row行的行句柄
+    std::shared_ptr<ResourceNode> rowNode(size_t row) const {
+        return rows_[row]->shared_from_this();
+    }
+
+    // 字段下标，字段不存在时抛出std::invalid_argument
+    size_t fieldIndex(const std::string& fieldName) const;
+
+    // 第field个字段的列，长度为rowCount()，增删行后指针失效；T与字段类型不符时抛出std::bad_cast
+    template<typename T>
+    T* column(size_t field) {
+        return typedColumn<T>(field).data();
+    }
+
+    template<typename T>
+    const T* column(size_t field) const {
+        return const_cast<ResourceTable*>(this)->typedColumn<T>(field).data();
+    }
+
+    template<typename T>
+    T* column(const std::string& fieldName) {
+        return column<T>(fieldIndex(fieldName));
+    }
+
+    template<typename T>
+    const T* column(const std::string& fieldName) const {
+        return column<T>(fieldIndex(fieldName));
+    }
+
+    // 把一列全部设为value
+    template<typename T>
+    void fill(const std::string& fieldName, const T& value) {
+        T* values = column<T>(fieldName);
+        std::fill(values, values + rowCount(), value);
+    }
+
+    // 顺序扫描一个数值列求聚合
+    template<typename T>
+    AggregateResult aggregate(const std::string& fieldName) const {
+        const T* values = column<T>(fieldName);
+        AggregateResult result;
+        if (rows_.empty()) return result;
+        T low = values[0], high = values[0];
+        double sum = 0.0;
+        for (size_t row = 0; row < rows_.size(); ++row) {
+            sum += static_cast<double>(values[row]);
+            low = values[row] < low ? values[row] : low;
+            high = values[row] > high ? values[row] : high;
+        }
+        result.count = rows_.size();
+        result.sum = sum;
+        result.min = static_cast<double>(low);
+        result.max = static_cast<double>(high);
+        return result;
+    }
+
+    // 顺序扫描一列，返回值满足predicate的行句柄
+    template<typename T, typename Predicate>
+    std::vector<std::shared_ptr<ResourceNode>> selectRows(const std::string& fieldName, Predicate predicate) const {
+        const T* values = column<T>(fieldName);
+        std::vector<std::shared_ptr<ResourceNode>> result;
+        for (size_t row = 0; row < rows_.size(); ++row) {
+            if (predicate(values[row])) {
+                result.push_back(rowNode(row));
+            }
+        }
+        return result;
+    }
+
+private:
+    explicit ResourceTable(std::shared_ptr<const NodeSchema> schema);
+
+    template<typename T>
+    TypedAttributeColumn<T>& typedColumn(size_t field) {
+        if (field >= columns_.size()) {
+            throw std::out_of_range("Table field index out of range");
+        }
+        if (columns_[field]->getType() != typeid(T)) {
+            throw std::bad_cast();
+        }
+        return static_cast<TypedAttributeColumn<T>&>(*columns_[field]);
+    }
+
+    AttributeValue& cellAt(size_t field, size_t row) override { return columns_[field]->cell(row); }
+    void* valueAt(size_t field, size_t row) override { return columns_[field]->valueAt(row); }
+    void releaseRow(size_t row) override;
+
+    std::shared_ptr<const NodeSchema> schema_;
+    std::vector<std::unique_ptr<AttributeColumn>> columns_;
+    std::vector<ResourceNode*> rows_;  // 行号到行句柄，不持有所有权
+};
+
+} // namespace resource
@@ -0,0 +1,90 @@
+#pragma once
+
+#include "resource_node.h"
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace resource {
+
+// 批量写入：暂存跨整棵树的属性修改和节点增删，由ResourceRegistry::commit一次性原子应用
+// 提交时先在暂存视图上校验全部操作，任一操作失败则整个批次不生效；
+// 成功后只通知一次订阅者和索引，索引按排序后的键一次性更新
+class WriteBatch {
+public:
+    WriteBatch() {}
+
+    WriteBatch(const WriteBatch&) = delete;
+    WriteBatch& operator=(const WriteBatch&) = delete;
+    WriteBatch(WriteBatch&&) = default;
+    WriteBatch& operator=(WriteBatch&&) = default;
+
+    template<typename T>
+    WriteBatch& setAttribute(const std::string& nodePath, const std::string& key, const T& value) {
+        Operation op(Operation::Type::SET_ATTRIBUTE, nodePath, key);
+        op.value.reset(new TypedAttributeValue<T>(value));
+        operations_.push_back(std::move(op));
+        return *this;
+    }
+
+    // 右值版本：值移入批次，不复制
+    template<typename T>
+    typename std::enable_if<!std::is_reference<T>::value && !std::is_const<T>::value, WriteBatch&>::type
+    setAttribute(const std::string& nodePath, const std::string& key, T&& value) {
+        Operation op(Operation::Type::SET_ATTRIBUTE, nodePath, key);
+        op.value.reset(new TypedAttributeValue<T>(std::move(value)));
+        operations_.push_back(std::move(op));
+        return *this;
+    }
+
+    WriteBatch& setAttribute(const std::string& nodePath, const std::string& key, const char* value) {
+        return setAttribute<std::string>(nodePath, key, std::string(value));
+    }
+
+    // 删除属性，属性不存在时忽略
+    WriteBatch& removeAttribute(const std::string& nodePath, const std::string& key) {
+        operations_.push_back(Operation(Operation::Type::REMOVE_ATTRIBUTE, nodePath, key));
+        return *this;
+    }
+
+    // 在parentPath下添加节点，parentPath为空时注册为根节点
+    WriteBatch& addNode(const std::string& parentPath, std::shared_ptr<ResourceNode> node) {
+        Operation op(Operation::Type::ADD_NODE, parentPath, std::string());
+        op.node = std::move(node);
+        operations_.push_back(std::move(op));
+        return *this;
+    }
+
+    WriteBatch& removeNode(const std::string& path) {
+        operations_.push_back(Operation(Operation::Type::REMOVE_NODE, path, std::string()));
+        return *this;
+    }
+
+    size_t size() const { return operations_.size(); }
+    bool empty() const { return operations_.empty(); }
+    void clear() { operations_.clear(); }
+
+private:
+    friend class ResourceRegistry;
+
+    struct Operation {
+        enum class Type {
+            SET_ATTRIBUTE,
+            REMOVE_ATTRIBUTE,
+            ADD_NODE,
+            REMOVE_NODE
+        };
+
+        Type type;
+        std::string path;  // 属性操作为节点路径，ADD_NODE为父节点路径，REMOVE_NODE为被删节点路径
+        std::string key;
+        std::unique_ptr<AttributeValue> value;
+        std::shared_ptr<ResourceNode> node;
+
+        Operation(Type t, const std::string& p, const std::string& k) : type(t), path(p), key(k) {}
+    };
+
+    std::vector<Operation> operations_;
+};
+
+} // namespace resource
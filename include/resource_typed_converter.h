@@ -0,0 +1,177 @@
+#pragma once
+
+#include "resource_registry.h"
+#include <array>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+
+namespace resource {
+
+// 结构体字段：成员指针作为模板参数，读取在编译期展开，成员类型与M不符时编译失败
+template<typename T, typename M, M T::*Member>
+struct StructField {
+    typedef T Struct;
+    typedef M Type;
+
+    static const M& get(const T& obj) { return obj.*Member; }
+};
+
+// RESOURCE_STRUCT_FIELD(Track, speed) 即 StructField<Track, double, &Track::speed>
+#define RESOURCE_STRUCT_FIELD(Struct, member) \
+    ::resource::StructField<Struct, decltype(Struct::member), &Struct::member>
+
+namespace detail {
+
+template<typename... Keys>
+struct AllStrings : std::true_type {};
+
+template<typename Key, typename... Rest>
+struct AllStrings<Key, Rest...>
+    : std::integral_constant<bool, std::is_convertible<Key, std::string>::value && AllStrings<Rest...>::value> {};
+
+// 按字段列表逐个展开的写入和比较，I为字段下标（对应属性名和模式字段下标）
+template<size_t I, typename... Fields>
+struct FieldList {
+    template<typename T>
+    static void set(ResourceNode&, const T&, const std::string*, bool) {}
+
+    template<typename T>
+    static void update(ResourceNode&, const T&, const std::string*, bool, AttributeChanges&) {}
+
+    static void addTo(NodeSchema&, const std::string*) {}
+
+    static bool matches(const NodeSchema&, const std::string*) { return true; }
+};
+
+template<size_t I, typename Field, typename... Rest>
+struct FieldList<I, Field, Rest...> {
+    typedef typename Field::Type Type;
+
+    template<typename T>
+    static void set(ResourceNode& node, const T& obj, const std::string* keys, bool bound) {
+        static_assert(std::is_same<typename Field::Struct, T>::value, "Field must belong to the converted struct");
+        if (bound) {
+            node.setField<Type>(I, Field::get(obj));
+        } else {
+            node.setAttribute<Type>(keys[I], Field::get(obj));
+        }
+        FieldList<I + 1, Rest...>::set(node, obj, keys, bound);
+    }
+
+    // 值未变化的字段跳过，变化的字段记下旧值
+    template<typename T>
+    static void update(ResourceNode& node, const T& obj, const std::string* keys, bool bound,
+                       AttributeChanges& changes) {
+        const Type& value = Field::get(obj);
+        if (bound) {
+            const Type& current = node.getField<Type>(I);
+            if (!detail::valueEquals(current, value)) {
+                std::unique_ptr<AttributeValue> oldValue(new TypedAttributeValue<Type>(current));
+                node.setField<Type>(I, value);
+                changes.push_back(std::make_pair(&keys[I], std::move(oldValue)));
+            }
+        } else {
+            const Type* current = node.tryGetAttribute<Type>(keys[I]);
+            if (!current || !detail::valueEquals(*current, value)) {
+                auto oldValue = node.exchangeAttributeRaw(
+                    keys[I], std::unique_ptr<AttributeValue>(new TypedAttributeValue<Type>(value)));
+                changes.push_back(std::make_pair(&keys[I], std::move(oldValue)));
+            }
+        }
+        FieldList<I + 1, Rest...>::update(node, obj, keys, bound, changes);
+    }
+
+    static void addTo(NodeSchema& schema, const std::string* keys) {
+        schema.addField<Type>(keys[I]);
+        FieldList<I + 1, Rest...>::addTo(schema, keys);
+    }
+
+    static bool matches(const NodeSchema& schema, const std::string* keys) {
+        return schema.field(I).name == keys[I] && schema.field(I).tag == detail::typeTag<Type>() &&
+               FieldList<I + 1, Rest...>::matches(schema, keys);
+    }
+};
+
+} // namespace detail
+
+// 由字段列表在编译期生成的转换器：IdField给出节点ID（须为std::string成员），Fields依次为各属性，
+// 属性名在构造时按字段顺序给出，个数不符时编译失败
+//
+//   TypedConverter<Track, RESOURCE_STRUCT_FIELD(Track, id),
+//                  RESOURCE_STRUCT_FIELD(Track, tick), RESOURCE_STRUCT_FIELD(Track, speed)>
+//       converter("tick", "speed");
+//
+// 转换和增量更新对每个字段直接读取成员、按类型写入属性，没有按字段的虚调用和类型转换；
+// 作为StructConverter传给registerStruct/registerDynamicStruct等接口时，每个对象只有一次虚调用
+// 用useSchema绑定由makeSchema生成的模式后，节点的属性按模式字段下标直接读写，省去属性名查找
+// 转换得到的节点没有子节点，动态更新（包括TickPipeline的合并）时只更新属性，不改动节点上另行添加的子节点
+template<typename T, typename IdField, typename... Fields>
+class TypedConverter : public StructConverter {
+public:
+    static const size_t FIELD_COUNT = sizeof...(Fields);
+
+    static_assert(std::is_same<typename IdField::Struct, T>::value, "ID field must belong to the converted struct");
+    static_assert(std::is_same<typename IdField::Type, std::string>::value, "ID field must be a std::string member");
+
+    template<typename... Keys, typename = typename std::enable_if<detail::AllStrings<Keys...>::value>::type>
+    explicit TypedConverter(Keys&&... keys) : keys_{{std::string(std::forward<Keys>(keys))...}} {
+        static_assert(sizeof...(Keys) == sizeof...(Fields), "Each field needs exactly one attribute key");
+    }
+
+    const std::string& key(size_t index) const { return keys_.at(index); }
+
+    // 按字段列表生成模式（字段名为属性名，类型为成员类型，默认值为值初始化）
+    std::shared_ptr<NodeSchema> makeSchema(const std::string& schemaName) const {
+        auto schema = std::make_shared<NodeSchema>(schemaName);
+        detail::FieldList<0, Fields...>::addTo(*schema, keys_.data());
+        return schema;
+    }
+
+    // 此后转换出的节点绑定schema；schema的字段须与字段列表逐个对应，否则抛出std::invalid_argument
+    void useSchema(std::shared_ptr<const NodeSchema> schema) {
+        if (schema && (schema->fieldCount() != FIELD_COUNT ||
+                       !detail::FieldList<0, Fields...>::matches(*schema, keys_.data()))) {
+            throw std::invalid_argument("Schema " + schema->getName() + " does not match the converter fields");
+        }
+        schema_ = schema;
+    }
+
+    const std::shared_ptr<const NodeSchema>& getSchema() const { return schema_; }
+
+    std::shared_ptr<ResourceNode> convertTyped(const T& obj, const std::string& nodeName) const {
+        auto node = schema_ ? std::make_shared<ResourceNode>(nodeName, IdField::get(obj), schema_)
+                            : std::make_shared<ResourceNode>(nodeName, IdField::get(obj));
+        detail::FieldList<0, Fields...>::set(*node, obj, keys_.data(), schema_ != nullptr);
+        return node;
+    }
+
+    // 把obj的当前值写入node，返回值有变化的属性及旧值
+    void updateTyped(const T& obj, ResourceNode& node, AttributeChanges& changes) const {
+        const bool bound = schema_ && node.getSchema() == schema_;
+        detail::FieldList<0, Fields...>::update(node, obj, keys_.data(), bound, changes);
+    }
+
+    std::shared_ptr<ResourceNode> convert(const void* structPtr, const std::string& nodeName) const override {
+        return convertTyped(*static_cast<const T*>(structPtr), nodeName);
+    }
+
+    bool updateInPlace(const void* structPtr, ResourceNode& node, AttributeChanges& changes) const override {
+        updateTyped(*static_cast<const T*>(structPtr), node, changes);
+        return true;
+    }
+
+    bool updatesInPlace() const override { return true; }
+
+    StructConverter* clone() const override { return new TypedConverter(*this); }
+
+private:
+    std::array<std::string, FIELD_COUNT> keys_;
+    std::shared_ptr<const NodeSchema> schema_;
+};
+
+template<typename T, typename IdField, typename... Fields>
+const size_t TypedConverter<T, IdField, Fields...>::FIELD_COUNT;
+
+} // namespace resource
@@ -0,0 +1,339 @@
+#include "resource_bitmap.h"
+#include "resource_memory.h"
+#include <algorithm>
+#include <bitset>
+#include <iterator>
+
+namespace resource {
+
+const size_t RoaringBitmap::ARRAY_LIMIT;
+const size_t RoaringBitmap::BITSET_WORDS;
+
+unsigned RoaringBitmap::lowestBit(uint64_t bits) {
+#if defined(__GNUC__)
+    return static_cast<unsigned>(__builtin_ctzll(bits));
+#else
+    unsigned bit = 0;
+    while ((bits & 1) == 0) {
+        bits >>= 1;
+        ++bit;
+    }
+    return bit;
+#endif
+}
+
+size_t RoaringBitmap::popcount(uint64_t bits) {
+    return std::bitset<64>(bits).count();
+}
+
+void RoaringBitmap::toBitset(Container& container) {
+    container.bits.assign(BITSET_WORDS, 0);
+    for (uint16_t low : container.values) {
+        container.bits[low >> 6] |= uint64_t(1) << (low & 63);
+    }
+    std::vector<uint16_t>().swap(container.values);
+}
+
+void RoaringBitmap::toArray(Container& container) {
+    container.values.clear();
+    container.values.reserve(container.count);
+    for (size_t word = 0; word < container.bits.size(); ++word) {
+        uint64_t bits = container.bits[word];
+        while (bits != 0) {
+            container.values.push_back(static_cast<uint16_t>(word * 64 + lowestBit(bits)));
+            bits &= bits - 1;
+        }
+    }
+    std::vector<uint64_t>().swap(container.bits);
+}
+
+void RoaringBitmap::normalize(Container& container) {
+    if (container.bits.empty()) {
+        if (container.values.size() > ARRAY_LIMIT) {
+            toBitset(container);
+        }
+    } else if (container.count <= ARRAY_LIMIT) {
+        toArray(container);
+    }
+}
+
+size_t RoaringBitmap::lowerBound(uint16_t key) const {
+    size_t low = 0;
+    size_t high = containers_.size();
+    while (low < high) {
+        size_t mid = (low + high) / 2;
+        if (containers_[mid].key < key) {
+            low = mid + 1;
+        } else {
+            high = mid;
+        }
+    }
+    return low;
+}
+
+void RoaringBitmap::add(uint32_t value) {
+    const uint16_t key = static_cast<uint16_t>(value >> 16);
+    const uint16_t low = static_cast<uint16_t>(value & 0xFFFF);
+    size_t pos = lowerBound(key);
+    if (pos == containers_.size() || containers_[pos].key != key) {
+        Container container;
+        container.key = key;
+        containers_.insert(containers_.begin() + pos, container);
+    }
+
+    Container& container = containers_[pos];
+    if (!container.bits.empty()) {
+        uint64_t& word = container.bits[low >> 6];
+        const uint64_t mask = uint64_t(1) << (low & 63);
+        if ((word & mask) == 0) {
+            word |= mask;
+            ++container.count;
+        }
+        return;
+    }
+    auto it = std::lower_bound(container.values.begin(), container.values.end(), low);
+    if (it != container.values.end() && *it == low) {
+        return;
+    }
+    container.values.insert(it, low);
+    ++container.count;
+    normalize(container);
+}
+
+bool RoaringBitmap::remove(uint32_t value) {
+    const uint16_t key = static_cast<uint16_t>(value >> 16);
+    const uint16_t low = static_cast<uint16_t>(value & 0xFFFF);
+    size_t pos = lowerBound(key);
+    if (pos == containers_.size() || containers_[pos].key != key) {
+        return false;
+    }
+
+    Container& container = containers_[pos];
+    if (!container.bits.empty()) {
+        uint64_t& word = container.bits[low >> 6];
+        const uint64_t mask = uint64_t(1) << (low & 63);
+        if ((word & mask) == 0) {
+            return false;
+        }
+        word &= ~mask;
+        --container.count;
+    } else {
+        auto it = std::lower_bound(container.values.begin(), container.values.end(), low);
+        if (it == container.values.end() || *it != low) {
+            return false;
+        }
+        container.values.erase(it);
+        --container.count;
+    }
+
+    if (container.count == 0) {
+        containers_.erase(containers_.begin() + pos);
+    } else {
+        normalize(container);
+    }
+    return true;
+}
+
+bool RoaringBitmap::contains(uint32_t value) const {
+    const uint16_t key = static_cast<uint16_t>(value >> 16);
+    const uint16_t low = static_cast<uint16_t>(value & 0xFFFF);
+    size_t pos = lowerBound(key);
+    if (pos == containers_.size() || containers_[pos].key != key) {
+        return false;
+    }
+    const Container& container = containers_[pos];
+    if (!container.bits.empty()) {
+        return (container.bits[low >> 6] >> (low & 63)) & 1;
+    }
+    return std::binary_search(container.values.begin(), container.values.end(), low);
+}
+
+size_t RoaringBitmap::cardinality() const {
+    size_t count = 0;
+    for (const auto& container : containers_) {
+        count += container.count;
+    }
+    return count;
+}
+
+RoaringBitmap::Container RoaringBitmap::intersect(const Container& a, const Container& b) {
+    Container result;
+    result.key = a.key;
+    if (!a.bits.empty() && !b.bits.empty()) {
+        result.bits.resize(BITSET_WORDS);
+        for (size_t i = 0; i < BITSET_WORDS; ++i) {
+            result.bits[i] = a.bits[i] & b.bits[i];
+            result.count += popcount(result.bits[i]);
+        }
+    } else if (a.bits.empty() && b.bits.empty()) {
+        std::set_intersection(a.values.begin(), a.values.end(), b.values.begin(), b.values.end(),
+                              std::back_inserter(result.values));
+        result.count = result.values.size();
+    } else {
+        // 数组块逐个检查位集块中的位
+        const Container& array = a.bits.empty() ? a : b;
+        const Container& bitset = a.bits.empty() ? b : a;
+        for (uint16_t low : array.values) {
+            if ((bitset.bits[low >> 6] >> (low & 63)) & 1) {
+                result.values.push_back(low);
+            }
+        }
+        result.count = result.values.size();
+    }
+    normalize(result);
+    return result;
+}
+
+RoaringBitmap::Container RoaringBitmap::unite(const Container& a, const Container& b) {
+    Container result;
+    result.key = a.key;
+    if (a.bits.empty() && b.bits.empty()) {
+        std::set_union(a.values.begin(), a.values.end(), b.values.begin(), b.values.end(),
+                       std::back_inserter(result.values));
+        result.count = result.values.size();
+        normalize(result);
+        return result;
+    }
+
+    if (!a.bits.empty() && !b.bits.empty()) {
+        result.bits.resize(BITSET_WORDS);
+        for (size_t i = 0; i < BITSET_WORDS; ++i) {
+            result.bits[i] = a.bits[i] | b.bits[i];
+        }
+    } else {
+        const Container& array = a.bits.empty() ? a : b;
+        const Container& bitset = a.bits.empty() ? b : a;
+        result.bits = bitset.bits;
+        for (uint16_t low : array.values) {
+            result.bits[low >> 6] |= uint64_t(1) << (low & 63);
+        }
+    }
+    for (uint64_t word : result.bits) {
+        result.count += popcount(word);
+    }
+    return result;
+}
+
+RoaringBitmap::Container RoaringBitmap::subtract(const Container& a, const Container& b) {
+    Container result;
+    result.key = a.key;
+    if (a.bits.empty()) {
+        if (b.bits.empty()) {
+            std::set_difference(a.values.begin(), a.values.end(), b.values.begin(), b.values.end(),
+                                std::back_inserter(result.values));
+        } else {
+            for (uint16_t low : a.values) {
+                if (((b.bits[low >> 6] >> (low & 63)) & 1) == 0) {
+                    result.values.push_back(low);
+                }
+            }
+        }
+        result.count = result.values.size();
+        return result;
+    }
+
+    result.bits = a.bits;
+    if (b.bits.empty()) {
+        for (uint16_t low : b.values) {
+            result.bits[low >> 6] &= ~(uint64_t(1) << (low & 63));
+        }
+    } else {
+        for (size_t i = 0; i < BITSET_WORDS; ++i) {
+            result.bits[i] &= ~b.bits[i];
+        }
+    }
+    for (uint64_t word : result.bits) {
+        result.count += popcount(word);
+    }
+    normalize(result);
+    return result;
+}
+
+RoaringBitmap& RoaringBitmap::operator&=(const RoaringBitmap& other) {
+    std::vector<Container> result;
+    size_t i = 0;
+    size_t j = 0;
+    while (i < containers_.size() && j < other.containers_.size()) {
+        if (containers_[i].key < other.containers_[j].key) {
+            ++i;
+        } else if (other.containers_[j].key < containers_[i].key) {
+            ++j;
+        } else {
+            Container merged = intersect(containers_[i], other.containers_[j]);
+            if (merged.count > 0) {
+                result.push_back(std::move(merged));
+            }
+            ++i;
+            ++j;
+        }
+    }
+    containers_.swap(result);
+    return *this;
+}
+
+RoaringBitmap& RoaringBitmap::operator|=(const RoaringBitmap& other) {
+    std::vector<Container> result;
+    result.reserve(containers_.size() + other.containers_.size());
+    size_t i = 0;
+    size_t j = 0;
+    while (i < containers_.size() || j < other.containers_.size()) {
+        if (j == other.containers_.size() ||
+            (i < containers_.size() && containers_[i].key < other.containers_[j].key)) {
+            result.push_back(std::move(containers_[i++]));
+        } else if (i == containers_.size() || other.containers_[j].key < containers_[i].key) {
+            result.push_back(other.containers_[j++]);
+        } else {
+            result.push_back(unite(containers_[i], other.containers_[j]));
+            ++i;
+            ++j;
+        }
+    }
+    containers_.swap(result);
+    return *this;
+}
+
+RoaringBitmap& RoaringBitmap::operator-=(const RoaringBitmap& other) {
+    std::vector<Container> result;
+    result.reserve(containers_.size());
+    size_t j = 0;
+    for (size_t i = 0; i < containers_.size(); ++i) {
+        while (j < other.containers_.size() && other.containers_[j].key < containers_[i].key) {
+            ++j;
+        }
+        if (j < other.containers_.size() && other.containers_[j].key == containers_[i].key) {
+            Container merged = subtract(containers_[i], other.containers_[j]);
+            if (merged.count > 0) {
+                result.push_back(std::move(merged));
+            }
+        } else {
+            result.push_back(std::move(containers_[i]));
+        }
+    }
+    containers_.swap(result);
+    return *this;
+}
+
+bool RoaringBitmap::operator==(const RoaringBitmap& other) const {
+    if (containers_.size() != other.containers_.size()) {
+        return false;
+    }
+    // 存储方式只取决于元素个数，相同的集合表示也相同
+    for (size_t i = 0; i < containers_.size(); ++i) {
+        const Container& a = containers_[i];
+        const Container& b = other.containers_[i];
+        if (a.key != b.key || a.count != b.count || a.values != b.values || a.bits != b.bits) {
+            return false;
+        }
+    }
+    return true;
+}
+
+size_t RoaringBitmap::memoryBytes() const {
+    size_t bytes = detail::vectorBytes(containers_);
+    for (const auto& container : containers_) {
+        bytes += detail::vectorBytes(container.values) + detail::vectorBytes(container.bits);
+    }
+    return bytes;
+}
+
+} // namespace resource
@@ -0,0 +1,407 @@
+#include "resource_changelog.h"
+#include "resource_registry.h"
+#include "resource_serialization.h"
+#include <fstream>
+#include <iterator>
+#include <stdexcept>
+
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+namespace resource {
+
+namespace {
+
+const char SNAPSHOT_MAGIC[8] = {'R', 'M', 'S', 'N', 'A', 'P', '0', '1'};
+
+FILE* openFile(const std::string& path, const char* mode) {
+#ifdef _WIN32
+    FILE* file = nullptr;
+    if (fopen_s(&file, path.c_str(), mode) != 0) {
+        return nullptr;
+    }
+    return file;
+#else
+    return std::fopen(path.c_str(), mode);
+#endif
+}
+
+bool fsyncFile(FILE* file) {
+#ifdef _WIN32
+    return _commit(_fileno(file)) == 0;
+#else
+    return fsync(fileno(file)) == 0;
+#endif
+}
+
+bool readWholeFile(const std::string& path, std::string& content) {
+    std::ifstream in(path.c_str(), std::ios::binary);
+    if (!in) {
+        return false;
+    }
+    content.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+    return true;
+}
+
+// 应用单条日志记录
+bool applyRecord(BinaryReader& reader, ResourceRegistry& registry) {
+    auto type = static_cast<ChangeRecordType>(reader.readU8());
+    switch (type) {
+        case ChangeRecordType::SET_ATTRIBUTE: {
+            std::string path = reader.readString();
+            std::string key = reader.readString();
+            auto value = decodeAttributeValue(reader);
+            auto node = registry.getNodeByPath(path);
+            if (!value || !node) return false;
+            node->updateAttributeRaw(key, std::move(value));
+            return true;
+        }
+        case ChangeRecordType::REMOVE_ATTRIBUTE: {
+            std::string path = reader.readString();
+            std::string key = reader.readString();
+            auto node = registry.getNodeByPath(path);
+            if (!reader.ok() || !node) return false;
+            node->removeAttribute(key);
+            return true;
+        }
+        case ChangeRecordType::REGISTER_NODE: {
+            std::string parentPath = reader.readString();
+            auto node = decodeNode(reader);
+            if (!node) return false;
+            try {
+                if (parentPath.empty()) {
+                    return registry.registerRootNode(node);
+                }
+                auto parent = registry.getNodeByPath(parentPath);
+                if (!parent) return false;
+                parent->addChild(node);
+                return true;
+            } catch (const std::exception&) {
+                return false;
+            }
+        }
+        case ChangeRecordType::REMOVE_NODE: {
+            std::string path = reader.readString();
+            return reader.ok() && registry.removeNodeByPath(path);
+        }
+        case ChangeRecordType::COMMIT:
+            return true;
+        default:
+            return false;
+    }
+}
+
+} // namespace
+
+ChangeLog::ChangeLog(const std::string& filePath, const ChangeLogOptions& options)
+    : filePath_(filePath),
+      options_(options),
+      file_(openFile(filePath, "ab")),
+      appendedSeq_(0),
+      writtenSeq_(0),
+      syncedSeq_(0),
+      syncRequested_(false),
+      stop_(false),
+      lastFsync_(std::chrono::steady_clock::now()) {
+    if (!file_) {
+        throw std::runtime_error("Cannot open change log: " + filePath);
+    }
+    pending_.reserve(options_.batchBytes);
+    spare_.reserve(options_.batchBytes);
+    flusher_ = std::thread(&ChangeLog::flusherLoop, this);
+}
+
+ChangeLog::~ChangeLog() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stop_ = true;
+        syncRequested_ = true;
+    }
+    flushCond_.notify_one();
+    if (flusher_.joinable()) {
+        flusher_.join();
+    }
+    if (file_) {
+        std::fclose(file_);
+    }
+}
+
+uint64_t ChangeLog::append(const std::string& payload) {
+    // CRC在锁外计算，锁内只做内存拷贝
+    uint32_t checksum = crc32(payload.data(), payload.size());
+
+    std::unique_lock<std::mutex> lock(mutex_);
+    if (!writeError_.empty()) {
+        return 0;
+    }
+    BinaryWriter writer(pending_);
+    writer.writeU32(static_cast<uint32_t>(payload.size()));
+    writer.writeU32(checksum);
+    writer.writeBytes(payload.data(), payload.size());
+    uint64_t seq = ++appendedSeq_;
+    bool wake = pending_.size() >= options_.batchBytes;
+    lock.unlock();
+
+    if (wake) {
+        flushCond_.notify_one();
+    }
+    return seq;
+}
+
+uint64_t ChangeLog::logSetAttribute(const std::string& nodePath, const std::string& key, const AttributeValue& value) {
+    std::string payload;
+    BinaryWriter writer(payload);
+    writer.writeU8(static_cast<uint8_t>(ChangeRecordType::SET_ATTRIBUTE));
+    writer.writeString(nodePath);
+    writer.writeString(key);
+    if (!encodeAttributeValue(writer, value)) {
+        return 0;
+    }
+    return append(payload);
+}
+
+uint64_t ChangeLog::logRemoveAttribute(const std::string& nodePath, const std::string& key) {
+    std::string payload;
+    BinaryWriter writer(payload);
+    writer.writeU8(static_cast<uint8_t>(ChangeRecordType::REMOVE_ATTRIBUTE));
+    writer.writeString(nodePath);
+    writer.writeString(key);
+    return append(payload);
+}
+
+uint64_t ChangeLog::logRegisterNode(const std::string& parentPath, const ResourceNode& node) {
+    std::string payload;
+    BinaryWriter writer(payload);
+    writer.writeU8(static_cast<uint8_t>(ChangeRecordType::REGISTER_NODE));
+    writer.writeString(parentPath);
+    encodeNode(writer, node);
+    return append(payload);
+}
+
+uint64_t ChangeLog::logRemoveNode(const std::string& path) {
+    std::string payload;
+    BinaryWriter writer(payload);
+    writer.writeU8(static_cast<uint8_t>(ChangeRecordType::REMOVE_NODE));
+    writer.writeString(path);
+    return append(payload);
+}
+
+uint64_t ChangeLog::logCommit() {
+    std::string payload(1, static_cast<char>(ChangeRecordType::COMMIT));
+    return append(payload);
+}
+
+void ChangeLog::sync() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    uint64_t target = appendedSeq_;
+    syncRequested_ = true;
+    flushCond_.notify_one();
+    durableCond_.wait(lock, [&]() { return syncedSeq_ >= target || !writeError_.empty(); });
+    if (!writeError_.empty()) {
+        throw std::runtime_error(writeError_);
+    }
+}
+
+std::string ChangeLog::writeError() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return writeError_;
+}
+
+uint64_t ChangeLog::lastSequence() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return appendedSeq_;
+}
+
+uint64_t ChangeLog::durableSequence() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return syncedSeq_;
+}
+
+bool ChangeLog::syncFile() {
+    lastFsync_ = std::chrono::steady_clock::now();
+    return fsyncFile(file_);
+}
+
+void ChangeLog::flusherLoop() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (true) {
+        flushCond_.wait_for(lock, options_.flushInterval, [this]() {
+            return stop_ || syncRequested_ || pending_.size() >= options_.batchBytes;
+        });
+
+        // 写盘失败后不再写入：之后的记录接在缺失的记录后面，重放时会被错误地应用
+        if (!writeError_.empty()) {
+            pending_.clear();
+            syncRequested_ = false;
+            durableCond_.notify_all();
+            if (stop_) break;
+            continue;
+        }
+
+        bool forceSync = syncRequested_;
+        bool periodicPending = options_.fsyncPolicy == FsyncPolicy::PERIODIC && syncedSeq_ < writtenSeq_;
+        if (pending_.empty() && !forceSync && !periodicPending) {
+            if (stop_) break;
+            continue;
+        }
+
+        // 交换缓冲区后释放锁，写盘期间写入方可以继续追加
+        spare_.swap(pending_);
+        uint64_t batchSeq = appendedSeq_;
+        syncRequested_ = false;
+        lock.unlock();
+
+        bool synced = false;
+        bool failed = false;
+        {
+            std::lock_guard<std::mutex> fileLock(fileMutex_);
+            if (!spare_.empty()) {
+                failed = std::fwrite(spare_.data(), 1, spare_.size(), file_) != spare_.size() ||
+                         std::fflush(file_) != 0;
+            }
+
+            auto now = std::chrono::steady_clock::now();
+            if (!failed &&
+                (forceSync ||
+                 options_.fsyncPolicy == FsyncPolicy::ALWAYS ||
+                 (options_.fsyncPolicy == FsyncPolicy::PERIODIC && now - lastFsync_ >= options_.fsyncInterval))) {
+                failed = !syncFile();
+                synced = !failed;
+            }
+        }
+        spare_.clear();
+
+        lock.lock();
+        if (failed) {
+            writeError_ = "Cannot write change log: " + filePath_;
+            pending_.clear();
+        } else {
+            writtenSeq_ = batchSeq;
+            if (synced) {
+                syncedSeq_ = batchSeq;
+            }
+        }
+        durableCond_.notify_all();
+
+        if (stop_ && pending_.empty()) break;
+    }
+}
+
+bool ChangeLog::checkpoint(const ResourceRegistry& registry, const std::string& snapshotPath) {
+    sync();
+    if (!saveSnapshot(registry, snapshotPath)) {
+        return false;
+    }
+
+    // 快照已包含全部已提交的变更，截断日志
+    std::lock_guard<std::mutex> fileLock(fileMutex_);
+    std::fclose(file_);
+    file_ = openFile(filePath_, "wb");
+    if (!file_) {
+        throw std::runtime_error("Cannot reopen change log: " + filePath_);
+    }
+    syncFile();
+    return true;
+}
+
+size_t ChangeLog::replay(const std::string& logPath, ResourceRegistry& registry) {
+    std::string content;
+    if (!readWholeFile(logPath, content)) {
+        return 0;
+    }
+
+    // 重放期间暂时断开注册表上的日志，避免重复记录；记录应用失败抛出异常时同样要重新挂上
+    struct Reattach {
+        ResourceRegistry& registry;
+        std::shared_ptr<ChangeLog> changeLog;
+        ~Reattach() { registry.attachChangeLog(changeLog); }
+    } reattach = {registry, registry.detachChangeLog()};
+
+    size_t applied = 0;
+    size_t offset = 0;
+    while (offset < content.size()) {
+        BinaryReader header(content.data() + offset, content.size() - offset);
+        uint32_t length = header.readU32();
+        uint32_t checksum = header.readU32();
+        offset += header.position();
+        if (!header.ok() || content.size() - offset < length) {
+            break;  // 尾部残缺记录
+        }
+        if (crc32(content.data() + offset, length) != checksum) {
+            break;
+        }
+
+        BinaryReader record(content.data() + offset, length);
+        if (applyRecord(record, registry)) {
+            ++applied;
+        }
+        offset += length;
+    }
+    return applied;
+}
+
+bool ChangeLog::saveSnapshot(const ResourceRegistry& registry, const std::string& snapshotPath) {
+    std::string buffer(SNAPSHOT_MAGIC, sizeof(SNAPSHOT_MAGIC));
+    BinaryWriter writer(buffer);
+
+    auto roots = registry.getAllRootNodes();
+    writer.writeU32(static_cast<uint32_t>(roots.size()));
+    for (const auto& root : roots) {
+        encodeNode(writer, *root);
+    }
+    writer.writeU32(crc32(buffer.data(), buffer.size()));
+
+    // 先写临时文件再替换，避免写到一半时崩溃损坏旧快照
+    std::string tempPath = snapshotPath + ".tmp";
+    FILE* file = openFile(tempPath, "wb");
+    if (!file) {
+        return false;
+    }
+    bool ok = std::fwrite(buffer.data(), 1, buffer.size(), file) == buffer.size();
+    ok = ok && std::fflush(file) == 0;
+    fsyncFile(file);
+    std::fclose(file);
+    if (!ok) {
+        std::remove(tempPath.c_str());
+        return false;
+    }
+
+    std::remove(snapshotPath.c_str());
+    return std::rename(tempPath.c_str(), snapshotPath.c_str()) == 0;
+}
+
+bool ChangeLog::loadSnapshot(const std::string& snapshotPath, ResourceRegistry& registry) {
+    std::string content;
+    if (!readWholeFile(snapshotPath, content)) {
+        return false;
+    }
+    if (content.size() < sizeof(SNAPSHOT_MAGIC) + 8 ||
+        content.compare(0, sizeof(SNAPSHOT_MAGIC), SNAPSHOT_MAGIC, sizeof(SNAPSHOT_MAGIC)) != 0) {
+        return false;
+    }
+
+    size_t bodySize = content.size() - 4;
+    BinaryReader trailer(content.data() + bodySize, 4);
+    if (crc32(content.data(), bodySize) != trailer.readU32()) {
+        return false;
+    }
+
+    auto attached = registry.detachChangeLog();
+    registry.clear();
+
+    BinaryReader reader(content.data() + sizeof(SNAPSHOT_MAGIC), bodySize - sizeof(SNAPSHOT_MAGIC));
+    uint32_t rootCount = reader.readU32();
+    bool ok = reader.ok();
+    for (uint32_t i = 0; i < rootCount && ok; ++i) {
+        auto root = decodeNode(reader);
+        ok = root && registry.registerRootNode(root);
+    }
+
+    registry.attachChangeLog(attached);
+    return ok;
+}
+
+} // namespace resource
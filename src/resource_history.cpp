@@ -0,0 +1,513 @@
+#include "resource_history.h"
+#include "resource_memory.h"
+#include <chrono>
+#include <cstring>
+#include <stdexcept>
+
+namespace resource {
+
+namespace {
+
+const unsigned NO_WINDOW = 65;  // 还没有可复用的有效位窗口
+
+template<typename T>
+bool readNumber(const AttributeValue& value, double& out) {
+    const T* number = value.as<T>();
+    if (!number) {
+        return false;
+    }
+    out = static_cast<double>(*number);
+    return true;
+}
+
+bool readNumeric(const AttributeValue& value, double& out) {
+    return readNumber<double>(value, out) || readNumber<int>(value, out) ||
+           readNumber<float>(value, out) || readNumber<long>(value, out) ||
+           readNumber<long long>(value, out) || readNumber<unsigned>(value, out) ||
+           readNumber<unsigned long>(value, out) || readNumber<unsigned long long>(value, out) ||
+           readNumber<short>(value, out) || readNumber<unsigned short>(value, out);
+}
+
+// 节点是否属于延迟加载节点加载出的子树：这样的子树可能被LazyLoadBudget::enforce卸载，卸载不产生变更事件
+bool insideLoadedSubtree(const ResourceNode& node) {
+    for (const ResourceNode* parent = node.getParent(); parent; parent = parent->getParent()) {
+        if (parent->isLazy()) {
+            return true;
+        }
+    }
+    return false;
+}
+
+uint64_t toBits(double value) {
+    uint64_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    return bits;
+}
+
+double fromBits(uint64_t bits) {
+    double value;
+    std::memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+unsigned leadingZeros(uint64_t bits) {
+#if defined(__GNUC__)
+    return static_cast<unsigned>(__builtin_clzll(bits));
+#else
+    unsigned count = 0;
+    while ((bits & (uint64_t(1) << 63)) == 0) {
+        bits <<= 1;
+        ++count;
+    }
+    return count;
+#endif
+}
+
+unsigned trailingZeros(uint64_t bits) {
+#if defined(__GNUC__)
+    return static_cast<unsigned>(__builtin_ctzll(bits));
+#else
+    unsigned count = 0;
+    while ((bits & 1) == 0) {
+        bits >>= 1;
+        ++count;
+    }
+    return count;
+#endif
+}
+
+// 按写入顺序读取HistoryBlock的位流
+class BitReader {
+public:
+    explicit BitReader(const std::vector<uint64_t>& words) : words_(words), pos_(0) {}
+
+    uint64_t read(unsigned bits) {
+        if (bits == 0) {
+            return 0;
+        }
+        const size_t word = pos_ / 64;
+        const size_t offset = pos_ % 64;
+        uint64_t value = words_[word] >> offset;
+        if (offset + bits > 64) {
+            value |= words_[word + 1] << (64 - offset);
+        }
+        if (bits < 64) {
+            value &= (uint64_t(1) << bits) - 1;
+        }
+        pos_ += bits;
+        return value;
+    }
+
+    bool readBit() { return read(1) != 0; }
+
+    int64_t readDelta() {
+        if (!readBit()) return 0;
+        if (!readBit()) return static_cast<int64_t>(read(7)) - 63;
+        if (!readBit()) return static_cast<int64_t>(read(9)) - 255;
+        if (!readBit()) return static_cast<int64_t>(read(12)) - 2047;
+        return static_cast<int64_t>(read(64));
+    }
+
+private:
+    const std::vector<uint64_t>& words_;
+    size_t pos_;
+};
+
+} // namespace
+
+void HistoryBlock::clear() {
+    words_.clear();
+    bitCount_ = 0;
+    count_ = 0;
+    first_ = HistorySample();
+    last_ = HistorySample();
+    tickDelta_ = 0;
+    timeDelta_ = 0;
+    leading_ = NO_WINDOW;
+    trailing_ = 0;
+}
+
+void HistoryBlock::writeBits(uint64_t value, unsigned bits) {
+    if (bits == 0) {
+        return;
+    }
+    if (bits < 64) {
+        value &= (uint64_t(1) << bits) - 1;
+    }
+    const size_t offset = bitCount_ % 64;
+    if (offset == 0) {
+        words_.push_back(0);
+    }
+    words_.back() |= value << offset;
+    if (offset + bits > 64) {
+        words_.push_back(value >> (64 - offset));
+    }
+    bitCount_ += bits;
+}
+
+// 二阶差分：0 -> '0'，[-63,64] -> '10'+7位，[-255,256] -> '110'+9位，[-2047,2048] -> '1110'+12位，其余 -> '1111'+64位
+void HistoryBlock::writeDelta(int64_t deltaOfDelta) {
+    if (deltaOfDelta == 0) {
+        writeBits(0, 1);
+    } else if (deltaOfDelta >= -63 && deltaOfDelta <= 64) {
+        writeBits(0x1, 2);
+        writeBits(static_cast<uint64_t>(deltaOfDelta + 63), 7);
+    } else if (deltaOfDelta >= -255 && deltaOfDelta <= 256) {
+        writeBits(0x3, 3);
+        writeBits(static_cast<uint64_t>(deltaOfDelta + 255), 9);
+    } else if (deltaOfDelta >= -2047 && deltaOfDelta <= 2048) {
+        writeBits(0x7, 4);
+        writeBits(static_cast<uint64_t>(deltaOfDelta + 2047), 12);
+    } else {
+        writeBits(0xF, 4);
+        writeBits(static_cast<uint64_t>(deltaOfDelta), 64);
+    }
+}
+
+// 与前一个值的异或：相同 -> '0'；有效位落在上一个窗口内 -> '10'+窗口内的位；
+// 否则 -> '11'+5位前导零个数+6位有效位长度+有效位
+void HistoryBlock::writeValue(uint64_t bits) {
+    const uint64_t xorBits = bits ^ toBits(last_.value);
+    if (xorBits == 0) {
+        writeBits(0, 1);
+        return;
+    }
+    writeBits(1, 1);
+    unsigned leading = leadingZeros(xorBits);
+    const unsigned trailing = trailingZeros(xorBits);
+    if (leading_ != NO_WINDOW && leading >= leading_ && trailing >= trailing_) {
+        writeBits(0, 1);
+        writeBits(xorBits >> trailing_, 64 - leading_ - trailing_);
+        return;
+    }
+    if (leading > 31) {
+        leading = 31;  // 前导零个数只有5位
+    }
+    const unsigned meaningful = 64 - leading - trailing;
+    writeBits(1, 1);
+    writeBits(leading, 5);
+    writeBits(meaningful - 1, 6);
+    writeBits(xorBits >> trailing, meaningful);
+    leading_ = leading;
+    trailing_ = trailing;
+}
+
+void HistoryBlock::append(const HistorySample& sample) {
+    if (count_ == 0) {
+        writeBits(sample.tick, 64);
+        writeBits(static_cast<uint64_t>(sample.timestamp), 64);
+        writeBits(toBits(sample.value), 64);
+        first_ = sample;
+    } else {
+        const int64_t tickDelta = static_cast<int64_t>(sample.tick - last_.tick);
+        const int64_t timeDelta = sample.timestamp - last_.timestamp;
+        writeDelta(tickDelta - tickDelta_);
+        writeDelta(timeDelta - timeDelta_);
+        writeValue(toBits(sample.value));
+        tickDelta_ = tickDelta;
+        timeDelta_ = timeDelta;
+    }
+    last_ = sample;
+    ++count_;
+}
+
+void HistoryBlock::decode(std::vector<HistorySample>& out,
+                          const std::function<bool(const HistorySample&)>& filter) const {
+    if (count_ == 0) {
+        return;
+    }
+    BitReader reader(words_);
+    HistorySample sample;
+    sample.tick = reader.read(64);
+    sample.timestamp = static_cast<int64_t>(reader.read(64));
+    uint64_t valueBits = reader.read(64);
+    sample.value = fromBits(valueBits);
+    if (filter(sample)) {
+        out.push_back(sample);
+    }
+
+    int64_t tickDelta = 0;
+    int64_t timeDelta = 0;
+    unsigned leading = 0;
+    unsigned trailing = 0;
+    for (size_t i = 1; i < count_; ++i) {
+        tickDelta += reader.readDelta();
+        timeDelta += reader.readDelta();
+        sample.tick += static_cast<uint64_t>(tickDelta);
+        sample.timestamp += timeDelta;
+        if (reader.readBit()) {
+            if (reader.readBit()) {
+                leading = static_cast<unsigned>(reader.read(5));
+                trailing = 64 - leading - (static_cast<unsigned>(reader.read(6)) + 1);
+            }
+            valueBits ^= reader.read(64 - leading - trailing) << trailing;
+            sample.value = fromBits(valueBits);
+        }
+        if (filter(sample)) {
+            out.push_back(sample);
+        }
+    }
+}
+
+const size_t HistorySeries::BLOCK_SAMPLES;
+
+HistorySeries::HistorySeries(size_t capacity) : oldest_(0), used_(0) {
+    if (capacity == 0) {
+        throw std::invalid_argument("History capacity must be positive");
+    }
+    blockSamples_ = capacity < BLOCK_SAMPLES ? capacity : BLOCK_SAMPLES;
+    // 多留一个块，淘汰最旧的块后仍保留至少capacity个样本
+    blocks_.resize((capacity + blockSamples_ - 1) / blockSamples_ + 1);
+}
+
+void HistorySeries::append(const HistorySample& sample) {
+    if (used_ == 0) {
+        used_ = 1;
+    } else if (blocks_[(oldest_ + used_ - 1) % blocks_.size()].size() >= blockSamples_) {
+        if (used_ < blocks_.size()) {
+            ++used_;
+        } else {
+            oldest_ = (oldest_ + 1) % blocks_.size();
+        }
+        blocks_[(oldest_ + used_ - 1) % blocks_.size()].clear();
+    }
+    blocks_[(oldest_ + used_ - 1) % blocks_.size()].append(sample);
+}
+
+void HistorySeries::read(std::vector<HistorySample>& out,
+                         const std::function<bool(const HistoryBlock&)>& overlaps,
+                         const std::function<bool(const HistorySample&)>& filter) const {
+    for (size_t i = 0; i < used_; ++i) {
+        const HistoryBlock& block = blocks_[(oldest_ + i) % blocks_.size()];
+        if (!block.empty() && overlaps(block)) {
+            block.decode(out, filter);
+        }
+    }
+}
+
+void HistorySeries::readTicks(uint64_t fromTick, uint64_t toTick, std::vector<HistorySample>& out) const {
+    read(out,
+         [&](const HistoryBlock& block) { return block.last().tick >= fromTick && block.first().tick <= toTick; },
+         [&](const HistorySample& sample) { return sample.tick >= fromTick && sample.tick <= toTick; });
+}
+
+void HistorySeries::readTimes(int64_t fromTime, int64_t toTime, std::vector<HistorySample>& out) const {
+    read(out,
+         [&](const HistoryBlock& block) {
+             return block.last().timestamp >= fromTime && block.first().timestamp <= toTime;
+         },
+         [&](const HistorySample& sample) { return sample.timestamp >= fromTime && sample.timestamp <= toTime; });
+}
+
+size_t HistorySeries::size() const {
+    size_t count = 0;
+    for (size_t i = 0; i < used_; ++i) {
+        count += blocks_[(oldest_ + i) % blocks_.size()].size();
+    }
+    return count;
+}
+
+const HistorySample* HistorySeries::latest() const {
+    if (used_ == 0) {
+        return nullptr;
+    }
+    return &blocks_[(oldest_ + used_ - 1) % blocks_.size()].last();
+}
+
+size_t HistorySeries::memoryBytes() const {
+    size_t bytes = detail::vectorBytes(blocks_);
+    for (const auto& block : blocks_) {
+        bytes += block.memoryBytes();
+    }
+    return bytes;
+}
+
+AttributeHistory::AttributeHistory(ResourceRegistry& registry)
+    : registry_(registry), tick_(0) {
+    clock_ = []() {
+        return static_cast<int64_t>(std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::system_clock::now().time_since_epoch()).count());
+    };
+    registry_.addChangeListener(this);
+}
+
+AttributeHistory::~AttributeHistory() {
+    registry_.removeChangeListener(this);
+}
+
+void AttributeHistory::track(const std::string& attrName, size_t capacity) {
+    if (capacity == 0) {
+        throw std::invalid_argument("History capacity must be positive: " + attrName);
+    }
+    auto it = tracked_.find(attrName);
+    if (it == tracked_.end()) {
+        // 空闲槽位之外的槽位都在使用，下一个新槽位即为已跟踪的属性数
+        TrackedAttribute attr;
+        attr.slot = tracked_.size();
+        if (!freeSlots_.empty()) {
+            attr.slot = freeSlots_.back();
+            freeSlots_.pop_back();
+        }
+        it = tracked_.insert(std::make_pair(attrName, attr)).first;
+    }
+    it->second.capacity = capacity;
+    const size_t slot = it->second.slot;
+    for (auto& entry : nodes_) {
+        if (slot < entry.second.series.size()) {
+            entry.second.series[slot].reset();
+        }
+    }
+
+    ++tick_;
+    const int64_t timestamp = clock_();
+    const TrackedAttribute& attr = it->second;
+    registry_.traverseNodes([&](std::shared_ptr<ResourceNode> node) {
+        if (insideLoadedSubtree(*node)) {
+            return;
+        }
+        if (const AttributeValue* value = node->findAttribute(attrName)) {
+            record(*node, attr, *value, timestamp);
+        }
+    });
+}
+
+void AttributeHistory::untrack(const std::string& attrName) {
+    auto it = tracked_.find(attrName);
+    if (it == tracked_.end()) {
+        return;
+    }
+    const size_t slot = it->second.slot;
+    for (auto& entry : nodes_) {
+        if (slot < entry.second.series.size()) {
+            entry.second.series[slot].reset();
+        }
+    }
+    freeSlots_.push_back(slot);
+    tracked_.erase(it);
+}
+
+const HistorySeries* AttributeHistory::findSeries(const ResourceNode& node, const std::string& attrName) const {
+    auto attr = tracked_.find(attrName);
+    auto entry = nodes_.find(&node);
+    if (attr == tracked_.end() || entry == nodes_.end() || attr->second.slot >= entry->second.series.size()) {
+        return nullptr;
+    }
+    return entry->second.series[attr->second.slot].get();
+}
+
+std::vector<HistorySample> AttributeHistory::history(const ResourceNode& node, const std::string& attrName,
+                                                     uint64_t fromTick, uint64_t toTick) const {
+    std::vector<HistorySample> samples;
+    if (const HistorySeries* series = findSeries(node, attrName)) {
+        series->readTicks(fromTick, toTick, samples);
+    }
+    return samples;
+}
+
+std::vector<HistorySample> AttributeHistory::historyByTime(const ResourceNode& node, const std::string& attrName,
+                                                           int64_t fromTime, int64_t toTime) const {
+    std::vector<HistorySample> samples;
+    if (const HistorySeries* series = findSeries(node, attrName)) {
+        series->readTimes(fromTime, toTime, samples);
+    }
+    return samples;
+}
+
+std::vector<HistorySample> AttributeHistory::history(const ResourceNode& node, const std::string& attrName) const {
+    return history(node, attrName, 0, UINT64_MAX);
+}
+
+void AttributeHistory::record(const ResourceNode& node, const TrackedAttribute& attr, const AttributeValue& value,
+                              int64_t timestamp) {
+    double number = 0.0;
+    if (!readNumeric(value, number)) {
+        return;
+    }
+    NodeHistory& entry = nodes_[&node];
+    if (entry.series.size() <= attr.slot) {
+        entry.series.resize(attr.slot + 1);
+    }
+    std::unique_ptr<HistorySeries>& series = entry.series[attr.slot];
+    if (!series) {
+        series.reset(new HistorySeries(attr.capacity));
+    }
+    // 同一批次内的多次修改（包括新增节点后再修改）只记一个样本，取值为提交时的值
+    const HistorySample* latest = series->latest();
+    if (latest && latest->tick == tick_) {
+        return;
+    }
+    series->append(HistorySample(tick_, timestamp, number));
+}
+
+void AttributeHistory::recordSubtree(const ResourceNode& root, int64_t timestamp) {
+    for (const auto& entry : tracked_) {
+        if (const AttributeValue* value = root.findAttribute(entry.first)) {
+            record(root, entry.second, *value, timestamp);
+        }
+    }
+    if (root.isLazy()) {
+        return;
+    }
+    for (const auto& child : root.getLoadedChildren()) {
+        recordSubtree(*child, timestamp);
+    }
+}
+
+void AttributeHistory::forgetSubtree(const ResourceNode& root) {
+    nodes_.erase(&root);
+    for (const auto& child : root.getLoadedChildren()) {
+        forgetSubtree(*child);
+    }
+}
+
+void AttributeHistory::onChangesCommitted(const ChangeBatch& batch) {
+    ++tick_;
+    if (tracked_.empty()) {
+        return;
+    }
+    const int64_t timestamp = clock_();
+    for (const auto& event : batch) {
+        switch (event.type) {
+        case ChangeEvent::Type::ATTRIBUTE_CHANGED: {
+            auto attr = tracked_.find(event.key);
+            if (attr != tracked_.end() && event.node && event.newValue && !insideLoadedSubtree(*event.node)) {
+                // 读节点上的当前值，批次内后面的修改已经生效
+                const AttributeValue* current = event.node->findAttribute(event.key);
+                record(*event.node, attr->second, current ? *current : *event.newValue, timestamp);
+            }
+            break;
+        }
+        case ChangeEvent::Type::NODE_ADDED:
+            if (event.node && !insideLoadedSubtree(*event.node)) {
+                recordSubtree(*event.node, timestamp);
+            }
+            break;
+        case ChangeEvent::Type::NODE_REMOVED:
+            if (event.node) {
+                forgetSubtree(*event.node);
+            }
+            break;
+        case ChangeEvent::Type::ATTRIBUTE_REMOVED:
+            break;
+        }
+    }
+}
+
+size_t AttributeHistory::memoryBytes() const {
+    size_t bytes = detail::hashTableBytes(tracked_) + detail::hashTableBytes(nodes_) +
+                   detail::vectorBytes(freeSlots_);
+    for (const auto& entry : tracked_) {
+        bytes += detail::stringHeapBytes(entry.first);
+    }
+    for (const auto& entry : nodes_) {
+        bytes += detail::vectorBytes(entry.second.series);
+        for (const auto& series : entry.second.series) {
+            if (series) {
+                bytes += sizeof(HistorySeries) + series->memoryBytes();
+            }
+        }
+    }
+    return bytes;
+}
+
+} // namespace resource
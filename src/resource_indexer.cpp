@@ -1,32 +1,102 @@
 #include "resource_indexer.h"
 #include <algorithm>
+#include <iterator>
 
 namespace resource {
 
-ResourceIndexer::ResourceIndexer(ResourceRegistry& registry)
-    : registry_(registry) {
-    refreshIndex();
+namespace {
+
+template<typename T>
+bool readNumber(const AttributeValue& value, double& out) {
+    const T* number = value.as<T>();
+    if (!number) {
+        return false;
+    }
+    out = static_cast<double>(*number);
+    return true;
 }
 
-ResourceIndexer::~ResourceIndexer() = default;
+bool readNumeric(const AttributeValue& value, double& out) {
+    return readNumber<int>(value, out) || readNumber<double>(value, out) ||
+           readNumber<float>(value, out) || readNumber<long>(value, out) ||
+           readNumber<long long>(value, out) || readNumber<unsigned>(value, out) ||
+           readNumber<unsigned long>(value, out) || readNumber<unsigned long long>(value, out) ||
+           readNumber<short>(value, out) || readNumber<unsigned short>(value, out);
+}
 
-std::vector<std::shared_ptr<ResourceNode>> ResourceIndexer::findByName(const std::string& name) {
-    auto it = nameIndex_.find(name);
-    if (it != nameIndex_.end()) {
-        return it->second;
+// 分组键：字符串取其值，布尔取"true"/"false"
+bool readGroupKey(const AttributeValue& value, std::string& out) {
+    if (const std::string* text = value.as<std::string>()) {
+        out = *text;
+        return true;
+    }
+    if (const bool* flag = value.as<bool>()) {
+        out = *flag ? "true" : "false";
+        return true;
     }
-    return std::vector<std::shared_ptr<ResourceNode>>();
+    return false;
+}
+
+// 节点同时具有分组属性和数值属性时取出分组键和值
+bool readGroupEntry(const ResourceNode& node, const std::string& groupAttr, const std::string& valueAttr,
+                    std::string& group, double& number) {
+    const AttributeValue* groupValue = node.findAttribute(groupAttr);
+    const AttributeValue* value = node.findAttribute(valueAttr);
+    return groupValue && value && readGroupKey(*groupValue, group) && readNumeric(*value, number);
+}
+
+// 提交中受影响的节点
+struct AffectedNode {
+    std::shared_ptr<ResourceNode> node;
+    bool live;        // 批次结束后是否仍挂在注册表上
+    bool structural;  // 是否经历了增删（需要重新检查全部索引）
+
+    AffectedNode() : live(true), structural(false) {}
+};
+
+} // namespace
+
+ResourceIndexer::ResourceIndexer(ResourceRegistry& registry)
+    : registry_(registry), bitmapRows_(std::make_shared<NodeRowTable>()), queryCacheCapacity_(256) {
+    rebuildAll();
+    registry_.addChangeListener(this);
+}
+
+ResourceIndexer::~ResourceIndexer() {
+    registry_.removeChangeListener(this);
+}
+
+std::vector<std::shared_ptr<ResourceNode>> ResourceIndexer::findByName(const std::string& name) const {
+    RESOURCE_METRIC_SCOPE(registry_.getMetrics(), FindByName);
+    std::vector<std::shared_ptr<ResourceNode>> results;
+    nameIndex_.find(name, results);
+    return results;
 }
 
-std::vector<std::shared_ptr<ResourceNode>> ResourceIndexer::findById(const std::string& id) {
-    auto it = idIndex_.find(id);
-    if (it != idIndex_.end()) {
-        return {it->second};
+std::vector<std::shared_ptr<ResourceNode>> ResourceIndexer::findById(const std::string& id) const {
+    RESOURCE_METRIC_SCOPE(registry_.getMetrics(), FindById);
+    std::vector<std::shared_ptr<ResourceNode>> results;
+    std::shared_ptr<ResourceNode> node;
+    if (idIndex_.find(id, node) && node) {
+        results.push_back(node);
     }
-    return std::vector<std::shared_ptr<ResourceNode>>();
+    return results;
+}
+
+std::shared_ptr<ResourceNode> ResourceIndexer::getById(const std::string& id) const {
+    RESOURCE_METRIC_SCOPE(registry_.getMetrics(), FindById);
+    std::shared_ptr<ResourceNode> node;
+    idIndex_.find(id, node);
+    return node;
 }
 
 std::vector<std::shared_ptr<ResourceNode>> ResourceIndexer::findByPredicate(
+    const std::function<bool(const std::shared_ptr<ResourceNode>&)>& predicate) {
+    RESOURCE_METRIC_SCOPE(registry_.getMetrics(), FindByPredicate);
+    return collectMatching(predicate);
+}
+
+std::vector<std::shared_ptr<ResourceNode>> ResourceIndexer::collectMatching(
     const std::function<bool(const std::shared_ptr<ResourceNode>&)>& predicate) {
     std::vector<std::shared_ptr<ResourceNode>> results;
 
@@ -43,12 +113,18 @@ std::vector<std::shared_ptr<ResourceNode>> ResourceIndexer::findByPredicate(
 std::vector<std::shared_ptr<ResourceNode>> ResourceIndexer::findByMultiConditions(
     const std::vector<std::function<bool(const std::shared_ptr<ResourceNode>&)>>& conditions,
     bool matchAll) {
-    
+    RESOURCE_METRIC_SCOPE(registry_.getMetrics(), FindByMultiConditions);
+    return matchConditions(conditions, matchAll);
+}
+
+std::vector<std::shared_ptr<ResourceNode>> ResourceIndexer::matchConditions(
+    const std::vector<std::function<bool(const std::shared_ptr<ResourceNode>&)>>& conditions,
+    bool matchAll) {
     if (conditions.empty()) {
         return std::vector<std::shared_ptr<ResourceNode>>();
     }
 
-    return findByPredicate([&](const std::shared_ptr<ResourceNode>& node) -> bool {
+    return collectMatching([&](const std::shared_ptr<ResourceNode>& node) -> bool {
         if (matchAll) {
             // 所有条件都必须满足（AND）
             for (const auto& condition : conditions) {
@@ -69,29 +145,224 @@ std::vector<std::shared_ptr<ResourceNode>> ResourceIndexer::findByMultiCondition
     });
 }
 
+std::vector<std::shared_ptr<ResourceNode>> ResourceIndexer::findByMultiConditions(
+    const std::vector<std::function<bool(const std::shared_ptr<ResourceNode>&)>>& conditions,
+    bool matchAll, const std::string& cacheKey, const std::vector<std::string>& attributes) {
+    RESOURCE_METRIC_SCOPE(registry_.getMetrics(), FindByMultiConditions);
+    std::vector<std::shared_ptr<ResourceNode>> results;
+    std::string key = "multi\x1f" + cacheKey;
+    if (findCachedResult(key, results)) {
+        return results;
+    }
+    results = matchConditions(conditions, matchAll);
+    storeCachedResult(key, attributes, results);
+    return results;
+}
+
+MemoryUsage ResourceIndexer::memoryUsage(std::map<std::string, size_t>* byIndex) const {
+    MemoryUsage usage;
+    auto add = [&](const std::string& name, size_t bytes) {
+        usage.indexes += bytes;
+        if (byIndex) {
+            (*byIndex)[name] += bytes;
+        }
+    };
+
+    add("id", idIndex_.memoryUsage([](const std::shared_ptr<ResourceNode>&) { return size_t(0); }));
+    add("name", nameIndex_.memoryUsage([](const std::vector<std::shared_ptr<ResourceNode>>& nodes) {
+        return detail::vectorBytes(nodes);
+    }));
+
+    for (const auto& pair : attributeIndices_) {
+        add(pair.second->attrName(), detail::hashNodeBytes<decltype(attributeIndices_)>() +
+                                         detail::stringHeapBytes(pair.first) + pair.second->memoryBytes());
+    }
+
+    for (const auto& pair : groupAggregates_) {
+        const GroupAggregate& aggregate = pair.second;
+        size_t bytes = detail::treeBytes(aggregate.groups) + detail::hashTableBytes(aggregate.entries);
+        for (const auto& group : aggregate.groups) {
+            bytes += detail::stringHeapBytes(group.first) + detail::treeBytes(group.second.values);
+        }
+        for (const auto& entry : aggregate.entries) {
+            bytes += detail::stringHeapBytes(entry.second.first);
+        }
+        add("group:" + pair.first.first + "/" + pair.first.second, bytes);
+    }
+
+    // 链表节点带前后两个指针
+    std::lock_guard<std::mutex> cacheGuard(queryCacheMutex_);
+    size_t cacheBytes = detail::hashTableBytes(queryCacheIndex_) + detail::hashTableBytes(attributeVersions_);
+    for (const auto& entry : queryCache_) {
+        cacheBytes += sizeof(CachedQuery) + 2 * sizeof(void*) + 2 * detail::stringHeapBytes(entry.key) +
+                      detail::vectorBytes(entry.results) + detail::vectorBytes(entry.versions);
+    }
+    add("query_cache", cacheBytes);
+    add("bitmap_rows", bitmapRows_->memoryBytes());
+    return usage;
+}
+
+std::vector<std::shared_ptr<ResourceNode>> ResourceIndexer::nodesOf(const RoaringBitmap& rows) const {
+    std::vector<std::shared_ptr<ResourceNode>> results;
+    results.reserve(rows.cardinality());
+    rows.forEach([&](uint32_t row) { results.push_back(bitmapRows_->nodeAt(row)); });
+    return results;
+}
+
+void ResourceIndexer::setQueryCacheCapacity(size_t capacity) {
+    std::lock_guard<std::mutex> guard(queryCacheMutex_);
+    queryCacheCapacity_ = capacity;
+    while (queryCache_.size() > capacity) {
+        queryCacheIndex_.erase(queryCache_.back().key);
+        queryCache_.pop_back();
+        ++queryCacheStats_.evictions;
+    }
+    queryCacheStats_.entries = queryCache_.size();
+}
+
+void ResourceIndexer::clearQueryCache() {
+    std::lock_guard<std::mutex> guard(queryCacheMutex_);
+    clearQueryCacheLocked();
+}
+
+void ResourceIndexer::clearQueryCacheLocked() {
+    queryCache_.clear();
+    queryCacheIndex_.clear();
+    queryCacheStats_.entries = 0;
+}
+
+QueryCacheStats ResourceIndexer::getQueryCacheStats() const {
+    QueryCacheStats stats;
+    stats.hits = queryCacheStats_.hits.load(std::memory_order_relaxed);
+    stats.misses = queryCacheStats_.misses.load(std::memory_order_relaxed);
+    stats.invalidations = queryCacheStats_.invalidations.load(std::memory_order_relaxed);
+    stats.evictions = queryCacheStats_.evictions.load(std::memory_order_relaxed);
+    stats.entries = queryCacheStats_.entries.load(std::memory_order_relaxed);
+    return stats;
+}
+
+bool ResourceIndexer::findCachedResult(const std::string& key, std::vector<std::shared_ptr<ResourceNode>>& results) {
+    // 空键表示查询不可缓存
+    if (queryCacheCapacity_ == 0 || key.empty()) {
+        return false;
+    }
+    std::lock_guard<std::mutex> guard(queryCacheMutex_);
+    auto it = queryCacheIndex_.find(key);
+    if (it == queryCacheIndex_.end()) {
+        ++queryCacheStats_.misses;
+        return false;
+    }
+
+    for (const auto& version : it->second->versions) {
+        if (*version.first != version.second) {
+            queryCache_.erase(it->second);
+            queryCacheIndex_.erase(it);
+            ++queryCacheStats_.invalidations;
+            ++queryCacheStats_.misses;
+            queryCacheStats_.entries = queryCache_.size();
+            return false;
+        }
+    }
+
+    // 移到最近使用的位置
+    queryCache_.splice(queryCache_.begin(), queryCache_, it->second);
+    results = it->second->results;
+    ++queryCacheStats_.hits;
+    return true;
+}
+
+void ResourceIndexer::storeCachedResult(const std::string& key, const std::vector<std::string>& attributes,
+                                        const std::vector<std::shared_ptr<ResourceNode>>& results) {
+    if (queryCacheCapacity_ == 0 || key.empty()) {
+        return;
+    }
+
+    CachedQuery entry;
+    entry.key = key;
+    entry.results = results;
+    std::lock_guard<std::mutex> guard(queryCacheMutex_);
+    for (const auto& attr : attributes) {
+        const uint64_t& version = attributeVersions_[attr];
+        entry.versions.push_back(std::make_pair(&version, version));
+    }
+
+    auto existing = queryCacheIndex_.find(key);
+    if (existing != queryCacheIndex_.end()) {
+        queryCache_.erase(existing->second);
+        queryCacheIndex_.erase(existing);
+    }
+    queryCache_.push_front(std::move(entry));
+    queryCacheIndex_[key] = queryCache_.begin();
+
+    while (queryCache_.size() > queryCacheCapacity_) {
+        queryCacheIndex_.erase(queryCache_.back().key);
+        queryCache_.pop_back();
+        ++queryCacheStats_.evictions;
+    }
+    queryCacheStats_.entries = queryCache_.size();
+}
+
 void ResourceIndexer::refreshIndex() {
+    // 监听器注册后注册表会为每次修改记录事件，只靠refreshIndex维护索引的调用方从不提交，
+    // 在这里提交掉，事件照常投递给其他监听器和订阅者
+    registry_.commitChanges();
+    rebuildAll();
+}
+
+void ResourceIndexer::rebuildAll() {
+    RESOURCE_METRIC_SCOPE(registry_.getMetrics(), RefreshIndex);
+    // 重建后缓存的结果不再可信
+    clearQueryCache();
+
     // 构建基本索引
     buildIndices();
     
-    // 保存要重建的索引键
-    std::vector<std::string> indexKeys(indexedAttributes_.begin(), indexedAttributes_.end());
-    
-    // 清空属性索引
-    attributeIndices_.clear();
-    indexedAttributes_.clear();
-    
-    // 重新构建所有属性索引
-    for (const auto& indexKey : indexKeys) {
-        // 解析索引键以获取属性名和类型
-        size_t separatorPos = indexKey.find(':');
-        if (separatorPos != std::string::npos) {
-            std::string typeName = indexKey.substr(0, separatorPos);
-            std::string attrName = indexKey.substr(separatorPos + 1);
-            
-            // 根据类型重新构建索引
-            rebuildAttributeIndex(typeName, attrName);
-        }
+    // 重新构建所有属性索引，各索引按自身的键类型重建
+    for (auto& pair : attributeIndices_) {
+        pair.second->rebuild(registry_);
     }
+
+    for (auto& pair : groupAggregates_) {
+        rebuildGroupAggregate(pair.first.first, pair.first.second, pair.second);
+    }
+
+    std::unordered_set<std::string> indexedAttributes;
+    for (const auto& pair : attributeIndices_) {
+        indexedAttributes.insert(pair.second->attrName());
+    }
+    numericCovered_.clear();
+    groupCovered_.clear();
+    for (const auto& attrName : indexedAttributes) {
+        updateCoverage(attrName);
+    }
+}
+
+void ResourceIndexer::updateCoverage(const std::string& attrName) {
+    numericCovered_.erase(attrName);
+    groupCovered_.erase(attrName);
+    bool numeric = true;
+    bool group = true;
+    registry_.traverseNodes([&](std::shared_ptr<ResourceNode> node) {
+        if (const AttributeValue* value = node->findAttribute(attrName)) {
+            numeric = numeric && numericIndexed(attrName, *value);
+            group = group && groupIndexed(attrName, *value);
+        }
+    });
+    if (numeric) numericCovered_.insert(attrName);
+    if (group) groupCovered_.insert(attrName);
+}
+
+bool ResourceIndexer::numericIndexed(const std::string& attrName, const AttributeValue& value) const {
+    auto it = attributeIndices_.find(getAttributeIndexKey(attrName, value.getType()));
+    bool indexed = it != attributeIndices_.end() && it->second->numeric();
+    double number = 0.0;
+    return readNumeric(value, number) == indexed;
+}
+
+bool ResourceIndexer::groupIndexed(const std::string& attrName, const AttributeValue& value) const {
+    std::string key;
+    return !readGroupKey(value, key) ||
+           attributeIndices_.count(getAttributeIndexKey(attrName, value.getType())) > 0;
 }
 
 void ResourceIndexer::buildIndices() {
@@ -99,73 +370,334 @@ void ResourceIndexer::buildIndices() {
     nameIndex_.clear();
     idIndex_.clear();
     
-    // 遍历所有节点构建索引
-    registry_.traverseNodes([this](std::shared_ptr<ResourceNode> node) {
+    // 遍历所有节点构建索引，名称索引的条目发布后不再修改，先按名称分组再整体插入
+    StringRefMap<std::vector<std::shared_ptr<ResourceNode>>> byName;
+    registry_.traverseNodes([&](std::shared_ptr<ResourceNode> node) {
         // 按名称索引
-        nameIndex_[node->getName()].push_back(node);
+        byName[&node->getName()].push_back(node);
         
         // 按ID索引
-        idIndex_[node->getId()] = node;
+        idIndex_.insertOrAssign(node->getInternedId(), node);
     });
+    for (auto& group : byName) {
+        InternedString name = group.second.front()->getInternedName();
+        nameIndex_.insertOrAssign(name, std::move(group.second));
+    }
 }
 
-void ResourceIndexer::rebuildAttributeIndex(const std::string& typeName, const std::string& attrName) {
-    std::string indexKey = typeName + ":" + attrName;
-    
-    // 初始化索引
-    attributeIndices_[indexKey].clear();
-    indexedAttributes_.insert(indexKey);
-    
-    // 根据类型重建索引
-    if (typeName == typeid(int).name()) {
-        registry_.traverseNodes([&](std::shared_ptr<ResourceNode> node) {
-            if (node->hasAttribute(attrName)) {
-                try {
-                    int value = node->getAttribute<int>(attrName);
-                    attributeIndices_[indexKey][IndexKey(static_cast<double>(value))].push_back(node);
-                } catch (...) {
-                    // 忽略类型不匹配的属性
-                }
+void ResourceIndexer::GroupAggregate::add(const ResourceNode* node, const std::string& group, double value) {
+    Group& entry = groups[group];
+    ++entry.count;
+    entry.sum += value;
+    ++entry.values[value];
+    entries[node] = std::make_pair(group, value);
+}
+
+void ResourceIndexer::GroupAggregate::remove(const ResourceNode* node) {
+    auto it = entries.find(node);
+    if (it == entries.end()) {
+        return;
+    }
+    auto groupIt = groups.find(it->second.first);
+    Group& entry = groupIt->second;
+    if (--entry.count == 0) {
+        groups.erase(groupIt);
+    } else {
+        entry.sum -= it->second.second;
+        auto valueIt = entry.values.find(it->second.second);
+        if (--valueIt->second == 0) {
+            entry.values.erase(valueIt);
+        }
+    }
+    entries.erase(it);
+}
+
+void ResourceIndexer::rebuildGroupAggregate(const std::string& groupAttr, const std::string& valueAttr,
+                                            GroupAggregate& aggregate) {
+    aggregate.groups.clear();
+    aggregate.entries.clear();
+    registry_.traverseNodes([&](std::shared_ptr<ResourceNode> node) {
+        std::string group;
+        double number = 0.0;
+        if (readGroupEntry(*node, groupAttr, valueAttr, group, number)) {
+            aggregate.add(node.get(), group, number);
+        }
+    });
+}
+
+void ResourceIndexer::createGroupAggregate(const std::string& groupAttr, const std::string& valueAttr) {
+    rebuildGroupAggregate(groupAttr, valueAttr, groupAggregates_[std::make_pair(groupAttr, valueAttr)]);
+}
+
+void ResourceIndexer::removeGroupAggregate(const std::string& groupAttr, const std::string& valueAttr) {
+    groupAggregates_.erase(std::make_pair(groupAttr, valueAttr));
+}
+
+void ResourceIndexer::forEachNodeIn(const std::string& subtreePath,
+                                    const std::function<void(const ResourceNode&)>& visitor) {
+    std::vector<const ResourceNode*> stack;
+    if (subtreePath.empty()) {
+        for (const auto& root : registry_.getAllRootNodes()) {
+            stack.push_back(root.get());
+        }
+    } else if (auto root = registry_.getNodeByPath(subtreePath)) {
+        stack.push_back(root.get());
+    }
+
+    while (!stack.empty()) {
+        const ResourceNode* node = stack.back();
+        stack.pop_back();
+        visitor(*node);
+        for (const auto& child : node->getLoadedChildren()) {
+            stack.push_back(child.get());
+        }
+    }
+}
+
+AggregateResult ResourceIndexer::aggregate(const std::string& attrName, const std::string& subtreePath) {
+    RESOURCE_METRIC_SCOPE(registry_.getMetrics(), Aggregate);
+    AggregateResult result;
+    bool indexed = false;
+    if (subtreePath.empty() && numericCovered_.count(attrName) > 0) {
+        for (const auto& pair : attributeIndices_) {
+            AggregateResult part;
+            if (pair.second->attrName() == attrName && pair.second->aggregate(part)) {
+                result.merge(part);
+                indexed = true;
             }
-        });
-    }
-    else if (typeName == typeid(double).name()) {
-        registry_.traverseNodes([&](std::shared_ptr<ResourceNode> node) {
-            if (node->hasAttribute(attrName)) {
-                try {
-                    double value = node->getAttribute<double>(attrName);
-                    attributeIndices_[indexKey][IndexKey(value)].push_back(node);
-                } catch (...) {
-                    // 忽略类型不匹配的属性
-                }
+        }
+    }
+    if (indexed) {
+        return result;
+    }
+
+    forEachNodeIn(subtreePath, [&](const ResourceNode& node) {
+        const AttributeValue* value = node.findAttribute(attrName);
+        double number = 0.0;
+        if (value && readNumeric(*value, number)) {
+            result.add(number);
+        }
+    });
+    return result;
+}
+
+std::map<std::string, AggregateResult> ResourceIndexer::aggregateBy(const std::string& groupAttr,
+                                                                    const std::string& valueAttr,
+                                                                    const std::string& subtreePath) {
+    RESOURCE_METRIC_SCOPE(registry_.getMetrics(), AggregateBy);
+    std::map<std::string, AggregateResult> result;
+
+    auto maintained = groupAggregates_.find(std::make_pair(groupAttr, valueAttr));
+    if (subtreePath.empty() && maintained != groupAggregates_.end()) {
+        for (const auto& group : maintained->second.groups) {
+            AggregateResult& entry = result[group.first];
+            entry.count = group.second.count;
+            entry.sum = group.second.sum;
+            entry.min = group.second.values.begin()->first;
+            entry.max = group.second.values.rbegin()->first;
+        }
+        return result;
+    }
+
+    auto collect = [&](const ResourceNode& node) {
+        std::string group;
+        double number = 0.0;
+        if (readGroupEntry(node, groupAttr, valueAttr, group, number)) {
+            result[group].add(number);
+        }
+    };
+
+    // 分组属性的值都有索引收录时只访问索引中的节点，不必遍历整棵树；字符串和布尔索引收录的节点互不重叠
+    if (subtreePath.empty() && groupCovered_.count(groupAttr) > 0) {
+        for (const auto& pair : attributeIndices_) {
+            const AttributeIndexBase& index = *pair.second;
+            if (index.attrName() == groupAttr &&
+                (index.keyType() == typeid(std::string) || index.keyType() == typeid(bool))) {
+                index.forEachNode(collect);
+            }
+        }
+        return result;
+    }
+
+    forEachNodeIn(subtreePath, collect);
+    return result;
+}
+
+void ResourceIndexer::onChangesCommitted(const ChangeBatch& batch) {
+    // 1. 按事件顺序收集受影响的节点，后面的结构事件覆盖前面的状态
+    std::unordered_map<const ResourceNode*, AffectedNode> affected;
+    std::unordered_map<std::string, std::vector<const ResourceNode*>> touchedByAttribute;
+    std::vector<const ResourceNode*> structural;
+    affected.reserve(batch.size());
+
+    // 没有属性索引、分组聚合和缓存条目时不需要跟踪属性变化；缓存可能被并发的查询写入，在缓存锁下读取
+    bool trackAttributes = !attributeIndices_.empty() || !groupAggregates_.empty();
+    if (!trackAttributes) {
+        std::lock_guard<std::mutex> cacheLock(queryCacheMutex_);
+        trackAttributes = !queryCache_.empty();
+    }
+
+    for (const auto& event : batch) {
+        if (!event.node) continue;
+
+        if (event.type == ChangeEvent::Type::ATTRIBUTE_CHANGED ||
+            event.type == ChangeEvent::Type::ATTRIBUTE_REMOVED) {
+            if (!trackAttributes) continue;
+            AffectedNode& entry = affected[event.node.get()];
+            entry.node = event.node;
+            touchedByAttribute[event.key].push_back(event.node.get());
+            continue;
+        }
+
+        bool live = event.type == ChangeEvent::Type::NODE_ADDED;
+        std::vector<std::shared_ptr<ResourceNode>> stack(1, event.node);
+        while (!stack.empty()) {
+            auto node = stack.back();
+            stack.pop_back();
+            AffectedNode& entry = affected[node.get()];
+            if (!entry.structural) {
+                structural.push_back(node.get());
             }
-        });
-    }
-    else if (typeName == typeid(std::string).name()) {
-        registry_.traverseNodes([&](std::shared_ptr<ResourceNode> node) {
-            if (node->hasAttribute(attrName)) {
-                try {
-                    std::string value = node->getAttribute<std::string>(attrName);
-                    attributeIndices_[indexKey][IndexKey(value)].push_back(node);
-                } catch (...) {
-                    // 忽略类型不匹配的属性
+            entry.node = node;
+            entry.live = live;
+            entry.structural = true;
+            stack.insert(stack.end(), node->getLoadedChildren().begin(), node->getLoadedChildren().end());
+        }
+    }
+
+    // 查询缓存：节点增删影响所有查询，直接清空；只改属性时让这些属性的版本号失效
+    std::unique_lock<std::mutex> cacheGuard(queryCacheMutex_);
+    if (!queryCache_.empty()) {
+        if (!structural.empty()) {
+            queryCacheStats_.invalidations += queryCache_.size();
+            clearQueryCacheLocked();
+        } else {
+            for (const auto& touched : touchedByAttribute) {
+                auto version = attributeVersions_.find(touched.first);
+                if (version != attributeVersions_.end()) {
+                    ++version->second;
                 }
             }
-        });
-    }
-    else if (typeName == typeid(bool).name()) {
-        registry_.traverseNodes([&](std::shared_ptr<ResourceNode> node) {
-            if (node->hasAttribute(attrName)) {
-                try {
-                    bool value = node->getAttribute<bool>(attrName);
-                    attributeIndices_[indexKey][IndexKey(value)].push_back(node);
-                } catch (...) {
-                    // 忽略类型不匹配的属性
+        }
+    }
+    cacheGuard.unlock();
+
+    // 2. 名称/ID索引：按名称分组，每个名称桶只扫描一次
+    StringRefMap<std::vector<const AffectedNode*>> byName;
+    for (const auto* ptr : structural) {
+        const AffectedNode& entry = affected[ptr];
+        const auto& node = entry.node;
+        byName[&node->getName()].push_back(&entry);
+
+        std::shared_ptr<ResourceNode> indexed;
+        if (entry.live) {
+            idIndex_.insertOrAssign(node->getInternedId(), node);
+        } else if (idIndex_.find(node->getId(), indexed) && indexed == node) {
+            idIndex_.erase(node->getId());
+        }
+    }
+    for (const auto& group : byName) {
+        // 复制出当前的桶，修改后整体替换，并发的读者看到的始终是完整的桶
+        std::vector<std::shared_ptr<ResourceNode>> bucket;
+        nameIndex_.find(*group.first, bucket);
+        std::unordered_set<const ResourceNode*> present;
+        for (const auto& node : bucket) {
+            present.insert(node.get());
+        }
+        std::unordered_set<const ResourceNode*> removed;
+        size_t added = 0;
+        for (const auto* entry : group.second) {
+            if (entry->live && present.insert(entry->node.get()).second) {
+                bucket.push_back(entry->node);
+                ++added;
+            } else if (!entry->live && present.count(entry->node.get()) > 0) {
+                removed.insert(entry->node.get());
+            }
+        }
+        if (added == 0 && removed.empty()) {
+            continue;
+        }
+        if (!removed.empty()) {
+            bucket.erase(std::remove_if(bucket.begin(), bucket.end(),
+                [&removed](const std::shared_ptr<ResourceNode>& node) { return removed.count(node.get()) > 0; }),
+                bucket.end());
+        }
+        if (bucket.empty()) {
+            nameIndex_.erase(*group.first);
+        } else {
+            nameIndex_.insertOrAssign(group.second.front()->node->getInternedName(), std::move(bucket));
+        }
+    }
+
+    // 3. 属性索引：各索引对比节点当前值和旧键，生成桶操作后按键排序批量应用
+    std::vector<IndexCandidate> changes;
+    for (auto& indexPair : attributeIndices_) {
+        AttributeIndexBase& index = *indexPair.second;
+        std::vector<const ResourceNode*> candidates(structural);
+        auto touched = touchedByAttribute.find(index.attrName());
+        if (touched != touchedByAttribute.end()) {
+            candidates.insert(candidates.end(), touched->second.begin(), touched->second.end());
+        }
+        if (candidates.empty()) continue;
+        std::sort(candidates.begin(), candidates.end());
+        candidates.erase(std::unique(candidates.begin(), candidates.end()), candidates.end());
+
+        changes.clear();
+        for (const auto* ptr : candidates) {
+            const AffectedNode& entry = affected[ptr];
+            changes.push_back(IndexCandidate{&entry.node, entry.live});
+        }
+        index.update(changes);
+    }
+
+    // 受影响的节点出现索引未收录的值时，聚合改回扫描
+    for (auto* covered : {&numericCovered_, &groupCovered_}) {
+        const bool numeric = covered == &numericCovered_;
+        for (auto it = covered->begin(); it != covered->end();) {
+            std::vector<const ResourceNode*> candidates(structural);
+            auto touched = touchedByAttribute.find(*it);
+            if (touched != touchedByAttribute.end()) {
+                candidates.insert(candidates.end(), touched->second.begin(), touched->second.end());
+            }
+            bool stillCovered = true;
+            for (const auto* ptr : candidates) {
+                const AffectedNode& entry = affected[ptr];
+                const AttributeValue* value = entry.live ? entry.node->findAttribute(*it) : nullptr;
+                if (value && !(numeric ? numericIndexed(*it, *value) : groupIndexed(*it, *value))) {
+                    stillCovered = false;
+                    break;
                 }
             }
-        });
+            it = stillCovered ? std::next(it) : covered->erase(it);
+        }
+    }
+
+    // 4. 分组聚合：受影响节点先从旧分组中扣除，再按当前值计入
+    for (auto& aggregatePair : groupAggregates_) {
+        const std::string& groupAttr = aggregatePair.first.first;
+        const std::string& valueAttr = aggregatePair.first.second;
+        GroupAggregate& aggregate = aggregatePair.second;
+
+        std::vector<const ResourceNode*> candidates(structural);
+        for (const std::string* attr : {&groupAttr, &valueAttr}) {
+            auto touched = touchedByAttribute.find(*attr);
+            if (touched != touchedByAttribute.end()) {
+                candidates.insert(candidates.end(), touched->second.begin(), touched->second.end());
+            }
+        }
+        std::sort(candidates.begin(), candidates.end());
+        candidates.erase(std::unique(candidates.begin(), candidates.end()), candidates.end());
+
+        for (const auto* ptr : candidates) {
+            const AffectedNode& entry = affected[ptr];
+            aggregate.remove(ptr);
+            std::string group;
+            double number = 0.0;
+            if (entry.live && readGroupEntry(*entry.node, groupAttr, valueAttr, group, number)) {
+                aggregate.add(ptr, group, number);
+            }
+        }
     }
-    // 可以根据需要添加更多类型的处理
 }
 
 } // namespace resource
\ No newline at end of file
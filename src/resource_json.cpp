@@ -0,0 +1,763 @@
+#include "resource_json.h"
+#include "resource_registry.h"
+#include <cerrno>
+#include <climits>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <sstream>
+
+namespace resource {
+
+// ===================== JsonSaxParser =====================
+
+JsonSaxParser::JsonSaxParser(size_t bufferSize)
+    : buffer_(bufferSize > 0 ? bufferSize : 1), in_(nullptr), base_(nullptr), cur_(nullptr), end_(nullptr), consumed_(0) {}
+
+bool JsonSaxParser::parse(std::istream& in, JsonSaxHandler& handler) {
+    in_ = &in;
+    base_ = cur_ = end_ = buffer_.data();
+    consumed_ = 0;
+    error_.clear();
+    bool ok = run(handler);
+    in_ = nullptr;
+    return ok;
+}
+
+bool JsonSaxParser::parse(const char* data, size_t size, JsonSaxHandler& handler) {
+    in_ = nullptr;
+    base_ = cur_ = data;
+    end_ = data + size;
+    consumed_ = 0;
+    error_.clear();
+    return run(handler);
+}
+
+bool JsonSaxParser::refill() {
+    if (!in_) return false;
+    consumed_ += static_cast<size_t>(end_ - base_);
+    in_->read(buffer_.data(), static_cast<std::streamsize>(buffer_.size()));
+    std::streamsize count = in_->gcount();
+    base_ = cur_ = buffer_.data();
+    end_ = cur_ + count;
+    return count > 0;
+}
+
+inline int JsonSaxParser::peekChar() {
+    if (cur_ == end_ && !refill()) return -1;
+    return static_cast<unsigned char>(*cur_);
+}
+
+inline int JsonSaxParser::nextChar() {
+    if (cur_ == end_ && !refill()) return -1;
+    return static_cast<unsigned char>(*cur_++);
+}
+
+void JsonSaxParser::skipWhitespace() {
+    while (true) {
+        while (cur_ != end_) {
+            char c = *cur_;
+            if (c != ' ' && c != '\n' && c != '\r' && c != '\t') return;
+            ++cur_;
+        }
+        if (!refill()) return;
+    }
+}
+
+bool JsonSaxParser::fail(const std::string& message) {
+    std::ostringstream oss;
+    oss << message << " (offset " << consumed_ + static_cast<size_t>(cur_ - base_) << ")";
+    error_ = oss.str();
+    return false;
+}
+
+bool JsonSaxParser::parseLiteral(const char* literal) {
+    for (const char* p = literal; *p; ++p) {
+        if (nextChar() != static_cast<unsigned char>(*p)) {
+            return fail(std::string("Invalid literal, expected ") + literal);
+        }
+    }
+    return true;
+}
+
+bool JsonSaxParser::parseUnicodeEscape(std::string& out) {
+    auto readHex = [this](unsigned& value) -> bool {
+        value = 0;
+        for (int i = 0; i < 4; ++i) {
+            int c = nextChar();
+            value <<= 4;
+            if (c >= '0' && c <= '9') value |= static_cast<unsigned>(c - '0');
+            else if (c >= 'a' && c <= 'f') value |= static_cast<unsigned>(c - 'a' + 10);
+            else if (c >= 'A' && c <= 'F') value |= static_cast<unsigned>(c - 'A' + 10);
+            else return false;
+        }
+        return true;
+    };
+
+    unsigned code;
+    if (!readHex(code)) return fail("Invalid \\u escape");
+
+    // 代理对
+    if (code >= 0xD800 && code <= 0xDBFF) {
+        unsigned low;
+        if (nextChar() != '\\' || nextChar() != 'u' || !readHex(low) || low < 0xDC00 || low > 0xDFFF) {
+            return fail("Invalid surrogate pair");
+        }
+        code = 0x10000 + ((code - 0xD800) << 10) + (low - 0xDC00);
+    }
+
+    // 编码为UTF-8
+    if (code < 0x80) {
+        out.push_back(static_cast<char>(code));
+    } else if (code < 0x800) {
+        out.push_back(static_cast<char>(0xC0 | (code >> 6)));
+        out.push_back(static_cast<char>(0x80 | (code & 0x3F)));
+    } else if (code < 0x10000) {
+        out.push_back(static_cast<char>(0xE0 | (code >> 12)));
+        out.push_back(static_cast<char>(0x80 | ((code >> 6) & 0x3F)));
+        out.push_back(static_cast<char>(0x80 | (code & 0x3F)));
+    } else {
+        out.push_back(static_cast<char>(0xF0 | (code >> 18)));
+        out.push_back(static_cast<char>(0x80 | ((code >> 12) & 0x3F)));
+        out.push_back(static_cast<char>(0x80 | ((code >> 6) & 0x3F)));
+        out.push_back(static_cast<char>(0x80 | (code & 0x3F)));
+    }
+    return true;
+}
+
+bool JsonSaxParser::parseString(std::string& out) {
+    // 调用前已消费开头的引号
+    out.clear();
+    while (true) {
+        // 快速路径：整段复制不含转义的字符
+        const char* start = cur_;
+        while (cur_ != end_ && *cur_ != '"' && *cur_ != '\\') {
+            ++cur_;
+        }
+        out.append(start, cur_);
+
+        int c = nextChar();
+        if (c == -1) return fail("Unterminated string");
+        if (c == '"') return true;
+
+        // 转义字符
+        c = nextChar();
+        switch (c) {
+            case '"': out.push_back('"'); break;
+            case '\\': out.push_back('\\'); break;
+            case '/': out.push_back('/'); break;
+            case 'b': out.push_back('\b'); break;
+            case 'f': out.push_back('\f'); break;
+            case 'n': out.push_back('\n'); break;
+            case 'r': out.push_back('\r'); break;
+            case 't': out.push_back('\t'); break;
+            case 'u':
+                if (!parseUnicodeEscape(out)) return false;
+                break;
+            default:
+                return fail("Invalid escape sequence");
+        }
+    }
+}
+
+bool JsonSaxParser::parseNumber(JsonSaxHandler& handler) {
+    token_.clear();
+    bool isInteger = true;
+    while (true) {
+        int c = peekChar();
+        if ((c >= '0' && c <= '9') || c == '-' || c == '+') {
+            token_.push_back(static_cast<char>(c));
+        } else if (c == '.' || c == 'e' || c == 'E') {
+            token_.push_back(static_cast<char>(c));
+            isInteger = false;
+        } else {
+            break;
+        }
+        ++cur_;
+    }
+
+    const char* begin = token_.c_str();
+    char* endPtr = nullptr;
+    if (isInteger) {
+        errno = 0;
+        long long value = std::strtoll(begin, &endPtr, 10);
+        if (errno == 0 && endPtr && *endPtr == '\0' && endPtr != begin) {
+            return handler.onInteger(value) || fail("Handler aborted");
+        }
+        // 超出long long范围时按浮点数处理
+    }
+
+    double value = std::strtod(begin, &endPtr);
+    if (!endPtr || *endPtr != '\0' || endPtr == begin) {
+        return fail("Invalid number: " + token_);
+    }
+    return handler.onDouble(value) || fail("Handler aborted");
+}
+
+bool JsonSaxParser::run(JsonSaxHandler& handler) {
+    // 容器栈：'{' 或 '['
+    std::vector<char> stack;
+    enum class Expect { VALUE, KEY_OR_END, KEY, COLON, COMMA_OR_END, VALUE_OR_END };
+    Expect expect = Expect::VALUE;
+    std::string text;
+
+    while (true) {
+        skipWhitespace();
+        int c = peekChar();
+        if (c == -1) {
+            if (stack.empty() && expect == Expect::COMMA_OR_END) return true;
+            return fail("Unexpected end of input");
+        }
+
+        switch (expect) {
+            case Expect::KEY_OR_END:
+            case Expect::KEY:
+                if (c == '}' && expect == Expect::KEY_OR_END) {
+                    ++cur_;
+                    stack.pop_back();
+                    if (!handler.onEndObject()) return fail("Handler aborted");
+                    expect = Expect::COMMA_OR_END;
+                    break;
+                }
+                if (c != '"') return fail("Expected object key");
+                ++cur_;
+                if (!parseString(text)) return false;
+                if (!handler.onKey(text)) return fail("Handler aborted");
+                expect = Expect::COLON;
+                break;
+
+            case Expect::COLON:
+                if (c != ':') return fail("Expected ':'");
+                ++cur_;
+                expect = Expect::VALUE;
+                break;
+
+            case Expect::COMMA_OR_END:
+                if (stack.empty()) {
+                    return fail("Unexpected trailing content");
+                }
+                ++cur_;
+                if (c == ',') {
+                    expect = stack.back() == '{' ? Expect::KEY : Expect::VALUE;
+                } else if (c == '}' && stack.back() == '{') {
+                    stack.pop_back();
+                    if (!handler.onEndObject()) return fail("Handler aborted");
+                } else if (c == ']' && stack.back() == '[') {
+                    stack.pop_back();
+                    if (!handler.onEndArray()) return fail("Handler aborted");
+                } else {
+                    return fail("Expected ',' or closing bracket");
+                }
+                break;
+
+            case Expect::VALUE_OR_END:
+                if (c == ']') {
+                    ++cur_;
+                    stack.pop_back();
+                    if (!handler.onEndArray()) return fail("Handler aborted");
+                    expect = Expect::COMMA_OR_END;
+                    break;
+                }
+                // 继续按值处理
+                // fallthrough
+            case Expect::VALUE:
+                expect = Expect::COMMA_OR_END;
+                if (c == '{') {
+                    ++cur_;
+                    stack.push_back('{');
+                    if (!handler.onStartObject()) return fail("Handler aborted");
+                    expect = Expect::KEY_OR_END;
+                } else if (c == '[') {
+                    ++cur_;
+                    stack.push_back('[');
+                    if (!handler.onStartArray()) return fail("Handler aborted");
+                    expect = Expect::VALUE_OR_END;
+                } else if (c == '"') {
+                    ++cur_;
+                    if (!parseString(text)) return false;
+                    if (!handler.onString(text)) return fail("Handler aborted");
+                } else if (c == 't') {
+                    if (!parseLiteral("true")) return false;
+                    if (!handler.onBool(true)) return fail("Handler aborted");
+                } else if (c == 'f') {
+                    if (!parseLiteral("false")) return false;
+                    if (!handler.onBool(false)) return fail("Handler aborted");
+                } else if (c == 'n') {
+                    if (!parseLiteral("null")) return false;
+                    if (!handler.onNull()) return fail("Handler aborted");
+                } else if (c == '-' || (c >= '0' && c <= '9')) {
+                    if (!parseNumber(handler)) return false;
+                } else {
+                    return fail("Unexpected character");
+                }
+                break;
+        }
+    }
+}
+
+// ===================== JsonTreeReader =====================
+
+namespace {
+
+// 将SAX事件组装为ResourceNode树
+class TreeBuildHandler : public JsonSaxHandler {
+public:
+    TreeBuildHandler(const JsonImportOptions& options, std::vector<std::shared_ptr<ResourceNode>>& roots)
+        : options_(options), roots_(roots), skipDepth_(0) {}
+
+    bool onNull() override { return true; }
+
+    bool onBool(bool value) override {
+        if (skipDepth_ > 0 || contexts_.empty()) return true;
+        if (contexts_.back() == Context::ATTRIBUTES) {
+            switch (typeFor(attrKey_)) {
+                case JsonAttributeType::STRING: setAttribute(std::string(value ? "true" : "false")); break;
+                case JsonAttributeType::INT: setAttribute(static_cast<int>(value)); break;
+                default: setAttribute(value); break;
+            }
+        }
+        return true;
+    }
+
+    bool onInteger(long long value) override {
+        if (skipDepth_ > 0 || contexts_.empty()) return true;
+        if (contexts_.back() == Context::ATTRIBUTES) {
+            switch (typeFor(attrKey_)) {
+                case JsonAttributeType::INT: setAttribute(static_cast<int>(value)); break;
+                case JsonAttributeType::INT64: setAttribute(value); break;
+                case JsonAttributeType::DOUBLE: setAttribute(static_cast<double>(value)); break;
+                case JsonAttributeType::FLOAT: setAttribute(static_cast<float>(value)); break;
+                case JsonAttributeType::BOOL: setAttribute(value != 0); break;
+                case JsonAttributeType::STRING: setAttribute(std::to_string(value)); break;
+                case JsonAttributeType::AUTO:
+                    if (value >= INT_MIN && value <= INT_MAX) {
+                        setAttribute(static_cast<int>(value));
+                    } else {
+                        setAttribute(value);
+                    }
+                    break;
+            }
+        }
+        return true;
+    }
+
+    bool onDouble(double value) override {
+        if (skipDepth_ > 0 || contexts_.empty()) return true;
+        if (contexts_.back() == Context::ATTRIBUTES) {
+            switch (typeFor(attrKey_)) {
+                case JsonAttributeType::INT: setAttribute(static_cast<int>(value)); break;
+                case JsonAttributeType::INT64: setAttribute(static_cast<long long>(value)); break;
+                case JsonAttributeType::FLOAT: setAttribute(static_cast<float>(value)); break;
+                case JsonAttributeType::BOOL: setAttribute(value != 0.0); break;
+                case JsonAttributeType::STRING: {
+                    std::ostringstream oss;
+                    oss << value;
+                    setAttribute(oss.str());
+                    break;
+                }
+                default: setAttribute(value); break;
+            }
+        }
+        return true;
+    }
+
+    bool onString(const std::string& value) override {
+        if (skipDepth_ > 0 || contexts_.empty()) return true;
+        if (contexts_.back() == Context::ATTRIBUTES) {
+            setAttribute(value);
+        } else if (contexts_.back() == Context::NODE) {
+            NodeFrame& frame = frames_.back();
+            if (frame.key == "name") {
+                frame.name = value;
+                frame.hasName = true;
+            } else if (frame.key == "id") {
+                frame.id = value;
+                frame.hasId = true;
+            }
+            if (frame.hasName && frame.hasId) {
+                return materialize(frame);
+            }
+        }
+        return true;
+    }
+
+    bool onKey(const std::string& key) override {
+        if (skipDepth_ > 0) return true;
+        if (contexts_.back() == Context::ATTRIBUTES) {
+            attrKey_ = key;
+        } else if (contexts_.back() == Context::NODE) {
+            frames_.back().key = key;
+        }
+        return true;
+    }
+
+    bool onStartObject() override {
+        if (skipDepth_ > 0) {
+            ++skipDepth_;
+            return true;
+        }
+        if (contexts_.empty() || contexts_.back() == Context::ARRAY || contexts_.back() == Context::CHILDREN) {
+            frames_.push_back(NodeFrame());
+            contexts_.push_back(Context::NODE);
+        } else if (contexts_.back() == Context::NODE && frames_.back().key == "attributes") {
+            contexts_.push_back(Context::ATTRIBUTES);
+        } else {
+            // 不支持的嵌套对象（例如对象类型的属性值），整体跳过
+            skipDepth_ = 1;
+        }
+        return true;
+    }
+
+    bool onEndObject() override {
+        if (skipDepth_ > 0) {
+            --skipDepth_;
+            return true;
+        }
+        Context context = contexts_.back();
+        contexts_.pop_back();
+        if (context == Context::NODE) {
+            return finishNode();
+        }
+        return true;
+    }
+
+    bool onStartArray() override {
+        if (skipDepth_ > 0) {
+            ++skipDepth_;
+            return true;
+        }
+        if (contexts_.empty()) {
+            contexts_.push_back(Context::ARRAY);
+        } else if (contexts_.back() == Context::NODE && frames_.back().key == "children") {
+            contexts_.push_back(Context::CHILDREN);
+        } else {
+            skipDepth_ = 1;
+        }
+        return true;
+    }
+
+    bool onEndArray() override {
+        if (skipDepth_ > 0) {
+            --skipDepth_;
+            return true;
+        }
+        contexts_.pop_back();
+        return true;
+    }
+
+    const std::string& getError() const { return error_; }
+
+private:
+    enum class Context { ARRAY, NODE, ATTRIBUTES, CHILDREN };
+
+    struct NodeFrame {
+        std::string name;
+        std::string id;
+        bool hasName;
+        bool hasId;
+        std::string key;
+        std::shared_ptr<ResourceNode> node;
+        // 节点创建前暂存的属性和子节点
+        std::vector<std::pair<std::string, std::unique_ptr<AttributeValue>>> pendingAttributes;
+        std::vector<std::shared_ptr<ResourceNode>> pendingChildren;
+
+        NodeFrame() : hasName(false), hasId(false) {}
+    };
+
+    JsonAttributeType typeFor(const std::string& key) const {
+        if (options_.attributeTypes.empty()) return JsonAttributeType::AUTO;
+        auto it = options_.attributeTypes.find(key);
+        return it != options_.attributeTypes.end() ? it->second : JsonAttributeType::AUTO;
+    }
+
+    // 按值接收后移入属性，临时字符串不再复制
+    template<typename T>
+    void setAttribute(T value) {
+        NodeFrame& frame = frames_.back();
+        if (frame.node) {
+            frame.node->setAttribute(attrKey_, std::move(value));
+        } else {
+            frame.pendingAttributes.emplace_back(attrKey_,
+                std::unique_ptr<AttributeValue>(new TypedAttributeValue<T>(std::move(value))));
+        }
+    }
+
+    // 暂存的子节点ID重复时addChild抛出异常，转为解析错误返回false
+    bool materialize(NodeFrame& frame) {
+        if (frame.node) return true;
+        frame.node = std::make_shared<ResourceNode>(frame.name, frame.id);
+        for (auto& attr : frame.pendingAttributes) {
+            frame.node->updateAttributeRaw(attr.first, std::move(attr.second));
+        }
+        frame.pendingAttributes.clear();
+        try {
+            for (auto& child : frame.pendingChildren) {
+                frame.node->addChild(std::move(child));
+            }
+        } catch (const std::exception& e) {
+            error_ = e.what();
+            return false;
+        }
+        frame.pendingChildren.clear();
+        return true;
+    }
+
+    bool finishNode() {
+        NodeFrame& frame = frames_.back();
+        if (!frame.node) {
+            if (!frame.hasId && !frame.hasName) {
+                error_ = "Node without name and id";
+                return false;
+            }
+            // 缺少id时使用name，反之亦然
+            if (!frame.hasId) frame.id = frame.name;
+            if (!frame.hasName) frame.name = frame.id;
+            if (!materialize(frame)) {
+                return false;
+            }
+        }
+
+        auto node = frame.node;
+        frames_.pop_back();
+
+        try {
+            if (frames_.empty()) {
+                roots_.push_back(node);
+            } else if (frames_.back().node) {
+                frames_.back().node->addChild(node);
+            } else {
+                frames_.back().pendingChildren.push_back(node);
+            }
+        } catch (const std::exception& e) {
+            error_ = e.what();
+            return false;
+        }
+        return true;
+    }
+
+    const JsonImportOptions& options_;
+    std::vector<std::shared_ptr<ResourceNode>>& roots_;
+    std::vector<Context> contexts_;
+    std::vector<NodeFrame> frames_;
+    std::string attrKey_;
+    int skipDepth_;
+    std::string error_;
+};
+
+} // namespace
+
+JsonTreeReader::JsonTreeReader(const JsonImportOptions& options) : options_(options) {}
+
+bool JsonTreeReader::read(std::istream& in, std::vector<std::shared_ptr<ResourceNode>>& roots) {
+    TreeBuildHandler handler(options_, roots);
+    JsonSaxParser parser;
+    if (!parser.parse(in, handler)) {
+        error_ = handler.getError().empty() ? parser.getError() : handler.getError();
+        return false;
+    }
+    error_.clear();
+    return true;
+}
+
+bool JsonTreeReader::read(const std::string& json, std::vector<std::shared_ptr<ResourceNode>>& roots) {
+    TreeBuildHandler handler(options_, roots);
+    JsonSaxParser parser;
+    if (!parser.parse(json.data(), json.size(), handler)) {
+        error_ = handler.getError().empty() ? parser.getError() : handler.getError();
+        return false;
+    }
+    error_.clear();
+    return true;
+}
+
+bool JsonTreeReader::readIntoRegistry(std::istream& in, ResourceRegistry& registry, const std::string& parentPath) {
+    std::vector<std::shared_ptr<ResourceNode>> roots;
+    if (!read(in, roots)) {
+        return false;
+    }
+
+    for (const auto& root : roots) {
+        std::string path = parentPath.empty() ? std::string() : parentPath + "/" + root->getId();
+        if (!registry.registerNodeAtPath(path, root)) {
+            error_ = "Failed to register node " + root->getId();
+            return false;
+        }
+    }
+    return true;
+}
+
+// ===================== JsonTreeWriter =====================
+
+JsonTreeWriter::JsonTreeWriter(std::ostream& out, bool pretty, size_t bufferSize)
+    : out_(out), pretty_(pretty), bufferSize_(bufferSize) {
+    buffer_.reserve(bufferSize_ + 1024);
+}
+
+JsonTreeWriter::~JsonTreeWriter() {
+    flush();
+}
+
+void JsonTreeWriter::flush() {
+    if (!buffer_.empty()) {
+        out_.write(buffer_.data(), static_cast<std::streamsize>(buffer_.size()));
+        buffer_.clear();
+    }
+    out_.flush();
+}
+
+inline void JsonTreeWriter::reserveOrFlush() {
+    if (buffer_.size() >= bufferSize_) {
+        out_.write(buffer_.data(), static_cast<std::streamsize>(buffer_.size()));
+        buffer_.clear();
+    }
+}
+
+void JsonTreeWriter::newline(int depth) {
+    if (!pretty_) return;
+    buffer_.push_back('\n');
+    buffer_.append(static_cast<size_t>(depth) * 2, ' ');
+}
+
+void JsonTreeWriter::writeString(const std::string& value) {
+    static const char HEX[] = "0123456789abcdef";
+    buffer_.push_back('"');
+    const char* p = value.data();
+    const char* end = p + value.size();
+    while (p != end) {
+        // 整段复制无需转义的字符（包括UTF-8多字节字符）
+        const char* start = p;
+        while (p != end && static_cast<unsigned char>(*p) >= 0x20 && *p != '"' && *p != '\\') {
+            ++p;
+        }
+        buffer_.append(start, p);
+        if (p == end) break;
+
+        char c = *p++;
+        switch (c) {
+            case '"': buffer_.append("\\\""); break;
+            case '\\': buffer_.append("\\\\"); break;
+            case '\n': buffer_.append("\\n"); break;
+            case '\r': buffer_.append("\\r"); break;
+            case '\t': buffer_.append("\\t"); break;
+            case '\b': buffer_.append("\\b"); break;
+            case '\f': buffer_.append("\\f"); break;
+            default:
+                buffer_.append("\\u00");
+                buffer_.push_back(HEX[(static_cast<unsigned char>(c) >> 4) & 0xF]);
+                buffer_.push_back(HEX[static_cast<unsigned char>(c) & 0xF]);
+                break;
+        }
+    }
+    buffer_.push_back('"');
+}
+
+void JsonTreeWriter::writeDouble(double value) {
+    if (!std::isfinite(value)) {
+        buffer_.append("null");  // JSON不支持NaN/Inf
+        return;
+    }
+
+    // 优先使用较短的表示，无法无损还原时再使用17位有效数字
+    char text[32];
+    int length = std::snprintf(text, sizeof(text), "%.15g", value);
+    if (std::strtod(text, nullptr) != value) {
+        length = std::snprintf(text, sizeof(text), "%.17g", value);
+    }
+    buffer_.append(text, static_cast<size_t>(length));
+
+    // 保证导入时仍被识别为浮点数
+    if (!std::strpbrk(text, ".eEn")) {
+        buffer_.append(".0");
+    }
+}
+
+bool JsonTreeWriter::writeAttributeValue(const AttributeValue& value) {
+    const std::type_info& type = value.getType();
+    if (type == typeid(int)) {
+        buffer_.append(std::to_string(*static_cast<const int*>(value.data())));
+    } else if (type == typeid(long long)) {
+        buffer_.append(std::to_string(*static_cast<const long long*>(value.data())));
+    } else if (type == typeid(double)) {
+        writeDouble(*static_cast<const double*>(value.data()));
+    } else if (type == typeid(float)) {
+        writeDouble(*static_cast<const float*>(value.data()));
+    } else if (type == typeid(bool)) {
+        buffer_.append(*static_cast<const bool*>(value.data()) ? "true" : "false");
+    } else if (type == typeid(std::string)) {
+        writeString(*static_cast<const std::string*>(value.data()));
+    } else {
+        return false;
+    }
+    return true;
+}
+
+void JsonTreeWriter::writeNodeAt(const ResourceNode& node, int depth) {
+    buffer_.push_back('{');
+    newline(depth + 1);
+    buffer_.append("\"name\":");
+    writeString(node.getName());
+    buffer_.push_back(',');
+    newline(depth + 1);
+    buffer_.append("\"id\":");
+    writeString(node.getId());
+
+    if (node.getSchema() || !node.getAttributes().empty()) {
+        buffer_.push_back(',');
+        newline(depth + 1);
+        buffer_.append("\"attributes\":{");
+        bool first = true;
+        node.forEachAttribute([&](const std::string& key, const AttributeValue& value) {
+            size_t mark = buffer_.size();
+            if (!first) buffer_.push_back(',');
+            newline(depth + 2);
+            writeString(key);
+            buffer_.push_back(':');
+            if (writeAttributeValue(value)) {
+                first = false;
+            } else {
+                buffer_.resize(mark);  // 跳过不支持导出的类型
+            }
+        });
+        newline(depth + 1);
+        buffer_.push_back('}');
+    }
+
+    const auto& children = node.getChildren();
+    if (!children.empty()) {
+        buffer_.push_back(',');
+        newline(depth + 1);
+        buffer_.append("\"children\":[");
+        for (size_t i = 0; i < children.size(); ++i) {
+            if (i > 0) buffer_.push_back(',');
+            newline(depth + 2);
+            writeNodeAt(*children[i], depth + 2);
+        }
+        newline(depth + 1);
+        buffer_.push_back(']');
+    }
+
+    newline(depth);
+    buffer_.push_back('}');
+    reserveOrFlush();
+}
+
+void JsonTreeWriter::writeNode(const ResourceNode& node) {
+    writeNodeAt(node, 0);
+}
+
+void JsonTreeWriter::writeRegistry(const ResourceRegistry& registry) {
+    buffer_.push_back('[');
+    bool first = true;
+    for (const auto& root : registry.getAllRootNodes()) {
+        if (!first) buffer_.push_back(',');
+        newline(1);
+        writeNodeAt(*root, 1);
+        first = false;
+    }
+    newline(0);
+    buffer_.push_back(']');
+    reserveOrFlush();
+}
+
+} // namespace resource
@@ -0,0 +1,118 @@
+#include "resource_lazy.h"
+#include "resource_serialization.h"
+#include <algorithm>
+#include <stdexcept>
+
+namespace resource {
+
+size_t LazyLoadBudget::limit() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return limit_;
+}
+
+void LazyLoadBudget::setLimit(size_t limitBytes) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    limit_ = limitBytes;
+}
+
+size_t LazyLoadBudget::loadedBytes() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return loadedBytes_;
+}
+
+size_t LazyLoadBudget::loadedCount() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return loaded_.size();
+}
+
+size_t LazyLoadBudget::loadCount() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return loads_;
+}
+
+size_t LazyLoadBudget::evictionCount() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return evictions_;
+}
+
+void LazyLoadBudget::noteLoaded(ResourceNode* node, size_t bytes) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    size_t& entry = loaded_[node];
+    loadedBytes_ = loadedBytes_ - entry + bytes;
+    entry = bytes;
+    ++loads_;
+}
+
+void LazyLoadBudget::forget(const ResourceNode* node) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = loaded_.find(const_cast<ResourceNode*>(node));
+    if (it != loaded_.end()) {
+        loadedBytes_ -= it->second;
+        loaded_.erase(it);
+    }
+}
+
+size_t LazyLoadBudget::enforce() {
+    // 先在锁内选出要卸载的节点，卸载时节点会回调forget
+    std::vector<ResourceNode*> victims;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (loadedBytes_ <= limit_) {
+            return 0;
+        }
+        std::vector<std::pair<uint64_t, ResourceNode*>> byUse;
+        byUse.reserve(loaded_.size());
+        for (const auto& entry : loaded_) {
+            byUse.push_back(std::make_pair(entry.first->lazy_->lastUse.load(std::memory_order_relaxed), entry.first));
+        }
+        std::sort(byUse.begin(), byUse.end());
+        size_t remaining = loadedBytes_;
+        for (const auto& use : byUse) {
+            if (remaining <= limit_) {
+                break;
+            }
+            remaining -= loaded_[use.second];
+            victims.push_back(use.second);
+        }
+    }
+
+    size_t evicted = 0;
+    for (ResourceNode* node : victims) {
+        if (node->unload()) {
+            ++evicted;
+        }
+    }
+    std::lock_guard<std::mutex> lock(mutex_);
+    evictions_ += evicted;
+    return evicted;
+}
+
+NodeLoader snapshotLoader(const ResourceNode& source) {
+    auto buffer = std::make_shared<std::string>();
+    BinaryWriter writer(*buffer);
+    encodeChildren(writer, source);
+
+    std::shared_ptr<const std::string> snapshot = buffer;
+    return [snapshot](ResourceNode& target) {
+        BinaryReader reader(snapshot->data(), snapshot->size());
+        if (!decodeChildren(reader, target)) {
+            throw std::runtime_error("Corrupted lazy snapshot for node " + target.getId());
+        }
+    };
+}
+
+void deferChildren(ResourceNode& node, std::shared_ptr<LazyLoadBudget> budget) {
+    NodeLoader loader = snapshotLoader(node);
+    std::vector<std::string> ids;
+    for (const auto& child : node.getChildren()) {
+        ids.push_back(child->getId());
+    }
+    for (const auto& id : ids) {
+        node.removeChild(id);
+    }
+    // 已经是延迟加载的节点（子树刚刚被加载出来）先回到未加载状态
+    node.unload();
+    node.setLoader(loader, budget);
+}
+
+} // namespace resource
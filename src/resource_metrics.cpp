@@ -0,0 +1,175 @@
+#include "resource_metrics.h"
+#include <cstdlib>
+#include <new>
+
+#if RESOURCE_ENABLE_METRICS
+namespace {
+thread_local uint64_t allocationCount = 0;
+}
+
+// 启用指标时替换全局operator new以统计每个线程的分配次数（数组形式默认转发到这里）
+void* operator new(std::size_t size) {
+    ++allocationCount;
+    for (;;) {
+        if (void* ptr = std::malloc(size ? size : 1)) {
+            return ptr;
+        }
+        std::new_handler handler = std::get_new_handler();
+        if (!handler) {
+            throw std::bad_alloc();
+        }
+        handler();
+    }
+}
+
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept {
+    try {
+        return ::operator new(size);
+    } catch (...) {
+        return nullptr;
+    }
+}
+
+void operator delete(void* ptr) noexcept { std::free(ptr); }
+void operator delete(void* ptr, const std::nothrow_t&) noexcept { std::free(ptr); }
+#endif
+
+namespace resource {
+
+namespace {
+
+const uint64_t BUCKET_BOUNDS[ResourceMetrics::BUCKET_COUNT - 1] = {
+    250, 1000, 4000, 16000, 64000, 256000, 1024000, 4096000, 16384000, 65536000, 262144000, 1048576000
+};
+
+const char* const OP_NAMES[] = {
+    "get_node_by_path",
+    "update_all_dynamic_objects",
+    "refresh_index",
+    "find_by_name",
+    "find_by_id",
+    "find_by_predicate",
+    "find_by_multi_conditions",
+    "find_by_attribute_indexed",
+    "find_greater_than",
+    "find_less_than",
+    "find_in_range",
+    "find_top_k",
+    "aggregate",
+    "aggregate_by"
+};
+
+static_assert(sizeof(OP_NAMES) / sizeof(OP_NAMES[0]) == static_cast<size_t>(MetricOp::Count),
+              "每个MetricOp都需要名称");
+
+} // namespace
+
+uint64_t threadAllocationCount() {
+#if RESOURCE_ENABLE_METRICS
+    return allocationCount;
+#else
+    return 0;
+#endif
+}
+
+const char* metricOpName(MetricOp op) {
+    return OP_NAMES[static_cast<size_t>(op)];
+}
+
+const uint64_t* ResourceMetrics::bucketBounds() {
+    return BUCKET_BOUNDS;
+}
+
+ResourceMetrics::ResourceMetrics() {
+    reset();
+}
+
+void ResourceMetrics::record(MetricOp op, uint64_t nanos, uint64_t allocations) {
+    Histogram& histogram = operations_[static_cast<size_t>(op)];
+    size_t bucket = 0;
+    while (bucket < BUCKET_COUNT - 1 && nanos > BUCKET_BOUNDS[bucket]) {
+        ++bucket;
+    }
+    histogram.count.fetch_add(1, std::memory_order_relaxed);
+    histogram.totalNanos.fetch_add(nanos, std::memory_order_relaxed);
+    histogram.allocations.fetch_add(allocations, std::memory_order_relaxed);
+    histogram.buckets[bucket].fetch_add(1, std::memory_order_relaxed);
+}
+
+void ResourceMetrics::snapshot(RegistryStats& stats) const {
+    stats.indexHits = indexHits_.load(std::memory_order_relaxed);
+    stats.indexScans = indexScans_.load(std::memory_order_relaxed);
+    stats.operations.clear();
+    for (size_t i = 0; i < static_cast<size_t>(MetricOp::Count); ++i) {
+        const Histogram& histogram = operations_[i];
+        OperationStats op;
+        op.name = OP_NAMES[i];
+        op.count = histogram.count.load(std::memory_order_relaxed);
+        op.totalNanos = histogram.totalNanos.load(std::memory_order_relaxed);
+        op.allocations = histogram.allocations.load(std::memory_order_relaxed);
+        for (size_t b = 0; b < BUCKET_COUNT; ++b) {
+            op.buckets.push_back(histogram.buckets[b].load(std::memory_order_relaxed));
+        }
+        stats.operations.push_back(op);
+    }
+}
+
+void ResourceMetrics::reset() {
+    for (auto& histogram : operations_) {
+        histogram.count.store(0, std::memory_order_relaxed);
+        histogram.totalNanos.store(0, std::memory_order_relaxed);
+        histogram.allocations.store(0, std::memory_order_relaxed);
+        for (auto& bucket : histogram.buckets) {
+            bucket.store(0, std::memory_order_relaxed);
+        }
+    }
+    indexHits_.store(0, std::memory_order_relaxed);
+    indexScans_.store(0, std::memory_order_relaxed);
+}
+
+void writePrometheus(std::ostream& out, const RegistryStats& stats) {
+    out << "# HELP resource_nodes Number of nodes in the registry.\n"
+        << "# TYPE resource_nodes gauge\n"
+        << "resource_nodes " << stats.nodeCount << "\n"
+        << "# HELP resource_root_nodes Number of root nodes in the registry.\n"
+        << "# TYPE resource_root_nodes gauge\n"
+        << "resource_root_nodes " << stats.rootCount << "\n"
+        << "# HELP resource_attributes Number of attributes over all nodes.\n"
+        << "# TYPE resource_attributes gauge\n"
+        << "resource_attributes " << stats.attributeCount << "\n";
+
+    if (!stats.metricsEnabled) {
+        return;
+    }
+
+    out << "# HELP resource_index_lookups_total Attribute queries by whether the index already existed.\n"
+        << "# TYPE resource_index_lookups_total counter\n"
+        << "resource_index_lookups_total{result=\"hit\"} " << stats.indexHits << "\n"
+        << "resource_index_lookups_total{result=\"scan\"} " << stats.indexScans << "\n";
+
+    out << "# HELP resource_operation_duration_seconds Latency of instrumented operations.\n"
+        << "# TYPE resource_operation_duration_seconds histogram\n";
+    for (const auto& op : stats.operations) {
+        uint64_t cumulative = 0;
+        for (size_t b = 0; b < op.buckets.size(); ++b) {
+            cumulative += op.buckets[b];
+            out << "resource_operation_duration_seconds_bucket{op=\"" << op.name << "\",le=\"";
+            if (b + 1 < op.buckets.size()) {
+                out << BUCKET_BOUNDS[b] / 1e9;
+            } else {
+                out << "+Inf";
+            }
+            out << "\"} " << cumulative << "\n";
+        }
+        out << "resource_operation_duration_seconds_sum{op=\"" << op.name << "\"} " << op.totalNanos / 1e9 << "\n"
+            << "resource_operation_duration_seconds_count{op=\"" << op.name << "\"} " << op.count << "\n";
+    }
+
+    out << "# HELP resource_operation_allocations_total Heap allocations made during instrumented operations.\n"
+        << "# TYPE resource_operation_allocations_total counter\n";
+    for (const auto& op : stats.operations) {
+        out << "resource_operation_allocations_total{op=\"" << op.name << "\"} " << op.allocations << "\n";
+    }
+}
+
+} // namespace resource
@@ -1,52 +1,264 @@
 #include "resource_node.h"
+#include "resource_lazy.h"
 #include <algorithm>
 #include <stdexcept>
 
 namespace resource {
 
+ResourceNode::ResourceNode(const std::string& name, const std::string& id, std::shared_ptr<const NodeSchema> schema)
+    : name_(name), id_(id), parent_(nullptr), schema_(schema), slots_(nullptr), row_(0), referenced_(false) {
+    constructSlots(nullptr);
+}
+
+ResourceNode::ResourceNode(const std::string& name, const std::string& id, std::shared_ptr<RowStorage> rows, size_t row)
+    : name_(name), id_(id), parent_(nullptr), schema_(rows->getSchema()), slots_(nullptr), rows_(rows), row_(row),
+      referenced_(false) {
+}
+
+ResourceNode::~ResourceNode() {
+    // 子节点可能被外部继续持有，断开其指向本节点的父指针
+    for (const auto& child : children_) {
+        if (child->parent_ == this) {
+            child->parent_ = nullptr;
+        }
+    }
+
+    if (slots_) {
+        for (size_t i = 0; i < schema_->fieldCount(); ++i) {
+            slotAt(i).~AttributeValue();
+        }
+        ::operator delete(slots_);
+    }
+    if (rows_) {
+        rows_->releaseRow(row_);
+    }
+    if (lazy_ && lazy_->budget && lazy_->loaded.load()) {
+        lazy_->budget->forget(this);
+    }
+}
+
+void ResourceNode::constructSlots(const ResourceNode* source) {
+    if (!schema_) {
+        return;
+    }
+    schema_->seal();
+
+    // operator new返回的内存满足所有基本类型的对齐要求
+    slots_ = static_cast<unsigned char*>(::operator new(schema_->slotSize() > 0 ? schema_->slotSize() : 1));
+    size_t constructed = 0;
+    try {
+        for (; constructed < schema_->fieldCount(); ++constructed) {
+            const NodeSchema::Field& field = schema_->field(constructed);
+            const AttributeValue& initial = source ? source->slotAt(constructed) : *field.defaultValue;
+            field.construct(slots_ + field.offset, initial);
+        }
+    } catch (...) {
+        while (constructed > 0) {
+            slotAt(--constructed).~AttributeValue();
+        }
+        ::operator delete(slots_);
+        slots_ = nullptr;
+        throw;
+    }
+}
+
+void ResourceNode::forEachAttribute(
+    const std::function<void(const std::string& key, const AttributeValue& value)>& visitor) const {
+    for (size_t i = 0; schema_ && i < schema_->fieldCount(); ++i) {
+        visitor(schema_->field(i).name, slotAt(i));
+    }
+    for (const auto& attr : attributes_) {
+        visitor(attr.first, *attr.second);
+    }
+}
+
+MemoryUsage ResourceNode::memoryUsage(bool recursive, std::map<std::string, size_t>* byAttribute) const {
+    MemoryUsage usage;
+    usage.nodeCount = 1;
+    // make_shared把控制块（虚表指针和两个计数）与节点分配在一起
+    usage.nodeHeaders = sizeof(ResourceNode) + sizeof(void*) + 2 * sizeof(int) + (lazy_ ? sizeof(LazyState) : 0);
+    // 名称和ID由字符串池共享，计入StringPool::memoryUsage
+    // 正在被其他读取方加载的节点按未加载统计，不读取加载过程中被替换的容器
+    if (isLoaded()) {
+        usage.childContainers = detail::vectorBytes(children_) + detail::hashTableBytes(childMap_);
+    }
+
+    // 模式字段直接构造在槽位中，值对象的大小即槽位的大小
+    forEachAttribute([&](const std::string& key, const AttributeValue& value) {
+        MemoryUsage valueUsage;
+        value.accountMemory(valueUsage);
+        usage.attributeValues += valueUsage.attributeValues;
+        usage.strings += valueUsage.strings;
+        if (byAttribute) {
+            (*byAttribute)[key] += valueUsage.total();
+        }
+    });
+
+    usage.attributeMaps = detail::hashTableBytes(attributes_);
+    for (const auto& attr : attributes_) {
+        size_t keyBytes = detail::stringHeapBytes(attr.first);
+        usage.strings += keyBytes;
+        if (byAttribute) {
+            (*byAttribute)[attr.first] += keyBytes + detail::hashNodeBytes<decltype(attributes_)>();
+        }
+    }
+
+    if (recursive) {
+        for (const auto& child : getLoadedChildren()) {
+            usage += child->memoryUsage(true, byAttribute);
+        }
+    }
+    return usage;
+}
+
+std::string ResourceNode::getPath() const {
+    std::vector<const ResourceNode*> chain;
+    for (const ResourceNode* node = this; node; node = node->parent_) {
+        chain.push_back(node);
+    }
+
+    std::string path;
+    for (auto it = chain.rbegin(); it != chain.rend(); ++it) {
+        if (!path.empty()) path += "/";
+        path += (*it)->getId();
+    }
+    return path;
+}
+
 void ResourceNode::addChild(std::shared_ptr<ResourceNode> child) {
     if (!child) {
         throw std::invalid_argument("Cannot add null child");
     }
+    if (lazy_) {
+        ensureLoaded();
+    }
     
     // 检查是否存在相同ID的子节点
-    if (childMap_.find(child->getId()) != childMap_.end()) {
+    if (childMap_.find(&child->getId()) != childMap_.end()) {
         throw std::invalid_argument("Child with ID " + child->getId() + " already exists");
     }
     
-    children_.push_back(child);
-    childMap_[child->getId()] = child;
+    child->parent_ = this;
+    childMap_.emplace(&child->getId(), child);
+    children_.push_back(std::move(child));
 }
 
 void ResourceNode::removeChild(const std::string& id) {
-    auto it = childMap_.find(id);
+    if (lazy_) {
+        ensureLoaded();
+    }
+    auto it = childMap_.find(&id);
     if (it == childMap_.end()) {
         return; // 节点不存在，直接返回
     }
     
     // 从vector中移除
+    const ResourceNode* target = it->second.get();
     auto vecIt = std::find_if(children_.begin(), children_.end(),
-        [&id](const std::shared_ptr<ResourceNode>& node) {
-            return node->getId() == id;
+        [target](const std::shared_ptr<ResourceNode>& node) {
+            return node.get() == target;
         });
         
     if (vecIt != children_.end()) {
         children_.erase(vecIt);
     }
+
+    if (it->second->parent_ == this) {
+        it->second->parent_ = nullptr;
+    }
     
     // 从map中移除
     childMap_.erase(it);
 }
 
+void ResourceNode::setLoader(NodeLoader loader, std::shared_ptr<LazyLoadBudget> budget) {
+    if (!loader) {
+        throw std::invalid_argument("Cannot set empty loader on node " + getId());
+    }
+    if (!children_.empty()) {
+        throw std::logic_error("Cannot make node with children lazy: " + getId());
+    }
+    if (lazy_ && lazy_->budget && lazy_->loaded.load()) {
+        lazy_->budget->forget(this);
+    }
+    lazy_.reset(new LazyState());
+    lazy_->loader = std::move(loader);
+    lazy_->budget = std::move(budget);
+}
+
+void ResourceNode::ensureLoaded() const {
+    LazyState& lazy = *lazy_;
+    if (lazy.budget) {
+        lazy.lastUse.store(lazy.budget->nextUse(), std::memory_order_relaxed);
+    }
+    if (lazy.loaded.load(std::memory_order_acquire)) {
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(lazy.mutex);
+    if (lazy.loaded.load(std::memory_order_relaxed)) {
+        return;
+    }
+    // 加载器在临时节点上建好整个子树后再移交，其他读取方看不到加载到一半的子节点
+    ResourceNode staging(getName(), getId());
+    lazy.loader(staging);
+
+    ResourceNode* self = const_cast<ResourceNode*>(this);
+    self->children_.swap(staging.children_);
+    self->childMap_.swap(staging.childMap_);
+    size_t bytes = detail::vectorBytes(children_) + detail::hashTableBytes(childMap_);
+    for (const auto& child : children_) {
+        child->parent_ = self;
+        bytes += child->memoryUsage(true).total();
+    }
+    lazy.loaded.store(true, std::memory_order_release);
+    if (lazy.budget) {
+        lazy.budget->noteLoaded(self, bytes);
+    }
+}
+
+bool ResourceNode::unload() {
+    if (!lazy_ || !lazy_->loaded.load()) {
+        return false;
+    }
+    {
+        std::lock_guard<std::mutex> lock(lazy_->mutex);
+        for (const auto& child : children_) {
+            if (child->parent_ == this) {
+                child->parent_ = nullptr;
+            }
+        }
+        std::vector<std::shared_ptr<ResourceNode>>().swap(children_);
+        StringRefMap<std::shared_ptr<ResourceNode>>().swap(childMap_);
+        lazy_->loaded.store(false, std::memory_order_release);
+    }
+    if (lazy_->budget) {
+        lazy_->budget->forget(this);
+    }
+    return true;
+}
+
 // 添加克隆方法
 std::shared_ptr<ResourceNode> ResourceNode::clone() const {
-    auto copy = std::make_shared<ResourceNode>(name_, id_);
+    auto copy = std::make_shared<ResourceNode>(name_.str(), id_.str());
     
+    // 复制模式字段（新节点绑定同一模式；行句柄的副本不属于任何表，字段存放在自己的槽位中）
+    if (schema_) {
+        copy->schema_ = schema_;
+        copy->constructSlots(this);
+    }
+
     // 复制属性
     for (const auto& attr : attributes_) {
         copy->attributes_[attr.first] = attr.second->clone();
     }
     
+    // 延迟加载的节点复制加载器，副本按需自行加载
+    if (lazy_) {
+        copy->setLoader(lazy_->loader, lazy_->budget);
+        return copy;
+    }
+
     // 递归复制子节点
     for (const auto& child : children_) {
         copy->addChild(child->clone());
@@ -65,44 +277,40 @@ void ResourceNode::traverse(const std::function<void(const std::shared_ptr<Resou
     visitor(thisPtr, depth);
     
     // 递归访问所有子节点
-    for (const auto& child : children_) {
+    for (const auto& child : getLoadedChildren()) {
         child->traverse(visitor, depth + 1);
     }
 }
 
 void simple_visitor(const std::shared_ptr<ResourceNode>& node, int depth) {
     std::string indent(depth * 2, ' ');
-    std::cout << indent << "- " << node->getName() << " (ID: " << node->getId() << ")" << std::endl;
+    // 使用'\n'而非std::endl，避免逐行刷新输出流
+    std::cout << indent << "- " << node->getName() << " (ID: " << node->getId() << ")" << '\n';
     
     // 打印节点属性
     auto keys = node->getAttributeKeys();
     if (!keys.empty()) {
         std::string attrIndent(depth * 2 + 2, ' ');
-        std::cout << attrIndent << "attr:" << std::endl;
+        std::cout << attrIndent << "attr:" << '\n';
         for (const auto& key : keys) {
             std::cout << attrIndent << "  " << key << ": ";
             
             // 尝试输出常见类型的属性值
-            try {
-                if (node->getAttributeType(key) == typeid(int)) {
-                    std::cout << node->getAttribute<int>(key);
-                }
-                else if (node->getAttributeType(key) == typeid(double)) {
-                    std::cout << node->getAttribute<double>(key);
-                }
-                else if (node->getAttributeType(key) == typeid(std::string)) {
-                    std::cout << node->getAttribute<std::string>(key);
-                }
-                else if (node->getAttributeType(key) == typeid(bool)) {
-                    std::cout << (node->getAttribute<bool>(key) ? "true" : "false");
-                }
-                else {
-                    std::cout << "[complex type]";
-                }
-            } catch (...) {
+            const AttributeValue* value = node->findAttribute(key);
+            if (!value) {
                 std::cout << "[error:can't read attribute]";
+            } else if (const int* number = value->as<int>()) {
+                std::cout << *number;
+            } else if (const double* real = value->as<double>()) {
+                std::cout << *real;
+            } else if (const std::string* text = value->as<std::string>()) {
+                std::cout << *text;
+            } else if (const bool* flag = value->as<bool>()) {
+                std::cout << (*flag ? "true" : "false");
+            } else {
+                std::cout << "[complex type]";
             }
-            std::cout << std::endl;
+            std::cout << '\n';
         }
     }
 }
@@ -0,0 +1,187 @@
+#include "resource_pipeline.h"
+#include <algorithm>
+
+namespace resource {
+
+namespace {
+
+// 每次领取的动态对象数，兼顾负载均衡和领取开销
+const size_t CONVERT_CHUNK = 64;
+
+} // namespace
+
+size_t TickPipeline::defaultWorkerCount() {
+    // 调用线程自己也参与转换
+    unsigned cores = std::thread::hardware_concurrency();
+    return cores > 2 ? cores - 2 : 0;
+}
+
+TickPipeline::TickPipeline(ResourceRegistry& registry, size_t workers)
+    : registry_(registry), stopping_(false), convertGeneration_(0), activeWorkers_(0), converting_(nullptr),
+      convertCount_(0), nextChunk_(0), mergePending_(false), submitted_(0), completed_(0) {
+    merger_ = std::thread(&TickPipeline::mergeLoop, this);
+    for (size_t i = 0; i < workers; ++i) {
+        workers_.push_back(std::thread(&TickPipeline::workerLoop, this));
+    }
+}
+
+TickPipeline::~TickPipeline() {
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        // 已提交的tick仍然合并完再退出
+        mergeCond_.wait(lock, [this]() { return completed_.load() == submitted_.load(); });
+        stopping_ = true;
+    }
+    workCond_.notify_all();
+    mergeCond_.notify_all();
+    for (auto& worker : workers_) {
+        worker.join();
+    }
+    merger_.join();
+}
+
+uint64_t TickPipeline::submitTick() {
+    rethrowPendingError();
+
+    std::vector<std::shared_ptr<ResourceNode>> converted(registry_.getDynamicObjectCount());
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        converting_ = &converted;
+        convertCount_ = converted.size();
+        nextChunk_ = 0;
+        activeWorkers_ = workers_.size();
+        ++convertGeneration_;
+    }
+    workCond_.notify_all();
+
+    // 调用线程也领取转换任务
+    std::exception_ptr convertError;
+    try {
+        convertChunks();
+    } catch (...) {
+        convertError = std::current_exception();
+        nextChunk_ = convertCount_;
+    }
+
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        doneCond_.wait(lock, [this]() { return activeWorkers_ == 0; });
+        converting_ = nullptr;
+        if (!convertError && error_) {
+            convertError = error_;
+            error_ = nullptr;
+        }
+    }
+    if (convertError) {
+        std::rethrow_exception(convertError);
+    }
+
+    uint64_t tick;
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        mergeCond_.wait(lock, [this]() { return !mergePending_; });
+        pending_ = std::move(converted);
+        mergePending_ = true;
+        tick = ++submitted_;
+    }
+    mergeCond_.notify_all();
+    return tick;
+}
+
+void TickPipeline::flush() {
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        mergeCond_.wait(lock, [this]() { return completed_.load() == submitted_.load(); });
+    }
+    rethrowPendingError();
+}
+
+void TickPipeline::query(const std::function<void()>& reader) const {
+    ReadLock lock(registry_.getMutex());
+    reader();
+}
+
+void TickPipeline::rethrowPendingError() {
+    std::exception_ptr error;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        std::swap(error, error_);
+    }
+    if (error) {
+        std::rethrow_exception(error);
+    }
+}
+
+void TickPipeline::convertChunks() {
+    for (;;) {
+        size_t begin = nextChunk_.fetch_add(CONVERT_CHUNK);
+        if (begin >= convertCount_) {
+            return;
+        }
+        registry_.convertDynamicObjects(begin, std::min(begin + CONVERT_CHUNK, convertCount_), *converting_);
+    }
+}
+
+void TickPipeline::workerLoop() {
+    uint64_t seen = 0;
+    for (;;) {
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            workCond_.wait(lock, [&]() { return stopping_ || convertGeneration_ != seen; });
+            if (stopping_) {
+                return;
+            }
+            seen = convertGeneration_;
+        }
+
+        try {
+            convertChunks();
+        } catch (...) {
+            // 放弃剩余的块，错误交给submitTick抛出
+            nextChunk_ = convertCount_;
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (!error_) {
+                error_ = std::current_exception();
+            }
+        }
+
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (--activeWorkers_ == 0) {
+            doneCond_.notify_all();
+        }
+    }
+}
+
+void TickPipeline::mergeLoop() {
+    for (;;) {
+        std::vector<std::shared_ptr<ResourceNode>> batch;
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            mergeCond_.wait(lock, [this]() { return stopping_ || mergePending_; });
+            if (!mergePending_) {
+                return;
+            }
+            batch.swap(pending_);
+            mergePending_ = false;
+        }
+        // 排队位置已空出，下一个tick可以提交
+        mergeCond_.notify_all();
+
+        try {
+            registry_.mergeDynamicObjects(batch);
+        } catch (...) {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (!error_) {
+                error_ = std::current_exception();
+            }
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            ++completed_;
+        }
+        mergeCond_.notify_all();
+    }
+}
+
+} // namespace resource
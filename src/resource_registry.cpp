@@ -1,10 +1,96 @@
 #include "resource_registry.h"
+#include "resource_changelog.h"
 #include <sstream>
+#include <algorithm>
+#include <exception>
 #include <stdexcept>
+#include <map>
+#include <thread>
 
 namespace resource {
 
-ResourceRegistry::ResourceRegistry() {}
+namespace {
+
+// 提交前的暂存视图：父路径的解析结果被缓存，同一父节点下的大量操作只导航一次；
+// 批次内已校验操作的节点增删记录在叠加层中，后续操作看到的是应用前面操作之后的树
+class StagedView {
+public:
+    explicit StagedView(const StringRefMap<std::shared_ptr<ResourceNode>>& roots)
+        : roots_(roots) {}
+
+    std::shared_ptr<ResourceNode> resolve(const std::string& path) {
+        size_t separator = path.rfind('/');
+        if (separator == std::string::npos) {
+            return lookup(nullptr, path);
+        }
+        auto parent = resolveParent(path.substr(0, separator));
+        return parent ? lookup(parent.get(), path.substr(separator + 1)) : nullptr;
+    }
+
+    // 记录路径上节点的替换（node为空表示删除），以该路径为前缀的父路径缓存全部失效
+    void stage(const std::string& path, const std::shared_ptr<ResourceNode>& node) {
+        size_t separator = path.rfind('/');
+        std::shared_ptr<ResourceNode> parent;
+        if (separator != std::string::npos) {
+            parent = resolveParent(path.substr(0, separator));
+        }
+        overlay_[std::make_pair(parent.get(), path.substr(separator + 1))] = node;
+
+        for (auto it = parents_.begin(); it != parents_.end();) {
+            const std::string& cached = it->first;
+            if (cached.compare(0, path.size(), path) == 0 &&
+                (cached.size() == path.size() || cached[path.size()] == '/')) {
+                it = parents_.erase(it);
+            } else {
+                ++it;
+            }
+        }
+    }
+
+private:
+    std::shared_ptr<ResourceNode> resolveParent(const std::string& path) {
+        auto it = parents_.find(path);
+        if (it != parents_.end()) {
+            return it->second;
+        }
+        auto node = resolve(path);
+        parents_[path] = node;
+        return node;
+    }
+
+    std::shared_ptr<ResourceNode> lookup(const ResourceNode* parent, const std::string& id) const {
+        if (!overlay_.empty()) {
+            auto staged = overlay_.find(std::make_pair(parent, id));
+            if (staged != overlay_.end()) {
+                return staged->second;
+            }
+        }
+        if (parent) {
+            return parent->getChild(id);
+        }
+        auto root = roots_.find(&id);
+        return root != roots_.end() ? root->second : nullptr;
+    }
+
+    const StringRefMap<std::shared_ptr<ResourceNode>>& roots_;
+    std::unordered_map<std::string, std::shared_ptr<ResourceNode>> parents_;
+    std::map<std::pair<const ResourceNode*, std::string>, std::shared_ptr<ResourceNode>> overlay_;
+};
+
+// 路径没有首尾和重复的分隔符时无需重新拆分
+bool isNormalizedPath(const std::string& path) {
+    if (path.empty()) {
+        return true;
+    }
+    if (path.front() == '/' || path.back() == '/') {
+        return false;
+    }
+    return path.find("//") == std::string::npos;
+}
+
+} // namespace
+
+ResourceRegistry::ResourceRegistry() : reloads_(std::make_shared<ReloadQueue>()) {}
 
 bool ResourceRegistry::registerRootNode(std::shared_ptr<ResourceNode> root) {
     if (!root) {
@@ -12,15 +98,67 @@ bool ResourceRegistry::registerRootNode(std::shared_ptr<ResourceNode> root) {
         return false;
     }
     
-    if (rootNodes_.find(root->getId()) != rootNodes_.end()) {
+    if (rootNodes_.find(&root->getId()) != rootNodes_.end()) {
         throw std::invalid_argument("Root node with ID " + root->getId() + " already registered");
         return false;
     }
     
-    rootNodes_[root->getId()] = root;
+    const ResourceNode& node = *root;
+    rootNodes_.emplace(&node.getId(), std::move(root));
+    recordNodeAdded(nullptr, node);
     return true;
 }
 
+void ResourceRegistry::unregisterRootNode(const std::string& rootId) {
+    auto it = rootNodes_.find(&rootId);
+    if (it != rootNodes_.end()) {
+        auto root = it->second;
+        rootNodes_.erase(it);
+        recordNodeRemoved(rootId, root);
+    }
+}
+
+bool ResourceRegistry::registerSchema(std::shared_ptr<const NodeSchema> schema) {
+    if (!schema) {
+        return false;
+    }
+    return schemas_.insert(std::make_pair(schema->getName(), schema)).second;
+}
+
+std::shared_ptr<const NodeSchema> ResourceRegistry::getSchema(const std::string& schemaName) const {
+    auto it = schemas_.find(schemaName);
+    return it != schemas_.end() ? it->second : nullptr;
+}
+
+std::shared_ptr<ResourceNode> ResourceRegistry::createNode(const std::string& schemaName,
+                                                           const std::string& name, const std::string& id) const {
+    auto schema = getSchema(schemaName);
+    if (!schema) {
+        return nullptr;
+    }
+    return std::make_shared<ResourceNode>(name, id, schema);
+}
+
+std::shared_ptr<ResourceTable> ResourceRegistry::getTable(const std::string& schemaName) {
+    auto it = tables_.find(schemaName);
+    if (it != tables_.end()) {
+        return it->second;
+    }
+    auto schema = getSchema(schemaName);
+    if (!schema) {
+        return nullptr;
+    }
+    auto table = ResourceTable::create(schema);
+    tables_[schemaName] = table;
+    return table;
+}
+
+std::shared_ptr<ResourceNode> ResourceRegistry::createRow(const std::string& schemaName,
+                                                          const std::string& name, const std::string& id) {
+    auto table = getTable(schemaName);
+    return table ? table->addRow(name, id) : nullptr;
+}
+
 std::vector<std::string> ResourceRegistry::splitPath(const std::string& path) const {
     std::vector<std::string> parts;
     std::stringstream ss(path);
@@ -36,6 +174,7 @@ std::vector<std::string> ResourceRegistry::splitPath(const std::string& path) co
 }
 
 std::shared_ptr<ResourceNode> ResourceRegistry::getNodeByPath(const std::string& path) const {
+    RESOURCE_METRIC_SCOPE(metrics_, GetNodeByPath);
     auto parts = splitPath(path);
     if (parts.empty()) {
         return nullptr;
@@ -91,12 +230,171 @@ bool ResourceRegistry::registerNodeAtPath(const std::string& path, std::shared_p
     // 添加节点
     try {
         parentNode->addChild(node);
+        recordNodeAdded(parentNode.get(), *node);
         return true;
     } catch (const std::exception&) {
         return false;
     }
 }
 
+size_t ResourceRegistry::registerChildren(const std::string& parentPath,
+                                         const std::vector<std::shared_ptr<ResourceNode>>& nodes) {
+    size_t attached = 0;
+    if (splitPath(parentPath).empty()) {
+        for (const auto& node : nodes) {
+            if (node && rootNodes_.find(&node->getId()) == rootNodes_.end()) {
+                registerRootNode(node);
+                ++attached;
+            }
+        }
+        return attached;
+    }
+
+    auto parentNode = getNodeByPath(parentPath);
+    if (!parentNode) {
+        return 0;
+    }
+    parentNode->reserveChildren(nodes.size());
+    // 父路径只拼接一次，所有节点的新增事件共用
+    const std::string resolvedPath = (changeLog_ || isTrackingChanges()) ? parentNode->getPath() : std::string();
+    for (const auto& node : nodes) {
+        if (!node || parentNode->getChild(node->getId())) {
+            continue;
+        }
+        parentNode->addChild(node);
+        recordNodeAdded(parentNode.get(), *node, &resolvedPath);
+        ++attached;
+    }
+    return attached;
+}
+
+size_t ResourceRegistry::evictChildren(const std::vector<std::shared_ptr<ResourceNode>>& nodes,
+                                      const std::vector<NodeLoader>& loaders) {
+    if (nodes.size() != loaders.size()) {
+        throw std::invalid_argument("Each evicted node needs a loader");
+    }
+    WriteLock lock(mutex_);
+    size_t evicted = 0;
+    for (size_t i = 0; i < nodes.size(); ++i) {
+        const auto& node = nodes[i];
+        if (!node || !loaders[i] || containsDynamicObject(*node)) {
+            continue;
+        }
+        // 未加载的延迟节点上没有子节点，直接换成新的加载器
+        const std::vector<std::shared_ptr<ResourceNode>> children = node->getLoadedChildren();
+        if (isTrackingChanges() && !children.empty()) {
+            const std::string path = node->getPath();
+            for (const auto& child : children) {
+                recordNodeRemoved(path + "/" + child->getId(), child, false);
+            }
+        }
+        if (!node->unload()) {
+            for (const auto& child : children) {
+                node->removeChild(child->getId());
+            }
+        }
+        node->setLoader(loaders[i]);
+        ++evicted;
+    }
+    publishChanges();
+    return evicted;
+}
+
+std::function<void(const std::shared_ptr<ResourceNode>&)> ResourceRegistry::reloadNotifier() {
+    std::weak_ptr<ReloadQueue> weakQueue = reloads_;
+    return [weakQueue](const std::shared_ptr<ResourceNode>& node) {
+        if (auto queue = weakQueue.lock()) {
+            std::lock_guard<std::mutex> lock(queue->mutex);
+            queue->nodes.push_back(node);
+            queue->pending.store(true, std::memory_order_release);
+        }
+    };
+}
+
+size_t ResourceRegistry::publishReloads() {
+    WriteLock lock(mutex_);
+    size_t republished = recordReloads();
+    publishChanges();
+    return republished;
+}
+
+size_t ResourceRegistry::recordReloads() {
+    if (!reloads_->pending.load(std::memory_order_acquire)) {
+        return 0;
+    }
+    std::vector<std::weak_ptr<ResourceNode>> pending;
+    {
+        std::lock_guard<std::mutex> lock(reloads_->mutex);
+        pending.swap(reloads_->nodes);
+        reloads_->pending.store(false, std::memory_order_relaxed);
+    }
+
+    // 同一节点可能在两次提交之间被加载、换出、再加载多次，只发布一次
+    std::unordered_set<const ResourceNode*> seen;
+    size_t republished = 0;
+    for (const auto& weak : pending) {
+        auto node = weak.lock();
+        if (!node || !node->isLazy() || !node->isLoaded() || !seen.insert(node.get()).second) {
+            continue;
+        }
+        if (isTrackingChanges()) {
+            const std::string path = node->getPath();
+            for (const auto& child : node->getLoadedChildren()) {
+                recordNodeAdded(node.get(), *child, &path, false);
+            }
+        }
+        ++republished;
+    }
+    return republished;
+}
+
+std::vector<std::shared_ptr<ResourceNode>> ResourceRegistry::convertStructs(const std::vector<const void*>& objects,
+                                                                            const StructConverter& converter,
+                                                                            const std::string& nodeName,
+                                                                            size_t workers) {
+    std::vector<std::shared_ptr<ResourceNode>> nodes(objects.size());
+    auto convertRange = [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+            nodes[i] = converter.convert(objects[i], nodeName);
+        }
+    };
+    if (workers == 0 || objects.size() <= workers) {
+        convertRange(0, objects.size());
+        return nodes;
+    }
+
+    // 调用线程转换第一块，其余各块交给额外的线程
+    const size_t chunk = (objects.size() + workers) / (workers + 1);
+    std::vector<std::exception_ptr> errors(workers + 1);
+    std::vector<std::thread> threads;
+    threads.reserve(workers);
+    for (size_t w = 1; w <= workers; ++w) {
+        const size_t begin = std::min(objects.size(), w * chunk);
+        const size_t end = w == workers ? objects.size() : std::min(objects.size(), begin + chunk);
+        threads.push_back(std::thread([&convertRange, &errors, begin, end, w]() {
+            try {
+                convertRange(begin, end);
+            } catch (...) {
+                errors[w] = std::current_exception();
+            }
+        }));
+    }
+    try {
+        convertRange(0, std::min(objects.size(), chunk));
+    } catch (...) {
+        errors[0] = std::current_exception();
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    for (const auto& error : errors) {
+        if (error) {
+            std::rethrow_exception(error);
+        }
+    }
+    return nodes;
+}
+
 bool ResourceRegistry::removeNodeByPath(const std::string& path) {
     auto parts = splitPath(path);
     if (parts.empty()) {
@@ -105,9 +403,11 @@ bool ResourceRegistry::removeNodeByPath(const std::string& path) {
     
     if (parts.size() == 1) {
         // 移除根节点
-        auto it = rootNodes_.find(parts[0]);
+        auto it = rootNodes_.find(&parts[0]);
         if (it != rootNodes_.end()) {
+            auto root = it->second;
             rootNodes_.erase(it);
+            recordNodeRemoved(parts[0], root);
             return true;
         }
         return false;
@@ -126,6 +426,12 @@ bool ResourceRegistry::removeNodeByPath(const std::string& path) {
     }
     
     // 移除子节点
+    if (changeLog_ || isTrackingChanges()) {
+        auto child = parentNode->getChild(parts.back());
+        if (child) {
+            recordNodeRemoved(parentNode->getPath() + "/" + parts.back(), child);
+        }
+    }
     parentNode->removeChild(parts.back());
     return true;
 }
@@ -149,6 +455,7 @@ std::shared_ptr<ResourceNode> ResourceRegistry::createPath(const std::string& pa
         if (!childNode) {
             childNode = std::make_shared<ResourceNode>(parts[i], parts[i]);
             currentNode->addChild(childNode);
+            recordNodeAdded(currentNode.get(), *childNode);
         }
         currentNode = childNode;
     }
@@ -172,7 +479,7 @@ void ResourceRegistry::traverseNodes(const std::function<void(std::shared_ptr<Re
         callback(node);
         
         // 递归处理所有子节点
-        for (const auto& child : node->getChildren()) {
+        for (const auto& child : node->getLoadedChildren()) {
             traverse(child);
         }
     };
@@ -188,6 +495,15 @@ bool ResourceRegistry::updateNode(std::shared_ptr<ResourceNode> node,
     std::shared_ptr<const StructConverter> converter) {
     if (!node || !objPtr || !converter) return false;
 
+    // 转换器支持时直接写入节点，不创建临时节点
+    AttributeChanges changes;
+    if (converter->updateInPlace(objPtr, *node, changes)) {
+        for (auto& change : changes) {
+            recordAttributeChanged(*node, *change.first, std::move(change.second));
+        }
+        return true;
+    }
+
     // 创建临时节点以获取最新属性
     auto tempNode = converter->convert(objPtr, node->getName());
     if (!tempNode) return false;
@@ -198,26 +514,78 @@ bool ResourceRegistry::updateNode(std::shared_ptr<ResourceNode> node,
     return true;
 }
 
+void ResourceRegistry::convertDynamicObjects(size_t begin, size_t end,
+                                             std::vector<std::shared_ptr<ResourceNode>>& converted) const {
+    for (size_t i = begin; i < end && i < dynamicObjects_.size(); ++i) {
+        const auto& obj = dynamicObjects_[i];
+        converted[i] = std::get<2>(obj)->convert(std::get<0>(obj), std::get<3>(obj)->getName());
+    }
+}
+
+void ResourceRegistry::mergeDynamicObjects(const std::vector<std::shared_ptr<ResourceNode>>& converted) {
+    WriteLock lock(mutex_);
+    RESOURCE_METRIC_SCOPE(metrics_, UpdateDynamicObjects);
+    for (size_t i = 0; i < converted.size() && i < dynamicObjects_.size(); ++i) {
+        if (!converted[i]) {
+            continue;
+        }
+        const auto& obj = dynamicObjects_[i];
+        if (std::get<2>(obj)->updatesInPlace()) {
+            mergeAttributes(*std::get<3>(obj), *converted[i]);
+        } else {
+            updateNodeAttributes(std::get<3>(obj), converted[i]);
+        }
+    }
+    publishChanges();
+}
+
 bool ResourceRegistry::removeDynamicObject(std::shared_ptr<ResourceNode> node) {
     auto it = std::find_if(dynamicObjects_.begin(), dynamicObjects_.end(),
-        [&node](const auto& item) {
+        [&node](const std::tuple<const void*, std::type_index,
+                                  std::shared_ptr<const StructConverter>,
+                                  std::shared_ptr<ResourceNode>>& item) {
             return std::get<3>(item) == node;
         });
     
     if (it != dynamicObjects_.end()) {
         dynamicObjects_.erase(it);
+        dynamicNodes_.erase(dynamicNodes_.find(node.get()));
         return true;
     }
     return false;
 }
 
+bool ResourceRegistry::containsDynamicObject(const ResourceNode& root) const {
+    if (dynamicNodes_.empty()) {
+        return false;
+    }
+    if (dynamicNodes_.count(&root) > 0) {
+        return true;
+    }
+    for (const auto& child : root.getLoadedChildren()) {
+        if (containsDynamicObject(*child)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+void ResourceRegistry::mergeAttributes(ResourceNode& target, const ResourceNode& source) {
+    // 值未变化的属性跳过，避免重复分配和无效日志
+    source.forEachAttribute([&](const std::string& key, const AttributeValue& value) {
+        const AttributeValue* existing = target.findAttribute(key);
+        if (existing && existing->equals(value)) {
+            return;
+        }
+        auto oldValue = target.exchangeAttributeRaw(key, value.clone());
+        recordAttributeChanged(target, key, std::move(oldValue));
+    });
+}
+
 void ResourceRegistry::updateNodeAttributes(std::shared_ptr<ResourceNode> target, 
                             std::shared_ptr<ResourceNode> source) {
     // 1. 更新所有属性
-    auto& sourceAttrs = source->getAttributes();
-    for (const auto& attr : sourceAttrs) {
-        target->updateAttributeRaw(std::get<0>(attr), std::get<1>(attr)->clone());  // key, value
-    }
+    mergeAttributes(*target, *source);
     
     // 2. 处理子节点
     const auto& sourceChildren = source->getChildren();
@@ -227,7 +595,7 @@ void ResourceRegistry::updateNodeAttributes(std::shared_ptr<ResourceNode> target
     for (const auto& sourceChild : sourceChildren) {
         bool found = false;
         for (const auto& targetChild : targetChildren) {
-            if (targetChild->getId() == sourceChild->getId()) {
+            if (targetChild->getInternedId() == sourceChild->getInternedId()) {
                 // 递归更新子节点
                 updateNodeAttributes(targetChild, sourceChild);
                 found = true;
@@ -237,7 +605,9 @@ void ResourceRegistry::updateNodeAttributes(std::shared_ptr<ResourceNode> target
         
         // 如果没找到匹配的子节点，添加新节点
         if (!found) {
-            target->addChild(sourceChild->clone());
+            auto child = sourceChild->clone();
+            target->addChild(child);
+            recordNodeAdded(target.get(), *child);
         }
     }
     
@@ -246,7 +616,7 @@ void ResourceRegistry::updateNodeAttributes(std::shared_ptr<ResourceNode> target
     for (const auto& targetChild : targetChildren) {
         bool found = false;
         for (const auto& sourceChild : sourceChildren) {
-            if (targetChild->getId() == sourceChild->getId()) {
+            if (targetChild->getInternedId() == sourceChild->getInternedId()) {
                 found = true;
                 break;
             }
@@ -258,12 +628,380 @@ void ResourceRegistry::updateNodeAttributes(std::shared_ptr<ResourceNode> target
     }
     
     for (const auto& childId : childrenToRemove) {
+        if (changeLog_ || isTrackingChanges()) {
+            recordNodeRemoved(target->getPath() + "/" + childId, target->getChild(childId));
+        }
         target->removeChild(childId);
     }
 }
 
+bool ResourceRegistry::setAttributeValue(const std::string& nodePath, const std::string& key,
+                                         std::unique_ptr<AttributeValue> value) {
+    auto node = getNodeByPath(nodePath);
+    if (!node) {
+        return false;
+    }
+    auto oldValue = node->exchangeAttributeRaw(key, std::move(value));
+    recordAttributeChanged(*node, key, std::move(oldValue));
+    return true;
+}
+
+bool ResourceRegistry::removeAttribute(const std::string& nodePath, const std::string& key) {
+    auto node = getNodeByPath(nodePath);
+    if (!node) {
+        return false;
+    }
+    auto oldValue = node->releaseAttribute(key);
+    if (!oldValue) {
+        return false;
+    }
+    recordAttributeRemoved(*node, key, std::move(oldValue));
+    return true;
+}
+
 void ResourceRegistry::clear() {
+    if (changeLog_ || isTrackingChanges()) {
+        for (const auto& pair : rootNodes_) {
+            recordNodeRemoved(*pair.first, pair.second);
+        }
+    }
     rootNodes_.clear();
 }
 
+MemoryReport ResourceRegistry::memoryUsage(bool byAttribute) const {
+    MemoryReport report;
+    std::map<std::string, size_t>* attributes = byAttribute ? &report.byAttribute : nullptr;
+    for (const auto& pair : rootNodes_) {
+        MemoryUsage usage = pair.second->memoryUsage(true, attributes);
+        report.byRoot[*pair.first] = usage;
+        report.total += usage;
+    }
+    for (const auto& pair : tables_) {
+        report.tables += pair.second->memoryUsage(attributes);
+    }
+    report.total += report.tables;
+
+    // 注册表自身的根节点表和模式表
+    report.total.childContainers += detail::hashTableBytes(rootNodes_);
+    report.total.attributeMaps += detail::hashTableBytes(schemas_) + detail::hashTableBytes(tables_);
+    report.internedStrings = StringPool::memoryUsage();
+    return report;
+}
+
+RegistryStats ResourceRegistry::stats() const {
+    RegistryStats result;
+    metrics_.snapshot(result);
+    result.rootCount = rootNodes_.size();
+    traverseNodes([&result](std::shared_ptr<ResourceNode> node) {
+        ++result.nodeCount;
+        result.attributeCount += node->attributeCount();
+    });
+    return result;
+}
+
+std::shared_ptr<ChangeSubscription> ResourceRegistry::subscribe(const std::string& path,
+                                                                bool includeSubtree,
+                                                                const std::vector<std::string>& attributeKeys,
+                                                                size_t capacity) {
+    // 统一路径格式，去掉首尾和重复的分隔符
+    std::string normalized;
+    for (const auto& part : splitPath(path)) {
+        if (!normalized.empty()) normalized += "/";
+        normalized += part;
+    }
+
+    auto subscription = std::make_shared<ChangeSubscription>(normalized, includeSubtree, attributeKeys, capacity);
+    subscriptions_.push_back(subscription);
+    return subscription;
+}
+
+bool ResourceRegistry::unsubscribe(const std::shared_ptr<ChangeSubscription>& subscription) {
+    auto it = std::find(subscriptions_.begin(), subscriptions_.end(), subscription);
+    if (it == subscriptions_.end()) {
+        return false;
+    }
+    subscriptions_.erase(it);
+    if (!isTrackingChanges()) {
+        pendingChanges_.clear();
+        pendingAttributeIndex_.clear();
+    }
+    return true;
+}
+
+void ResourceRegistry::addChangeListener(ChangeListener* listener) {
+    if (listener && std::find(listeners_.begin(), listeners_.end(), listener) == listeners_.end()) {
+        listeners_.push_back(listener);
+    }
+}
+
+void ResourceRegistry::removeChangeListener(ChangeListener* listener) {
+    auto it = std::find(listeners_.begin(), listeners_.end(), listener);
+    if (it == listeners_.end()) {
+        return;
+    }
+    listeners_.erase(it);
+    if (!isTrackingChanges()) {
+        pendingChanges_.clear();
+        pendingAttributeIndex_.clear();
+    }
+}
+
+void ResourceRegistry::commitChanges() {
+    WriteLock lock(mutex_);
+    publishChanges();
+}
+
+void ResourceRegistry::publishChanges() {
+    recordReloads();
+    if (changeLog_) {
+        changeLog_->logCommit();
+    }
+    if (pendingChanges_.empty()) {
+        return;
+    }
+
+    // 丢弃合并后实际没有变化的事件
+    ChangeBatch events;
+    events.reserve(pendingChanges_.size());
+    for (auto& event : pendingChanges_) {
+        if (event.type == ChangeEvent::Type::ATTRIBUTE_CHANGED &&
+            event.oldValue && event.newValue && event.oldValue->equals(*event.newValue)) {
+            continue;
+        }
+        if (event.type == ChangeEvent::Type::ATTRIBUTE_REMOVED && !event.oldValue) {
+            continue;  // 本批次内新增后又删除
+        }
+        events.push_back(std::move(event));
+    }
+    pendingChanges_.clear();
+    pendingAttributeIndex_.clear();
+    if (events.empty()) {
+        return;
+    }
+
+    // 监听器先于订阅者更新，保证订阅者收到通知时索引已经是最新的
+    for (auto* listener : listeners_) {
+        listener->onChangesCommitted(events);
+    }
+
+    for (const auto& subscription : subscriptions_) {
+        ChangeBatch batch;
+        for (const auto& event : events) {
+            if (subscription->matches(event)) {
+                batch.push_back(event);
+            }
+        }
+        if (!batch.empty()) {
+            subscription->publish(std::move(batch));
+        }
+    }
+}
+
+bool ResourceRegistry::commit(WriteBatch& batch, std::string* error) {
+    WriteLock lock(mutex_);
+
+    auto fail = [error](const std::string& message) {
+        if (error) *error = message;
+        return false;
+    };
+
+    // 1. 校验并解析所有操作，此阶段不修改节点树
+    auto& operations = batch.operations_;
+    std::vector<std::string> paths(operations.size());
+    std::vector<std::shared_ptr<ResourceNode>> targets(operations.size());
+    StagedView view(rootNodes_);
+
+    for (size_t i = 0; i < operations.size(); ++i) {
+        auto& op = operations[i];
+        std::string& path = paths[i];
+        if (isNormalizedPath(op.path)) {
+            path = op.path;
+        } else {
+            for (const auto& part : splitPath(op.path)) {
+                if (!path.empty()) path += "/";
+                path += part;
+            }
+        }
+
+        switch (op.type) {
+            case WriteBatch::Operation::Type::SET_ATTRIBUTE:
+            case WriteBatch::Operation::Type::REMOVE_ATTRIBUTE:
+                targets[i] = path.empty() ? nullptr : view.resolve(path);
+                if (!targets[i]) {
+                    return fail("Node not found: " + op.path);
+                }
+                // 模式字段的类型固定，类型不符时应用阶段会抛出异常，必须在这里拒绝
+                if (op.type == WriteBatch::Operation::Type::SET_ATTRIBUTE) {
+                    const auto& schema = targets[i]->getSchema();
+                    size_t field = schema ? schema->fieldIndex(op.key) : NodeSchema::npos;
+                    if (field != NodeSchema::npos && schema->field(field).tag != op.value->typeTag()) {
+                        return fail("Type mismatch for schema field " + op.key + " of: " + op.path);
+                    }
+                }
+                break;
+
+            case WriteBatch::Operation::Type::ADD_NODE: {
+                if (!op.node) {
+                    return fail("Cannot add null node under: " + op.path);
+                }
+                if (!path.empty()) {
+                    targets[i] = view.resolve(path);
+                    if (!targets[i]) {
+                        return fail("Parent node not found: " + op.path);
+                    }
+                }
+                std::string childPath = path.empty() ? op.node->getId() : path + "/" + op.node->getId();
+                if (view.resolve(childPath)) {
+                    return fail("Node already exists: " + childPath);
+                }
+                view.stage(childPath, op.node);
+                break;
+            }
+
+            case WriteBatch::Operation::Type::REMOVE_NODE: {
+                op.node = path.empty() ? nullptr : view.resolve(path);
+                if (!op.node) {
+                    return fail("Node not found: " + op.path);
+                }
+                size_t separator = path.rfind('/');
+                if (separator != std::string::npos) {
+                    targets[i] = view.resolve(path.substr(0, separator));
+                }
+                view.stage(path, nullptr);
+                break;
+            }
+        }
+    }
+
+    // 2. 按顺序应用，校验已经保证每一步都会成功
+    for (size_t i = 0; i < operations.size(); ++i) {
+        auto& op = operations[i];
+        const auto& target = targets[i];
+        switch (op.type) {
+            case WriteBatch::Operation::Type::SET_ATTRIBUTE: {
+                auto oldValue = target->exchangeAttributeRaw(op.key, std::move(op.value));
+                recordAttributeChanged(*target, op.key, std::move(oldValue), &paths[i]);
+                break;
+            }
+
+            case WriteBatch::Operation::Type::REMOVE_ATTRIBUTE: {
+                auto oldValue = target->releaseAttribute(op.key);
+                if (oldValue) {
+                    recordAttributeRemoved(*target, op.key, std::move(oldValue), &paths[i]);
+                }
+                break;
+            }
+
+            case WriteBatch::Operation::Type::ADD_NODE:
+                if (target) {
+                    target->addChild(op.node);
+                } else {
+                    rootNodes_.insert(std::make_pair(&op.node->getId(), op.node));
+                }
+                recordNodeAdded(target.get(), *op.node);
+                break;
+
+            case WriteBatch::Operation::Type::REMOVE_NODE:
+                recordNodeRemoved(paths[i], op.node);
+                if (target) {
+                    target->removeChild(op.node->getId());
+                } else {
+                    rootNodes_.erase(&op.node->getId());
+                }
+                break;
+        }
+    }
+
+    batch.clear();
+
+    // 3. 整个批次只通知一次
+    publishChanges();
+    return true;
+}
+
+void ResourceRegistry::recordAttributeChanged(const ResourceNode& node, const std::string& key,
+                                              std::unique_ptr<AttributeValue> oldValue,
+                                              const std::string* knownPath) {
+    if (!changeLog_ && !isTrackingChanges()) return;
+
+    const AttributeValue* value = node.findAttribute(key);
+    if (!value) return;
+
+    std::string path = knownPath ? *knownPath : node.getPath();
+    if (changeLog_) {
+        changeLog_->logSetAttribute(path, key, *value);
+    }
+    if (isTrackingChanges()) {
+        pushAttributeEvent(ChangeEvent::Type::ATTRIBUTE_CHANGED, node, path, key, std::move(oldValue),
+                           std::shared_ptr<const AttributeValue>(value->clone()));
+    }
+}
+
+void ResourceRegistry::recordAttributeRemoved(const ResourceNode& node, const std::string& key,
+                                              std::unique_ptr<AttributeValue> oldValue,
+                                              const std::string* knownPath) {
+    if (!changeLog_ && !isTrackingChanges()) return;
+
+    std::string path = knownPath ? *knownPath : node.getPath();
+    if (changeLog_) {
+        changeLog_->logRemoveAttribute(path, key);
+    }
+    if (isTrackingChanges()) {
+        pushAttributeEvent(ChangeEvent::Type::ATTRIBUTE_REMOVED, node, path, key, std::move(oldValue), nullptr);
+    }
+}
+
+void ResourceRegistry::pushAttributeEvent(ChangeEvent::Type type, const ResourceNode& node,
+                                          const std::string& path, const std::string& key,
+                                          std::unique_ptr<AttributeValue> oldValue,
+                                          std::shared_ptr<const AttributeValue> newValue) {
+    // 同一批次内对同一属性的多次修改合并：保留最早的旧值和最新的新值
+    std::string indexKey = path + '\x1f' + key;
+    auto it = pendingAttributeIndex_.find(indexKey);
+    if (it != pendingAttributeIndex_.end()) {
+        ChangeEvent& event = pendingChanges_[it->second];
+        event.type = type;
+        event.newValue = newValue;
+        return;
+    }
+
+    ChangeEvent event(type, path, key);
+    event.oldValue = std::shared_ptr<const AttributeValue>(std::move(oldValue));
+    event.newValue = newValue;
+    event.node = std::const_pointer_cast<ResourceNode>(node.shared_from_this());
+    pendingAttributeIndex_[indexKey] = pendingChanges_.size();
+    pendingChanges_.push_back(std::move(event));
+}
+
+void ResourceRegistry::recordNodeAdded(const ResourceNode* parent, const ResourceNode& node,
+                                       const std::string* knownParentPath, bool logged) {
+    if (!(changeLog_ && logged) && !isTrackingChanges()) return;
+
+    std::string parentPath = knownParentPath ? *knownParentPath : parent ? parent->getPath() : std::string();
+    if (changeLog_ && logged) {
+        changeLog_->logRegisterNode(parentPath, node);
+    }
+    if (isTrackingChanges()) {
+        // 结构变化后不再与之前的属性事件合并，保证事件顺序正确
+        pendingAttributeIndex_.clear();
+        ChangeEvent event(ChangeEvent::Type::NODE_ADDED,
+                          parentPath.empty() ? node.getId() : parentPath + "/" + node.getId());
+        event.node = std::const_pointer_cast<ResourceNode>(node.shared_from_this());
+        pendingChanges_.push_back(std::move(event));
+    }
+}
+
+void ResourceRegistry::recordNodeRemoved(const std::string& path, const std::shared_ptr<ResourceNode>& node,
+                                         bool logged) {
+    if (changeLog_ && logged) {
+        changeLog_->logRemoveNode(path);
+    }
+    if (isTrackingChanges()) {
+        pendingAttributeIndex_.clear();
+        ChangeEvent event(ChangeEvent::Type::NODE_REMOVED, path);
+        event.node = node;
+        pendingChanges_.push_back(std::move(event));
+    }
+}
+
 } // namespace resource
\ No newline at end of file
@@ -0,0 +1,240 @@
+#include "resource_serialization.h"
+#include <cstring>
+
+namespace resource {
+
+void BinaryWriter::writeU32(uint32_t value) {
+    for (int i = 0; i < 4; ++i) {
+        buffer_.push_back(static_cast<char>((value >> (8 * i)) & 0xFF));
+    }
+}
+
+void BinaryWriter::writeU64(uint64_t value) {
+    for (int i = 0; i < 8; ++i) {
+        buffer_.push_back(static_cast<char>((value >> (8 * i)) & 0xFF));
+    }
+}
+
+void BinaryWriter::writeDouble(double value) {
+    uint64_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    writeU64(bits);
+}
+
+void BinaryWriter::writeString(const std::string& value) {
+    writeU32(static_cast<uint32_t>(value.size()));
+    buffer_.append(value);
+}
+
+void BinaryWriter::writeBytes(const char* data, size_t size) {
+    buffer_.append(data, size);
+}
+
+bool BinaryReader::require(size_t bytes) {
+    if (!ok_ || size_ - pos_ < bytes) {
+        ok_ = false;
+        return false;
+    }
+    return true;
+}
+
+uint8_t BinaryReader::readU8() {
+    if (!require(1)) return 0;
+    return static_cast<uint8_t>(data_[pos_++]);
+}
+
+uint32_t BinaryReader::readU32() {
+    if (!require(4)) return 0;
+    uint32_t value = 0;
+    for (int i = 0; i < 4; ++i) {
+        value |= static_cast<uint32_t>(static_cast<uint8_t>(data_[pos_++])) << (8 * i);
+    }
+    return value;
+}
+
+uint64_t BinaryReader::readU64() {
+    if (!require(8)) return 0;
+    uint64_t value = 0;
+    for (int i = 0; i < 8; ++i) {
+        value |= static_cast<uint64_t>(static_cast<uint8_t>(data_[pos_++])) << (8 * i);
+    }
+    return value;
+}
+
+double BinaryReader::readDouble() {
+    uint64_t bits = readU64();
+    double value;
+    std::memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+std::string BinaryReader::readString() {
+    uint32_t length = readU32();
+    if (!require(length)) return std::string();
+    std::string value(data_ + pos_, length);
+    pos_ += length;
+    return value;
+}
+
+bool encodeAttributeValue(BinaryWriter& writer, const AttributeValue& value) {
+    const std::type_info& type = value.getType();
+    if (type == typeid(int)) {
+        writer.writeU8(static_cast<uint8_t>(ValueTypeCode::INT32));
+        writer.writeU32(static_cast<uint32_t>(*static_cast<const int*>(value.data())));
+    }
+    else if (type == typeid(long long)) {
+        writer.writeU8(static_cast<uint8_t>(ValueTypeCode::INT64));
+        writer.writeU64(static_cast<uint64_t>(*static_cast<const long long*>(value.data())));
+    }
+    else if (type == typeid(double)) {
+        writer.writeU8(static_cast<uint8_t>(ValueTypeCode::DOUBLE));
+        writer.writeDouble(*static_cast<const double*>(value.data()));
+    }
+    else if (type == typeid(float)) {
+        writer.writeU8(static_cast<uint8_t>(ValueTypeCode::FLOAT));
+        writer.writeDouble(*static_cast<const float*>(value.data()));
+    }
+    else if (type == typeid(bool)) {
+        writer.writeU8(static_cast<uint8_t>(ValueTypeCode::BOOL));
+        writer.writeU8(*static_cast<const bool*>(value.data()) ? 1 : 0);
+    }
+    else if (type == typeid(std::string)) {
+        writer.writeU8(static_cast<uint8_t>(ValueTypeCode::STRING));
+        writer.writeString(*static_cast<const std::string*>(value.data()));
+    }
+    else {
+        return false;
+    }
+    return true;
+}
+
+std::unique_ptr<AttributeValue> decodeAttributeValue(BinaryReader& reader) {
+    auto code = static_cast<ValueTypeCode>(reader.readU8());
+    std::unique_ptr<AttributeValue> value;
+    switch (code) {
+        case ValueTypeCode::INT32:
+            value.reset(new TypedAttributeValue<int>(static_cast<int>(reader.readU32())));
+            break;
+        case ValueTypeCode::INT64:
+            value.reset(new TypedAttributeValue<long long>(static_cast<long long>(reader.readU64())));
+            break;
+        case ValueTypeCode::DOUBLE:
+            value.reset(new TypedAttributeValue<double>(reader.readDouble()));
+            break;
+        case ValueTypeCode::FLOAT:
+            value.reset(new TypedAttributeValue<float>(static_cast<float>(reader.readDouble())));
+            break;
+        case ValueTypeCode::BOOL:
+            value.reset(new TypedAttributeValue<bool>(reader.readU8() != 0));
+            break;
+        case ValueTypeCode::STRING:
+            value.reset(new TypedAttributeValue<std::string>(reader.readString()));
+            break;
+        default:
+            return nullptr;
+    }
+    if (!reader.ok()) {
+        return nullptr;
+    }
+    return value;
+}
+
+void encodeNode(BinaryWriter& writer, const ResourceNode& node) {
+    writer.writeString(node.getName());
+    writer.writeString(node.getId());
+
+    // 先写入属性，再回填实际写入的数量（不支持的类型会被跳过）
+    std::string attrBuffer;
+    BinaryWriter attrWriter(attrBuffer);
+    uint32_t attrCount = 0;
+    node.forEachAttribute([&](const std::string& key, const AttributeValue& value) {
+        size_t mark = attrBuffer.size();
+        attrWriter.writeString(key);
+        if (encodeAttributeValue(attrWriter, value)) {
+            ++attrCount;
+        } else {
+            attrBuffer.resize(mark);
+        }
+    });
+    writer.writeU32(attrCount);
+    writer.writeBytes(attrBuffer.data(), attrBuffer.size());
+
+    const auto& children = node.getChildren();
+    writer.writeU32(static_cast<uint32_t>(children.size()));
+    for (const auto& child : children) {
+        encodeNode(writer, *child);
+    }
+}
+
+std::shared_ptr<ResourceNode> decodeNode(BinaryReader& reader) {
+    std::string name = reader.readString();
+    std::string id = reader.readString();
+    if (!reader.ok()) return nullptr;
+
+    auto node = std::make_shared<ResourceNode>(name, id);
+
+    uint32_t attrCount = reader.readU32();
+    for (uint32_t i = 0; i < attrCount && reader.ok(); ++i) {
+        std::string key = reader.readString();
+        auto value = decodeAttributeValue(reader);
+        if (!value) return nullptr;
+        node->updateAttributeRaw(key, std::move(value));
+    }
+
+    uint32_t childCount = reader.readU32();
+    for (uint32_t i = 0; i < childCount && reader.ok(); ++i) {
+        auto child = decodeNode(reader);
+        if (!child) return nullptr;
+        node->addChild(std::move(child));
+    }
+
+    return reader.ok() ? node : nullptr;
+}
+
+void encodeChildren(BinaryWriter& writer, const ResourceNode& node) {
+    const auto& children = node.getChildren();
+    writer.writeU32(static_cast<uint32_t>(children.size()));
+    for (const auto& child : children) {
+        encodeNode(writer, *child);
+    }
+}
+
+bool decodeChildren(BinaryReader& reader, ResourceNode& target) {
+    uint32_t count = reader.readU32();
+    for (uint32_t i = 0; i < count && reader.ok(); ++i) {
+        auto child = decodeNode(reader);
+        if (!child) return false;
+        target.addChild(std::move(child));
+    }
+    return reader.ok() && reader.atEnd();
+}
+
+namespace {
+
+struct Crc32Table {
+    uint32_t entries[256];
+
+    Crc32Table() {
+        for (uint32_t i = 0; i < 256; ++i) {
+            uint32_t c = i;
+            for (int k = 0; k < 8; ++k) {
+                c = (c & 1) ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+            }
+            entries[i] = c;
+        }
+    }
+};
+
+} // namespace
+
+uint32_t crc32(const char* data, size_t size) {
+    static const Crc32Table table;
+
+    uint32_t crc = 0xFFFFFFFFu;
+    for (size_t i = 0; i < size; ++i) {
+        crc = table.entries[(crc ^ static_cast<uint8_t>(data[i])) & 0xFF] ^ (crc >> 8);
+    }
+    return crc ^ 0xFFFFFFFFu;
+}
+
+} // namespace resource
@@ -0,0 +1,235 @@
+#include "resource_spill.h"
+#include "resource_serialization.h"
+#include <cstdio>
+#include <mutex>
+#include <stdexcept>
+
+namespace resource {
+
+namespace detail {
+
+// 只追加的换出文件，多个读取方线程可以同时从中加载
+class SpillFile {
+public:
+    explicit SpillFile(const std::string& path) : path_(path), file_(nullptr), size_(0), reads_(0) {
+#ifdef _WIN32
+        if (fopen_s(&file_, path.c_str(), "w+b") != 0) {
+            file_ = nullptr;
+        }
+#else
+        file_ = std::fopen(path.c_str(), "w+b");
+#endif
+        if (!file_) {
+            throw std::runtime_error("Cannot open spill file: " + path);
+        }
+    }
+
+    ~SpillFile() {
+        std::fclose(file_);
+        std::remove(path_.c_str());
+    }
+
+    SpillFile(const SpillFile&) = delete;
+    SpillFile& operator=(const SpillFile&) = delete;
+
+    // 返回记录的起始偏移
+    uint64_t append(const std::string& record) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (std::fseek(file_, static_cast<long>(size_), SEEK_SET) != 0 ||
+            std::fwrite(record.data(), 1, record.size(), file_) != record.size() || std::fflush(file_) != 0) {
+            throw std::runtime_error("Cannot write spill file: " + path_);
+        }
+        uint64_t offset = size_;
+        size_ += record.size();
+        return offset;
+    }
+
+    std::string read(uint64_t offset, size_t length) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        std::string record(length, '\0');
+        if (std::fseek(file_, static_cast<long>(offset), SEEK_SET) != 0 ||
+            std::fread(&record[0], 1, length, file_) != length) {
+            throw std::runtime_error("Cannot read spill file: " + path_);
+        }
+        ++reads_;
+        return record;
+    }
+
+    uint64_t size() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return size_;
+    }
+
+    size_t reads() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return reads_;
+    }
+
+private:
+    std::string path_;
+    mutable std::mutex mutex_;
+    FILE* file_;
+    uint64_t size_;
+    size_t reads_;
+};
+
+} // namespace detail
+
+namespace {
+
+// 后代能否原样换出：没有模式字段和延迟加载的节点，所有属性都能二进制编码
+bool encodable(const ResourceNode& node) {
+    if (node.getSchema() || node.isLazy()) {
+        return false;
+    }
+    std::string scratch;
+    BinaryWriter writer(scratch);
+    for (const auto& attr : node.getAttributes()) {
+        scratch.clear();
+        if (!encodeAttributeValue(writer, *attr.second)) {
+            return false;
+        }
+    }
+    for (const auto& child : node.getLoadedChildren()) {
+        if (!encodable(*child)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// 候选子树的根节点留作桩不写入文件，可以是已加载的桩（再次换出）
+bool spillable(const ResourceNode& root) {
+    for (const auto& child : root.getLoadedChildren()) {
+        if (!encodable(*child)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// 换出后释放的字节数：整个子树减去桩节点自身（子节点表随子树一起释放）
+size_t childBytes(const ResourceNode& node) {
+    MemoryUsage self = node.memoryUsage(false);
+    return node.memoryUsage(true).total() - self.total() + self.childContainers;
+}
+
+// 加载器只持有桩节点的弱引用，桩节点的LazyState持有加载器，不形成循环
+// 加载完成后向注册表登记桩节点，下一次提交时加载回来的后代重新进入索引
+NodeLoader spillLoader(const std::shared_ptr<detail::SpillFile>& file, const std::shared_ptr<ResourceNode>& stub,
+                       uint64_t offset, size_t length,
+                       const std::function<void(const std::shared_ptr<ResourceNode>&)>& notifyReload) {
+    std::weak_ptr<ResourceNode> weakStub = stub;
+    return [file, weakStub, offset, length, notifyReload](ResourceNode& target) {
+        std::string record = file->read(offset, length);
+        BinaryReader reader(record.data(), record.size());
+        if (!decodeChildren(reader, target)) {
+            throw std::runtime_error("Corrupted spill record for node " + target.getId());
+        }
+        if (auto node = weakStub.lock()) {
+            notifyReload(node);
+        }
+    };
+}
+
+} // namespace
+
+SpillManager::SpillManager(ResourceRegistry& registry, const std::string& spillPath, size_t budgetBytes)
+    : registry_(registry),
+      file_(std::make_shared<detail::SpillFile>(spillPath)),
+      budget_(budgetBytes),
+      hand_(0),
+      residentBytes_(0),
+      spills_(0) {}
+
+// 桩节点的加载器持有换出文件，文件在最后一个桩释放后才关闭
+SpillManager::~SpillManager() {}
+
+void SpillManager::manage(const std::string& parentPath) {
+    managed_.push_back(parentPath);
+}
+
+std::vector<std::shared_ptr<ResourceNode>> SpillManager::candidates() const {
+    std::vector<std::shared_ptr<ResourceNode>> nodes;
+    for (const auto& path : managed_) {
+        auto parent = registry_.getNodeByPath(path);
+        if (parent) {
+            const auto& children = parent->getLoadedChildren();
+            nodes.insert(nodes.end(), children.begin(), children.end());
+        }
+    }
+    return nodes;
+}
+
+size_t SpillManager::publishReloads() {
+    return registry_.publishReloads();
+}
+
+size_t SpillManager::sweep() {
+    // 先让上次提交以来加载回来的后代重新进入索引，再决定换出哪些子树
+    publishReloads();
+    std::vector<std::shared_ptr<ResourceNode>> nodes = candidates();
+    std::vector<size_t> bytes(nodes.size(), 0);
+    size_t resident = 0;
+    for (size_t i = 0; i < nodes.size(); ++i) {
+        if (nodes[i]->isLoaded()) {
+            bytes[i] = childBytes(*nodes[i]);
+            resident += bytes[i];
+        }
+    }
+
+    std::vector<std::shared_ptr<ResourceNode>> victims;
+    std::vector<NodeLoader> loaders;
+    const auto notifyReload = registry_.reloadNotifier();
+    if (!nodes.empty() && resident > budget_) {
+        // 最多转两圈：第一圈清除访问位，第二圈换出仍未被访问的子树
+        std::vector<bool> done(nodes.size(), false);
+        size_t pos = hand_ % nodes.size();
+        for (size_t step = 0; step < 2 * nodes.size() && resident > budget_; ++step) {
+            const size_t i = pos;
+            pos = (pos + 1) % nodes.size();
+            const auto& node = nodes[i];
+            if (done[i] || bytes[i] == 0 || node->clearReferenced()) {
+                continue;
+            }
+            done[i] = true;
+            if (!spillable(*node) || registry_.containsDynamicObject(*node)) {
+                continue;
+            }
+            std::string record;
+            BinaryWriter writer(record);
+            encodeChildren(writer, *node);
+            node->clearReferenced();  // 编码时的getChildren不算访问
+            const uint64_t offset = file_->append(record);
+            victims.push_back(node);
+            loaders.push_back(spillLoader(file_, node, offset, record.size(), notifyReload));
+            resident -= bytes[i];
+        }
+        hand_ = pos;
+    }
+
+    size_t spilled = victims.empty() ? 0 : registry_.evictChildren(victims, loaders);
+    spills_ += spilled;
+    residentBytes_ = resident;
+    return spilled;
+}
+
+size_t SpillManager::spilledCount() const {
+    size_t count = 0;
+    for (const auto& node : candidates()) {
+        if (!node->isLoaded()) {
+            ++count;
+        }
+    }
+    return count;
+}
+
+size_t SpillManager::reloadCount() const {
+    return file_->reads();
+}
+
+uint64_t SpillManager::fileBytes() const {
+    return file_->size();
+}
+
+} // namespace resource
@@ -0,0 +1,86 @@
+#include "resource_string_pool.h"
+#include "resource_memory.h"
+#include <mutex>
+
+namespace resource {
+
+namespace {
+
+const size_t SHARD_COUNT = 16;
+
+struct Shard {
+    std::mutex mutex;
+    StringRefMap<StringPool::Entry*> entries;  // 键指向条目自身的value
+};
+
+// 有意不释放：静态对象析构顺序不确定，程序退出时仍可能有节点持有驻留字符串
+Shard* shards() {
+    static Shard* pool = new Shard[SHARD_COUNT];
+    return pool;
+}
+
+Shard& shardFor(size_t hash) {
+    return shards()[(hash >> 4) % SHARD_COUNT];
+}
+
+} // namespace
+
+StringPool::Entry* StringPool::acquire(const std::string& value) {
+    const size_t hash = std::hash<std::string>()(value);
+    Shard& shard = shardFor(hash);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    auto it = shard.entries.find(&value);
+    if (it != shard.entries.end()) {
+        it->second->refs.fetch_add(1, std::memory_order_relaxed);
+        return it->second;
+    }
+    Entry* entry = new Entry(value, hash);
+    try {
+        shard.entries.insert(std::make_pair(&entry->value, entry));
+    } catch (...) {
+        delete entry;
+        throw;
+    }
+    return entry;
+}
+
+void StringPool::release(Entry* entry) {
+    // 不是最后一个引用时无锁递减
+    size_t refs = entry->refs.load();
+    while (refs > 1) {
+        if (entry->refs.compare_exchange_weak(refs, refs - 1)) {
+            return;
+        }
+    }
+    // 可能是最后一个引用：在分片锁内递减，与acquire互斥，避免删除刚被重新取得的条目
+    Shard& shard = shardFor(entry->hash);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    if (entry->refs.fetch_sub(1) == 1) {
+        shard.entries.erase(&entry->value);
+        delete entry;
+    }
+}
+
+size_t StringPool::size() {
+    size_t count = 0;
+    for (size_t i = 0; i < SHARD_COUNT; ++i) {
+        std::lock_guard<std::mutex> lock(shards()[i].mutex);
+        count += shards()[i].entries.size();
+    }
+    return count;
+}
+
+size_t StringPool::memoryUsage() {
+    size_t bytes = 0;
+    for (size_t i = 0; i < SHARD_COUNT; ++i) {
+        Shard& shard = shards()[i];
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        bytes += detail::hashTableBytes(shard.entries);
+        for (const auto& pair : shard.entries) {
+            bytes += sizeof(Entry) + detail::stringHeapBytes(pair.second->value);
+        }
+    }
+    return bytes;
+}
+
+} // namespace resource
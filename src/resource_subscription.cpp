@@ -0,0 +1,56 @@
+#include "resource_subscription.h"
+
+namespace resource {
+
+ChangeSubscription::ChangeSubscription(const std::string& path, bool includeSubtree,
+                                       const std::vector<std::string>& attributeKeys, size_t capacity)
+    : path_(path),
+      includeSubtree_(includeSubtree),
+      attributeKeys_(attributeKeys.begin(), attributeKeys.end()),
+      ring_(capacity > 0 ? capacity : 1),
+      dropped_(0) {}
+
+bool ChangeSubscription::isWithin(const std::string& path) const {
+    if (path_.empty()) {
+        return true;  // 空路径订阅整个注册表
+    }
+    if (path.compare(0, path_.size(), path_) != 0) {
+        return false;
+    }
+    if (path.size() == path_.size()) {
+        return true;
+    }
+    return includeSubtree_ && path[path_.size()] == '/';
+}
+
+bool ChangeSubscription::isAncestor(const std::string& path) const {
+    return !path_.empty() && path_.size() > path.size() && path_.compare(0, path.size(), path) == 0 &&
+           path_[path.size()] == '/';
+}
+
+bool ChangeSubscription::matches(const ChangeEvent& event) const {
+    switch (event.type) {
+        case ChangeEvent::Type::ATTRIBUTE_CHANGED:
+        case ChangeEvent::Type::ATTRIBUTE_REMOVED:
+            if (!attributeKeys_.empty() && attributeKeys_.count(event.key) == 0) {
+                return false;
+            }
+            return isWithin(event.path);
+
+        case ChangeEvent::Type::NODE_REMOVED:
+        case ChangeEvent::Type::NODE_ADDED:
+            // 订阅路径的祖先被删除，或者连同订阅的节点一起挂载时同样需要通知
+            return isAncestor(event.path) || isWithin(event.path);
+    }
+    return false;
+}
+
+bool ChangeSubscription::publish(ChangeBatch&& batch) {
+    if (ring_.tryPush(std::move(batch))) {
+        return true;
+    }
+    dropped_.fetch_add(1, std::memory_order_relaxed);
+    return false;
+}
+
+} // namespace resource
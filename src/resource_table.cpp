@@ -0,0 +1,84 @@
+#include "resource_table.h"
+#include <stdexcept>
+
+namespace resource {
+
+std::shared_ptr<ResourceTable> ResourceTable::create(std::shared_ptr<const NodeSchema> schema) {
+    if (!schema) {
+        throw std::invalid_argument("Cannot create table without schema");
+    }
+    return std::shared_ptr<ResourceTable>(new ResourceTable(schema));
+}
+
+ResourceTable::ResourceTable(std::shared_ptr<const NodeSchema> schema) : schema_(schema) {
+    schema_->seal();
+    columns_.reserve(schema_->fieldCount());
+    for (size_t i = 0; i < schema_->fieldCount(); ++i) {
+        columns_.push_back(schema_->field(i).makeColumn());
+    }
+}
+
+void ResourceTable::reserve(size_t rows) {
+    rows_.reserve(rows);
+    for (auto& column : columns_) {
+        column->reserve(rows);
+    }
+}
+
+MemoryUsage ResourceTable::memoryUsage(std::map<std::string, size_t>* byAttribute) const {
+    MemoryUsage usage;
+    usage.attributeValues = detail::vectorBytes(rows_) + detail::vectorBytes(columns_);
+    for (size_t i = 0; i < columns_.size(); ++i) {
+        MemoryUsage column;
+        columns_[i]->accountMemory(column);
+        usage += column;
+        if (byAttribute) {
+            (*byAttribute)[schema_->field(i).name] += column.total();
+        }
+    }
+    return usage;
+}
+
+size_t ResourceTable::fieldIndex(const std::string& fieldName) const {
+    size_t index = schema_->fieldIndex(fieldName);
+    if (index == NodeSchema::npos) {
+        throw std::invalid_argument("Schema " + schema_->getName() + " has no field " + fieldName);
+    }
+    return index;
+}
+
+std::shared_ptr<ResourceNode> ResourceTable::addRow(const std::string& name, const std::string& id) {
+    const size_t row = rows_.size();
+    rows_.push_back(nullptr);
+
+    // 任一步失败时撤销已追加的列元素，保持各列等长
+    size_t appended = 0;
+    try {
+        for (; appended < columns_.size(); ++appended) {
+            columns_[appended]->append(*schema_->field(appended).defaultValue);
+        }
+        auto node = std::make_shared<ResourceNode>(name, id, shared_from_this(), row);
+        rows_[row] = node.get();
+        return node;
+    } catch (...) {
+        while (appended > 0) {
+            columns_[--appended]->swapRemove(row);
+        }
+        rows_.pop_back();
+        throw;
+    }
+}
+
+void ResourceTable::releaseRow(size_t row) {
+    const size_t last = rows_.size() - 1;
+    for (auto& column : columns_) {
+        column->swapRemove(row);
+    }
+    if (row != last) {
+        rows_[row] = rows_[last];
+        rows_[row]->row_ = row;
+    }
+    rows_.pop_back();
+}
+
+} // namespace resource
@@ -0,0 +1,187 @@
+#include "resource_api.h"
+#include <cmath>
+
+#ifdef _WIN32
+#include <windows.h>
+#endif
+
+using namespace resource;
+
+const int WAREHOUSE_COUNT = 20;
+const int ITEMS_PER_WAREHOUSE = 500;
+
+bool sameAggregate(const AggregateResult& a, const AggregateResult& b) {
+    return a.count == b.count && a.min == b.min && a.max == b.max &&
+           std::abs(a.sum - b.sum) < 1e-6 * (1.0 + std::abs(b.sum));
+}
+
+void printAggregate(const std::string& title, const AggregateResult& result) {
+    std::cout << title << ": 数量 " << result.count << ", 总和 " << result.sum << ", 最小 " << result.min
+              << ", 最大 " << result.max << ", 平均 " << result.average() << std::endl;
+}
+
+int main()
+{
+#ifdef _WIN32
+    SetConsoleOutputCP(CP_UTF8);
+#endif
+    int failures = 0;
+    ResourceRegistry registry;
+
+    const std::vector<std::string> categories = {"弹药", "燃料", "备件", "食品"};
+    auto depot = std::make_shared<ResourceNode>("仓储中心", "depot");
+    for (int w = 0; w < WAREHOUSE_COUNT; ++w) {
+        auto warehouse = std::make_shared<ResourceNode>("仓库", "w" + std::to_string(w));
+        for (int i = 0; i < ITEMS_PER_WAREHOUSE; ++i) {
+            auto item = std::make_shared<ResourceNode>("物资", "item" + std::to_string(i));
+            item->setAttribute("类别", categories[(w + i) % categories.size()]);
+            item->setAttribute("库存数量", (w * 37 + i * 13) % 1000);
+            item->setAttribute("紧缺", i % 7 == 0);
+            warehouse->addChild(item);
+        }
+        depot->addChild(warehouse);
+    }
+    registry.registerRootNode(depot);
+    ResourceIndexer indexer(registry);
+
+    std::cout << "=== 数值聚合 ===" << std::endl;
+    AggregateResult scanned;
+    long long scanTime = measureTime([&]() { scanned = indexer.aggregate("库存数量"); });
+    indexer.createAttributeIndex<int>("库存数量");
+    AggregateResult indexed;
+    long long indexTime = measureTime([&]() { indexed = indexer.aggregate("库存数量"); });
+    printAggregate("扫描", scanned);
+    printAggregate("索引", indexed);
+    std::cout << "扫描耗时: " << scanTime << " 微秒, 索引耗时: " << indexTime << " 微秒" << std::endl;
+    if (scanned.count != static_cast<size_t>(WAREHOUSE_COUNT * ITEMS_PER_WAREHOUSE)) ++failures;
+    if (!sameAggregate(scanned, indexed)) ++failures;
+
+    AggregateResult subtree = indexer.aggregate("库存数量", "depot/w3");
+    printAggregate("仓库w3", subtree);
+    if (subtree.count != static_cast<size_t>(ITEMS_PER_WAREHOUSE)) ++failures;
+
+    std::cout << "\n=== 分组聚合 ===" << std::endl;
+    auto byCategory = indexer.aggregateBy("类别", "库存数量");
+    for (const auto& group : byCategory) {
+        printAggregate(group.first, group.second);
+    }
+    auto byShortage = indexer.aggregateBy("紧缺", "库存数量", "depot/w0");
+    std::cout << "w0 紧缺物资: " << byShortage["true"].count << ", 非紧缺: " << byShortage["false"].count << std::endl;
+    if (byCategory.size() != categories.size()) ++failures;
+    if (byShortage["true"].count + byShortage["false"].count != static_cast<size_t>(ITEMS_PER_WAREHOUSE)) ++failures;
+
+    std::cout << "\n=== 更新后增量维护 ===" << std::endl;
+    indexer.createGroupAggregate("类别", "库存数量");
+    for (int i = 0; i < ITEMS_PER_WAREHOUSE; i += 5) {
+        std::string path = "depot/w1/item" + std::to_string(i);
+        registry.setAttribute(path, "库存数量", 5000 + i);
+        registry.setAttribute(path, "类别", std::string("弹药"));
+    }
+    registry.removeNodeByPath("depot/w2");
+    auto extra = std::make_shared<ResourceNode>("物资", "extra");
+    extra->setAttribute("类别", std::string("医疗"));
+    extra->setAttribute("库存数量", -3);
+    registry.registerNodeAtPath("depot/w0/extra", extra);
+    registry.commitChanges();
+
+    AggregateResult maintainedTotal;
+    std::map<std::string, AggregateResult> maintainedGroups;
+    long long maintainedTime = measureTime([&]() {
+        maintainedTotal = indexer.aggregate("库存数量");
+        maintainedGroups = indexer.aggregateBy("类别", "库存数量");
+    });
+
+    // 对照：从当前树重新扫描
+    ResourceIndexer fresh(registry);
+    AggregateResult freshTotal;
+    std::map<std::string, AggregateResult> freshGroups;
+    long long freshTime = measureTime([&]() {
+        freshTotal = fresh.aggregate("库存数量");
+        freshGroups = fresh.aggregateBy("类别", "库存数量");
+    });
+    printAggregate("维护的总计", maintainedTotal);
+    printAggregate("重新扫描的总计", freshTotal);
+    std::cout << "维护结果查询耗时: " << maintainedTime << " 微秒, 重新扫描耗时: " << freshTime << " 微秒" << std::endl;
+    if (!sameAggregate(maintainedTotal, freshTotal)) ++failures;
+    if (maintainedGroups.size() != freshGroups.size()) ++failures;
+    for (const auto& group : freshGroups) {
+        if (!sameAggregate(maintainedGroups[group.first], group.second)) {
+            std::cout << "分组不一致: " << group.first << std::endl;
+            ++failures;
+        }
+    }
+    std::cout << "医疗分组: " << maintainedGroups["医疗"].count << " 项, 最大库存: " << maintainedGroups["弹药"].max << std::endl;
+    if (maintainedGroups["医疗"].count != 1 || maintainedGroups["弹药"].max != 5495) ++failures;
+
+    std::cout << "\n=== 混合类型的属性 ===" << std::endl;
+    // 同一属性既有int又有double，分组属性既有字符串又有布尔，建了部分索引的结果须与扫描一致
+    ResourceRegistry mixed;
+    auto convoy = std::make_shared<ResourceNode>("车队", "convoy");
+    for (int i = 0; i < 300; ++i) {
+        auto truck = std::make_shared<ResourceNode>("车辆", "t" + std::to_string(i));
+        if (i % 3 == 0) {
+            truck->setAttribute("载重", 2.5 + i);
+        } else {
+            truck->setAttribute("载重", i);
+        }
+        if (i % 4 == 0) {
+            truck->setAttribute("状态", i % 8 == 0);
+        } else {
+            truck->setAttribute("状态", std::string(i % 2 == 0 ? "行驶" : "待命"));
+        }
+        convoy->addChild(truck);
+    }
+    mixed.registerRootNode(convoy);
+    ResourceIndexer partial(mixed);
+    ResourceIndexer scanOnly(mixed);
+    partial.createAttributeIndex<int>("载重");
+    partial.createAttributeIndex<std::string>("状态");
+
+    auto sameGroups = [](const std::map<std::string, AggregateResult>& a,
+                         const std::map<std::string, AggregateResult>& b) {
+        if (a.size() != b.size()) return false;
+        for (const auto& group : b) {
+            auto it = a.find(group.first);
+            if (it == a.end() || !sameAggregate(it->second, group.second)) return false;
+        }
+        return true;
+    };
+    AggregateResult partialLoad = partial.aggregate("载重");
+    AggregateResult scannedLoad = scanOnly.aggregate("载重");
+    printAggregate("只有int索引", partialLoad);
+    printAggregate("扫描", scannedLoad);
+    if (scannedLoad.count != 300 || !sameAggregate(partialLoad, scannedLoad)) ++failures;
+    if (!sameGroups(partial.aggregateBy("状态", "载重"), scanOnly.aggregateBy("状态", "载重"))) ++failures;
+
+    // 各类型都有索引后改用索引，结果不变
+    partial.createAttributeIndex<double>("载重");
+    partial.createAttributeIndex<bool>("状态");
+    if (!sameAggregate(partial.aggregate("载重"), scannedLoad)) ++failures;
+    if (!sameGroups(partial.aggregateBy("状态", "载重"), scanOnly.aggregateBy("状态", "载重"))) ++failures;
+
+    // 提交中出现没有索引的类型后回到扫描
+    mixed.setAttribute("convoy/t1", "载重", 7.5f);
+    mixed.setAttribute("convoy/t2", "状态", true);
+    mixed.commitChanges();
+    AggregateResult afterFloat = partial.aggregate("载重");
+    printAggregate("写入float后", afterFloat);
+    if (!sameAggregate(afterFloat, scanOnly.aggregate("载重")) || afterFloat.count != 300) ++failures;
+    if (!sameGroups(partial.aggregateBy("状态", "载重"), scanOnly.aggregateBy("状态", "载重"))) ++failures;
+
+    std::cout << "\n=== 列存储聚合 ===" << std::endl;
+    auto schema = std::make_shared<NodeSchema>("导弹");
+    schema->addField<double>("射程");
+    registry.registerSchema(schema);
+    auto table = registry.getTable("导弹");
+    std::vector<std::shared_ptr<ResourceNode>> rows;
+    for (int i = 0; i < 1000; ++i) {
+        rows.push_back(table->addRow("导弹", "m" + std::to_string(i)));
+        rows.back()->setAttribute("射程", 100.0 + i);
+    }
+    AggregateResult ranges = table->aggregate<double>("射程");
+    printAggregate("射程", ranges);
+    if (ranges.count != 1000 || ranges.min != 100.0 || ranges.max != 1099.0 || ranges.average() != 599.5) ++failures;
+
+    std::cout << "\n失败项: " << failures << std::endl;
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,182 @@
+#include "resource_api.h"
+#include <set>
+
+#ifdef _WIN32
+#include <windows.h>
+#endif
+
+using namespace resource;
+
+const int UNIT_COUNT = 60000;
+
+// 简单的线性同余随机数，保证各平台结果一致
+struct Lcg {
+    uint32_t state;
+    explicit Lcg(uint32_t seed) : state(seed) {}
+    // 低位周期很短，取高位
+    uint32_t next() {
+        state = state * 1664525u + 1013904223u;
+        return state >> 8;
+    }
+};
+
+std::set<uint32_t> toSet(const RoaringBitmap& bitmap) {
+    std::set<uint32_t> values;
+    bitmap.forEach([&](uint32_t value) { values.insert(value); });
+    return values;
+}
+
+bool sameNodes(std::vector<std::shared_ptr<ResourceNode>> a, std::vector<std::shared_ptr<ResourceNode>> b) {
+    std::sort(a.begin(), a.end());
+    std::sort(b.begin(), b.end());
+    return a == b;
+}
+
+int main()
+{
+#ifdef _WIN32
+    SetConsoleOutputCP(CP_UTF8);
+#endif
+    int failures = 0;
+
+    std::cout << "=== 压缩位图集合运算 ===" << std::endl;
+    // 第0块稠密（位集），第1块稀疏（数组），第3块只在b中
+    RoaringBitmap a, b;
+    std::set<uint32_t> setA, setB;
+    Lcg rng(7);
+    for (int i = 0; i < 30000; ++i) {
+        uint32_t value = rng.next() % 65536;
+        a.add(value);
+        setA.insert(value);
+    }
+    for (int i = 0; i < 2000; ++i) {
+        uint32_t value = 65536 + rng.next() % 65536;
+        a.add(value);
+        setA.insert(value);
+        value = rng.next() % (4 * 65536);
+        b.add(value);
+        setB.insert(value);
+    }
+    std::set<uint32_t> expectAnd, expectOr, expectDiff;
+    std::set_intersection(setA.begin(), setA.end(), setB.begin(), setB.end(), std::inserter(expectAnd, expectAnd.end()));
+    std::set_union(setA.begin(), setA.end(), setB.begin(), setB.end(), std::inserter(expectOr, expectOr.end()));
+    std::set_difference(setA.begin(), setA.end(), setB.begin(), setB.end(), std::inserter(expectDiff, expectDiff.end()));
+    bool algebra = toSet(a & b) == expectAnd && toSet(a | b) == expectOr && toSet(a - b) == expectDiff &&
+                   toSet(b - a).size() == setB.size() - expectAnd.size();
+    std::cout << "a: " << a.cardinality() << ", b: " << b.cardinality() << ", a&b: " << (a & b).cardinality()
+              << ", a|b: " << (a | b).cardinality() << ", a-b: " << (a - b).cardinality() << std::endl;
+    if (!algebra || a.cardinality() != setA.size()) ++failures;
+
+    // 删除到阈值以下后位集转回数组，结果与重新插入的位图相同
+    RoaringBitmap shrunk = a;
+    RoaringBitmap rebuilt;
+    size_t kept = 0;
+    for (uint32_t value : setA) {
+        if (value < 65536 && kept++ >= 1000) {
+            shrunk.remove(value);
+        } else {
+            rebuilt.add(value);
+        }
+    }
+    std::cout << "删除后元素数: " << shrunk.cardinality() << ", 内存: " << shrunk.memoryBytes() << " 字节 (删除前 "
+              << a.memoryBytes() << ")" << std::endl;
+    if (shrunk != rebuilt || shrunk.memoryBytes() >= a.memoryBytes() || !shrunk.contains(*setA.rbegin())) {
+        ++failures;
+    }
+
+    std::cout << "\n=== 分类属性的组合条件 ===" << std::endl;
+    const char* fuels[] = {"柴油", "汽油", "电力"};
+    const char* seekers[] = {"红外", "雷达", "激光", "电视", "复合", "无"};
+    ResourceRegistry registry;
+    auto army = std::make_shared<ResourceNode>("部队", "army");
+    for (int i = 0; i < UNIT_COUNT; ++i) {
+        auto unit = std::make_shared<ResourceNode>("单元", "u" + std::to_string(i));
+        unit->setAttribute("燃料", std::string(fuels[i % 3]));
+        unit->setAttribute("已部署", i % 4 != 0);
+        unit->setAttribute("导引头", std::string(seekers[i % 6]));
+        army->addChild(unit);
+    }
+    registry.registerRootNode(army);
+    ResourceIndexer indexer(registry);
+    indexer.createAttributeIndex<std::string>("燃料", IndexKind::Bitmap);
+    indexer.createAttributeIndex<bool>("已部署", IndexKind::Bitmap);
+    indexer.createAttributeIndex<std::string>("导引头", IndexKind::Bitmap);
+
+    auto predicate = [](const std::shared_ptr<ResourceNode>& node) {
+        if (!node->hasAttribute("燃料")) return false;
+        const std::string fuel = node->getAttribute<std::string>("燃料");
+        const std::string seeker = node->getAttribute<std::string>("导引头");
+        return fuel == "柴油" && node->getAttribute<bool>("已部署") && (seeker == "红外" || seeker == "雷达");
+    };
+    std::vector<std::shared_ptr<ResourceNode>> scanned, combined;
+    long long scanTime = measureTime([&]() { scanned = indexer.findByPredicate(predicate); });
+    long long bitmapTime = measureTime([&]() {
+        combined = indexer.nodesOf(indexer.bitmapOf<std::string>("燃料", "柴油") &
+                                   indexer.bitmapOf<bool>("已部署", true) &
+                                   indexer.bitmapOfAny<std::string>("导引头", {"红外", "雷达"}));
+    });
+    std::cout << "扫描: " << scanTime << " 微秒, 位图: " << bitmapTime << " 微秒, 结果数: " << combined.size()
+              << std::endl;
+    if (scanned.empty() || !sameNodes(scanned, combined)) ++failures;
+
+    // 取反：未部署或不是柴油的单元
+    auto notDiesel = indexer.nodesOf(indexer.bitmapOfAll<std::string>("燃料") -
+                                     (indexer.bitmapOf<std::string>("燃料", "柴油") &
+                                      indexer.bitmapOf<bool>("已部署", true)));
+    std::cout << "其余单元: " << notDiesel.size() << std::endl;
+    if (notDiesel.size() + indexer.nodesOf(indexer.bitmapOf<std::string>("燃料", "柴油") &
+                                           indexer.bitmapOf<bool>("已部署", true)).size() != UNIT_COUNT) {
+        ++failures;
+    }
+
+    std::cout << "\n=== 增量维护与行号回收 ===" << std::endl;
+    for (int i = 0; i < 300; ++i) {
+        registry.setAttribute("army/u" + std::to_string(i), "燃料", std::string("电力"));
+    }
+    for (int i = 300; i < 600; ++i) {
+        registry.removeNodeByPath("army/u" + std::to_string(i));
+    }
+    registry.commitChanges();
+    for (int i = 0; i < 200; ++i) {
+        auto unit = std::make_shared<ResourceNode>("单元", "new" + std::to_string(i));
+        unit->setAttribute("燃料", std::string("柴油"));
+        unit->setAttribute("已部署", true);
+        unit->setAttribute("导引头", std::string("红外"));
+        registry.registerNodeAtPath("army/new" + std::to_string(i), unit);
+    }
+    registry.commitChanges();
+    combined = indexer.nodesOf(indexer.bitmapOf<std::string>("燃料", "柴油") & indexer.bitmapOf<bool>("已部署", true) &
+                               indexer.bitmapOfAny<std::string>("导引头", {"红外", "雷达"}));
+    scanned = indexer.findByPredicate(predicate);
+    std::vector<std::shared_ptr<ResourceNode>> electric = indexer.findByAttributeIndexed<std::string>("燃料", "电力");
+    std::cout << "组合结果数: " << combined.size() << ", 电力: " << electric.size() << std::endl;
+    if (!sameNodes(scanned, combined)) ++failures;
+    if (!sameNodes(electric, indexer.findByAttribute<std::string>("燃料", "电力"))) ++failures;
+
+    // 记下位图索引的内存，与后面导引头上的有序索引对比
+    std::map<std::string, size_t> byIndex;
+    indexer.memoryUsage(&byIndex);
+    indexer.refreshIndex();
+    size_t afterRefresh = indexer.nodesOf(indexer.bitmapOf<std::string>("燃料", "柴油")).size();
+    std::cout << "重建后柴油: " << afterRefresh << std::endl;
+    if (afterRefresh != indexer.findByAttribute<std::string>("燃料", "柴油").size()) ++failures;
+
+    std::cout << "\n=== 内存对比 ===" << std::endl;
+    indexer.createAttributeIndex<std::string>("导引头");
+    std::map<std::string, size_t> orderedBytes;
+    indexer.memoryUsage(&orderedBytes);
+    std::cout << "位图索引(燃料): " << byIndex["燃料"] << " 字节, 有序索引(导引头): " << orderedBytes["导引头"]
+              << " 字节, 共用行号: " << byIndex["bitmap_rows"] << " 字节" << std::endl;
+    if (byIndex["燃料"] == 0 || byIndex["燃料"] * 4 > orderedBytes["导引头"]) ++failures;
+
+    bool rejected = false;
+    try {
+        indexer.bitmapOf<std::string>("导引头", "红外");
+    } catch (const std::logic_error&) {
+        rejected = true;
+    }
+    if (!rejected) ++failures;
+
+    std::cout << "\n失败项: " << failures << std::endl;
+    return failures == 0 ? 0 : 1;
+}
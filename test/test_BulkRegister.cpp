@@ -0,0 +1,165 @@
+#include "resource_api.h"
+#include <stdexcept>
+
+#ifdef _WIN32
+#include <windows.h>
+#endif
+
+using namespace resource;
+
+const int AGENT_COUNT = 50000;
+
+struct Agent {
+    std::string id;
+    int side;
+    double longitude;
+    double latitude;
+};
+
+class AgentConverter : public StructConverter {
+public:
+    std::shared_ptr<ResourceNode> convert(const void* structPtr, const std::string& nodeName) const override {
+        const Agent& agent = *static_cast<const Agent*>(structPtr);
+        if (agent.id.empty()) {
+            return nullptr;
+        }
+        if (agent.id == "bad") {
+            throw std::runtime_error("cannot convert agent");
+        }
+        auto node = std::make_shared<ResourceNode>(nodeName, agent.id);
+        node->setAttribute("阵营", agent.side);
+        node->setAttribute("经度", agent.longitude);
+        node->setAttribute("纬度", agent.latitude);
+        return node;
+    }
+
+    StructConverter* clone() const override { return new AgentConverter(*this); }
+};
+
+std::vector<Agent> makeAgents(int count) {
+    std::vector<Agent> agents(count);
+    for (int i = 0; i < count; ++i) {
+        agents[i].id = "a" + std::to_string(i);
+        agents[i].side = i % 3;
+        agents[i].longitude = 116.0 + i * 0.0001;
+        agents[i].latitude = 39.0 - i * 0.0001;
+    }
+    return agents;
+}
+
+// 统计提交次数和收到的新增事件数
+class BatchCounter : public ChangeListener {
+public:
+    BatchCounter() : batches(0), added(0) {}
+    void onChangesCommitted(const ChangeBatch& batch) override {
+        ++batches;
+        for (const auto& event : batch) {
+            if (event.type == ChangeEvent::Type::NODE_ADDED) ++added;
+        }
+    }
+
+    size_t batches;
+    size_t added;
+};
+
+int main()
+{
+#ifdef _WIN32
+    SetConsoleOutputCP(CP_UTF8);
+#endif
+    int failures = 0;
+    AgentConverter converter;
+    std::vector<Agent> agents = makeAgents(AGENT_COUNT);
+
+    std::cout << "=== 逐个注册与批量注册 ===" << std::endl;
+    ResourceRegistry one;
+    one.createPath("scenario/red/agents");
+    ResourceIndexer oneIndexer(one);
+    oneIndexer.createAttributeIndex<int>("阵营");
+    long long oneTime = measureTime([&]() {
+        one.registerStructs<Agent>(agents, "scenario/red/agents", converter,
+                                   [](const Agent& agent) { return agent.id; });
+        one.commitChanges();
+    });
+
+    ResourceRegistry bulk;
+    bulk.createPath("scenario/red/agents");
+    ResourceIndexer bulkIndexer(bulk);
+    bulkIndexer.createAttributeIndex<int>("阵营");
+    BatchCounter counter;
+    bulk.addChangeListener(&counter);
+    size_t attached = 0;
+    long long bulkTime = measureTime([&]() {
+        attached = bulk.registerStructsBulk(agents, "scenario/red/agents", converter, "agent", 2);
+    });
+    bulk.removeChangeListener(&counter);
+    std::cout << "逐个注册: " << oneTime << " 微秒, 批量注册: " << bulkTime << " 微秒, 挂载: " << attached
+              << ", 提交次数: " << counter.batches << std::endl;
+    if (attached != AGENT_COUNT || counter.batches != 1 || counter.added != AGENT_COUNT) ++failures;
+
+    // 两棵树内容一致，顺序与输入相同
+    auto oneParent = one.getNodeByPath("scenario/red/agents");
+    auto bulkParent = bulk.getNodeByPath("scenario/red/agents");
+    bool same = oneParent->getChildren().size() == bulkParent->getChildren().size();
+    for (size_t i = 0; same && i < bulkParent->getChildren().size(); ++i) {
+        const auto& a = oneParent->getChildren()[i];
+        const auto& b = bulkParent->getChildren()[i];
+        same = a->getId() == b->getId() && b->getName() == "agent" &&
+               a->getAttribute<double>("经度") == b->getAttribute<double>("经度") &&
+               b->getParent() == bulkParent.get();
+    }
+    std::cout << "内容一致: " << (same ? "是" : "否") << std::endl;
+    if (!same) ++failures;
+
+    std::cout << "\n=== 索引在同一批次中更新 ===" << std::endl;
+    size_t side1 = bulkIndexer.findByAttributeIndexed<int>("阵营", 1).size();
+    size_t byId = bulkIndexer.findById("a4242").size();
+    std::cout << "阵营1: " << side1 << ", 按ID: " << byId << std::endl;
+    if (side1 != oneIndexer.findByAttributeIndexed<int>("阵营", 1).size() || side1 == 0 || byId != 1) ++failures;
+    if (bulk.getNodeByPath("scenario/red/agents/a4242")->getPath() != "scenario/red/agents/a4242") ++failures;
+
+    std::cout << "\n=== 跳过的对象 ===" << std::endl;
+    // 转换失败（返回空）和已存在的ID被跳过，其余照常挂载
+    std::vector<Agent> extra = makeAgents(5);
+    extra[1].id = "";
+    extra[3].id = "fresh";
+    size_t extraAttached = bulk.registerStructsBulk(extra, "scenario/red/agents", converter);
+    std::cout << "挂载: " << extraAttached << std::endl;
+    if (extraAttached != 1 || !bulk.getNodeByPath("scenario/red/agents/fresh")) ++failures;
+
+    // 父路径不存在时什么也不做
+    if (bulk.registerStructsBulk(extra, "scenario/blue", converter) != 0) ++failures;
+
+    // 父路径为空时作为根节点注册
+    std::vector<Agent> roots = makeAgents(3);
+    size_t rootAttached = bulk.registerStructsBulk(roots, "", converter, "root");
+    std::cout << "根节点: " << rootAttached << std::endl;
+    if (rootAttached != 3 || !bulk.getRootNode("a2")) ++failures;
+
+    std::cout << "\n=== 转换异常 ===" << std::endl;
+    std::vector<Agent> broken = makeAgents(1000);
+    broken[777].id = "bad";
+    bool thrown = false;
+    try {
+        bulk.registerStructsBulk(broken, "scenario/red", converter, "agent", 3);
+    } catch (const std::runtime_error& e) {
+        thrown = true;
+        std::cout << "异常: " << e.what() << std::endl;
+    }
+    // 转换阶段失败时不挂载任何节点
+    if (!thrown || bulk.getNodeByPath("scenario/red")->getChildren().size() != 1) ++failures;
+
+    std::cout << "\n=== 手动组装的节点 ===" << std::endl;
+    std::vector<std::shared_ptr<ResourceNode>> nodes;
+    for (int i = 0; i < 10; ++i) {
+        nodes.push_back(std::make_shared<ResourceNode>("仓库", "d" + std::to_string(i)));
+    }
+    nodes.push_back(nullptr);
+    size_t depots = bulk.registerChildren("scenario", nodes);
+    bulk.commitChanges();
+    std::cout << "挂载: " << depots << std::endl;
+    if (depots != 10 || bulkIndexer.findByName("仓库").size() != 10) ++failures;
+
+    std::cout << "\n失败项: " << failures << std::endl;
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,149 @@
+#include "resource_api.h"
+#include <cstdio>
+
+#ifdef _WIN32
+#include <windows.h>
+#endif
+
+using namespace resource;
+
+// 构建演示用的弹群树
+std::shared_ptr<ResourceNode> buildGroup() {
+    auto group = std::make_shared<ResourceNode>("弹群1", "group001");
+    group->setAttribute("类型", std::string("演示用混合弹群"));
+    auto cluster = std::make_shared<ResourceNode>("弹簇1", "cluster001");
+    group->addChild(cluster);
+
+    for (int i = 1; i <= 3; ++i) {
+        auto missile = std::make_shared<ResourceNode>("弹" + std::to_string(i), "m1-" + std::to_string(i));
+        missile->setAttribute("射程", 100.0 * i);
+        missile->setAttribute("已部署", false);
+        cluster->addChild(missile);
+    }
+    return group;
+}
+
+int main()
+{
+#ifdef _WIN32
+    SetConsoleOutputCP(CP_UTF8);
+#endif
+    const std::string snapshotPath = "test_changelog.snapshot";
+    const std::string logPath = "test_changelog.wal";
+    std::remove(snapshotPath.c_str());
+    std::remove(logPath.c_str());
+
+    int failures = 0;
+
+    {
+        ResourceRegistry registry;
+        ChangeLogOptions options;
+        options.fsyncPolicy = FsyncPolicy::NEVER;
+        auto changeLog = std::make_shared<ChangeLog>(logPath, options);
+        registry.attachChangeLog(changeLog);
+
+        registry.registerRootNode(buildGroup());
+
+        std::cout << "\n=== 写入快照并截断日志 ===" << std::endl;
+        if (!changeLog->checkpoint(registry, snapshotPath)) {
+            std::cout << "快照写入失败" << std::endl;
+            ++failures;
+        }
+
+        std::cout << "\n=== 快照之后的变更 ===" << std::endl;
+        registry.setAttribute("group001/cluster001/m1-1", "已部署", true);
+        registry.updateAttribute(registry.getNodeByPath("group001/cluster001/m1-2"), "射程", 450.0);
+        registry.registerNodeAtPath("group001/cluster001/m1-4", std::make_shared<ResourceNode>("弹4", "m1-4"));
+        registry.setAttribute("group001/cluster001/m1-4", "目标", "Berkeley1");
+        registry.removeNodeByPath("group001/cluster001/m1-3");
+        registry.removeAttribute("group001", "类型");
+        changeLog->logCommit();
+        changeLog->sync();
+        std::cout << "已落盘记录数: " << changeLog->durableSequence() << std::endl;
+
+        registry.traverseRootNode(simple_visitor);
+        // 模拟崩溃：直接丢弃注册表
+    }
+
+    std::cout << "\n=== 从快照和日志恢复 ===" << std::endl;
+    ResourceRegistry recovered;
+    if (!ChangeLog::loadSnapshot(snapshotPath, recovered)) {
+        std::cout << "快照加载失败" << std::endl;
+        ++failures;
+    }
+    size_t applied = ChangeLog::replay(logPath, recovered);
+    std::cout << "重放记录数: " << applied << std::endl;
+    recovered.traverseRootNode(simple_visitor);
+
+    auto m1 = recovered.getNodeByPath("group001/cluster001/m1-1");
+    auto m2 = recovered.getNodeByPath("group001/cluster001/m1-2");
+    auto m4 = recovered.getNodeByPath("group001/cluster001/m1-4");
+    if (!m1 || !m1->getAttribute<bool>("已部署")) ++failures;
+    if (!m2 || m2->getAttribute<double>("射程") != 450.0) ++failures;
+    if (!m4 || m4->getAttribute<std::string>("目标") != "Berkeley1") ++failures;
+    if (recovered.getNodeByPath("group001/cluster001/m1-3")) ++failures;
+    if (recovered.getNodeByPath("group001")->hasAttribute("类型")) ++failures;
+
+    std::cout << "\n=== 日志尾部残缺时的恢复 ===" << std::endl;
+    {
+        FILE* file = std::fopen(logPath.c_str(), "ab");
+        const char garbage[] = {0x40, 0x00, 0x00, 0x00, 0x01};
+        std::fwrite(garbage, 1, sizeof(garbage), file);
+        std::fclose(file);
+    }
+    ResourceRegistry truncated;
+    ChangeLog::loadSnapshot(snapshotPath, truncated);
+    size_t appliedTruncated = ChangeLog::replay(logPath, truncated);
+    std::cout << "重放记录数: " << appliedTruncated << std::endl;
+    if (appliedTruncated != applied) ++failures;
+
+    std::cout << "\n=== 重放时抛出异常 ===" << std::endl;
+    // 路径上的延迟加载节点加载失败，异常穿过replay，注册表上的日志仍要挂回去
+    const std::string brokenLogPath = "test_changelog_broken.wal";
+    {
+        ResourceRegistry broken;
+        auto root = std::make_shared<ResourceNode>("弹群1", "group001");
+        auto cluster = std::make_shared<ResourceNode>("弹簇1", "cluster001");
+        cluster->setLoader([](ResourceNode&) { throw std::runtime_error("loader failed"); });
+        root->addChild(cluster);
+        broken.registerRootNode(root);
+        auto brokenLog = std::make_shared<ChangeLog>(brokenLogPath);
+        broken.attachChangeLog(brokenLog);
+        bool thrown = false;
+        try {
+            ChangeLog::replay(logPath, broken);
+        } catch (const std::runtime_error&) {
+            thrown = true;
+        }
+        std::cout << "异常: " << (thrown ? "是" : "否") << ", 日志已挂回: "
+                  << (broken.getChangeLog() == brokenLog ? "是" : "否") << std::endl;
+        if (!thrown || broken.getChangeLog() != brokenLog) ++failures;
+    }
+    std::remove(brokenLogPath.c_str());
+
+#ifndef _WIN32
+    std::cout << "\n=== 写盘失败 ===" << std::endl;
+    // /dev/full的每次写入都以ENOSPC失败
+    if (FILE* probe = std::fopen("/dev/full", "ab")) {
+        std::fclose(probe);
+        ChangeLog full("/dev/full");
+        full.logCommit();
+        bool syncFailed = false;
+        try {
+            full.sync();
+        } catch (const std::runtime_error& e) {
+            syncFailed = true;
+            std::cout << "同步失败: " << e.what() << std::endl;
+        }
+        uint64_t afterFailure = full.logCommit();
+        std::cout << "失败后追加的序号: " << afterFailure << std::endl;
+        if (!syncFailed || full.writeError().empty() || afterFailure != 0) ++failures;
+    }
+#endif
+
+    std::remove(snapshotPath.c_str());
+    std::remove(logPath.c_str());
+
+    std::cout << "\n失败项: " << failures << std::endl;
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,182 @@
+#include "resource_api.h"
+#include <atomic>
+#include <thread>
+#include <unordered_map>
+
+#ifdef _WIN32
+#include <windows.h>
+#endif
+
+using namespace resource;
+
+const int KEY_COUNT = 50000;
+const int LOOKUPS_PER_THREAD = 200000;
+
+#if RESOURCE_HASH_INDEX_TESTING
+// 只让测试中的读线程在停顿点停住
+thread_local bool pausedReader = false;
+#endif
+
+// 多个线程并发按ID查找，返回每秒查找次数（百万次）
+double measureThroughput(const ResourceIndexer& indexer, int threadCount, std::atomic<int>& misses) {
+    std::vector<std::thread> threads;
+    long long elapsed = measureTime([&]() {
+        for (int t = 0; t < threadCount; ++t) {
+            threads.push_back(std::thread([&indexer, &misses, t]() {
+                unsigned seed = 12345u + static_cast<unsigned>(t);
+                for (int i = 0; i < LOOKUPS_PER_THREAD; ++i) {
+                    seed = seed * 1103515245u + 12345u;
+                    if (!indexer.getById("unit" + std::to_string(seed % KEY_COUNT))) ++misses;
+                }
+            }));
+        }
+        for (auto& thread : threads) thread.join();
+    });
+    return static_cast<double>(threadCount) * LOOKUPS_PER_THREAD / (elapsed > 0 ? elapsed : 1);
+}
+
+int main()
+{
+#ifdef _WIN32
+    SetConsoleOutputCP(CP_UTF8);
+#endif
+    int failures = 0;
+
+    std::cout << "=== 哈希表基本操作 ===" << std::endl;
+    ConcurrentHashIndex<int> table;
+    for (int i = 0; i < KEY_COUNT; ++i) {
+        table.insertOrAssign("key" + std::to_string(i), i);
+    }
+    for (int i = 0; i < KEY_COUNT; i += 2) {
+        table.erase("key" + std::to_string(i));
+    }
+    for (int i = 0; i < KEY_COUNT; i += 3) {
+        table.insertOrAssign("key" + std::to_string(i), -i);
+    }
+    int wrong = 0;
+    for (int i = 0; i < KEY_COUNT; ++i) {
+        int value = 0;
+        bool found = table.find("key" + std::to_string(i), value);
+        bool expectFound = i % 2 != 0 || i % 3 == 0;
+        int expectValue = i % 3 == 0 ? -i : i;
+        if (found != expectFound || (found && value != expectValue)) ++wrong;
+    }
+    size_t expectedSize = KEY_COUNT / 2 + (KEY_COUNT + 5) / 6;
+    std::cout << "元素数: " << table.size() << " (期望 " << expectedSize << "), 错误: " << wrong << std::endl;
+    if (wrong != 0 || table.size() != expectedSize) ++failures;
+
+#if RESOURCE_HASH_INDEX_TESTING
+    std::cout << "\n=== 读者登记时被抢占 ===" << std::endl;
+    // 读者读取纪元后、增加计数前停住，写线程借机翻转纪元；读者取得条目后再停住，写线程删除该条目。
+    // 读者若按旧纪元计数，删除的条目会在读者复制值之前被释放
+    int released = 0, wrongValues = 0;
+    for (int round = 0; round < 20; ++round) {
+        ConcurrentHashIndex<std::shared_ptr<int>> values;
+        values.insertOrAssign("filler", std::make_shared<int>(0));
+        auto value = std::make_shared<int>(round);
+        std::weak_ptr<int> observer = value;
+        values.insertOrAssign("target", std::move(value));
+        std::atomic<int> stage(0);
+        hashIndexTestHook() = [&stage](HashIndexPoint point) {
+            if (!pausedReader) return;
+            if (point == HashIndexPoint::BeforeEnter && stage.load() == 0) {
+                stage = 1;
+                while (stage.load() != 2) std::this_thread::yield();
+            } else if (point == HashIndexPoint::AfterLookup) {
+                stage = 3;
+                while (stage.load() != 4) std::this_thread::yield();
+            }
+        };
+        std::shared_ptr<int> read;
+        std::thread reader([&]() {
+            pausedReader = true;
+            values.find("target", read);
+        });
+        while (stage.load() != 1) std::this_thread::yield();
+        values.insertOrAssign("filler", std::make_shared<int>(1));
+        stage = 2;
+        while (stage.load() != 3) std::this_thread::yield();
+        values.erase("target");
+        values.insertOrAssign("filler", std::make_shared<int>(2));
+        if (observer.expired()) ++released;
+        stage = 4;
+        reader.join();
+        hashIndexTestHook() = nullptr;
+        if (!read || *read != round) ++wrongValues;
+    }
+    std::cout << "读者离开前被释放: " << released << ", 读到错误的值: " << wrongValues << std::endl;
+    if (released != 0 || wrongValues != 0) ++failures;
+#endif
+
+    std::cout << "\n=== 按ID查找 ===" << std::endl;
+    ResourceRegistry registry;
+    auto army = std::make_shared<ResourceNode>("部队", "army");
+    std::unordered_map<std::string, std::shared_ptr<ResourceNode>> baseline;
+    for (int i = 0; i < KEY_COUNT; ++i) {
+        auto unit = std::make_shared<ResourceNode>("单元", "unit" + std::to_string(i));
+        army->addChild(unit);
+        baseline[unit->getId()] = unit;
+    }
+    registry.registerRootNode(army);
+    ResourceIndexer indexer(registry);
+
+    std::vector<std::string> ids;
+    for (int i = 0; i < KEY_COUNT; i += 7) ids.push_back("unit" + std::to_string(i));
+    size_t hits1 = 0, hits2 = 0;
+    long long hashTime = measureTime([&]() {
+        for (int round = 0; round < 20; ++round)
+            for (const auto& id : ids) hits1 += indexer.getById(id) ? 1 : 0;
+    });
+    long long mapTime = measureTime([&]() {
+        for (int round = 0; round < 20; ++round)
+            for (const auto& id : ids) hits2 += baseline.find(id) != baseline.end() ? 1 : 0;
+    });
+    std::cout << "getById: " << hashTime << " 微秒, std::unordered_map查找: " << mapTime << " 微秒" << std::endl;
+    if (hits1 != hits2 || hits1 != ids.size() * 20) ++failures;
+    if (indexer.findByName("单元").size() != static_cast<size_t>(KEY_COUNT)) ++failures;
+
+    std::cout << "\n=== 多线程并发查找 ===" << std::endl;
+    std::atomic<int> misses(0);
+    double single = measureThroughput(indexer, 1, misses);
+    double quad = measureThroughput(indexer, 4, misses);
+    std::cout << "1个线程: " << single << " 百万次/秒, 4个线程: " << quad << " 百万次/秒" << std::endl;
+    if (misses.load() != 0) ++failures;
+
+    std::cout << "\n=== 查找与提交并发 ===" << std::endl;
+    // 写线程反复增删临时单元，读线程查找始终存在的单元，不应查不到
+    std::atomic<bool> done(false);
+    std::atomic<long long> reads(0);
+    std::vector<std::thread> readers;
+    for (int t = 0; t < 3; ++t) {
+        readers.push_back(std::thread([&, t]() {
+            int i = t;
+            while (!done.load()) {
+                if (!indexer.getById("unit" + std::to_string(i % KEY_COUNT))) ++misses;
+                indexer.findByName("临时单元");
+                i += 13;
+                ++reads;
+            }
+        }));
+    }
+    for (int round = 0; round < 200; ++round) {
+        WriteBatch batch;
+        for (int i = 0; i < 50; ++i) {
+            std::string id = "temp" + std::to_string(round * 50 + i);
+            if (round % 2 == 0) {
+                batch.addNode("army", std::make_shared<ResourceNode>("临时单元", id));
+            } else {
+                batch.removeNode("army/temp" + std::to_string((round - 1) * 50 + i));
+            }
+        }
+        registry.commit(batch);
+    }
+    done = true;
+    for (auto& thread : readers) thread.join();
+    std::cout << "并发读取次数: " << reads.load() << ", 查不到: " << misses.load()
+              << ", 剩余临时单元: " << indexer.findByName("临时单元").size() << std::endl;
+    if (misses.load() != 0 || !indexer.findByName("临时单元").empty()) ++failures;
+    if (indexer.getById("temp0") || !indexer.getById("unit0")) ++failures;
+
+    std::cout << "\n失败项: " << failures << std::endl;
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,214 @@
+#include "resource_api.h"
+#include <cstring>
+
+#ifdef _WIN32
+#include <windows.h>
+#endif
+
+using namespace resource;
+
+const int UNIT_COUNT = 200;
+const int TICK_COUNT = 500;
+const size_t CAPACITY = 320;
+
+// 第i个单元在第t个tick的坐标：缓慢匀速移动
+double longitudeOf(int i, int t) {
+    return 116.0 + i * 0.01 + t * 0.0001;
+}
+
+double latitudeOf(int i, int t) {
+    return 39.0 + i * 0.01 - t * 0.00005;
+}
+
+int main()
+{
+#ifdef _WIN32
+    SetConsoleOutputCP(CP_UTF8);
+#endif
+    int failures = 0;
+
+    std::cout << "=== 压缩块编解码 ===" << std::endl;
+    // 不规则的间隔和各种取值，包括整数值、负数、跳变和重复值
+    HistoryBlock block;
+    std::vector<HistorySample> samples;
+    const double values[] = {0.0, 1.5, 1.5, -3.25, 1e300, 42.0, 42.0, 3.14159, -0.0, 7.0};
+    int64_t time = 1700000000000000LL;
+    for (int i = 0; i < 60; ++i) {
+        time += (i % 7 == 0) ? 123456789 : 20000 + i;
+        samples.push_back(HistorySample(static_cast<uint64_t>(i * (i % 3 + 1)), time, values[i % 10] + i / 10));
+        block.append(samples.back());
+    }
+    std::vector<HistorySample> decoded;
+    block.decode(decoded, [](const HistorySample&) { return true; });
+    bool roundTrip = decoded.size() == samples.size();
+    for (size_t i = 0; roundTrip && i < samples.size(); ++i) {
+        roundTrip = decoded[i].tick == samples[i].tick && decoded[i].timestamp == samples[i].timestamp &&
+                    std::memcmp(&decoded[i].value, &samples[i].value, sizeof(double)) == 0;
+    }
+    std::cout << "样本数: " << decoded.size() << ", 一致: " << (roundTrip ? "是" : "否") << std::endl;
+    if (!roundTrip) ++failures;
+
+    std::cout << "\n=== 跟踪动态属性 ===" << std::endl;
+    ResourceRegistry registry;
+    auto army = std::make_shared<ResourceNode>("部队", "army");
+    for (int i = 0; i < UNIT_COUNT; ++i) {
+        auto unit = std::make_shared<ResourceNode>("单元", "u" + std::to_string(i));
+        unit->setAttribute("经度", longitudeOf(i, 0));
+        unit->setAttribute("纬度", latitudeOf(i, 0));
+        unit->setAttribute("油量", 100);
+        unit->setAttribute("名称", std::string("单元") + std::to_string(i));
+        army->addChild(unit);
+    }
+    registry.registerRootNode(army);
+
+    // 每个tick推进20毫秒
+    int64_t now = 1000000;
+    AttributeHistory history(registry);
+    history.setClock([&now]() { return now; });
+    history.track("经度", CAPACITY);
+    history.track("纬度", CAPACITY);
+    history.track("油量", CAPACITY);
+    history.track("名称", CAPACITY);
+    const uint64_t startTick = history.currentTick();
+
+    long long updateTime = measureTime([&]() {
+        for (int t = 1; t <= TICK_COUNT; ++t) {
+            now += 20000;
+            for (int i = 0; i < UNIT_COUNT; ++i) {
+                const std::string path = "army/u" + std::to_string(i);
+                registry.setAttribute(path, "经度", longitudeOf(i, t));
+                registry.setAttribute(path, "纬度", latitudeOf(i, t));
+                if (t % 100 == 0) {
+                    registry.setAttribute(path, "油量", 100 - t / 100);
+                }
+            }
+            registry.commitChanges();
+        }
+    });
+    std::cout << TICK_COUNT << "个tick, " << UNIT_COUNT << "个单元, 记录耗时: " << updateTime << " 微秒" << std::endl;
+
+    auto unit7 = registry.getNodeByPath("army/u7");
+    std::vector<HistorySample> all = history.history(*unit7, "经度");
+    std::cout << "保留的经度样本: " << all.size() << " (容量 " << CAPACITY << ")" << std::endl;
+    if (all.size() < CAPACITY || all.size() > CAPACITY + HistorySeries::BLOCK_SAMPLES) ++failures;
+    if (all.empty() || all.back().tick != history.currentTick() ||
+        all.back().value != longitudeOf(7, TICK_COUNT)) {
+        ++failures;
+    }
+
+    // 按tick区间读取：最近50个tick
+    const uint64_t lastTick = history.currentTick();
+    std::vector<HistorySample> recent = history.history(*unit7, "纬度", lastTick - 49, lastTick);
+    bool recentOk = recent.size() == 50;
+    for (size_t i = 0; recentOk && i < recent.size(); ++i) {
+        const int t = static_cast<int>(recent[i].tick - startTick);
+        recentOk = recent[i].value == latitudeOf(7, t) && recent[i].timestamp == 1000000 + t * 20000;
+    }
+    std::cout << "最近50个tick的纬度: " << recent.size() << " 个样本, 正确: " << (recentOk ? "是" : "否") << std::endl;
+    if (!recentOk) ++failures;
+
+    // 按时间区间读取：第400到第409个tick
+    std::vector<HistorySample> window = history.historyByTime(*unit7, "经度", 1000000 + 400 * 20000,
+                                                              1000000 + 409 * 20000);
+    std::cout << "时间区间内的经度: " << window.size() << " 个样本" << std::endl;
+    if (window.size() != 10 || window.front().value != longitudeOf(7, 400)) ++failures;
+
+    // 早已淘汰的区间没有样本
+    if (!history.history(*unit7, "经度", startTick, startTick + 10).empty()) ++failures;
+
+    std::cout << "\n=== 只在变化时记录 ===" << std::endl;
+    // 油量只在开始跟踪和每100个tick变化时有样本，非数值属性不记录
+    std::vector<HistorySample> fuel = history.history(*unit7, "油量");
+    std::cout << "油量样本: " << fuel.size() << ", 名称样本: " << history.history(*unit7, "名称").size() << std::endl;
+    if (fuel.size() != 6 || fuel.back().value != 95.0 || !history.history(*unit7, "名称").empty()) ++failures;
+
+    std::cout << "\n=== 内存上限 ===" << std::endl;
+    size_t bytes = history.memoryBytes();
+    size_t rawBytes = static_cast<size_t>(UNIT_COUNT) * 2 * all.size() * sizeof(HistorySample);
+    std::cout << "压缩后: " << bytes << " 字节, 未压缩的样本: " << rawBytes << " 字节" << std::endl;
+    if (bytes == 0 || bytes >= rawBytes) ++failures;
+
+    // 继续推进后内存不再增长
+    for (int t = TICK_COUNT + 1; t <= TICK_COUNT + 200; ++t) {
+        now += 20000;
+        for (int i = 0; i < UNIT_COUNT; ++i) {
+            registry.setAttribute("army/u" + std::to_string(i), "经度", longitudeOf(i, t));
+        }
+        registry.commitChanges();
+    }
+    std::cout << "再推进200个tick后: " << history.memoryBytes() << " 字节" << std::endl;
+    if (history.memoryBytes() > bytes) ++failures;
+
+    std::cout << "\n=== 节点增删 ===" << std::endl;
+    auto scout = std::make_shared<ResourceNode>("单元", "scout");
+    scout->setAttribute("经度", 120.0);
+    registry.registerNodeAtPath("army/scout", scout);
+    registry.commitChanges();
+    registry.setAttribute("army/scout", "经度", 120.5);
+    registry.commitChanges();
+    std::vector<HistorySample> scoutHistory = history.history(*scout, "经度");
+    std::cout << "新节点的经度样本: " << scoutHistory.size() << std::endl;
+    if (scoutHistory.size() != 2 || scoutHistory[0].value != 120.0) ++failures;
+
+    // 同一批次内新增后又修改的节点只有一个样本，取提交时的值
+    auto patrol = std::make_shared<ResourceNode>("单元", "patrol");
+    patrol->setAttribute("经度", 121.0);
+    registry.registerNodeAtPath("army/patrol", patrol);
+    registry.setAttribute("army/patrol", "经度", 121.5);
+    registry.setAttribute("army/patrol", "经度", 122.0);
+    registry.commitChanges();
+    std::vector<HistorySample> patrolHistory = history.history(*patrol, "经度");
+    std::cout << "同批次新增并修改的节点样本: " << patrolHistory.size() << std::endl;
+    if (patrolHistory.size() != 1 || patrolHistory[0].value != 122.0 ||
+        patrolHistory[0].tick != history.currentTick()) {
+        ++failures;
+    }
+
+    size_t beforeRemove = history.memoryBytes();
+    registry.removeNodeByPath("army/u7");
+    registry.commitChanges();
+    std::cout << "删除节点后: " << history.memoryBytes() << " 字节 (删除前 " << beforeRemove << ")" << std::endl;
+    if (!history.history(*unit7, "经度").empty() || history.memoryBytes() >= beforeRemove) ++failures;
+
+    std::cout << "\n=== 延迟加载的子树 ===" << std::endl;
+    // 加载出的子树可能被无事件地卸载，只记录延迟加载节点自身
+    auto depot = std::make_shared<ResourceNode>("仓库", "depot");
+    depot->setAttribute("经度", 118.0);
+    depot->setLoader([](ResourceNode& target) {
+        auto item = std::make_shared<ResourceNode>("单元", "m1");
+        item->setAttribute("经度", 118.5);
+        target.addChild(item);
+    });
+    registry.registerNodeAtPath("army/depot", depot);
+    registry.commitChanges();
+    auto loaded = registry.getNodeByPath("army/depot/m1");
+    registry.setAttribute("army/depot/m1", "经度", 119.0);
+    registry.setAttribute("army/depot", "经度", 118.2);
+    registry.commitChanges();
+    size_t depotSamples = history.history(*depot, "经度").size();
+    std::cout << "延迟节点样本: " << depotSamples << ", 加载出的节点样本: " << history.history(*loaded, "经度").size()
+              << std::endl;
+    if (!loaded || depotSamples != 2 || !history.history(*loaded, "经度").empty()) ++failures;
+
+    std::cout << "\n=== 取消跟踪 ===" << std::endl;
+    auto unit8 = registry.getNodeByPath("army/u8");
+    history.untrack("纬度");
+    history.track("高度", 16);
+    bool untracked = !history.isTracked("纬度") && history.history(*unit8, "纬度").empty();
+    registry.setAttribute("army/u8", "高度", 500.0f);
+    registry.commitChanges();
+    std::vector<HistorySample> altitude = history.history(*unit8, "高度");
+    std::cout << "纬度已取消: " << (untracked ? "是" : "否") << ", 高度样本: " << altitude.size() << std::endl;
+    if (!untracked || altitude.size() != 1 || altitude[0].value != 500.0) ++failures;
+
+    bool rejected = false;
+    try {
+        history.track("速度", 0);
+    } catch (const std::invalid_argument&) {
+        rejected = true;
+    }
+    if (!rejected) ++failures;
+
+    std::cout << "\n失败项: " << failures << std::endl;
+    return failures == 0 ? 0 : 1;
+}
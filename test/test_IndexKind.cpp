@@ -0,0 +1,149 @@
+#include "resource_api.h"
+
+#ifdef _WIN32
+#include <windows.h>
+#endif
+
+using namespace resource;
+
+enum class Fuel { Diesel, Kerosene, Electric };
+
+// 只有operator<，不能建立哈希索引
+struct Grade {
+    int level;
+
+    Grade(int l = 0) : level(l) {}
+    bool operator<(const Grade& other) const { return level < other.level; }
+};
+
+const int ITEM_COUNT = 50000;
+const int PROBE_COUNT = 20000;
+
+std::string serialOf(int i) {
+    return "SN-" + std::to_string(1000000 + i * 7);
+}
+
+int main()
+{
+#ifdef _WIN32
+    SetConsoleOutputCP(CP_UTF8);
+#endif
+    int failures = 0;
+    ResourceRegistry registry;
+
+    auto depot = std::make_shared<ResourceNode>("仓库", "depot");
+    for (int i = 0; i < ITEM_COUNT; ++i) {
+        auto item = std::make_shared<ResourceNode>("装备", "item" + std::to_string(i));
+        item->setAttribute("序列号", serialOf(i));
+        item->setAttribute("编号", serialOf(i));
+        item->setAttribute("分组", static_cast<long long>(i / 10));
+        item->setAttribute("燃料", static_cast<Fuel>(i % 3));
+        item->setAttribute("等级", Grade(i % 4));
+        depot->addChild(item);
+    }
+    registry.registerRootNode(depot);
+    ResourceIndexer indexer(registry);
+    indexer.setQueryCacheCapacity(0);
+
+    std::cout << "=== 建立索引 ===" << std::endl;
+    long long hashBuild = measureTime([&]() { indexer.createAttributeIndex<std::string>("序列号", IndexKind::Hash); });
+    long long orderedBuild = measureTime([&]() { indexer.createAttributeIndex<std::string>("编号"); });
+    std::cout << "哈希索引: " << hashBuild << " 微秒, 有序索引: " << orderedBuild << " 微秒" << std::endl;
+    IndexKind kind = IndexKind::Ordered;
+    if (!indexer.getAttributeIndexKind<std::string>("序列号", kind) || kind != IndexKind::Hash) ++failures;
+    if (!indexer.getAttributeIndexKind<std::string>("编号", kind) || kind != IndexKind::Ordered) ++failures;
+
+    std::cout << "\n=== 等值查询 ===" << std::endl;
+    size_t hashHits = 0;
+    size_t orderedHits = 0;
+    long long hashProbe = measureTime([&]() {
+        for (int i = 0; i < PROBE_COUNT; ++i) {
+            hashHits += indexer.findByAttributeIndexed<std::string>("序列号", serialOf(i * 3 % ITEM_COUNT)).size();
+        }
+    });
+    long long orderedProbe = measureTime([&]() {
+        for (int i = 0; i < PROBE_COUNT; ++i) {
+            orderedHits += indexer.findByAttributeIndexed<std::string>("编号", serialOf(i * 3 % ITEM_COUNT)).size();
+        }
+    });
+    std::cout << PROBE_COUNT << "次查询 哈希索引: " << hashProbe << " 微秒, 有序索引: " << orderedProbe << " 微秒"
+              << std::endl;
+    if (hashHits != PROBE_COUNT || orderedHits != PROBE_COUNT) ++failures;
+    if (!indexer.findByAttributeIndexed<std::string>("序列号", "SN-none").empty()) ++failures;
+
+    std::cout << "\n=== 增量维护 ===" << std::endl;
+    indexer.createAttributeIndex<long long>("分组", IndexKind::Hash);
+    registry.setAttribute("depot/item0", "序列号", std::string("SN-changed"));
+    registry.setAttribute("depot/item1", "分组", 999999LL);
+    registry.removeNodeByPath("depot/item2");
+    for (int i = 0; i < 100; ++i) {
+        // 新增的节点使哈希表扩容，删除的节点触发槽的后移
+        auto extra = std::make_shared<ResourceNode>("装备", "extra" + std::to_string(i));
+        extra->setAttribute("序列号", "SN-extra" + std::to_string(i));
+        extra->setAttribute("分组", static_cast<long long>(i));
+        registry.registerNodeAtPath("depot/extra" + std::to_string(i), extra);
+    }
+    for (int i = 10; i < 60; ++i) {
+        registry.removeNodeByPath("depot/item" + std::to_string(i));
+    }
+    registry.commitChanges();
+    size_t changed = indexer.findByAttributeIndexed<std::string>("序列号", "SN-changed").size();
+    size_t oldSerial = indexer.findByAttributeIndexed<std::string>("序列号", serialOf(0)).size();
+    size_t removed = indexer.findByAttributeIndexed<std::string>("序列号", serialOf(2)).size();
+    size_t extra = indexer.findByAttributeIndexed<std::string>("序列号", "SN-extra42").size();
+    size_t group0 = indexer.findByAttributeIndexed<long long>("分组", 0LL).size();
+    size_t group3 = indexer.findByAttributeIndexed<long long>("分组", 3LL).size();
+    std::cout << "修改后: " << changed << ", 旧值: " << oldSerial << ", 已删除: " << removed << ", 新增: " << extra
+              << ", 分组0: " << group0 << ", 分组3: " << group3 << std::endl;
+    // 分组0: item0、item3~item9和extra0（item1移走，item2删除）；分组3: extra3（item30~39已删除）
+    if (changed != 1 || oldSerial != 0 || removed != 0 || extra != 1 || group0 != 9 || group3 != 1) ++failures;
+
+    // 与扫描结果逐一核对
+    int mismatches = 0;
+    for (int i = 0; i < ITEM_COUNT; i += 997) {
+        std::string serial = serialOf(i);
+        size_t scanned = indexer.findByAttribute<std::string>("序列号", serial).size();
+        if (indexer.findByAttributeIndexed<std::string>("序列号", serial).size() != scanned) ++mismatches;
+    }
+    std::cout << "与扫描不一致: " << mismatches << std::endl;
+    if (mismatches != 0) ++failures;
+
+    std::cout << "\n=== 重建后保持种类 ===" << std::endl;
+    indexer.refreshIndex();
+    bool keptKind = indexer.getAttributeIndexKind<std::string>("序列号", kind) && kind == IndexKind::Hash;
+    size_t afterRefresh = indexer.findByAttributeIndexed<std::string>("序列号", "SN-changed").size();
+    std::cout << "种类保留: " << (keptKind ? "是" : "否") << ", 结果数: " << afterRefresh << std::endl;
+    if (!keptKind || afterRefresh != 1) ++failures;
+
+    std::cout << "\n=== 枚举哈希索引 ===" << std::endl;
+    indexer.createAttributeIndex<Fuel>("燃料", IndexKind::Hash);
+    size_t kerosene = indexer.findByAttributeIndexed<Fuel>("燃料", Fuel::Kerosene).size();
+    std::cout << "煤油: " << kerosene << std::endl;
+    if (kerosene != indexer.findByAttribute<Fuel>("燃料", Fuel::Kerosene).size() || kerosene == 0) ++failures;
+
+    std::cout << "\n=== 不支持的查询 ===" << std::endl;
+    bool rangeRejected = false;
+    try {
+        indexer.findGreaterThan<std::string>("序列号", "SN-2");
+    } catch (const std::logic_error& e) {
+        rangeRejected = true;
+        std::cout << "范围查询: " << e.what() << std::endl;
+    }
+    bool hashRejected = false;
+    try {
+        indexer.createAttributeIndex<Grade>("等级", IndexKind::Hash);
+    } catch (const std::invalid_argument& e) {
+        hashRejected = true;
+        std::cout << "哈希索引: " << e.what() << std::endl;
+    }
+    if (!rangeRejected || !hashRejected || indexer.hasAttributeIndex<Grade>("等级")) ++failures;
+
+    std::cout << "\n=== 内存 ===" << std::endl;
+    std::map<std::string, size_t> byIndex;
+    indexer.memoryUsage(&byIndex);
+    std::cout << "哈希索引: " << byIndex["序列号"] << " 字节, 有序索引: " << byIndex["编号"] << " 字节" << std::endl;
+    if (byIndex["序列号"] == 0 || byIndex["编号"] == 0) ++failures;
+
+    std::cout << "\n失败项: " << failures << std::endl;
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,118 @@
+#include "resource_api.h"
+#include <sstream>
+
+#ifdef _WIN32
+#include <windows.h>
+#endif
+
+using namespace resource;
+
+int main()
+{
+#ifdef _WIN32
+    SetConsoleOutputCP(CP_UTF8);
+#endif
+    int failures = 0;
+
+    std::cout << "\n=== 导入JSON场景定义 ===" << std::endl;
+    const std::string scenario =
+        "[{\"name\": \"弹群1\", \"id\": \"group001\","
+        "  \"attributes\": {\"类型\": \"演示用混合弹群\", \"编号\": 9000000000, \"备注\": null},"
+        "  \"children\": ["
+        "    {\"attributes\": {\"射程\": 300, \"速度\": 3.5, \"已部署\": true, \"导引头\": \"\\u7ea2\\u5916\"},"
+        "     \"id\": \"m1-1\", \"name\": \"弹1\", \"extra\": {\"ignored\": [1, 2, 3]}},"
+        "    {\"name\": \"弹2\", \"id\": \"m1-2\", \"attributes\": {\"射程\": 450.5, \"位置\": [116.3, 39.9]}}"
+        "  ]}]";
+
+    JsonImportOptions options;
+    options.attributeTypes["射程"] = JsonAttributeType::DOUBLE;
+    JsonTreeReader reader(options);
+
+    ResourceRegistry registry;
+    std::istringstream in(scenario);
+    if (!reader.readIntoRegistry(in, registry)) {
+        std::cout << "导入失败: " << reader.getError() << std::endl;
+        return 1;
+    }
+    registry.traverseRootNode(simple_visitor);
+
+    auto m1 = registry.getNodeByPath("group001/m1-1");
+    auto m2 = registry.getNodeByPath("group001/m1-2");
+    auto group = registry.getNodeByPath("group001");
+    if (!m1 || m1->getAttributeType("射程") != typeid(double) || m1->getAttribute<double>("射程") != 300.0) ++failures;
+    if (!m1 || m1->getAttribute<std::string>("导引头") != "红外") ++failures;
+    if (!m2 || m2->hasAttribute("位置")) ++failures;
+    if (!group || group->getAttributeType("编号") != typeid(long long)) ++failures;
+    if (!group || group->hasAttribute("备注")) ++failures;
+
+    std::cout << "\n=== 导出JSON ===" << std::endl;
+    std::ostringstream pretty;
+    {
+        JsonTreeWriter writer(pretty, true);
+        writer.writeRegistry(registry);
+    }
+    std::cout << pretty.str() << std::endl;
+
+    std::cout << "\n=== 导出后重新导入 ===" << std::endl;
+    std::vector<std::shared_ptr<ResourceNode>> roots;
+    JsonTreeReader plainReader;
+    if (!plainReader.read(pretty.str(), roots) || roots.size() != 1) {
+        std::cout << "重新导入失败: " << plainReader.getError() << std::endl;
+        return 1;
+    }
+    auto reimported = roots[0]->getChild("m1-2");
+    if (!reimported || reimported->getAttribute<double>("射程") != 450.5) ++failures;
+    if (roots[0]->getChild("m1-1")->getAttributeType("射程") != typeid(double)) ++failures;
+    std::cout << "重新导入节点: " << roots[0]->getName() << ", 子节点数 " << roots[0]->getChildren().size() << std::endl;
+
+    std::cout << "\n=== 错误输入 ===" << std::endl;
+    std::vector<std::shared_ptr<ResourceNode>> broken;
+    if (plainReader.read(std::string("{\"name\": \"a\", \"id\": }"), broken)) ++failures;
+    std::cout << "错误信息: " << plainReader.getError() << std::endl;
+    // 子节点写在id之前，创建父节点时才挂上，重复的ID也作为解析错误返回，不抛出异常
+    const std::string duplicated =
+        "{\"children\": [{\"name\": \"b\", \"id\": \"x\"}, {\"name\": \"c\", \"id\": \"x\"}], "
+        "\"name\": \"a\", \"id\": \"a\"}";
+    bool duplicateRejected = false;
+    try {
+        duplicateRejected = !plainReader.read(duplicated, broken) && !plainReader.getError().empty();
+    } catch (const std::exception& e) {
+        std::cout << "异常: " << e.what() << std::endl;
+    }
+    std::cout << "重复ID: " << plainReader.getError() << std::endl;
+    if (!duplicateRejected) ++failures;
+
+    std::cout << "\n=== 大规模导出/导入吞吐 ===" << std::endl;
+    const int MISSILE_COUNT = 100000;
+    auto fleet = std::make_shared<ResourceNode>("导弹集群", "missile-group");
+    for (int i = 0; i < MISSILE_COUNT; ++i) {
+        auto missile = std::make_shared<ResourceNode>("导弹" + std::to_string(i + 1), "missile-" + std::to_string(i + 1));
+        missile->setAttribute("类型", std::string("空空导弹"));
+        missile->setAttribute("射程", 100.0 + (i % 10) * 50.0);
+        missile->setAttribute("重量", 500 + (i % 20) * 100);
+        missile->setAttribute("已部署", (i % 3) == 0);
+        fleet->addChild(missile);
+    }
+
+    std::ostringstream bulk;
+    long long writeTime = measureTime([&]() {
+        JsonTreeWriter writer(bulk);
+        writer.writeNode(*fleet);
+    });
+    std::string bulkJson = bulk.str();
+
+    std::vector<std::shared_ptr<ResourceNode>> bulkRoots;
+    long long readTime = measureTime([&]() {
+        JsonTreeReader bulkReader;
+        bulkReader.read(bulkJson, bulkRoots);
+    });
+
+    double megabytes = static_cast<double>(bulkJson.size()) / (1024.0 * 1024.0);
+    std::cout << "数据大小: " << megabytes << " MB" << std::endl;
+    std::cout << "导出耗时: " << writeTime << " 微秒" << std::endl;
+    std::cout << "导入耗时: " << readTime << " 微秒" << std::endl;
+    if (bulkRoots.size() != 1 || bulkRoots[0]->getChildren().size() != static_cast<size_t>(MISSILE_COUNT)) ++failures;
+
+    std::cout << "\n失败项: " << failures << std::endl;
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,241 @@
+#include "resource_api.h"
+#include <atomic>
+#include <thread>
+
+#ifdef _WIN32
+#include <windows.h>
+#endif
+
+using namespace resource;
+
+const int UNIT_COUNT = 2000;
+const int SENSOR_COUNT = 20;
+
+struct Unit {
+    std::string id;
+    int side;
+    double range;
+};
+
+// 探测能力子树：每个单元若干传感器，每个传感器若干参数
+std::shared_ptr<ResourceNode> buildPerception(const Unit& unit) {
+    auto perception = std::make_shared<ResourceNode>("perception", "perception");
+    for (int s = 0; s < SENSOR_COUNT; ++s) {
+        auto sensor = std::make_shared<ResourceNode>("sensor", "s" + std::to_string(s));
+        sensor->setAttribute("range", unit.range + s);
+        sensor->setAttribute("band", std::string("X-band-") + std::to_string(s % 4));
+        sensor->setAttribute("elevation", -5.0 + s);
+        sensor->setAttribute("azimuth", 360.0);
+        perception->addChild(sensor);
+    }
+    return perception;
+}
+
+std::atomic<int> conversions(0);
+
+// 完整的单元（转换器生成全部子树）
+class DetailConverter : public StructConverter {
+public:
+    std::shared_ptr<ResourceNode> convert(const void* structPtr, const std::string& nodeName) const override {
+        const Unit& unit = *static_cast<const Unit*>(structPtr);
+        ++conversions;
+        auto node = std::make_shared<ResourceNode>(nodeName, unit.id);
+        node->addChild(buildPerception(unit));
+        return node;
+    }
+    StructConverter* clone() const override { return new DetailConverter(*this); }
+};
+
+// 常驻部分只有摘要属性，详细子树由DetailConverter按需生成
+class UnitConverter : public StructConverter {
+public:
+    explicit UnitConverter(bool lazy, std::shared_ptr<LazyLoadBudget> budget = nullptr)
+        : lazy_(lazy), budget_(budget) {}
+
+    std::shared_ptr<ResourceNode> convert(const void* structPtr, const std::string& nodeName) const override {
+        const Unit& unit = *static_cast<const Unit*>(structPtr);
+        auto node = std::make_shared<ResourceNode>(nodeName, unit.id);
+        node->setAttribute("side", unit.side);
+        node->setAttribute("range", unit.range);
+        if (lazy_) {
+            node->setLoader(converterLoader(unit, DetailConverter(), "detail"), budget_);
+        } else {
+            node->addChild(buildPerception(unit));
+        }
+        return node;
+    }
+    StructConverter* clone() const override { return new UnitConverter(*this); }
+
+private:
+    bool lazy_;
+    std::shared_ptr<LazyLoadBudget> budget_;
+};
+
+int main()
+{
+#ifdef _WIN32
+    SetConsoleOutputCP(CP_UTF8);
+#endif
+    int failures = 0;
+
+    std::vector<Unit> units(UNIT_COUNT);
+    for (int i = 0; i < UNIT_COUNT; ++i) {
+        units[i].id = "u" + std::to_string(i);
+        units[i].side = i % 2;
+        units[i].range = 1000.0 + i;
+    }
+
+    std::cout << "=== 常驻与延迟加载的内存 ===" << std::endl;
+    ResourceRegistry eager;
+    eager.createPath("army");
+    eager.registerStructsBulk(units, "army", UnitConverter(false), "unit");
+
+    ResourceRegistry lazy;
+    lazy.createPath("army");
+    auto budget = std::make_shared<LazyLoadBudget>(64 * 1024);
+    lazy.registerStructsBulk(units, "army", UnitConverter(true, budget), "unit");
+    ResourceIndexer indexer(lazy);
+    indexer.createAttributeIndex<int>("side");
+
+    size_t eagerBytes = eager.memoryUsage().total.total();
+    size_t lazyBytes = lazy.memoryUsage().total.total();
+    std::cout << "常驻: " << eagerBytes << " 字节, 延迟加载: " << lazyBytes << " 字节, 已加载: "
+              << budget->loadedCount() << std::endl;
+    // 注册、建索引和统计都不触发加载
+    if (lazyBytes * 5 > eagerBytes || conversions != 0 || budget->loadedCount() != 0) ++failures;
+    if (indexer.findByAttributeIndexed<int>("side", 1).size() != UNIT_COUNT / 2 || conversions != 0) ++failures;
+
+    std::cout << "\n=== 按路径访问时加载 ===" << std::endl;
+    auto sensor = lazy.getNodeByPath("army/u7/perception/s3");
+    auto again = lazy.getNodeByPath("army/u7/perception/s5");
+    std::cout << "转换次数: " << conversions << ", 传感器距离: " << (sensor ? sensor->getAttribute<double>("range") : 0)
+              << std::endl;
+    if (!sensor || !again || conversions != 1 || sensor->getAttribute<double>("range") != 1010.0) ++failures;
+    if (sensor->getParent()->getParent() != lazy.getNodeByPath("army/u7").get()) ++failures;
+    if (sensor->getPath() != "army/u7/perception/s3") ++failures;
+    if (!lazy.getNodeByPath("army/u7")->isLoaded() || lazy.getNodeByPath("army/u8")->isLoaded()) ++failures;
+
+    std::cout << "\n=== 并发首次访问只加载一次 ===" << std::endl;
+    conversions = 0;
+    std::atomic<int> found(0);
+    std::vector<std::thread> readers;
+    for (int t = 0; t < 4; ++t) {
+        readers.push_back(std::thread([&]() {
+            ReadLock lock(lazy.getMutex());
+            for (int i = 100; i < 200; ++i) {
+                if (lazy.getNodeByPath("army/u" + std::to_string(i) + "/perception/s0")) ++found;
+            }
+        }));
+    }
+    for (auto& reader : readers) {
+        reader.join();
+    }
+    std::cout << "找到: " << found << ", 转换次数: " << conversions << std::endl;
+    if (found != 400 || conversions != 100) ++failures;
+
+    // 一个读线程首次访问触发加载，另一个读线程同时遍历整棵树和按属性扫描
+    size_t before = 0;
+    lazy.traverseNodes([&](std::shared_ptr<ResourceNode>) { ++before; });
+    std::atomic<bool> loading(true);
+    std::atomic<int> shrunk(0);
+    std::atomic<int> scans(0);
+    std::thread loader([&]() {
+        ReadLock lock(lazy.getMutex());
+        for (int i = 200; i < 600; ++i) {
+            lazy.getNodeByPath("army/u" + std::to_string(i) + "/perception/s0");
+        }
+        loading = false;
+    });
+    std::thread scanner([&]() {
+        ReadLock lock(lazy.getMutex());
+        size_t last = 0;
+        while (loading || scans == 0) {
+            size_t count = 0;
+            lazy.traverseNodes([&](std::shared_ptr<ResourceNode>) { ++count; });
+            if (count < last || count < before) ++shrunk;
+            last = count;
+            indexer.findByAttribute<double>("range", 1000.0);
+            ++scans;
+        }
+    });
+    loader.join();
+    scanner.join();
+    size_t after = 0;
+    lazy.traverseNodes([&](std::shared_ptr<ResourceNode>) { ++after; });
+    std::cout << "加载中遍历: " << scans << " 次, 节点数: " << before << " -> " << after << std::endl;
+    if (shrunk != 0 || after != before + 400 * (SENSOR_COUNT + 1)) ++failures;
+
+    std::cout << "\n=== 超出预算时卸载 ===" << std::endl;
+    // 再访问一次u150，它成为最近访问的节点
+    lazy.getNodeByPath("army/u150")->getChildren();
+    size_t beforeBytes = budget->loadedBytes();
+    size_t evicted = 0;
+    {
+        WriteLock lock(lazy.getMutex());
+        evicted = budget->enforce();
+    }
+    std::cout << "卸载前: " << beforeBytes << " 字节, 卸载: " << evicted << " 个, 卸载后: " << budget->loadedBytes()
+              << " 字节 (预算 " << budget->limit() << ")" << std::endl;
+    if (evicted == 0 || budget->loadedBytes() > budget->limit()) ++failures;
+    if (!lazy.getNodeByPath("army/u150")->isLoaded() || lazy.getNodeByPath("army/u7")->isLoaded()) ++failures;
+    // 被卸载的子树脱离节点树，已取出的引用仍然有效
+    if (sensor->getParent() != nullptr || sensor->getAttribute<double>("range") != 1010.0) ++failures;
+
+    // 卸载后再次访问时按结构体的当前内容重新加载
+    units[7].range = 5000.0;
+    conversions = 0;
+    auto reloaded = lazy.getNodeByPath("army/u7/perception/s3");
+    std::cout << "重新加载后的距离: " << reloaded->getAttribute<double>("range") << ", 转换次数: " << conversions
+              << std::endl;
+    if (conversions != 1 || reloaded->getAttribute<double>("range") != 5003.0) ++failures;
+
+    std::cout << "\n=== 快照 ===" << std::endl;
+    auto depot = std::make_shared<ResourceNode>("depot", "depot");
+    for (int i = 0; i < 50; ++i) {
+        Unit unit = {"m" + std::to_string(i), 0, 200.0 + i};
+        auto item = std::make_shared<ResourceNode>("missile", unit.id);
+        item->addChild(buildPerception(unit));
+        depot->addChild(item);
+    }
+    size_t fullBytes = depot->memoryUsage().total();
+    deferChildren(*depot);
+    size_t deferredBytes = depot->memoryUsage().total();
+    std::cout << "展开: " << fullBytes << " 字节, 快照后: " << deferredBytes << " 字节" << std::endl;
+    if (!depot->isLazy() || depot->isLoaded() || deferredBytes * 10 > fullBytes) ++failures;
+    auto fromSnapshot = depot->getChild("m42");
+    bool snapshotOk = fromSnapshot && depot->getChildren().size() == 50 &&
+                      fromSnapshot->getChild("perception")->getChild("s1")->getAttribute<std::string>("band") ==
+                          "X-band-1";
+    std::cout << "从快照加载: " << (snapshotOk ? "是" : "否") << std::endl;
+    if (!snapshotOk) ++failures;
+
+    // 副本共用加载器，各自加载
+    auto copy = depot->clone();
+    if (!copy->isLazy() || copy->isLoaded() || copy->getChildren().size() != 50 || copy->getChild("m42") == fromSnapshot) {
+        ++failures;
+    }
+
+    std::cout << "\n=== 错误处理 ===" << std::endl;
+    bool rejected = false;
+    try {
+        auto parent = std::make_shared<ResourceNode>("p", "p");
+        parent->addChild(std::make_shared<ResourceNode>("c", "c"));
+        parent->setLoader([](ResourceNode&) {});
+    } catch (const std::logic_error& e) {
+        rejected = true;
+        std::cout << "已有子节点: " << e.what() << std::endl;
+    }
+    bool failedLoad = false;
+    auto broken = std::make_shared<ResourceNode>("b", "b");
+    broken->setLoader([](ResourceNode&) { throw std::runtime_error("loader failed"); });
+    try {
+        broken->getChildren();
+    } catch (const std::runtime_error&) {
+        failedLoad = !broken->isLoaded();
+    }
+    std::cout << "加载失败后仍未加载: " << (failedLoad ? "是" : "否") << std::endl;
+    if (!rejected || !failedLoad) ++failures;
+
+    std::cout << "\n失败项: " << failures << std::endl;
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,128 @@
+#include "resource_api.h"
+
+#ifdef _WIN32
+#include <windows.h>
+#endif
+
+using namespace resource;
+
+const int UNIT_COUNT = 5000;
+
+void printUsage(const std::string& title, const MemoryUsage& usage) {
+    std::cout << title << ": 共 " << usage.total() << " 字节, 节点 " << usage.nodeCount
+              << " (节点对象 " << usage.nodeHeaders << ", 子节点容器 " << usage.childContainers
+              << ", 属性表 " << usage.attributeMaps << ", 属性值 " << usage.attributeValues
+              << ", 字符串 " << usage.strings << ")" << std::endl;
+}
+
+void fillMissile(ResourceNode& node, int i) {
+    node.setAttribute("类型", std::string("空对地导弹-远程精确制导型号") + std::to_string(i % 10));
+    node.setAttribute("射程", 100.0 + i % 500);
+    node.setAttribute("速度", 2.5);
+    node.setAttribute("重量", 900.0);
+    node.setAttribute("已部署", i % 2 == 0);
+}
+
+int main()
+{
+#ifdef _WIN32
+    SetConsoleOutputCP(CP_UTF8);
+#endif
+    int failures = 0;
+    ResourceRegistry registry;
+
+    auto army = std::make_shared<ResourceNode>("部队", "army");
+    for (int i = 0; i < UNIT_COUNT; ++i) {
+        auto unit = std::make_shared<ResourceNode>("单元", "unit" + std::to_string(i));
+        unit->setAttribute("编号", i);
+        unit->setAttribute("兵力", 100.0 + i % 50);
+        unit->setAttribute("描述", std::string("第") + std::to_string(i) + "单元，负责北部防区的巡逻与警戒任务");
+        army->addChild(unit);
+    }
+    registry.registerRootNode(army);
+
+    auto depot = std::make_shared<ResourceNode>("仓库", "depot");
+    for (int i = 0; i < UNIT_COUNT / 5; ++i) {
+        auto item = std::make_shared<ResourceNode>("物资", "item" + std::to_string(i));
+        item->setAttribute("数量", i);
+        depot->addChild(item);
+    }
+    registry.registerRootNode(depot);
+
+    std::cout << "=== 按根节点统计 ===" << std::endl;
+    MemoryReport report = registry.memoryUsage(true);
+    printUsage("全部", report.total);
+    for (const auto& pair : report.byRoot) {
+        printUsage(pair.first, pair.second);
+    }
+    if (report.byRoot.size() != 2 || report.byRoot["army"].nodeCount != static_cast<size_t>(UNIT_COUNT + 1)) ++failures;
+    if (report.total.total() < report.byRoot["army"].total() + report.byRoot["depot"].total()) ++failures;
+    if (report.byRoot["army"].total() <= report.byRoot["depot"].total()) ++failures;
+
+    std::cout << "\n=== 按属性统计 ===" << std::endl;
+    for (const auto& pair : report.byAttribute) {
+        std::cout << pair.first << ": " << pair.second << " 字节" << std::endl;
+    }
+    // 长字符串超出短字符串优化，单独占用堆内存
+    if (report.byAttribute["描述"] <= report.byAttribute["编号"]) ++failures;
+    if (report.byAttribute.count("数量") == 0) ++failures;
+
+    std::cout << "\n=== 删除子树后 ===" << std::endl;
+    size_t before = registry.memoryUsage().total.total();
+    registry.removeNodeByPath("depot");
+    size_t after = registry.memoryUsage().total.total();
+    std::cout << "删除前: " << before << " 字节, 删除后: " << after << " 字节" << std::endl;
+    if (after >= before) ++failures;
+
+    std::cout << "\n=== 三种存储方式的单节点开销 ===" << std::endl;
+    auto schema = std::make_shared<NodeSchema>("导弹");
+    schema->addField<std::string>("类型")
+           .addField<double>("射程")
+           .addField<double>("速度")
+           .addField<double>("重量")
+           .addField<bool>("已部署", false);
+    registry.registerSchema(schema);
+    auto dynamicGroup = std::make_shared<ResourceNode>("导弹集群", "dynamic");
+    auto schemaGroup = std::make_shared<ResourceNode>("导弹集群", "schema");
+    auto rowGroup = std::make_shared<ResourceNode>("导弹集群", "rows");
+    for (int i = 0; i < 1000; ++i) {
+        auto dynamic = std::make_shared<ResourceNode>("导弹", "d" + std::to_string(i));
+        fillMissile(*dynamic, i);
+        dynamicGroup->addChild(dynamic);
+        auto node = registry.createNode("导弹", "导弹", "s" + std::to_string(i));
+        fillMissile(*node, i);
+        schemaGroup->addChild(node);
+        auto row = registry.createRow("导弹", "导弹", "r" + std::to_string(i));
+        fillMissile(*row, i);
+        rowGroup->addChild(row);
+    }
+    registry.registerRootNode(dynamicGroup);
+    registry.registerRootNode(schemaGroup);
+    registry.registerRootNode(rowGroup);
+    report = registry.memoryUsage();
+    size_t dynamicBytes = report.byRoot["dynamic"].total();
+    size_t schemaBytes = report.byRoot["schema"].total();
+    size_t rowBytes = report.byRoot["rows"].total() + report.tables.total();
+    std::cout << "动态属性: " << dynamicBytes / 1000 << " 字节/节点, 模式节点: " << schemaBytes / 1000
+              << " 字节/节点, 列存储行: " << rowBytes / 1000 << " 字节/节点" << std::endl;
+    printUsage("列存储表", report.tables);
+    if (report.byRoot["schema"].attributeMaps >= report.byRoot["dynamic"].attributeMaps) ++failures;
+    if (schemaBytes >= dynamicBytes || report.tables.attributeValues == 0) ++failures;
+
+    std::cout << "\n=== 索引占用 ===" << std::endl;
+    ResourceIndexer indexer(registry);
+    size_t basic = indexer.memoryUsage().indexes;
+    indexer.createAttributeIndex<double>("兵力");
+    indexer.findInRange<double>("兵力", 100.0, 120.0);
+    std::map<std::string, size_t> byIndex;
+    MemoryUsage indexUsage = indexer.memoryUsage(&byIndex);
+    for (const auto& pair : byIndex) {
+        std::cout << pair.first << ": " << pair.second << " 字节" << std::endl;
+    }
+    std::cout << "合计: " << indexUsage.indexes << " 字节" << std::endl;
+    if (indexUsage.indexes <= basic || byIndex["兵力"] == 0 || byIndex["id"] == 0 || byIndex["query_cache"] == 0) ++failures;
+    if (indexUsage.total() != indexUsage.indexes) ++failures;
+
+    std::cout << "\n失败项: " << failures << std::endl;
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,113 @@
+#include "resource_api.h"
+#include <sstream>
+
+#ifdef _WIN32
+#include <windows.h>
+#endif
+
+using namespace resource;
+
+const OperationStats* findOperation(const RegistryStats& stats, const std::string& name) {
+    for (const auto& op : stats.operations) {
+        if (op.name == name) return &op;
+    }
+    return nullptr;
+}
+
+void printOperation(const RegistryStats& stats, const std::string& name) {
+    const OperationStats* op = findOperation(stats, name);
+    std::cout << name << ": 调用 " << op->count << " 次, 平均 " << op->meanNanos() << " 纳秒, 每次分配 "
+              << op->allocationsPerCall() << " 次" << std::endl;
+}
+
+int main()
+{
+#ifdef _WIN32
+    SetConsoleOutputCP(CP_UTF8);
+#endif
+    int failures = 0;
+    ResourceRegistry registry;
+
+    auto fleet = std::make_shared<ResourceNode>("编队", "fleet");
+    for (int i = 0; i < 100; ++i) {
+        auto ship = std::make_shared<ResourceNode>("舰艇", "ship" + std::to_string(i));
+        ship->setAttribute("航速", 10.0 + i % 20);
+        ship->setAttribute("舷号", i);
+        fleet->addChild(ship);
+    }
+    registry.registerRootNode(fleet);
+    ResourceIndexer indexer(registry);
+
+    std::cout << "=== 节点与属性计数 ===" << std::endl;
+    RegistryStats stats = registry.stats();
+    std::cout << "指标已启用: " << (stats.metricsEnabled ? "是" : "否") << ", 根节点: " << stats.rootCount
+              << ", 节点: " << stats.nodeCount << ", 属性: " << stats.attributeCount << std::endl;
+    if (!stats.metricsEnabled || stats.rootCount != 1 || stats.nodeCount != 101 || stats.attributeCount != 200) ++failures;
+
+    std::cout << "\n=== 操作计数与耗时 ===" << std::endl;
+    for (int i = 0; i < 50; ++i) {
+        registry.getNodeByPath("fleet/ship" + std::to_string(i));
+        indexer.getById("ship" + std::to_string(i));
+    }
+    indexer.findByName("舰艇");
+    indexer.createAttributeIndex<double>("航速");
+    indexer.findInRange<double>("航速", 12.0, 15.0);      // 命中已有索引
+    indexer.findGreaterThan<double>("航速", 25.0);        // 命中已有索引
+    indexer.findByAttributeIndexed<int>("舷号", 7);       // 没有索引，扫描整棵树
+    indexer.refreshIndex();
+
+    stats = registry.stats();
+    printOperation(stats, "get_node_by_path");
+    printOperation(stats, "find_by_id");
+    printOperation(stats, "find_in_range");
+    printOperation(stats, "refresh_index");
+    std::cout << "索引命中: " << stats.indexHits << ", 扫描: " << stats.indexScans << std::endl;
+    if (findOperation(stats, "get_node_by_path")->count != 50) ++failures;
+    if (findOperation(stats, "find_by_id")->count != 50) ++failures;
+    if (findOperation(stats, "find_by_name")->count != 1) ++failures;
+    // 构造索引器时已经建立过一次索引
+    if (findOperation(stats, "refresh_index")->count != 2) ++failures;
+    if (stats.indexHits != 2 || stats.indexScans != 1) ++failures;
+    // 路径查找需要拆分路径，至少有一次分配
+    if (findOperation(stats, "get_node_by_path")->allocations < 50) ++failures;
+
+    uint64_t bucketTotal = 0;
+    for (uint64_t count : findOperation(stats, "get_node_by_path")->buckets) bucketTotal += count;
+    if (bucketTotal != 50) ++failures;
+
+    std::cout << "\n=== Prometheus文本输出 ===" << std::endl;
+    std::ostringstream text;
+    writePrometheus(text, stats);
+    std::istringstream lines(text.str());
+    std::string line;
+    int printed = 0;
+    while (std::getline(lines, line) && printed < 12) {
+        std::cout << line << std::endl;
+        ++printed;
+    }
+    if (text.str().find("resource_nodes 101") == std::string::npos) ++failures;
+    if (text.str().find("resource_operation_duration_seconds_count{op=\"get_node_by_path\"} 50") == std::string::npos) ++failures;
+    if (text.str().find("resource_operation_duration_seconds_bucket{op=\"find_by_id\",le=\"+Inf\"} 50") == std::string::npos) ++failures;
+
+    registry.getMetrics().reset();
+    if (registry.stats().indexHits != 0 || findOperation(registry.stats(), "find_by_id")->count != 0) ++failures;
+
+    std::cout << "\n=== 委托的查找只记一次 ===" << std::endl;
+    std::vector<std::function<bool(const std::shared_ptr<ResourceNode>&)>> conditions;
+    conditions.push_back([](const std::shared_ptr<ResourceNode>& node) {
+        const double* speed = node->tryGetAttribute<double>("航速");
+        return speed && *speed > 25.0;
+    });
+    indexer.findById("ship3");
+    indexer.findByMultiConditions(conditions);
+    indexer.findByMultiConditions(conditions, true, "fast", std::vector<std::string>(1, "航速"));
+    indexer.findByMultiConditions(conditions, true, "fast", std::vector<std::string>(1, "航速"));
+    stats = registry.stats();
+    printOperation(stats, "find_by_multi_conditions");
+    if (findOperation(stats, "find_by_id")->count != 1) ++failures;
+    if (findOperation(stats, "find_by_multi_conditions")->count != 3) ++failures;
+    if (findOperation(stats, "find_by_predicate")->count != 0) ++failures;
+
+    std::cout << "\n失败项: " << failures << std::endl;
+    return failures == 0 ? 0 : 1;
+}
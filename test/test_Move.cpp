@@ -0,0 +1,164 @@
+#include "resource_api.h"
+
+#ifdef _WIN32
+#include <windows.h>
+#endif
+
+using namespace resource;
+
+// 统计复制和移动次数的属性值
+struct Payload {
+    static int copies;
+    static int moves;
+
+    std::vector<double> samples;
+    std::string label;
+
+    Payload() {}
+    Payload(size_t count, const std::string& name) : samples(count, 1.0), label(name) {}
+    Payload(const Payload& other) : samples(other.samples), label(other.label) { ++copies; }
+    Payload(Payload&& other) : samples(std::move(other.samples)), label(std::move(other.label)) { ++moves; }
+    Payload& operator=(const Payload& other) {
+        samples = other.samples;
+        label = other.label;
+        ++copies;
+        return *this;
+    }
+    Payload& operator=(Payload&& other) {
+        samples = std::move(other.samples);
+        label = std::move(other.label);
+        ++moves;
+        return *this;
+    }
+    bool operator==(const Payload& other) const { return samples == other.samples && label == other.label; }
+
+    static void reset() {
+        copies = 0;
+        moves = 0;
+    }
+};
+
+int Payload::copies = 0;
+int Payload::moves = 0;
+
+int main()
+{
+#ifdef _WIN32
+    SetConsoleOutputCP(CP_UTF8);
+#endif
+    int failures = 0;
+
+    // 超出短字符串优化的长度，移动后数据指针不变
+    const std::string longText(256, 'x');
+
+    std::cout << "=== 右值和原地构造的属性 ===" << std::endl;
+    auto node = std::make_shared<ResourceNode>("track", "t1");
+    Payload::reset();
+    node->setAttribute("track", Payload(1000, "radar"));
+    int afterMove = Payload::copies;
+    node->emplaceAttribute<Payload>("plot", 500, "plot");
+    std::cout << "右值写入复制: " << afterMove << " 次, 原地构造复制: " << Payload::copies - afterMove
+              << " 次, 移动: " << Payload::moves << " 次" << std::endl;
+    if (Payload::copies != 0 || Payload::moves != 1) ++failures;
+
+    std::string text = longText;
+    const char* buffer = text.data();
+    node->setAttribute("note", std::move(text));
+    if (node->tryGetAttribute<std::string>("note")->data() != buffer) ++failures;
+
+    // 左值仍然复制，原值保持不变
+    Payload kept(10, "kept");
+    node->setAttribute("kept", kept);
+    if (Payload::copies != 1 || kept.samples.size() != 10) ++failures;
+
+    Payload::reset();
+    node->modifyAttribute("track", Payload(2000, "radar"));
+    if (Payload::copies != 0 || node->getAttributeRef<Payload>("track").samples.size() != 2000) ++failures;
+
+    std::cout << "\n=== 不复制的读取 ===" << std::endl;
+    Payload::reset();
+    const Payload* track = node->tryGetAttribute<Payload>("track");
+    const Payload& plot = node->getAttributeRef<Payload>("plot");
+    std::cout << "读取复制: " << Payload::copies << " 次, 点迹标签: " << plot.label << std::endl;
+    if (!track || track != node->tryGetAttribute<Payload>("track") || Payload::copies != 0) ++failures;
+    if (plot.samples.size() != 500 || plot.label != "plot") ++failures;
+    // 按值读取照旧复制一次
+    Payload copy = node->getAttribute<Payload>("plot");
+    if (Payload::copies != 1 || !(copy == plot)) ++failures;
+
+    // 不存在或类型不匹配时返回空指针，不抛出异常
+    bool missing = node->tryGetAttribute<Payload>("none") == nullptr;
+    bool mismatched = node->tryGetAttribute<int>("track") == nullptr;
+    std::cout << "不存在: " << (missing ? "空" : "非空") << ", 类型不匹配: " << (mismatched ? "空" : "非空") << std::endl;
+    if (!missing || !mismatched) ++failures;
+    bool notFound = false;
+    bool badCast = false;
+    try {
+        node->getAttributeRef<Payload>("none");
+    } catch (const std::runtime_error&) {
+        notFound = true;
+    }
+    try {
+        node->getAttributeRef<int>("track");
+    } catch (const std::bad_cast&) {
+        badCast = true;
+    }
+    if (!notFound || !badCast) ++failures;
+
+    std::cout << "\n=== 模式字段 ===" << std::endl;
+    auto schema = std::make_shared<NodeSchema>("sensor");
+    schema->addField<std::string>("model").addField<double>("range");
+    auto sensor = std::make_shared<ResourceNode>("sensor", "s1", schema);
+    text = longText;
+    buffer = text.data();
+    sensor->setAttribute("model", std::move(text));
+    sensor->emplaceAttribute<double>("range", 120.0);
+    const std::string* model = sensor->tryGetAttribute<std::string>("model");
+    std::cout << "型号长度: " << (model ? model->size() : 0) << ", 距离: " << sensor->getAttributeRef<double>("range")
+              << std::endl;
+    if (!model || model->data() != buffer || sensor->getAttributeRef<double>("range") != 120.0) ++failures;
+    if (sensor->tryGetAttribute<int>("range") != nullptr) ++failures;
+
+    std::cout << "\n=== 注册表和写入批次 ===" << std::endl;
+    ResourceRegistry registry;
+    auto root = std::make_shared<ResourceNode>("army", "army");
+    const ResourceNode* rootPtr = root.get();
+    registry.registerRootNode(std::move(root));
+    auto unit = std::make_shared<ResourceNode>("unit", "u1");
+    registry.getRootNode("army")->addChild(std::move(unit));
+    // 子节点数组和按ID查找的表各持有一份，没有多余的引用
+    long childRefs = registry.getNodeByPath("army")->getChildren().front().use_count();
+    std::cout << "子节点引用计数: " << childRefs << std::endl;
+    if (registry.getRootNode("army").get() != rootPtr || childRefs != 2 || root || unit) ++failures;
+
+    text = longText;
+    buffer = text.data();
+    registry.setAttribute("army/u1", "orders", std::move(text));
+    auto target = registry.getNodeByPath("army/u1");
+    if (target->tryGetAttribute<std::string>("orders")->data() != buffer) ++failures;
+
+    text = longText;
+    buffer = text.data();
+    registry.updateAttribute(target, "log", std::move(text));
+    if (target->tryGetAttribute<std::string>("log")->data() != buffer) ++failures;
+    // 字符串字面量按std::string存储
+    registry.updateAttribute(target, "mode", "patrol");
+    registry.batchUpdateAttributes(target, "callsign", "EAGLE", "strength", 12);
+    const std::string* mode = target->tryGetAttribute<std::string>("mode");
+    const std::string* callsign = target->tryGetAttribute<std::string>("callsign");
+    if (!mode || *mode != "patrol" || !callsign || *callsign != "EAGLE" ||
+        target->getAttributeRef<int>("strength") != 12) {
+        ++failures;
+    }
+
+    Payload::reset();
+    WriteBatch batch;
+    batch.setAttribute("army/u1", "track", Payload(100, "batch"));
+    std::string error;
+    bool committed = registry.commit(batch, &error);
+    std::cout << "批次提交: " << (committed ? "成功" : error) << ", 写入复制: " << Payload::copies << " 次" << std::endl;
+    if (!committed || target->getAttributeRef<Payload>("track").label != "batch") ++failures;
+
+    std::cout << "\n失败项: " << failures << std::endl;
+    return failures == 0 ? 0 : 1;
+}
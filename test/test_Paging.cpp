@@ -0,0 +1,116 @@
+#include "resource_api.h"
+#include <algorithm>
+
+#ifdef _WIN32
+#include <windows.h>
+#endif
+
+using namespace resource;
+
+const int MISSILE_COUNT = 10000;
+
+int main()
+{
+#ifdef _WIN32
+    SetConsoleOutputCP(CP_UTF8);
+#endif
+    int failures = 0;
+    ResourceRegistry registry;
+
+    auto group = std::make_shared<ResourceNode>("导弹集群", "missile-group");
+    for (int i = 0; i < MISSILE_COUNT; ++i) {
+        auto missile = std::make_shared<ResourceNode>("导弹", "m" + std::to_string(i));
+        // 射程为100~599的整数，每个值20枚，分页会在桶中间结束
+        missile->setAttribute("射程", 100.0 + (i * 7919) % 2000 / 4);
+        missile->setAttribute("型号", "型号" + std::to_string(i % 30));
+        group->addChild(missile);
+    }
+    registry.registerRootNode(group);
+    ResourceIndexer indexer(registry);
+    indexer.createAttributeIndex<double>("射程");
+
+    std::cout << "=== 射程最远的50枚导弹 ===" << std::endl;
+    std::vector<std::shared_ptr<ResourceNode>> topK;
+    long long topKTime = measureTime([&]() { topK = indexer.findTopK<double>("射程", 50); });
+
+    // 对照：猜一个阈值后自己排序
+    std::vector<std::shared_ptr<ResourceNode>> sorted;
+    long long sortTime = measureTime([&]() {
+        sorted = indexer.findGreaterThan<double>("射程", 0.0);
+        std::stable_sort(sorted.begin(), sorted.end(),
+            [](const std::shared_ptr<ResourceNode>& a, const std::shared_ptr<ResourceNode>& b) {
+                return a->getAttribute<double>("射程") > b->getAttribute<double>("射程");
+            });
+        sorted.resize(50);
+    });
+    std::cout << "findTopK: " << topKTime << " 微秒, 全部取出后排序: " << sortTime << " 微秒" << std::endl;
+    std::cout << "最远: " << topK.front()->getId() << " (" << topK.front()->getAttribute<double>("射程") << ")"
+              << ", 第50: " << topK.back()->getId() << " (" << topK.back()->getAttribute<double>("射程") << ")" << std::endl;
+    if (topK.size() != 50) ++failures;
+    for (size_t i = 0; i < topK.size(); ++i) {
+        if (topK[i]->getAttribute<double>("射程") != sorted[i]->getAttribute<double>("射程")) ++failures;
+        if (i > 0 && topK[i]->getAttribute<double>("射程") > topK[i - 1]->getAttribute<double>("射程")) ++failures;
+    }
+
+    auto shortest = indexer.findTopK<double>("射程", 3, true);
+    std::cout << "最近的3枚: ";
+    for (const auto& node : shortest) {
+        std::cout << node->getId() << "(" << node->getAttribute<double>("射程") << ") ";
+    }
+    std::cout << std::endl;
+    if (shortest.size() != 3 || shortest[0]->getAttribute<double>("射程") != 100.0) ++failures;
+
+    auto firstModels = indexer.findTopK<std::string>("型号", 2, true);
+    std::cout << "字符串属性升序前2: " << firstModels[0]->getAttribute<std::string>("型号") << std::endl;
+    if (firstModels.size() != 2 || firstModels[0]->getAttribute<std::string>("型号") != "型号0") ++failures;
+    // k超过节点数时只返回全部节点，不按k预留空间
+    if (indexer.findTopK<double>("射程", static_cast<size_t>(-1)).size() != static_cast<size_t>(MISSILE_COUNT)) ++failures;
+
+    std::cout << "\n=== 分页查询 ===" << std::endl;
+    auto all = indexer.findInRange<double>("射程", 200.0, 400.0);
+    PageToken<double> token;
+    std::vector<std::shared_ptr<ResourceNode>> paged;
+    int pages = 0;
+    double lastRange = 0.0;
+    bool ordered = true;
+    do {
+        auto page = indexer.findInRange<double>("射程", 200.0, 400.0, 64, token);
+        for (const auto& node : page) {
+            ordered = ordered && node->getAttribute<double>("射程") >= lastRange;
+            lastRange = node->getAttribute<double>("射程");
+        }
+        if (page.size() > 64) ++failures;
+        paged.insert(paged.end(), page.begin(), page.end());
+        ++pages;
+    } while (!token.empty);
+    std::cout << "范围内共 " << all.size() << " 枚, 分 " << pages << " 页取回 " << paged.size() << " 枚, 按键有序: "
+              << (ordered ? "是" : "否") << std::endl;
+    if (paged.size() != all.size() || !ordered) ++failures;
+    for (size_t i = 0; i < paged.size() && i < all.size(); ++i) {
+        if (paged[i] != all[i]) {
+            ++failures;
+            break;
+        }
+    }
+
+    // 结果恰好填满最后一页时不应返回多余的续查标记
+    PageToken<double> exact;
+    auto onlyPage = indexer.findInRange<double>("射程", 599.0, 600.0, 20, exact);
+    std::cout << "射程>=599的导弹: " << onlyPage.size() << " 枚, 还有下一页: " << (exact.empty ? "否" : "是") << std::endl;
+    if (onlyPage.size() != 20 || !exact.empty) ++failures;
+
+    // 页大小为0无法推进续查标记，直接拒绝
+    PageToken<double> zero;
+    bool rejected = false;
+    try {
+        indexer.findInRange<double>("射程", 200.0, 400.0, 0, zero);
+    } catch (const std::invalid_argument&) {
+        rejected = true;
+    }
+    if (!rejected || !zero.empty) ++failures;
+    auto huge = indexer.findInRange<double>("射程", 599.0, 600.0, static_cast<size_t>(-1), zero);
+    if (huge.size() != 20 || !zero.empty) ++failures;
+
+    std::cout << "\n失败项: " << failures << std::endl;
+    return failures == 0 ? 0 : 1;
+}
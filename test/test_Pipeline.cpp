@@ -0,0 +1,169 @@
+#include "resource_api.h"
+#include "resource_pipeline.h"
+#include <atomic>
+#include <thread>
+
+#ifdef _WIN32
+#include <windows.h>
+#endif
+
+using namespace resource;
+
+const int TRACK_COUNT = 2000;
+const int TICK_COUNT = 20;
+
+struct Track {
+    std::string id;
+    int tick;
+    double longitude;
+    double latitude;
+    double altitude;
+    double speed;
+};
+
+class TrackConverter : public StructConverter {
+public:
+    std::shared_ptr<ResourceNode> convert(const void* structPtr, const std::string& nodeName) const override {
+        const Track& track = *static_cast<const Track*>(structPtr);
+        auto node = std::make_shared<ResourceNode>(nodeName, track.id);
+        node->setAttribute("tick", track.tick);
+        node->setAttribute("longitude", track.longitude);
+        node->setAttribute("latitude", track.latitude);
+        node->setAttribute("altitude", track.altitude);
+        node->setAttribute("speed", track.speed);
+        auto sensor = std::make_shared<ResourceNode>("sensor", track.id + "_sensor");
+        sensor->setAttribute("range", track.speed * 10.0);
+        node->addChild(sensor);
+        return node;
+    }
+
+    StructConverter* clone() const override { return new TrackConverter(*this); }
+};
+
+void advance(std::vector<Track>& tracks, int tick) {
+    for (size_t i = 0; i < tracks.size(); ++i) {
+        tracks[i].tick = tick;
+        tracks[i].longitude += 0.001 * (i % 7);
+        tracks[i].latitude += 0.002;
+        tracks[i].speed = 200.0 + (tick * 13 + i) % 100;
+    }
+}
+
+void setupTracks(ResourceRegistry& registry, std::vector<Track>& tracks, const TrackConverter& converter) {
+    registry.registerRootNode(std::make_shared<ResourceNode>("航迹集合", "tracks"));
+    for (int i = 0; i < TRACK_COUNT; ++i) {
+        tracks[i].id = "t" + std::to_string(i);
+        tracks[i].tick = 0;
+        tracks[i].longitude = 116.0;
+        tracks[i].latitude = 39.0;
+        tracks[i].altitude = 8000.0;
+        tracks[i].speed = 200.0;
+        registry.registerDynamicStruct(tracks[i], "tracks/" + tracks[i].id, converter, "航迹");
+    }
+    registry.commitChanges();
+}
+
+int main()
+{
+#ifdef _WIN32
+    SetConsoleOutputCP(CP_UTF8);
+#endif
+    int failures = 0;
+    TrackConverter converter;
+
+    // 顺序更新作为对照
+    ResourceRegistry sequential;
+    std::vector<Track> sequentialTracks(TRACK_COUNT);
+    setupTracks(sequential, sequentialTracks, converter);
+    ResourceIndexer sequentialIndexer(sequential);
+    sequentialIndexer.createAttributeIndex<double>("speed");
+
+    ResourceRegistry registry;
+    std::vector<Track> tracks(TRACK_COUNT);
+    setupTracks(registry, tracks, converter);
+    ResourceIndexer indexer(registry);
+    indexer.createAttributeIndex<double>("speed");
+
+    std::cout << "=== 顺序更新与流水线更新 ===" << std::endl;
+    size_t sequentialHits = 0;
+    long long sequentialTime = measureTime([&]() {
+        for (int tick = 1; tick <= TICK_COUNT; ++tick) {
+            advance(sequentialTracks, tick);
+            sequential.updateAllDynamicObjects();
+            sequentialHits += sequentialIndexer.findGreaterThan<double>("speed", 290.0).size();
+        }
+    });
+
+    size_t pipelineHits = 0;
+    bool consistent = true;
+    TickPipeline pipeline(registry, 2);
+    long long pipelineTime = measureTime([&]() {
+        for (int tick = 1; tick <= TICK_COUNT; ++tick) {
+            advance(tracks, tick);
+            pipeline.submitTick();
+            // 查询看到的是最近一个合并完成的tick，所有航迹处于同一个tick
+            pipeline.query([&]() {
+                pipelineHits += indexer.findGreaterThan<double>("speed", 290.0).size();
+                int first = registry.getNodeByPath("tracks/t0")->getAttribute<int>("tick");
+                int last = registry.getNodeByPath("tracks/t" + std::to_string(TRACK_COUNT - 1))->getAttribute<int>("tick");
+                consistent = consistent && first == last;
+            });
+        }
+        pipeline.flush();
+    });
+    std::cout << "顺序更新: " << sequentialTime << " 微秒, 流水线: " << pipelineTime << " 微秒" << std::endl;
+    std::cout << "已提交: " << pipeline.submittedTick() << ", 已完成: " << pipeline.completedTick()
+              << ", 查询时各航迹tick一致: " << (consistent ? "是" : "否") << std::endl;
+    if (pipeline.completedTick() != static_cast<uint64_t>(TICK_COUNT) || !consistent) ++failures;
+    (void)sequentialHits;
+    (void)pipelineHits;
+
+    std::cout << "\n=== 最终状态与顺序更新一致 ===" << std::endl;
+    int mismatched = 0;
+    for (int i = 0; i < TRACK_COUNT; ++i) {
+        std::string path = "tracks/t" + std::to_string(i);
+        auto a = sequential.getNodeByPath(path);
+        auto b = registry.getNodeByPath(path);
+        if (a->getAttribute<double>("speed") != b->getAttribute<double>("speed") ||
+            a->getAttribute<double>("longitude") != b->getAttribute<double>("longitude") ||
+            b->getAttribute<int>("tick") != TICK_COUNT ||
+            b->getChild("t" + std::to_string(i) + "_sensor")->getAttribute<double>("range") !=
+                a->getChild("t" + std::to_string(i) + "_sensor")->getAttribute<double>("range")) {
+            ++mismatched;
+        }
+    }
+    size_t fast = indexer.findGreaterThan<double>("speed", 290.0).size();
+    size_t expected = sequentialIndexer.findGreaterThan<double>("speed", 290.0).size();
+    std::cout << "不一致的航迹: " << mismatched << ", 索引查询结果: " << fast << " / " << expected << std::endl;
+    if (mismatched != 0 || fast != expected) ++failures;
+
+    std::cout << "\n=== 后台查询线程 ===" << std::endl;
+    // 另一个线程持续查询，每次都应看到所有航迹处于同一个tick
+    std::atomic<bool> done(false);
+    std::atomic<int> inconsistent(0);
+    std::atomic<int> reads(0);
+    std::thread reader([&]() {
+        while (!done.load()) {
+            pipeline.query([&]() {
+                int first = registry.getNodeByPath("tracks/t0")->getAttribute<int>("tick");
+                int middle = registry.getNodeByPath("tracks/t1000")->getAttribute<int>("tick");
+                if (first != middle) ++inconsistent;
+            });
+            ++reads;
+        }
+    });
+    for (int tick = TICK_COUNT + 1; tick <= TICK_COUNT * 2; ++tick) {
+        advance(tracks, tick);
+        pipeline.submitTick();
+    }
+    pipeline.flush();
+    done = true;
+    reader.join();
+    std::cout << "读取次数: " << reads.load() << ", 不一致: " << inconsistent.load() << std::endl;
+    if (inconsistent.load() != 0 || registry.getNodeByPath("tracks/t5")->getAttribute<int>("tick") != TICK_COUNT * 2) {
+        ++failures;
+    }
+
+    std::cout << "\n失败项: " << failures << std::endl;
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,171 @@
+#include "resource_api.h"
+#include <atomic>
+#include <thread>
+
+#ifdef _WIN32
+#include <windows.h>
+#endif
+
+using namespace resource;
+
+const int ITEM_COUNT = 20000;
+
+void printStats(const ResourceIndexer& indexer) {
+    const QueryCacheStats& stats = indexer.getQueryCacheStats();
+    std::cout << "命中: " << stats.hits << ", 未命中: " << stats.misses << ", 失效: " << stats.invalidations
+              << ", 淘汰: " << stats.evictions << ", 条目: " << stats.entries << std::endl;
+}
+
+int main()
+{
+#ifdef _WIN32
+    SetConsoleOutputCP(CP_UTF8);
+#endif
+    int failures = 0;
+    ResourceRegistry registry;
+
+    auto depot = std::make_shared<ResourceNode>("仓库", "depot");
+    for (int i = 0; i < ITEM_COUNT; ++i) {
+        auto item = std::make_shared<ResourceNode>("物资", "item" + std::to_string(i));
+        item->setAttribute("库存数量", i % 1000);
+        item->setAttribute("类别", std::string(i % 4 == 0 ? "弹药" : "燃料"));
+        item->setAttribute("位置", std::string("A区"));
+        depot->addChild(item);
+    }
+    registry.registerRootNode(depot);
+    ResourceIndexer indexer(registry);
+    indexer.createAttributeIndex<int>("库存数量");
+
+    std::cout << "=== 重复的范围查询 ===" << std::endl;
+    size_t coldCount = 0;
+    long long coldTime = measureTime([&]() { coldCount = indexer.findInRange<int>("库存数量", 100, 600).size(); });
+    size_t hotCount = 0;
+    long long hotTime = measureTime([&]() {
+        for (int i = 0; i < 100; ++i) hotCount = indexer.findInRange<int>("库存数量", 100, 600).size();
+    });
+    std::cout << "首次查询: " << coldTime << " 微秒, 之后100次平均: " << hotTime / 100 << " 微秒, 结果数: " << hotCount << std::endl;
+    printStats(indexer);
+    if (coldCount != hotCount || indexer.getQueryCacheStats().hits != 100) ++failures;
+
+    std::cout << "\n=== 修改无关属性后仍然命中 ===" << std::endl;
+    registry.setAttribute("depot/item1", "位置", std::string("B区"));
+    registry.commitChanges();
+    indexer.findInRange<int>("库存数量", 100, 600);
+    printStats(indexer);
+    if (indexer.getQueryCacheStats().hits != 101 || indexer.getQueryCacheStats().invalidations != 0) ++failures;
+
+    std::cout << "\n=== 修改依赖属性后失效 ===" << std::endl;
+    registry.setAttribute("depot/item1", "库存数量", 5000);
+    registry.commitChanges();
+    size_t updated = indexer.findInRange<int>("库存数量", 100, 600).size();
+    std::cout << "更新后结果数: " << updated << std::endl;
+    printStats(indexer);
+    // item1原来的库存为1，不在范围内，结果数不变；把范围内的节点移出范围后结果应减少
+    registry.setAttribute("depot/item100", "库存数量", 5000);
+    registry.commitChanges();
+    size_t shrunk = indexer.findInRange<int>("库存数量", 100, 600).size();
+    std::cout << "移出范围后结果数: " << shrunk << std::endl;
+    if (updated != coldCount || shrunk != coldCount - 1) ++failures;
+    if (indexer.getQueryCacheStats().invalidations != 2) ++failures;
+
+    std::cout << "\n=== 多条件查询 ===" << std::endl;
+    std::vector<std::function<bool(const std::shared_ptr<ResourceNode>&)>> conditions = {
+        [](const std::shared_ptr<ResourceNode>& node) {
+            return node->hasAttribute("类别") && node->getAttribute<std::string>("类别") == "弹药";
+        },
+        [](const std::shared_ptr<ResourceNode>& node) {
+            return node->hasAttribute("库存数量") && node->getAttribute<int>("库存数量") < 50;
+        }
+    };
+    const std::vector<std::string> attributes = {"类别", "库存数量"};
+    size_t scanCount = 0;
+    long long scanTime = measureTime([&]() {
+        scanCount = indexer.findByMultiConditions(conditions, true, "紧缺弹药", attributes).size();
+    });
+    size_t cachedCount = 0;
+    long long cachedTime = measureTime([&]() {
+        cachedCount = indexer.findByMultiConditions(conditions, true, "紧缺弹药", attributes).size();
+    });
+    std::cout << "首次扫描: " << scanTime << " 微秒, 缓存命中: " << cachedTime << " 微秒, 结果数: " << cachedCount << std::endl;
+    if (scanCount != cachedCount || scanCount != indexer.findByMultiConditions(conditions, true).size()) ++failures;
+
+    registry.setAttribute("depot/item4", "库存数量", 999);
+    registry.commitChanges();
+    size_t afterChange = indexer.findByMultiConditions(conditions, true, "紧缺弹药", attributes).size();
+    std::cout << "item4库存增加后: " << afterChange << std::endl;
+    if (afterChange != scanCount - 1) ++failures;
+
+    std::cout << "\n=== 节点增删清空缓存 ===" << std::endl;
+    registry.registerNodeAtPath("depot/extra", std::make_shared<ResourceNode>("物资", "extra"));
+    registry.commitChanges();
+    printStats(indexer);
+    if (indexer.getQueryCacheStats().entries != 0) ++failures;
+
+    std::cout << "\n=== LRU淘汰 ===" << std::endl;
+    indexer.setQueryCacheCapacity(2);
+    indexer.findByAttributeIndexed<int>("库存数量", 1);
+    indexer.findByAttributeIndexed<int>("库存数量", 2);
+    indexer.findByAttributeIndexed<int>("库存数量", 1);   // 命中，1成为最近使用
+    indexer.findByAttributeIndexed<int>("库存数量", 3);   // 淘汰2
+    size_t hitsBefore = indexer.getQueryCacheStats().hits;
+    indexer.findByAttributeIndexed<int>("库存数量", 1);
+    indexer.findByAttributeIndexed<int>("库存数量", 2);
+    printStats(indexer);
+    if (indexer.getQueryCacheStats().hits != hitsBefore + 1 || indexer.getQueryCacheStats().entries != 2) ++failures;
+
+    indexer.setQueryCacheCapacity(0);
+    indexer.findByAttributeIndexed<int>("库存数量", 1);
+    if (indexer.getQueryCacheStats().entries != 0 || indexer.getQueryCacheStats().hits != hitsBefore + 1) ++failures;
+
+    std::cout << "\n=== 多个读线程共用缓存 ===" << std::endl;
+    // 容量小于不同查询的个数，读线程同时命中、写入和淘汰条目
+    indexer.setQueryCacheCapacity(8);
+    std::vector<size_t> expected(16);
+    for (int value = 0; value < 16; ++value) {
+        expected[value] = indexer.findByAttributeIndexed<int>("库存数量", value).size();
+    }
+    QueryCacheStats before = indexer.getQueryCacheStats();
+    const int THREAD_COUNT = 4;
+    const int QUERIES_PER_THREAD = 2000;
+    std::atomic<int> wrong(0);
+    std::vector<std::thread> readers;
+    for (int t = 0; t < THREAD_COUNT; ++t) {
+        readers.emplace_back([&, t]() {
+            for (int i = 0; i < QUERIES_PER_THREAD; ++i) {
+                int value = (i * 7 + t) % 16;
+                ReadLock lock(registry.getMutex());
+                if (indexer.findByAttributeIndexed<int>("库存数量", value).size() != expected[value]) ++wrong;
+            }
+        });
+    }
+    for (auto& reader : readers) reader.join();
+    QueryCacheStats after = indexer.getQueryCacheStats();
+    printStats(indexer);
+    if (wrong != 0 || after.entries > 8) ++failures;
+    if ((after.hits - before.hits) + (after.misses - before.misses) !=
+        static_cast<size_t>(THREAD_COUNT * QUERIES_PER_THREAD)) {
+        ++failures;
+    }
+
+    std::cout << "\n=== 没有索引的属性并发查询 ===" << std::endl;
+    // 查询不创建索引，各线程各自扫描，索引表保持不变
+    indexer.setQueryCacheCapacity(0);
+    const size_t ammo = indexer.findByAttribute<std::string>("类别", "弹药").size();
+    std::atomic<int> wrongScans(0);
+    readers.clear();
+    for (int t = 0; t < THREAD_COUNT; ++t) {
+        readers.emplace_back([&]() {
+            for (int i = 0; i < 20; ++i) {
+                ReadLock lock(registry.getMutex());
+                if (indexer.findByAttributeIndexed<std::string>("类别", "弹药").size() != ammo) ++wrongScans;
+            }
+        });
+    }
+    for (auto& reader : readers) reader.join();
+    bool created = indexer.hasAttributeIndex<std::string>("类别");
+    std::cout << "结果错误: " << wrongScans.load() << ", 查询后建立了索引: " << (created ? "是" : "否") << std::endl;
+    if (wrongScans != 0 || created) ++failures;
+
+    std::cout << "\n失败项: " << failures << std::endl;
+    return failures == 0 ? 0 : 1;
+}
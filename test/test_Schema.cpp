@@ -0,0 +1,172 @@
+#include "resource_api.h"
+#include <atomic>
+#include <cstdlib>
+#include <new>
+#include <sstream>
+
+#ifdef _WIN32
+#include <windows.h>
+#endif
+
+using namespace resource;
+
+// 统计堆上存活的字节数，用于比较两种节点的内存占用
+static std::atomic<long long> g_liveBytes(0);
+static const size_t HEADER_SIZE = 16;
+
+void* operator new(std::size_t size) {
+    void* block = std::malloc(size + HEADER_SIZE);
+    if (!block) throw std::bad_alloc();
+    *static_cast<std::size_t*>(block) = size;
+    g_liveBytes += static_cast<long long>(size);
+    return static_cast<char*>(block) + HEADER_SIZE;
+}
+
+void operator delete(void* ptr) noexcept {
+    if (!ptr) return;
+    char* block = static_cast<char*>(ptr) - HEADER_SIZE;
+    g_liveBytes -= static_cast<long long>(*reinterpret_cast<std::size_t*>(block));
+    std::free(block);
+}
+
+const int NODE_COUNT = 10000;
+
+void fillDynamic(ResourceNode& node, int i) {
+    node.setAttribute("类型", std::string(i % 2 ? "空空导弹" : "空地导弹"));
+    node.setAttribute("射程", 100.0 + i % 400);
+    node.setAttribute("速度", 2.0 + (i % 3) * 0.5);
+    node.setAttribute("重量", 150.0 + i % 100);
+    node.setAttribute("已部署", i % 3 == 0);
+}
+
+int main()
+{
+#ifdef _WIN32
+    SetConsoleOutputCP(CP_UTF8);
+#endif
+    int failures = 0;
+    ResourceRegistry registry;
+
+    auto schema = std::make_shared<NodeSchema>("导弹");
+    schema->addField<std::string>("类型")
+           .addField<double>("射程")
+           .addField<double>("速度")
+           .addField<double>("重量")
+           .addField<bool>("已部署", false);
+    registry.registerSchema(schema);
+
+    std::cout << "=== 模式布局 ===" << std::endl;
+    for (size_t i = 0; i < schema->fieldCount(); ++i) {
+        std::cout << "- " << schema->field(i).name << " 偏移: " << schema->field(i).offset << std::endl;
+    }
+    std::cout << "槽位大小: " << schema->slotSize() << " 字节" << std::endl;
+
+    std::cout << "\n=== 每节点内存占用 ===" << std::endl;
+    std::vector<std::shared_ptr<ResourceNode>> dynamicNodes;
+    std::vector<std::shared_ptr<ResourceNode>> schemaNodes;
+    dynamicNodes.reserve(NODE_COUNT);
+    schemaNodes.reserve(NODE_COUNT);
+
+    // 不带属性的节点作为基准，扣除节点本身的开销
+    std::vector<std::shared_ptr<ResourceNode>> bareNodes;
+    bareNodes.reserve(NODE_COUNT);
+    long long before = g_liveBytes.load();
+    for (int i = 0; i < NODE_COUNT; ++i) {
+        bareNodes.push_back(std::make_shared<ResourceNode>("导弹", "b" + std::to_string(i)));
+    }
+    long long bareBytes = (g_liveBytes.load() - before) / NODE_COUNT;
+    bareNodes.clear();
+
+    before = g_liveBytes.load();
+    for (int i = 0; i < NODE_COUNT; ++i) {
+        auto node = std::make_shared<ResourceNode>("导弹", "d" + std::to_string(i));
+        fillDynamic(*node, i);
+        dynamicNodes.push_back(node);
+    }
+    long long dynamicBytes = (g_liveBytes.load() - before) / NODE_COUNT;
+
+    before = g_liveBytes.load();
+    for (int i = 0; i < NODE_COUNT; ++i) {
+        auto node = registry.createNode("导弹", "导弹", "s" + std::to_string(i));
+        fillDynamic(*node, i);
+        schemaNodes.push_back(node);
+    }
+    long long schemaBytes = (g_liveBytes.load() - before) / NODE_COUNT;
+
+    std::cout << "空节点: " << bareBytes << " 字节/节点" << std::endl;
+    std::cout << "动态属性节点: " << dynamicBytes << " 字节/节点 (属性占 " << dynamicBytes - bareBytes << ")" << std::endl;
+    std::cout << "模式节点: " << schemaBytes << " 字节/节点 (属性占 " << schemaBytes - bareBytes << ")" << std::endl;
+    if ((schemaBytes - bareBytes) * 3 > dynamicBytes - bareBytes) ++failures;
+
+    std::cout << "\n=== 读取性能 ===" << std::endl;
+    double sum1 = 0, sum2 = 0, sum3 = 0;
+    long long dynamicTime = measureTime([&]() {
+        for (const auto& node : dynamicNodes) sum1 += node->getAttribute<double>("射程");
+    });
+    long long schemaTime = measureTime([&]() {
+        for (const auto& node : schemaNodes) sum2 += node->getAttribute<double>("射程");
+    });
+    size_t rangeField = schema->fieldIndex("射程");
+    long long fieldTime = measureTime([&]() {
+        for (const auto& node : schemaNodes) sum3 += node->getField<double>(rangeField);
+    });
+    std::cout << "动态属性 getAttribute: " << dynamicTime << " 微秒" << std::endl;
+    std::cout << "模式节点 getAttribute: " << schemaTime << " 微秒" << std::endl;
+    std::cout << "模式节点 getField: " << fieldTime << " 微秒" << std::endl;
+    if (sum1 != sum2 || sum2 != sum3) ++failures;
+
+    std::cout << "\n=== 额外属性与类型检查 ===" << std::endl;
+    auto missile = schemaNodes[0];
+    missile->setAttribute("备注", std::string("试验批次"));
+    missile->removeAttribute("射程");  // 模式字段不能删除
+    std::cout << "属性: ";
+    for (const auto& key : missile->getAttributeKeys()) {
+        std::cout << key << " ";
+    }
+    std::cout << std::endl;
+    if (missile->getAttributeKeys().size() != 6 || !missile->hasAttribute("射程")) ++failures;
+    if (missile->getAttribute<std::string>("备注") != "试验批次") ++failures;
+
+    bool threw = false;
+    try {
+        missile->setAttribute("射程", 300);  // int写入double字段
+    } catch (const std::bad_cast&) {
+        threw = true;
+    }
+    std::cout << "类型不匹配时抛出bad_cast: " << (threw ? "是" : "否") << std::endl;
+    if (!threw) ++failures;
+
+    auto copy = missile->clone();
+    std::cout << "克隆后模式: " << (copy->getSchema() ? copy->getSchema()->getName() : "(无)")
+              << ", 射程: " << copy->getAttribute<double>("射程") << std::endl;
+    if (copy->getSchema() != missile->getSchema() || copy->getAttribute<double>("射程") != 100.0) ++failures;
+
+    std::cout << "\n=== 注册表、索引与导出 ===" << std::endl;
+    auto fleet = std::make_shared<ResourceNode>("编队", "fleet");
+    for (int i = 0; i < 5; ++i) {
+        fleet->addChild(schemaNodes[i]);
+    }
+    registry.registerRootNode(fleet);
+    ResourceIndexer indexer(registry);
+    auto subscription = registry.subscribe("fleet", true, std::vector<std::string>{"射程"});
+
+    registry.setAttribute("fleet/s1", "射程", 450.0);
+    registry.commitChanges();
+    auto farReaching = indexer.findGreaterThan<double>("射程", 400.0);
+    ChangeBatch batch;
+    size_t events = 0;
+    while (subscription->poll(batch)) events += batch.size();
+    std::cout << "射程>400: " << farReaching.size() << " 个, 订阅事件: " << events << std::endl;
+    if (farReaching.size() != 1 || events != 1) ++failures;
+
+    std::ostringstream json;
+    {
+        JsonTreeWriter writer(json);
+        writer.writeNode(*schemaNodes[1]);
+    }
+    std::cout << json.str() << std::endl;
+    if (json.str().find("\"射程\":450.0") == std::string::npos) ++failures;
+
+    std::cout << "\n失败项: " << failures << std::endl;
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,199 @@
+#include "resource_api.h"
+#include <algorithm>
+#include <cstdio>
+
+#ifdef _WIN32
+#include <windows.h>
+#endif
+
+using namespace resource;
+
+const int UNIT_COUNT = 200;
+const int SENSOR_COUNT = 20;
+
+// 每个单元带一棵传感器子树
+std::shared_ptr<ResourceNode> buildUnit(int i) {
+    auto unit = std::make_shared<ResourceNode>("unit", "u" + std::to_string(i));
+    unit->setAttribute("side", i % 2);
+    auto perception = std::make_shared<ResourceNode>("perception", "perception");
+    for (int s = 0; s < SENSOR_COUNT; ++s) {
+        auto sensor = std::make_shared<ResourceNode>("sensor", "s" + std::to_string(s));
+        sensor->setAttribute("range", 1000.0 + i + s);
+        sensor->setAttribute("band", std::string("X-band-") + std::to_string(s % 4));
+        sensor->setAttribute("channels", s);
+        perception->addChild(sensor);
+    }
+    unit->addChild(perception);
+    return unit;
+}
+
+// 每个tick更新的航迹
+struct Track {
+    std::string id;
+    double speed;
+};
+
+class TrackConverter : public StructConverter {
+public:
+    std::shared_ptr<ResourceNode> convert(const void* structPtr, const std::string& nodeName) const override {
+        const Track& track = *static_cast<const Track*>(structPtr);
+        auto node = std::make_shared<ResourceNode>(nodeName, track.id);
+        node->setAttribute("speed", track.speed);
+        return node;
+    }
+
+    StructConverter* clone() const override { return new TrackConverter(*this); }
+};
+
+int main()
+{
+#ifdef _WIN32
+    SetConsoleOutputCP(CP_UTF8);
+#endif
+    int failures = 0;
+
+    ResourceRegistry registry;
+    registry.createPath("army");
+    std::vector<std::shared_ptr<ResourceNode>> units;
+    for (int i = 0; i < UNIT_COUNT; ++i) {
+        units.push_back(buildUnit(i));
+    }
+    registry.registerChildren("army", units);
+    registry.commitChanges();
+    ResourceIndexer indexer(registry);
+    indexer.createAttributeIndex<int>("side");
+
+    const std::string spillPath = "test_spill.bin";
+    const size_t fullBytes = registry.memoryUsage().total.total();
+    SpillManager spill(registry, spillPath, fullBytes / 4);
+    spill.manage("army");
+
+    std::cout << "=== 超出预算时换出未访问的子树 ===" << std::endl;
+    // 扫描前访问过的单元获得第二次机会
+    for (int i = 0; i < 10; ++i) {
+        registry.getNodeByPath("army/u" + std::to_string(i) + "/perception/s0");
+    }
+    size_t first = spill.sweep();
+    // 预算已满足时不再换出
+    size_t second = spill.sweep();
+    size_t spilledBytes = registry.memoryUsage().total.total();
+    std::cout << "换出: " << first << " + " << second << " 个, 内存: " << fullBytes << " -> " << spilledBytes
+              << " 字节, 驻留: " << spill.residentBytes() << " (预算 " << spill.getBudget() << "), 文件: "
+              << spill.fileBytes() << " 字节" << std::endl;
+    if (first == 0 || second != 0 || spill.residentBytes() > spill.getBudget()) ++failures;
+    if (spill.spilledCount() != first + second || spill.spillCount() != first + second) ++failures;
+    if (spilledBytes * 2 > fullBytes || spill.fileBytes() == 0) ++failures;
+    for (int i = 0; i < 10; ++i) {
+        if (!units[i]->isLoaded()) ++failures;
+    }
+    if (units[150]->isLoaded()) ++failures;
+
+    std::cout << "\n=== 访问时从文件加载 ===" << std::endl;
+    auto sensor = registry.getNodeByPath("army/u150/perception/s7");
+    bool reloaded = sensor && sensor->getAttribute<double>("range") == 1157.0 &&
+                    sensor->getAttribute<std::string>("band") == "X-band-3" && sensor->getAttribute<int>("channels") == 7;
+    std::cout << "加载内容一致: " << (reloaded ? "是" : "否") << ", 加载次数: " << spill.reloadCount() << std::endl;
+    if (!reloaded || spill.reloadCount() != 1 || !units[150]->isLoaded()) ++failures;
+    if (sensor->getPath() != "army/u150/perception/s7") ++failures;
+
+    std::cout << "\n=== 索引指向稳定的节点 ===" << std::endl;
+    // 桩节点就是原来的节点对象，属性索引里的条目不变
+    auto sideOne = indexer.findByAttributeIndexed<int>("side", 1);
+    bool stable = sideOne.size() == UNIT_COUNT / 2;
+    for (const auto& node : sideOne) {
+        if (node != registry.getNodeByPath("army/" + node->getId())) stable = false;
+    }
+    std::cout << "side=1: " << sideOne.size() << " 个, 与树上的节点相同: " << (stable ? "是" : "否") << std::endl;
+    if (!stable || indexer.getById("u199") != units[199]) ++failures;
+    // 被换出的后代离开了名称索引，只剩下常驻的单元
+    size_t indexedSensors = indexer.findByName("sensor").size();
+    std::cout << "名称索引中的传感器: " << indexedSensors << std::endl;
+    if (indexedSensors > (UNIT_COUNT - first - second) * SENSOR_COUNT) ++failures;
+
+    // 加载回来的后代在写线程发布后重新进入索引，名称索引中是树上的同一个节点对象
+    size_t republished = spill.publishReloads();
+    auto sensorsAfter = indexer.findByName("sensor");
+    bool reindexed = std::find(sensorsAfter.begin(), sensorsAfter.end(), sensor) != sensorsAfter.end();
+    std::cout << "重新发布: " << republished << " 棵子树, 名称索引中的传感器: " << sensorsAfter.size()
+              << ", 包含加载回来的节点: " << (reindexed ? "是" : "否") << std::endl;
+    if (republished != 1 || !reindexed || sensorsAfter.size() != indexedSensors + SENSOR_COUNT) ++failures;
+    if (spill.publishReloads() != 0) ++failures;
+
+    // 不调用publishReloads时，注册表的下一次提交顺带发布加载
+    auto other = registry.getNodeByPath("army/u151/perception/s3");
+    size_t beforeCommit = indexer.findByName("sensor").size();
+    registry.setAttribute("army/u0", "side", 0);
+    registry.commitChanges();
+    auto sensorsCommitted = indexer.findByName("sensor");
+    bool committedIn = std::find(sensorsCommitted.begin(), sensorsCommitted.end(), other) != sensorsCommitted.end();
+    std::cout << "提交前: " << beforeCommit << ", 提交后: " << sensorsCommitted.size()
+              << ", 包含加载回来的节点: " << (committedIn ? "是" : "否") << std::endl;
+    if (!other || beforeCommit != sensorsAfter.size() || !committedIn ||
+        sensorsCommitted.size() != beforeCommit + SENSOR_COUNT || spill.publishReloads() != 0) {
+        ++failures;
+    }
+
+    std::cout << "\n=== 修改随再次换出写入文件 ===" << std::endl;
+    sensor->setAttribute("range", 42.0);
+    spill.setBudget(0);
+    spill.sweep();
+    spill.sweep();
+    std::cout << "预算为0时换出: " << spill.spilledCount() << " 个" << std::endl;
+    if (spill.spilledCount() != UNIT_COUNT || units[150]->isLoaded()) ++failures;
+    auto modified = registry.getNodeByPath("army/u150/perception/s7");
+    if (!modified || modified->getAttribute<double>("range") != 42.0) ++failures;
+    // 已取出的引用仍然有效，只是脱离了节点树
+    if (sensor->getParent() != nullptr || sensor->getAttribute<double>("range") != 42.0) ++failures;
+
+    std::cout << "\n=== 不能换出的子树 ===" << std::endl;
+    auto lazy = std::make_shared<ResourceNode>("unit", "lazy");
+    lazy->setLoader([](ResourceNode& target) {
+        target.addChild(std::make_shared<ResourceNode>("sensor", "inner"));
+    });
+    registry.createPath("depot");
+    registry.registerNodeAtPath("depot/c0", std::make_shared<ResourceNode>("crate", "c0"));
+    registry.commitChanges();
+    auto crate = registry.getNodeByPath("depot/c0");
+    crate->addChild(lazy);
+    spill.manage("depot");
+    spill.sweep();
+    spill.sweep();
+    // 含有延迟加载后代的子树保持常驻
+    std::cout << "depot/c0 常驻: " << (crate->isLoaded() && !crate->isLazy() ? "是" : "否") << std::endl;
+    if (crate->isLazy() || !crate->getChild("lazy")) ++failures;
+
+    std::cout << "\n=== 动态对象所在的子树 ===" << std::endl;
+    registry.createPath("fleet");
+    registry.registerNodeAtPath("fleet/perception", buildUnit(0)->getChild("perception"));
+    registry.commitChanges();
+    Track escort = {"escort", 300.0};
+    Track flagship = {"f1", 250.0};
+    registry.registerDynamicStruct(escort, "fleet/perception/escort", TrackConverter(), "track");
+    auto flagshipNode = registry.registerDynamicStruct(flagship, "fleet/f1", TrackConverter(), "track");
+    registry.commitChanges();
+    auto holder = registry.getNodeByPath("fleet/perception");
+    auto escortNode = registry.getNodeByPath("fleet/perception/escort");
+    spill.manage("fleet");
+    spill.sweep();
+    spill.sweep();
+    // 含有动态对象的子树和动态对象自身都不换出，之后的tick写入仍在树上的节点
+    escort.speed = 320.0;
+    flagship.speed = 260.0;
+    registry.updateAllDynamicObjects();
+    auto ticked = registry.getNodeByPath("fleet/perception/escort");
+    std::cout << "含动态对象的子树常驻: " << (holder->isLazy() ? "否" : "是")
+              << ", tick后的速度: " << (ticked ? ticked->getAttribute<double>("speed") : 0.0) << std::endl;
+    if (holder->isLazy() || flagshipNode->isLazy() || ticked != escortNode) ++failures;
+    if (escortNode->getAttribute<double>("speed") != 320.0 || flagshipNode->getAttribute<double>("speed") != 260.0) {
+        ++failures;
+    }
+    // 取消跟踪后照常换出
+    registry.removeDynamicObject(escortNode);
+    spill.sweep();
+    spill.sweep();
+    if (!holder->isLazy() || !registry.getNodeByPath("fleet/perception/escort")) ++failures;
+
+    std::remove(spillPath.c_str());
+    std::cout << "\n失败项: " << failures << std::endl;
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,103 @@
+#include "resource_api.h"
+#include <thread>
+
+#ifdef _WIN32
+#include <windows.h>
+#endif
+
+using namespace resource;
+
+const int AGENT_COUNT = 2000;
+
+int main()
+{
+#ifdef _WIN32
+    SetConsoleOutputCP(CP_UTF8);
+#endif
+    int failures = 0;
+
+    std::cout << "=== 驻留字符串 ===" << std::endl;
+    size_t baseline = StringPool::size();
+    {
+        InternedString a(std::string("maneuver"));
+        InternedString b("maneuver");
+        InternedString c("perception");
+        InternedString empty;
+        std::cout << "相同内容共享条目: " << (a == b ? "是" : "否") << ", 不同内容: " << (a != c ? "不同" : "相同")
+                  << ", 池中字符串: " << StringPool::size() - baseline << std::endl;
+        if (a != b || a == c || &a.str() != &b.str() || StringPool::size() != baseline + 2) ++failures;
+        if (!empty.empty() || empty != InternedString("") || empty.str() != "") ++failures;
+        InternedString moved(std::move(a));
+        if (moved != b || !a.empty()) ++failures;
+    }
+    std::cout << "句柄释放后池中字符串: " << StringPool::size() - baseline << std::endl;
+    if (StringPool::size() != baseline) ++failures;
+
+    std::cout << "\n=== 重复的子节点名称只保存一份 ===" << std::endl;
+    ResourceRegistry registry;
+    auto fleet = std::make_shared<ResourceNode>("编队", "fleet");
+    for (int i = 0; i < AGENT_COUNT; ++i) {
+        std::string id = "agent" + std::to_string(i);
+        auto agent = std::make_shared<ResourceNode>("missile", id);
+        agent->addChild(std::make_shared<ResourceNode>("maneuver", id + "_maneuver"));
+        agent->addChild(std::make_shared<ResourceNode>("perception", id + "_perception"));
+        fleet->addChild(agent);
+    }
+    registry.registerRootNode(fleet);
+    // 每个智能体3个不同的ID，名称只有"missile"/"maneuver"/"perception"三个，另有编队的名称和ID
+    size_t pooled = StringPool::size() - baseline;
+    std::cout << "节点数: " << AGENT_COUNT * 3 + 1 << ", 驻留字符串: " << pooled
+              << ", sizeof(ResourceNode): " << sizeof(ResourceNode) << " 字节" << std::endl;
+    if (pooled != static_cast<size_t>(AGENT_COUNT) * 3 + 5) ++failures;
+
+    auto first = registry.getNodeByPath("fleet/agent0/agent0_maneuver");
+    auto second = registry.getNodeByPath("fleet/agent1/agent1_maneuver");
+    if (!first || !second || first->getInternedName() != second->getInternedName()) ++failures;
+    if (&first->getName() != &second->getName()) ++failures;
+
+    std::cout << "\n=== 子节点与根节点查找 ===" << std::endl;
+    auto agent5 = fleet->getChild("agent5");
+    agent5->removeChild("agent5_perception");
+    std::cout << "agent5子节点数: " << agent5->getChildren().size() << std::endl;
+    if (agent5->getChildren().size() != 1 || agent5->getChild("agent5_perception")) ++failures;
+    if (!agent5->getChild(std::string("agent5_") + "maneuver")) ++failures;
+
+    WriteBatch batch;
+    batch.addNode("", std::make_shared<ResourceNode>("仓库", "depot"));
+    batch.removeNode("fleet/agent7");
+    std::string error;
+    if (!registry.commit(batch, &error)) {
+        std::cout << "提交失败: " << error << std::endl;
+        ++failures;
+    }
+    if (!registry.getRootNode("depot") || registry.getNodeByPath("fleet/agent7")) ++failures;
+
+    ResourceIndexer indexer(registry);
+    std::cout << "名为maneuver的节点: " << indexer.findByName("maneuver").size() << std::endl;
+    if (indexer.findByName("maneuver").size() != static_cast<size_t>(AGENT_COUNT - 1)) ++failures;
+    if (!indexer.getById("agent9_perception") || indexer.getById("agent7")) ++failures;
+
+    MemoryReport report = registry.memoryUsage();
+    std::cout << "节点树: " << report.total.total() << " 字节, 字符串池: " << report.internedStrings << " 字节" << std::endl;
+    if (report.internedStrings == 0) ++failures;
+
+    std::cout << "\n=== 多线程驻留与释放 ===" << std::endl;
+    size_t before = StringPool::size();
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; ++t) {
+        threads.push_back(std::thread([]() {
+            for (int round = 0; round < 2000; ++round) {
+                InternedString shared("共享名称" + std::to_string(round % 8));
+                InternedString copy = shared;
+                InternedString other("临时" + std::to_string(round % 50));
+                if (copy != shared || other.str().empty()) std::abort();
+            }
+        }));
+    }
+    for (auto& thread : threads) thread.join();
+    std::cout << "结束后新增的驻留字符串: " << StringPool::size() - before << std::endl;
+    if (StringPool::size() != before) ++failures;
+
+    std::cout << "\n失败项: " << failures << std::endl;
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,162 @@
+#include "resource_api.h"
+#include <thread>
+
+#ifdef _WIN32
+#include <windows.h>
+#endif
+
+using namespace resource;
+
+// 简单的位置结构体及其转换器，用于演示动态更新后的批量通知
+struct Position {
+    std::string id;
+    double longitude;
+    double latitude;
+};
+
+class PositionConverter : public StructConverter {
+public:
+    std::shared_ptr<ResourceNode> convert(const void* structPtr, const std::string& nodeName) const override {
+        const Position& pos = *static_cast<const Position*>(structPtr);
+        auto node = std::make_shared<ResourceNode>(nodeName, pos.id);
+        node->setAttribute("longitude", pos.longitude);
+        node->setAttribute("latitude", pos.latitude);
+        return node;
+    }
+
+    StructConverter* clone() const override {
+        return new PositionConverter(*this);
+    }
+};
+
+std::string describeValue(const std::shared_ptr<const AttributeValue>& value) {
+    if (!value) return "(无)";
+    if (value->getType() == typeid(double)) {
+        return std::to_string(static_cast<const TypedAttributeValue<double>&>(*value).getValue());
+    }
+    if (value->getType() == typeid(bool)) {
+        return static_cast<const TypedAttributeValue<bool>&>(*value).getValue() ? "true" : "false";
+    }
+    if (value->getType() == typeid(std::string)) {
+        return static_cast<const TypedAttributeValue<std::string>&>(*value).getValue();
+    }
+    return "[complex type]";
+}
+
+void printBatch(const std::string& title, const ChangeBatch& batch) {
+    static const char* TYPE_NAMES[] = {"节点新增", "节点删除", "属性修改", "属性删除"};
+    std::cout << "\n=== " << title << " (" << batch.size() << " 条事件) ===" << std::endl;
+    for (const auto& event : batch) {
+        std::cout << "- " << TYPE_NAMES[static_cast<int>(event.type)] << " " << event.path;
+        if (!event.key.empty()) {
+            std::cout << " [" << event.key << "] " << describeValue(event.oldValue) << " -> " << describeValue(event.newValue);
+        }
+        std::cout << std::endl;
+    }
+}
+
+int main()
+{
+#ifdef _WIN32
+    SetConsoleOutputCP(CP_UTF8);
+#endif
+    int failures = 0;
+    ResourceRegistry registry;
+
+    auto group = std::make_shared<ResourceNode>("弹群1", "group001");
+    auto cluster1 = std::make_shared<ResourceNode>("弹簇1", "cluster001");
+    auto cluster2 = std::make_shared<ResourceNode>("弹簇2", "cluster002");
+    group->addChild(cluster1);
+    group->addChild(cluster2);
+    for (int i = 1; i <= 3; ++i) {
+        auto missile = std::make_shared<ResourceNode>("弹" + std::to_string(i), "m1-" + std::to_string(i));
+        missile->setAttribute("射程", 100.0 * i);
+        missile->setAttribute("已部署", false);
+        cluster1->addChild(missile);
+    }
+    registry.registerRootNode(group);
+
+    auto clusterSub = registry.subscribe("group001/cluster001");
+    auto rangeSub = registry.subscribe("", true, std::vector<std::string>{"射程"});
+    auto tinySub = registry.subscribe("group001", true, std::vector<std::string>(), 1);
+
+    // 同一属性多次修改只投递一条事件，改回原值的修改被丢弃
+    registry.setAttribute("group001/cluster001/m1-1", "射程", 150.0);
+    registry.setAttribute("group001/cluster001/m1-1", "射程", 180.0);
+    registry.setAttribute("group001/cluster001/m1-2", "已部署", true);
+    registry.setAttribute("group001/cluster001/m1-2", "已部署", false);
+    registry.setAttribute("group001/cluster002", "射程", 50.0);
+    registry.registerNodeAtPath("group001/cluster001/m1-4", std::make_shared<ResourceNode>("弹4", "m1-4"));
+    registry.removeNodeByPath("group001/cluster001/m1-3");
+    registry.commitChanges();
+    registry.setAttribute("group001/cluster002", "射程", 60.0);
+    registry.commitChanges();
+
+    // 在消费者线程中读取
+    ChangeBatch clusterBatch;
+    std::thread consumer([&]() {
+        ChangeBatch batch;
+        while (clusterSub->poll(batch)) {
+            clusterBatch.insert(clusterBatch.end(), batch.begin(), batch.end());
+        }
+    });
+    consumer.join();
+    printBatch("订阅 group001/cluster001", clusterBatch);
+    if (clusterBatch.size() != 3) ++failures;
+
+    ChangeBatch rangeBatch;
+    ChangeBatch batch;
+    while (rangeSub->poll(batch)) {
+        printBatch("订阅 射程 属性", batch);
+        rangeBatch.insert(rangeBatch.end(), batch.begin(), batch.end());
+    }
+    if (rangeBatch.size() != 5) ++failures;
+
+    std::cout << "\n=== 慢消费者（容量为1） ===" << std::endl;
+    std::cout << "丢弃批次数: " << tinySub->droppedBatches() << std::endl;
+    if (tinySub->droppedBatches() != 1) ++failures;
+
+    std::cout << "\n=== 动态对象更新后的批量通知 ===" << std::endl;
+    Position pos = {"p-1", 116.3, 39.9};
+    PositionConverter converter;
+    registry.registerDynamicStruct(pos, "group001/cluster002/p-1", converter, "位置");
+    registry.commitChanges();
+    auto posSub = registry.subscribe("group001/cluster002/p-1", false, std::vector<std::string>{"longitude"});
+    for (int tick = 0; tick < 3; ++tick) {
+        pos.longitude += 0.1;
+        pos.latitude += 0.05;
+        registry.updateAllDynamicObjects();
+    }
+    int ticks = 0;
+    while (posSub->poll(batch)) {
+        printBatch("tick " + std::to_string(ticks), batch);
+        ++ticks;
+    }
+    if (ticks != 3) ++failures;
+
+    registry.unsubscribe(posSub);
+    pos.longitude += 0.1;
+    registry.updateAllDynamicObjects();
+    if (posSub->hasPending()) ++failures;
+
+    std::cout << "\n=== 连同订阅节点一起挂载的祖先 ===" << std::endl;
+    auto futureSub = registry.subscribe("group001/cluster003/m3-1");
+    auto siblingSub = registry.subscribe("group001/cluster0030/m3-1");
+    auto cluster3 = std::make_shared<ResourceNode>("弹簇3", "cluster003");
+    cluster3->addChild(std::make_shared<ResourceNode>("弹1", "m3-1"));
+    registry.registerNodeAtPath("group001/cluster003", cluster3);
+    registry.commitChanges();
+    ChangeBatch addedBatch;
+    while (futureSub->poll(batch)) {
+        addedBatch.insert(addedBatch.end(), batch.begin(), batch.end());
+    }
+    printBatch("订阅 group001/cluster003/m3-1", addedBatch);
+    if (addedBatch.size() != 1 || addedBatch[0].type != ChangeEvent::Type::NODE_ADDED ||
+        addedBatch[0].path != "group001/cluster003") {
+        ++failures;
+    }
+    if (siblingSub->hasPending()) ++failures;
+
+    std::cout << "\n失败项: " << failures << std::endl;
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,146 @@
+#include "resource_api.h"
+#include <sstream>
+
+#ifdef _WIN32
+#include <windows.h>
+#endif
+
+using namespace resource;
+
+const int MISSILE_COUNT = 10000;
+
+void fillMissile(ResourceNode& node, int i) {
+    node.setAttribute("类型", std::string(i % 2 ? "空空导弹" : "空地导弹"));
+    node.setAttribute("射程", 100.0 + i % 400);
+    node.setAttribute("速度", 2.0 + (i % 3) * 0.5);
+    node.setAttribute("重量", 150.0 + i % 100);
+    node.setAttribute("已部署", i % 3 == 0);
+}
+
+int main()
+{
+#ifdef _WIN32
+    SetConsoleOutputCP(CP_UTF8);
+#endif
+    int failures = 0;
+    ResourceRegistry registry;
+
+    auto schema = std::make_shared<NodeSchema>("导弹");
+    schema->addField<std::string>("类型")
+           .addField<double>("射程")
+           .addField<double>("速度")
+           .addField<double>("重量")
+           .addField<bool>("已部署", false);
+    registry.registerSchema(schema);
+
+    std::cout << "=== 创建行句柄 ===" << std::endl;
+    auto table = registry.getTable("导弹");
+    table->reserve(MISSILE_COUNT);
+    auto group = std::make_shared<ResourceNode>("导弹集群", "missile-group");
+    std::vector<std::shared_ptr<ResourceNode>> schemaNodes;
+    std::vector<std::shared_ptr<ResourceNode>> dynamicNodes;
+    for (int i = 0; i < MISSILE_COUNT; ++i) {
+        auto row = registry.createRow("导弹", "导弹", "m" + std::to_string(i));
+        fillMissile(*row, i);
+        group->addChild(row);
+
+        auto node = registry.createNode("导弹", "导弹", "s" + std::to_string(i));
+        fillMissile(*node, i);
+        schemaNodes.push_back(node);
+
+        auto dynamic = std::make_shared<ResourceNode>("导弹", "d" + std::to_string(i));
+        fillMissile(*dynamic, i);
+        dynamicNodes.push_back(dynamic);
+    }
+    registry.registerRootNode(group);
+    std::cout << "表中行数: " << table->rowCount() << std::endl;
+    if (table->rowCount() != static_cast<size_t>(MISSILE_COUNT)) ++failures;
+
+    auto m7 = registry.getNodeByPath("missile-group/m7");
+    m7->setAttribute("备注", std::string("试验批次"));
+    std::cout << "m7 行号: " << m7->getRow() << ", 类型: " << m7->getAttribute<std::string>("类型")
+              << ", 射程: " << m7->getAttribute<double>("射程") << ", 属性数: " << m7->getAttributeKeys().size() << std::endl;
+    if (m7->getAttribute<double>("射程") != 107.0 || m7->getAttributeKeys().size() != 6) ++failures;
+    if (table->column<double>("射程")[m7->getRow()] != 107.0) ++failures;
+
+    auto detached = m7->clone();
+    std::cout << "克隆得到独立节点: " << (detached->getRowStorage() ? "否" : "是")
+              << ", 射程: " << detached->getAttribute<double>("射程") << std::endl;
+    if (detached->getRowStorage() || detached->getAttribute<double>("射程") != 107.0) ++failures;
+    if (table->rowCount() != static_cast<size_t>(MISSILE_COUNT)) ++failures;
+
+    std::cout << "\n=== 按列扫描 ===" << std::endl;
+    const size_t rangeField = schema->fieldIndex("射程");
+    double columnSum = 0, fieldSum = 0, dynamicSum = 0;
+    long long columnTime = measureTime([&]() {
+        const double* ranges = table->column<double>(rangeField);
+        for (size_t row = 0; row < table->rowCount(); ++row) columnSum += ranges[row];
+    });
+    long long fieldTime = measureTime([&]() {
+        for (const auto& node : schemaNodes) fieldSum += node->getField<double>(rangeField);
+    });
+    long long dynamicTime = measureTime([&]() {
+        for (const auto& node : dynamicNodes) dynamicSum += node->getAttribute<double>("射程");
+    });
+    std::cout << "列存储求和: " << columnTime << " 微秒" << std::endl;
+    std::cout << "模式节点逐个getField求和: " << fieldTime << " 微秒" << std::endl;
+    std::cout << "动态属性逐个getAttribute求和: " << dynamicTime << " 微秒" << std::endl;
+    if (columnSum != fieldSum || fieldSum != dynamicSum) ++failures;
+
+    auto deployed = table->selectRows<bool>("已部署", [](bool value) { return value; });
+    std::cout << "已部署: " << deployed.size() << " 枚" << std::endl;
+    if (deployed.size() != static_cast<size_t>((MISSILE_COUNT + 2) / 3)) ++failures;
+    deployed.clear();
+
+    std::cout << "\n=== 整列更新 ===" << std::endl;
+    long long columnUpdate = measureTime([&]() {
+        double* weights = table->column<double>("重量");
+        for (size_t row = 0; row < table->rowCount(); ++row) weights[row] *= 0.98;
+    });
+    long long nodeUpdate = measureTime([&]() {
+        for (const auto& node : dynamicNodes) node->setAttribute("重量", node->getAttribute<double>("重量") * 0.98);
+    });
+    std::cout << "按列更新重量: " << columnUpdate << " 微秒" << std::endl;
+    std::cout << "逐个节点更新重量: " << nodeUpdate << " 微秒" << std::endl;
+    if (m7->getAttribute<double>("重量") != dynamicNodes[7]->getAttribute<double>("重量")) ++failures;
+
+    table->fill("已部署", true);
+    std::cout << "整列部署后 m7 已部署: " << (m7->getAttribute<bool>("已部署") ? "是" : "否") << std::endl;
+    if (!m7->getAttribute<bool>("已部署")) ++failures;
+
+    std::cout << "\n=== 注册表、索引与导出 ===" << std::endl;
+    ResourceIndexer indexer(registry);
+    indexer.createAttributeIndex<double>("射程");
+    auto subscription = registry.subscribe("missile-group/m9");
+    registry.setAttribute("missile-group/m9", "射程", 600.0);
+    registry.commitChanges();
+    ChangeBatch batch;
+    size_t events = 0;
+    while (subscription->poll(batch)) events += batch.size();
+    auto farReaching = indexer.findGreaterThan<double>("射程", 500.0);
+    std::cout << "射程>500: " << farReaching.size() << " 个, 订阅事件: " << events
+              << ", 列中的值: " << table->column<double>("射程")[registry.getNodeByPath("missile-group/m9")->getRow()] << std::endl;
+    if (farReaching.size() != 1 || events != 1) ++failures;
+
+    std::ostringstream json;
+    {
+        JsonTreeWriter writer(json);
+        writer.writeNode(*registry.getNodeByPath("missile-group/m9"));
+    }
+    std::cout << json.str() << std::endl;
+    if (json.str().find("\"射程\":600.0") == std::string::npos) ++failures;
+
+    std::cout << "\n=== 删除行 ===" << std::endl;
+    // 删除m0后最后一行移入第0行，行句柄的行号随之更新
+    auto last = registry.getNodeByPath("missile-group/m" + std::to_string(MISSILE_COUNT - 1));
+    double lastRange = last->getAttribute<double>("射程");
+    registry.removeNodeByPath("missile-group/m0");
+    registry.commitChanges();  // 变更事件持有被删除的节点，提交后行才被释放
+    std::cout << "删除后行数: " << table->rowCount() << ", 最后一行移到: " << last->getRow()
+              << ", 射程: " << last->getAttribute<double>("射程") << std::endl;
+    if (table->rowCount() != static_cast<size_t>(MISSILE_COUNT - 1) || last->getRow() != 0) ++failures;
+    if (last->getAttribute<double>("射程") != lastRange || table->column<double>(rangeField)[0] != lastRange) ++failures;
+
+    std::cout << "\n失败项: " << failures << std::endl;
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,228 @@
+#include "resource_api.h"
+#include <atomic>
+#include <thread>
+
+#ifdef _WIN32
+#include <windows.h>
+#endif
+
+using namespace resource;
+
+// 记录收到的提交批次
+class CommitCounter : public ChangeListener {
+public:
+    CommitCounter() : batches(0), events(0) {}
+
+    void onChangesCommitted(const ChangeBatch& batch) override {
+        ++batches;
+        events += batch.size();
+    }
+
+    size_t batches;
+    size_t events;
+};
+
+int main()
+{
+#ifdef _WIN32
+    SetConsoleOutputCP(CP_UTF8);
+#endif
+    int failures = 0;
+    ResourceRegistry registry;
+
+    auto squad = std::make_shared<ResourceNode>("编队", "squad");
+    for (int i = 0; i < 3; ++i) {
+        auto agent = std::make_shared<ResourceNode>("单元", "agent" + std::to_string(i));
+        agent->setAttribute("health", 100);
+        agent->setAttribute("status", std::string("idle"));
+        squad->addChild(agent);
+    }
+    registry.registerRootNode(squad);
+
+    ResourceIndexer indexer(registry);
+    indexer.createAttributeIndex<int>("health");
+    indexer.createAttributeIndex<std::string>("status");
+    auto subscription = registry.subscribe("squad");
+
+    std::cout << "=== 批量提交 ===" << std::endl;
+    auto scout = std::make_shared<ResourceNode>("侦察单元", "scout");
+    WriteBatch batch;
+    batch.setAttribute("squad/agent0", "health", 80)
+         .setAttribute("squad/agent0", "status", "moving")
+         .setAttribute("squad/agent1", "health", 60)
+         .addNode("squad", scout)
+         .setAttribute("squad/scout", "health", 100)
+         .setAttribute("squad/scout", "status", "moving")
+         .removeNode("squad/agent2");
+    std::cout << "暂存操作数: " << batch.size() << std::endl;
+    bool committed = registry.commit(batch);
+    std::cout << "提交结果: " << (committed ? "成功" : "失败") << ", 剩余操作数: " << batch.size() << std::endl;
+    if (!committed || !batch.empty()) ++failures;
+
+    auto moving = indexer.findByAttributeIndexed<std::string>("status", "moving");
+    auto idle = indexer.findByAttributeIndexed<std::string>("status", "idle");
+    auto wounded = indexer.findLessThan<int>("health", 100);
+    std::cout << "status=moving: " << moving.size() << ", status=idle: " << idle.size()
+              << ", health<100: " << wounded.size() << std::endl;
+    std::cout << "findById(scout): " << indexer.findById("scout").size()
+              << ", findById(agent2): " << indexer.findById("agent2").size() << std::endl;
+    if (moving.size() != 2 || idle.size() != 1 || wounded.size() != 2) ++failures;
+    if (indexer.findById("scout").size() != 1 || !indexer.findById("agent2").empty()) ++failures;
+
+    ChangeBatch events;
+    int batches = 0;
+    while (subscription->poll(events)) {
+        ++batches;
+        std::cout << "订阅收到一批 " << events.size() << " 条事件" << std::endl;
+    }
+    if (batches != 1) ++failures;
+
+    std::cout << "\n=== 校验失败时整体回滚 ===" << std::endl;
+    batch.setAttribute("squad/agent0", "health", 1)
+         .removeNode("squad/agent1")
+         .setAttribute("squad/agent1", "health", 1);  // agent1已在本批次中删除
+    std::string error;
+    committed = registry.commit(batch, &error);
+    std::cout << "提交结果: " << (committed ? "成功" : "失败") << " (" << error << ")" << std::endl;
+    std::cout << "agent0 health: " << registry.getNodeByPath("squad/agent0")->getAttribute<int>("health")
+              << ", agent1 仍存在: " << (registry.getNodeByPath("squad/agent1") ? "是" : "否")
+              << ", 批次保留操作数: " << batch.size() << std::endl;
+    if (committed || batch.size() != 3) ++failures;
+    if (registry.getNodeByPath("squad/agent0")->getAttribute<int>("health") != 80) ++failures;
+    if (!registry.getNodeByPath("squad/agent1")) ++failures;
+    batch.clear();
+
+    std::cout << "\n=== 模式字段类型不符时整体回滚 ===" << std::endl;
+    // 本批次先添加的节点也要按其模式校验
+    auto sensorSchema = std::make_shared<NodeSchema>("传感器");
+    sensorSchema->addField<double>("range", 10.0);
+    batch.setAttribute("squad/agent0", "health", 2)
+         .addNode("squad", std::make_shared<ResourceNode>("传感器", "radar", sensorSchema))
+         .setAttribute("squad/radar", "range", 50);  // range为double字段
+    error.clear();
+    committed = false;
+    try {
+        committed = registry.commit(batch, &error);
+    } catch (const std::exception& e) {
+        error = std::string("异常: ") + e.what();
+        ++failures;
+    }
+    std::cout << "提交结果: " << (committed ? "成功" : "失败") << " (" << error << ")" << std::endl;
+    if (committed || batch.size() != 3 || error.find("range") == std::string::npos) ++failures;
+    if (registry.getNodeByPath("squad/agent0")->getAttribute<int>("health") != 80) ++failures;
+    if (registry.getNodeByPath("squad/radar")) ++failures;
+    batch.clear();
+    batch.addNode("squad", std::make_shared<ResourceNode>("传感器", "radar", sensorSchema))
+         .setAttribute("squad/radar", "range", 50.0);
+    if (!registry.commit(batch) || registry.getNodeByPath("squad/radar")->getAttribute<double>("range") != 50.0) {
+        ++failures;
+    }
+    batch.removeNode("squad/radar");
+    registry.commit(batch);
+    while (subscription->poll(events)) {
+    }
+
+    std::cout << "\n=== 读线程只看到完整的批次 ===" << std::endl;
+    // 每个批次在两个单元之间转移生命值，总和应保持不变
+    std::atomic<bool> done(false);
+    std::atomic<int> torn(0);
+    std::atomic<int> reads(0);
+    std::thread reader([&]() {
+        while (!done.load()) {
+            ReadLock lock(registry.getMutex());
+            int total = registry.getNodeByPath("squad/agent0")->getAttribute<int>("health") +
+                        registry.getNodeByPath("squad/agent1")->getAttribute<int>("health");
+            if (total != 140) ++torn;
+            ++reads;
+        }
+    });
+    for (int i = 0; i < 2000; ++i) {
+        int shift = i % 2 == 0 ? 1 : 0;
+        batch.setAttribute("squad/agent0", "health", 80 + shift)
+             .setAttribute("squad/agent1", "health", 60 - shift);
+        registry.commit(batch);
+    }
+    done = true;
+    reader.join();
+    std::cout << "读取次数: " << reads.load() << ", 读到中间状态: " << torn.load() << std::endl;
+    if (torn.load() != 0) ++failures;
+
+    std::cout << "\n=== 每帧数千次写入 ===" << std::endl;
+    registry.unsubscribe(subscription);
+
+    // 对照组：另一棵相同的树，逐条写入节点后全量刷新索引
+    ResourceRegistry baselineRegistry;
+    baselineRegistry.registerRootNode(std::make_shared<ResourceNode>("编队", "squad"));
+    for (int i = 0; i < 20000; ++i) {
+        auto agent = std::make_shared<ResourceNode>("单元", "unit" + std::to_string(i));
+        agent->setAttribute("health", i % 100);
+        agent->setAttribute("status", std::string("idle"));
+        batch.addNode("squad", agent);
+        baselineRegistry.registerNodeAtPath("squad/unit" + std::to_string(i), agent->clone());
+    }
+    registry.commit(batch);
+    ResourceIndexer baseline(baselineRegistry);
+    baseline.createAttributeIndex<int>("health");
+    baseline.createAttributeIndex<std::string>("status");
+
+    long long batchTime = 0;
+    long long baselineTime = 0;
+    for (int tick = 1; tick <= 5; ++tick) {
+        // 每帧修改十分之一的单元
+        for (int i = tick; i < 20000; i += 10) {
+            std::string path = "squad/unit" + std::to_string(i);
+            batch.setAttribute(path, "health", (i + tick) % 100);
+            batch.setAttribute(path, "status", tick % 2 ? "moving" : "idle");
+        }
+        batchTime += measureTime([&]() { registry.commit(batch); });
+        baselineTime += measureTime([&]() {
+            for (int i = tick; i < 20000; i += 10) {
+                auto node = baselineRegistry.getNodeByPath("squad/unit" + std::to_string(i));
+                node->setAttribute("health", (i + tick) % 100);
+                node->setAttribute("status", std::string(tick % 2 ? "moving" : "idle"));
+            }
+            baseline.refreshIndex();
+        });
+    }
+    std::cout << "批量提交平均耗时: " << batchTime / 5 << " 微秒/帧 (含增量更新索引)" << std::endl;
+    std::cout << "逐条写入+全量刷新索引平均耗时: " << baselineTime / 5 << " 微秒/帧" << std::endl;
+
+    // 增量维护的结果应与全量重建一致
+    ResourceIndexer rebuilt(registry);
+    for (int value = 0; value < 100; value += 7) {
+        if (indexer.findByAttributeIndexed<int>("health", value).size() !=
+            rebuilt.findByAttributeIndexed<int>("health", value).size()) {
+            ++failures;
+        }
+    }
+    if (indexer.findByAttributeIndexed<std::string>("status", "moving").size() !=
+        rebuilt.findByAttributeIndexed<std::string>("status", "moving").size()) {
+        ++failures;
+    }
+    std::cout << "health=42 节点数: " << indexer.findByAttributeIndexed<int>("health", 42).size()
+              << " (全量重建: " << rebuilt.findByAttributeIndexed<int>("health", 42).size()
+              << ", 对照组: " << baseline.findByAttributeIndexed<int>("health", 42).size() << ")" << std::endl;
+
+
+    std::cout << "\n=== 只用refreshIndex维护索引 ===" << std::endl;
+    // 索引器注册后注册表开始记录事件，refreshIndex负责把它们提交掉，不在注册表里堆积
+    ResourceRegistry manual;
+    manual.createPath("squad");
+    ResourceIndexer manualIndexer(manual);
+    CommitCounter counter;
+    manual.addChangeListener(&counter);
+    for (int i = 0; i < 100; ++i) {
+        const std::string id = "u" + std::to_string(i);
+        manual.registerNodeAtPath("squad/" + id, std::make_shared<ResourceNode>("单元", id));
+        manual.setAttribute("squad/" + id, "health", i);
+    }
+    manualIndexer.refreshIndex();
+    size_t delivered = counter.events;
+    manualIndexer.refreshIndex();
+    std::cout << "refreshIndex提交的事件: " << delivered << ", 再次刷新: " << counter.events - delivered << std::endl;
+    if (delivered != 200 || counter.batches != 1 || counter.events != delivered) ++failures;
+    if (manualIndexer.findByAttributeIndexed<int>("health", 42).size() != 1) ++failures;
+
+    std::cout << "\n失败项: " << failures << std::endl;
+    return failures == 0 ? 0 : 1;
+}
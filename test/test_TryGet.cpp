@@ -0,0 +1,118 @@
+#include "resource_api.h"
+#include <chrono>
+
+#ifdef _WIN32
+#include <windows.h>
+#endif
+
+using namespace resource;
+
+const int NODE_COUNT = 20000;
+
+double elapsedMs(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+int main()
+{
+#ifdef _WIN32
+    SetConsoleOutputCP(CP_UTF8);
+#endif
+    int failures = 0;
+
+    std::cout << "=== 类型标记 ===" << std::endl;
+    bool distinct = detail::typeTag<int>() != detail::typeTag<long>() &&
+                    detail::typeTag<int>() != detail::typeTag<unsigned>() &&
+                    detail::typeTag<std::string>() != detail::typeTag<const char*>();
+    bool stable = detail::typeTag<double>() == detail::typeTag<double>() &&
+                  TypedAttributeValue<double>(1.0).typeTag() == detail::typeTag<double>();
+    std::cout << "不同类型互不相同: " << (distinct ? "是" : "否") << ", 同一类型相同: " << (stable ? "是" : "否")
+              << std::endl;
+    if (!distinct || !stable) ++failures;
+
+    TypedAttributeValue<int> three(3);
+    if (!three.as<int>() || *three.as<int>() != 3 || three.as<double>() || three.as<long>()) ++failures;
+
+    std::cout << "\n=== 异构树上的按属性扫描 ===" << std::endl;
+    // 四分之一的节点"等级"为int，四分之一为double，四分之一为字符串，其余没有该属性
+    ResourceRegistry registry;
+    registry.createPath("army");
+    std::vector<std::shared_ptr<ResourceNode>> nodes;
+    nodes.reserve(NODE_COUNT);
+    int expectedInt = 0;
+    for (int i = 0; i < NODE_COUNT; ++i) {
+        auto node = std::make_shared<ResourceNode>("unit", "u" + std::to_string(i));
+        switch (i % 4) {
+            case 0:
+                node->setAttribute("等级", i % 5);
+                if (i % 5 == 3) ++expectedInt;
+                break;
+            case 1: node->setAttribute("等级", 3.0); break;
+            case 2: node->setAttribute("等级", std::string("3")); break;
+            default: node->setAttribute("编号", i); break;
+        }
+        nodes.push_back(node);
+    }
+    registry.registerChildren("army", nodes);
+    registry.commitChanges();
+    ResourceIndexer indexer(registry);
+
+    auto start = std::chrono::steady_clock::now();
+    size_t matched = indexer.findByAttribute<int>("等级", 3).size();
+    double scanMs = elapsedMs(start);
+    size_t doubles = indexer.findByAttribute<double>("等级", 3.0).size();
+    size_t strings = indexer.findByAttribute<std::string>("等级", "3").size();
+    std::cout << "int匹配: " << matched << " (预期 " << expectedInt << "), double: " << doubles << ", 字符串: " << strings
+              << ", 扫描 " << NODE_COUNT << " 个节点耗时 " << scanMs << " ms" << std::endl;
+    if (matched != static_cast<size_t>(expectedInt) || doubles != NODE_COUNT / 4 || strings != NODE_COUNT / 4) {
+        ++failures;
+    }
+
+    std::cout << "\n=== 建索引 ===" << std::endl;
+    start = std::chrono::steady_clock::now();
+    indexer.createAttributeIndex<int>("等级");
+    indexer.createAttributeIndex<double>("等级", IndexKind::Hash);
+    double buildMs = elapsedMs(start);
+    size_t indexedInt = indexer.findByAttributeIndexed<int>("等级", 3).size();
+    size_t indexedDouble = indexer.findByAttributeIndexed<double>("等级", 3.0).size();
+    std::cout << "int索引: " << indexedInt << ", double索引: " << indexedDouble << ", 建索引耗时 " << buildMs << " ms"
+              << std::endl;
+    if (indexedInt != matched || indexedDouble != doubles) ++failures;
+    // 重建与首次建立的结果相同
+    indexer.refreshIndex();
+    if (indexer.findByAttributeIndexed<int>("等级", 3).size() != matched) ++failures;
+
+    std::cout << "\n=== 模式字段和表中的行 ===" << std::endl;
+    auto schema = std::make_shared<NodeSchema>("radar");
+    schema->addField<double>("range").addField<bool>("active", true);
+    registry.registerSchema(schema);
+    auto bound = registry.createNode("radar", "radar", "r1");
+    auto row = registry.createRow("radar", "radar", "r2");
+    bound->setAttribute("range", 150.0);
+    row->setAttribute("range", 250.0);
+    bool fieldsOk = bound->tryGetAttribute<double>("range") && *bound->tryGetAttribute<double>("range") == 150.0 &&
+                    row->tryGetAttribute<double>("range") && *row->tryGetAttribute<double>("range") == 250.0 &&
+                    row->tryGetAttribute<bool>("active") && *row->tryGetAttribute<bool>("active") &&
+                    !bound->tryGetAttribute<int>("range") && !row->tryGetAttribute<float>("range");
+    std::cout << "模式字段按类型标记读取: " << (fieldsOk ? "正确" : "错误") << std::endl;
+    if (!fieldsOk) ++failures;
+    // 行视图与普通属性值之间的比较和赋值
+    const AttributeValue* cell = row->findAttribute("range");
+    if (!cell || !cell->equals(TypedAttributeValue<double>(250.0)) || cell->equals(TypedAttributeValue<int>(250))) {
+        ++failures;
+    }
+    bound->updateAttributeRaw("range", row->findAttribute("range")->clone());
+    if (bound->getAttributeRef<double>("range") != 250.0) ++failures;
+
+    // 类型不匹配的写入仍然报错
+    bool rejected = false;
+    try {
+        bound->setAttribute("range", 1);
+    } catch (const std::bad_cast&) {
+        rejected = true;
+    }
+    if (!rejected) ++failures;
+
+    std::cout << "\n失败项: " << failures << std::endl;
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,204 @@
+#include "resource_api.h"
+#include "resource_pipeline.h"
+#include <chrono>
+
+#ifdef _WIN32
+#include <windows.h>
+#endif
+
+using namespace resource;
+
+const int TRACK_COUNT = 5000;
+const int TICK_COUNT = 10;
+
+struct Track {
+    std::string id;
+    int tick;
+    double speed;
+    std::string callsign;
+};
+
+// 字段列表在编译期展开；成员类型写错（如把speed写成int）或属性名个数不符都无法通过编译
+typedef TypedConverter<Track, RESOURCE_STRUCT_FIELD(Track, id),
+                       RESOURCE_STRUCT_FIELD(Track, tick),
+                       RESOURCE_STRUCT_FIELD(Track, speed),
+                       RESOURCE_STRUCT_FIELD(Track, callsign)> TrackTypedConverter;
+
+// 手写的等价转换器，作为对照
+class TrackConverter : public StructConverter {
+public:
+    std::shared_ptr<ResourceNode> convert(const void* structPtr, const std::string& nodeName) const override {
+        const Track& track = *static_cast<const Track*>(structPtr);
+        auto node = std::make_shared<ResourceNode>(nodeName, track.id);
+        node->setAttribute("tick", track.tick);
+        node->setAttribute("speed", track.speed);
+        node->setAttribute("callsign", track.callsign);
+        return node;
+    }
+
+    StructConverter* clone() const override { return new TrackConverter(*this); }
+};
+
+// 统计提交的属性事件数
+class EventCounter : public ChangeListener {
+public:
+    EventCounter() : attributeEvents(0) {}
+
+    void onChangesCommitted(const ChangeBatch& batch) override {
+        for (const auto& event : batch) {
+            if (event.type == ChangeEvent::Type::ATTRIBUTE_CHANGED) ++attributeEvents;
+        }
+    }
+
+    size_t attributeEvents;
+};
+
+void advance(std::vector<Track>& tracks, int tick) {
+    for (size_t i = 0; i < tracks.size(); ++i) {
+        tracks[i].tick = tick;
+        tracks[i].speed = 200.0 + (tick * 13 + i) % 100;
+    }
+}
+
+std::vector<Track> makeTracks() {
+    std::vector<Track> tracks(TRACK_COUNT);
+    for (int i = 0; i < TRACK_COUNT; ++i) {
+        tracks[i].id = "t" + std::to_string(i);
+        tracks[i].tick = 0;
+        tracks[i].speed = 200.0;
+        tracks[i].callsign = "CS-" + std::to_string(i % 50);
+    }
+    return tracks;
+}
+
+// 注册全部航迹后运行TICK_COUNT次动态更新，返回总耗时（毫秒）
+double runTicks(ResourceRegistry& registry, std::vector<Track>& tracks, const StructConverter& converter) {
+    registry.createPath("tracks");
+    for (auto& track : tracks) {
+        registry.registerDynamicStruct(track, "tracks/" + track.id, converter, "track");
+    }
+    registry.commitChanges();
+    auto start = std::chrono::steady_clock::now();
+    for (int tick = 1; tick <= TICK_COUNT; ++tick) {
+        advance(tracks, tick);
+        registry.updateAllDynamicObjects();
+    }
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+int main()
+{
+#ifdef _WIN32
+    SetConsoleOutputCP(CP_UTF8);
+#endif
+    int failures = 0;
+
+    TrackTypedConverter typed("tick", "speed", "callsign");
+    std::cout << "=== 转换结果与手写转换器一致 ===" << std::endl;
+    Track sample = {"t42", 7, 250.5, "EAGLE"};
+    auto fromTyped = typed.convert(&sample, "track");
+    auto fromManual = TrackConverter().convert(&sample, "track");
+    bool same = fromTyped->getId() == "t42" && fromTyped->attributeCount() == fromManual->attributeCount();
+    for (const auto& key : fromManual->getAttributeKeys()) {
+        const AttributeValue* value = fromTyped->findAttribute(key);
+        if (!value || !value->equals(*fromManual->findAttribute(key))) same = false;
+    }
+    std::cout << "字段数: " << TrackTypedConverter::FIELD_COUNT << ", 属性一致: " << (same ? "是" : "否") << std::endl;
+    if (!same || TrackTypedConverter::FIELD_COUNT != 3 || typed.key(1) != "speed") ++failures;
+
+    std::cout << "\n=== 动态更新只提交有变化的属性 ===" << std::endl;
+    std::vector<Track> typedTracks = makeTracks();
+    ResourceRegistry typedRegistry;
+    EventCounter typedEvents;
+    typedRegistry.addChangeListener(&typedEvents);
+    ResourceIndexer typedIndexer(typedRegistry);
+    typedIndexer.createAttributeIndex<int>("tick");
+    double typedMs = runTicks(typedRegistry, typedTracks, typed);
+
+    std::vector<Track> manualTracks = makeTracks();
+    ResourceRegistry manualRegistry;
+    EventCounter manualEvents;
+    manualRegistry.addChangeListener(&manualEvents);
+    ResourceIndexer manualIndexer(manualRegistry);
+    manualIndexer.createAttributeIndex<int>("tick");
+    double manualMs = runTicks(manualRegistry, manualTracks, TrackConverter());
+
+    std::cout << "字段列表: " << typedMs << " ms, 手写转换器: " << manualMs << " ms (" << TRACK_COUNT << " 个对象 x "
+              << TICK_COUNT << " 次)" << std::endl;
+    std::cout << "属性事件: " << typedEvents.attributeEvents << " / " << manualEvents.attributeEvents << std::endl;
+    // 两条路径产生相同的事件，callsign不变所以不产生事件
+    if (typedEvents.attributeEvents != manualEvents.attributeEvents || typedEvents.attributeEvents == 0) ++failures;
+    if (typedEvents.attributeEvents >= static_cast<size_t>(TRACK_COUNT * TICK_COUNT * 3)) ++failures;
+    auto t9 = typedRegistry.getNodeByPath("tracks/t9");
+    if (!t9 || t9->getAttributeRef<double>("speed") != typedTracks[9].speed ||
+        t9->getAttributeRef<int>("tick") != TICK_COUNT) {
+        ++failures;
+    }
+    // 索引随提交的事件增量更新
+    if (typedIndexer.findByAttributeIndexed<int>("tick", TICK_COUNT).size() != static_cast<size_t>(TRACK_COUNT)) {
+        ++failures;
+    }
+
+    // 直接写入节点，节点上另行添加的子节点保留
+    t9->addChild(std::make_shared<ResourceNode>("sensor", "t9_sensor"));
+    typedTracks[9].speed = 999.0;
+    typedRegistry.updateAllDynamicObjects();
+    if (!t9->getChild("t9_sensor") || t9->getAttributeRef<double>("speed") != 999.0) ++failures;
+
+    std::cout << "\n=== 流水线合并同样只更新属性 ===" << std::endl;
+    // 合并线程拿到的是转换结果，字段值在转换时取出；节点上另行添加的子节点照样保留
+    size_t eventsBefore = typedEvents.attributeEvents;
+    {
+        TickPipeline pipeline(typedRegistry, 2);
+        for (int tick = TICK_COUNT + 1; tick <= TICK_COUNT + 3; ++tick) {
+            advance(typedTracks, tick);
+            typedTracks[9].speed = 1000.0 + tick;
+            pipeline.submitTick();
+        }
+        pipeline.flush();
+    }
+    const int lastTick = TICK_COUNT + 3;
+    std::cout << "子节点保留: " << (t9->getChild("t9_sensor") ? "是" : "否")
+              << ", 速度: " << t9->getAttributeRef<double>("speed") << std::endl;
+    if (!t9->getChild("t9_sensor") || t9->getAttributeRef<double>("speed") != 1000.0 + lastTick ||
+        t9->getAttributeRef<int>("tick") != lastTick) {
+        ++failures;
+    }
+    if (typedEvents.attributeEvents == eventsBefore ||
+        typedIndexer.findByAttributeIndexed<int>("tick", lastTick).size() != static_cast<size_t>(TRACK_COUNT)) {
+        ++failures;
+    }
+
+    std::cout << "\n=== 绑定模式 ===" << std::endl;
+    TrackTypedConverter bound("tick", "speed", "callsign");
+    auto schema = bound.makeSchema("track");
+    bound.useSchema(schema);
+    ResourceRegistry schemaRegistry;
+    schemaRegistry.registerSchema(schema);
+    schemaRegistry.createPath("tracks");
+    auto node = schemaRegistry.registerDynamicStruct(sample, "tracks/t42", bound, "track");
+    sample.speed = 300.0;
+    sample.callsign = "FALCON";
+    schemaRegistry.updateAllDynamicObjects();
+    std::cout << "模式字段: " << schema->fieldCount() << ", 速度: " << node->getAttributeRef<double>("speed")
+              << ", 呼号: " << node->getAttributeRef<std::string>("callsign") << std::endl;
+    if (node->getSchema() != schema || node->getAttributeRef<double>("speed") != 300.0 ||
+        node->getAttributeRef<std::string>("callsign") != "FALCON" || node->getAttributeRef<int>("tick") != 7) {
+        ++failures;
+    }
+
+    // 字段与转换器不对应的模式被拒绝
+    auto other = std::make_shared<NodeSchema>("other");
+    other->addField<int>("tick").addField<int>("speed").addField<std::string>("callsign");
+    bool rejected = false;
+    try {
+        bound.useSchema(other);
+    } catch (const std::invalid_argument& e) {
+        rejected = true;
+        std::cout << "不匹配的模式: " << e.what() << std::endl;
+    }
+    if (!rejected || bound.getSchema() != schema) ++failures;
+
+    std::cout << "\n失败项: " << failures << std::endl;
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,125 @@
+#include "resource_api.h"
+
+#ifdef _WIN32
+#include <windows.h>
+#endif
+
+using namespace resource;
+
+enum class TrackClass { Unknown, Friendly, Hostile };
+
+// 自定义键类型：只需要operator<即可建立索引
+struct Version {
+    int major;
+    int minor;
+
+    Version(int ma = 0, int mi = 0) : major(ma), minor(mi) {}
+
+    bool operator<(const Version& other) const {
+        return major < other.major || (major == other.major && minor < other.minor);
+    }
+};
+
+const int TRACK_COUNT = 1000;
+// 超过2^53后相邻的整数在double中无法区分
+const long long BASE_ID = (1LL << 53) + 1;
+
+int main()
+{
+#ifdef _WIN32
+    SetConsoleOutputCP(CP_UTF8);
+#endif
+    int failures = 0;
+    ResourceRegistry registry;
+
+    auto tracks = std::make_shared<ResourceNode>("航迹表", "tracks");
+    for (int i = 0; i < TRACK_COUNT; ++i) {
+        auto track = std::make_shared<ResourceNode>("航迹", "t" + std::to_string(i));
+        track->setAttribute("批号", BASE_ID + i);
+        track->setAttribute("时间戳", static_cast<unsigned long long>(1700000000000000000ULL + i));
+        track->setAttribute("速度", 100.0f + static_cast<float>(i % 10));
+        track->setAttribute("分类", i % 3 == 0 ? TrackClass::Hostile : TrackClass::Friendly);
+        track->setAttribute("版本", Version(1, i % 5));
+        tracks->addChild(track);
+    }
+    registry.registerRootNode(tracks);
+    ResourceIndexer indexer(registry);
+    indexer.createAttributeIndex<long long>("批号");
+    indexer.createAttributeIndex<unsigned long long>("时间戳");
+    indexer.createAttributeIndex<float>("速度");
+    indexer.createAttributeIndex<TrackClass>("分类");
+    indexer.createAttributeIndex<Version>("版本");
+
+    std::cout << "=== 64位整数索引不丢失精度 ===" << std::endl;
+    auto exact = indexer.findByAttributeIndexed<long long>("批号", BASE_ID + 1);
+    std::cout << "批号 " << BASE_ID + 1 << " 的结果数: " << exact.size() << std::endl;
+    if (exact.size() != 1 || exact[0]->getId() != "t1") ++failures;
+    auto range = indexer.findInRange<long long>("批号", BASE_ID + 10, BASE_ID + 19);
+    std::cout << "范围内结果数: " << range.size() << std::endl;
+    if (range.size() != 10) ++failures;
+    auto later = indexer.findGreaterThan<unsigned long long>("时间戳", 1700000000000000000ULL + TRACK_COUNT - 3);
+    std::cout << "时间戳大于倒数第三个的结果数: " << later.size() << std::endl;
+    if (later.size() != 2) ++failures;
+
+    std::cout << "\n=== float索引在refreshIndex后保留 ===" << std::endl;
+    size_t fast = indexer.findGreaterThan<float>("速度", 105.0f).size();
+    indexer.refreshIndex();
+    bool kept = indexer.hasAttributeIndex<float>("速度") && indexer.hasAttributeIndex<long long>("批号");
+    size_t fastAfter = indexer.findGreaterThan<float>("速度", 105.0f).size();
+    std::cout << "重建前: " << fast << ", 重建后: " << fastAfter << ", 索引保留: " << (kept ? "是" : "否") << std::endl;
+    if (!kept || fast != 400 || fastAfter != fast) ++failures;
+
+    std::cout << "\n=== 枚举索引 ===" << std::endl;
+    size_t hostile = indexer.findByAttributeIndexed<TrackClass>("分类", TrackClass::Hostile).size();
+    std::cout << "敌方航迹数: " << hostile << std::endl;
+    if (hostile != 334) ++failures;
+
+    std::cout << "\n=== 自定义类型索引 ===" << std::endl;
+    QueryCacheStats before = indexer.getQueryCacheStats();
+    size_t newer = indexer.findGreaterThan<Version>("版本", Version(1, 2)).size();
+    size_t exactVersion = indexer.findByAttributeIndexed<Version>("版本", Version(1, 0)).size();
+    std::cout << "版本高于1.2: " << newer << ", 版本为1.0: " << exactVersion << std::endl;
+    if (newer != 400 || exactVersion != 200) ++failures;
+    // 没有IndexKeyFormat的类型不进入查询缓存
+    if (indexer.getQueryCacheStats().misses != before.misses || indexer.getQueryCacheStats().entries != before.entries) {
+        ++failures;
+    }
+
+    std::cout << "\n=== 增量更新 ===" << std::endl;
+    registry.setAttribute("tracks/t0", "批号", BASE_ID + 5000);
+    registry.setAttribute("tracks/t1", "分类", TrackClass::Unknown);
+    registry.setAttribute("tracks/t3", "版本", Version(2, 0));
+    registry.commitChanges();
+    size_t moved = indexer.findByAttributeIndexed<long long>("批号", BASE_ID + 5000).size();
+    size_t old = indexer.findByAttributeIndexed<long long>("批号", BASE_ID).size();
+    size_t unknown = indexer.findByAttributeIndexed<TrackClass>("分类", TrackClass::Unknown).size();
+    size_t major2 = indexer.findGreaterThan<Version>("版本", Version(1, 9)).size();
+    std::cout << "新批号: " << moved << ", 旧批号: " << old << ", 未知分类: " << unknown << ", 2.x版本: " << major2
+              << std::endl;
+    if (moved != 1 || old != 0 || unknown != 1 || major2 != 1) ++failures;
+
+    std::cout << "\n=== 分页续查标记保留64位键 ===" << std::endl;
+    PageToken<long long> token;
+    size_t paged = 0;
+    size_t pages = 0;
+    do {
+        paged += indexer.findInRange<long long>("批号", BASE_ID, BASE_ID + TRACK_COUNT, 7, token).size();
+        ++pages;
+    } while (!token.empty);
+    std::cout << "页数: " << pages << ", 总数: " << paged << std::endl;
+    if (paged != TRACK_COUNT - 1) ++failures;
+
+    std::cout << "\n=== 数值索引聚合 ===" << std::endl;
+    AggregateResult speed = indexer.aggregate("速度");
+    std::cout << "计数: " << speed.count << ", 最小: " << speed.min << ", 最大: " << speed.max << std::endl;
+    if (speed.count != TRACK_COUNT || speed.min != 100.0 || speed.max != 109.0) ++failures;
+
+    std::cout << "\n=== 内存统计 ===" << std::endl;
+    std::map<std::string, size_t> byIndex;
+    indexer.memoryUsage(&byIndex);
+    std::cout << "批号索引: " << byIndex["批号"] << " 字节, 版本索引: " << byIndex["版本"] << " 字节" << std::endl;
+    if (byIndex["批号"] == 0 || byIndex["版本"] == 0) ++failures;
+
+    std::cout << "\n失败项: " << failures << std::endl;
+    return failures == 0 ? 0 : 1;
+}